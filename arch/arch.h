@@ -212,4 +212,127 @@ static inline ALWAYS_INLINE int32_t Arch_SSAT(int32_t x, const int bit)
 	return result;
 }
 
+/**
+ * @brief signed multiply the bottom halves of two words and accumulate: 
+ * x[15:0] * y[15:0] + acc 
+ * 
+ * @param x 1st operand (two packed halfwords)
+ * @param y 2nd operand (two packed halfwords)
+ * @param acc accumulator value
+ * 
+ * @return int32_t result
+ */
+static inline ALWAYS_INLINE int32_t Arch_SMLABB(uint32_t x, uint32_t y, 
+	int32_t acc)
+{
+	/* result */
+	int32_t result;
+	/* some assembly magic */
+	ASM (
+		"smlabb	   %[result], %[x], %[y], %[acc]	\n"
+		: [result] "=r" (result)
+		: [x] "r" (x), [y] "r" (y), [acc] "r" (acc)
+	);
+	/* report result */
+	return result;
+}
+
+/**
+ * @brief signed multiply the top halves of two words and accumulate: 
+ * x[31:16] * y[31:16] + acc 
+ * 
+ * @param x 1st operand (two packed halfwords)
+ * @param y 2nd operand (two packed halfwords)
+ * @param acc accumulator value
+ * 
+ * @return int32_t result
+ */
+static inline ALWAYS_INLINE int32_t Arch_SMLATT(uint32_t x, uint32_t y, 
+	int32_t acc)
+{
+	/* result */
+	int32_t result;
+	/* some assembly magic */
+	ASM (
+		"smlatt	   %[result], %[x], %[y], %[acc]	\n"
+		: [result] "=r" (result)
+		: [x] "r" (x), [y] "r" (y), [acc] "r" (acc)
+	);
+	/* report result */
+	return result;
+}
+
+/**
+ * @brief signed dual multiply and add: x[15:0] * y[15:0] + 
+ * x[31:16] * y[31:16]
+ * 
+ * @param x 1st operand (two packed halfwords)
+ * @param y 2nd operand (two packed halfwords)
+ * 
+ * @return int32_t result
+ */
+static inline ALWAYS_INLINE int32_t Arch_SMUAD(uint32_t x, uint32_t y)
+{
+	/* result */
+	int32_t result;
+	/* some assembly magic */
+	ASM (
+		"smuad	   %[result], %[x], %[y]	\n"
+		: [result] "=r" (result)
+		: [x] "r" (x), [y] "r" (y)
+	);
+	/* report result */
+	return result;
+}
+
+/**
+ * @brief pack halfwords: bottom half is taken from 'b', top half from 't' 
+ * shifted left by 'lsl' bits
+ * 
+ * @param b word that provides the bottom half
+ * @param t word that provides the top half (after shifting)
+ * @param lsl left shift applied to 't', needs to be a compile time constant
+ * 
+ * @return uint32_t packed word
+ */
+static inline ALWAYS_INLINE uint32_t Arch_PKHBT(uint32_t b, uint32_t t, 
+	const int lsl)
+{
+	/* result */
+	uint32_t result;
+	/* some assembly magic */
+	ASM (
+		"pkhbt	   %[result], %[b], %[t], lsl %[lsl]	\n"
+		: [result] "=r" (result)
+		: [b] "r" (b), [t] "r" (t), [lsl] "M" (lsl)
+	);
+	/* report result */
+	return result;
+}
+
+/**
+ * @brief signed multiply two words and accumulate the 64-bit result: 
+ * x * y + acc
+ * 
+ * @param x 1st operand
+ * @param y 2nd operand
+ * @param acc 64-bit accumulator value
+ * 
+ * @return int64_t result
+ */
+static inline ALWAYS_INLINE int64_t Arch_SMLAL(int32_t x, int32_t y, 
+	int64_t acc)
+{
+	/* accumulator halves */
+	uint32_t lo = (uint32_t)acc, hi = (uint32_t)((uint64_t)acc >> 32);
+	/* some assembly magic */
+	ASM (
+		"smlal	   %[lo], %[hi], %[x], %[y]	\n"
+		: [lo] "+r" (lo), [hi] "+r" (hi)
+		: [x] "r" (x), [y] "r" (y)
+	);
+	/* report result */
+	return (int64_t)((uint64_t)hi << 32 | lo);
+}
+
 #endif /* ARCH_ARCH_H_ */
@@ -13,8 +13,15 @@
 #include "config.h"
 #include "err.h"
 #include "at/cmd.h"
+#include "at/ntf/radio.h"
+#include "radio/meter.h"
+#include "radio/mix1.h"
 #include "radio/radio.h"
+#include "radio/rfcap.h"
+#include "radio/scan.h"
+#include "radio/spectrum.h"
 #include "util/stdio.h"
+#include "util/string.h"
 
 /* process AT+RADIO= command */
 static int ATCmdRadio_ProcFrequencySet(int iface, const char *line, size_t len)
@@ -49,16 +56,609 @@ static int ATCmdRadio_ProcFrequencyRead(int iface, const char *line,
     char res[AT_RES_MAX_LINE_LEN];
     /* render the response */
     size_t res_len = snprintf(res, sizeof(res), 
-        "+RADIO_TUNE: %.5e" AT_LINE_END, f);
+        "+RADIO_TUNE: %.3f" AT_LINE_END, f);
 	/* execute command and report status */
 	return ATCmd_SendResponse(iface, res, res_len);
 }
 
+/* set the demodulation mode */
+static int ATCmdRadio_ProcModeSet(int iface, const char *line, size_t len)
+{
+    /* name of the mode */
+    char name[4]; const char *n;
+
+	/* try to parse the input string */
+	if (sscanf(line, "AT+RADIO_MODE=%.4s%", name) != 2)
+        return EAT_SYNTAX;
+    
+    /* look for the mode with matching name */
+    for (int i = 0; (n = Radio_GetModeName(i)); i++)
+        if (strcmp(n, name) == 0)
+            return Radio_SetMode(i);
+    
+    /* mode not found */
+    return EAT_SYNTAX;
+}
+
+/* read the demodulation mode */
+static int ATCmdRadio_ProcModeRead(int iface, const char *line, size_t len)
+{
+    /* demodulation mode */
+    int mode;
+
+	/* try to parse the input string */
+	if (sscanf(line, "AT+RADIO_MODE?%") != 1)
+		return EAT_SYNTAX;
+
+    /* get the mode */
+    if (Radio_GetMode(&mode) != EOK)
+        return EFATAL;
+
+    /* buffer for the response */
+    char res[AT_RES_MAX_LINE_LEN];
+    /* render the response */
+    size_t res_len = snprintf(res, sizeof(res), 
+        "+RADIO_MODE: %s" AT_LINE_END, Radio_GetModeName(mode));
+	/* execute command and report status */
+	return ATCmd_SendResponse(iface, res, res_len);
+}
+
+/* set the bfo pitch */
+static int ATCmdRadio_ProcBFOSet(int iface, const char *line, size_t len)
+{
+    /* placeholder for the pitch value */
+    float f;
+
+	/* try to parse the input string */
+	if (sscanf(line, "AT+RADIO_BFO=%e%", &f) != 2)
+        return EAT_SYNTAX;
+    
+	/* apply */
+	return Radio_SetBFO(f);
+}
+
+/* read the bfo pitch */
+static int ATCmdRadio_ProcBFORead(int iface, const char *line, size_t len)
+{
+    /* pitch */
+    float f;
+
+	/* try to parse the input string */
+	if (sscanf(line, "AT+RADIO_BFO?%") != 1)
+		return EAT_SYNTAX;
+
+    /* get the pitch */
+    if (Radio_GetBFO(&f) != EOK)
+        return EFATAL;
+
+    /* buffer for the response */
+    char res[AT_RES_MAX_LINE_LEN];
+    /* render the response */
+    size_t res_len = snprintf(res, sizeof(res), 
+        "+RADIO_BFO: %.1f" AT_LINE_END, f);
+	/* execute command and report status */
+	return ATCmd_SendResponse(iface, res, res_len);
+}
+
+/* set the agc settings of the current mode */
+static int ATCmdRadio_ProcAGCSet(int iface, const char *line, size_t len)
+{
+    /* settings: times in ms, max gain in dB */
+    float attack, hang, decay, max_gain; int mode;
+
+	/* try to parse the input string */
+	if (sscanf(line, "AT+RADIO_AGC=%e,%e,%e,%e%", &attack, &hang, &decay, 
+        &max_gain) != 5)
+        return EAT_SYNTAX;
+    
+    /* settings are kept per mode */
+    if (Radio_GetMode(&mode) != EOK)
+        return EFATAL;
+    /* convert the times to seconds */
+    agc_cfg_t cfg = { .attack = attack / 1000, .hang = hang / 1000, 
+        .decay = decay / 1000, .max_gain = max_gain };
+	/* apply */
+	return Radio_SetAGC(mode, &cfg);
+}
+
+/* read the agc settings of the current mode and its state */
+static int ATCmdRadio_ProcAGCRead(int iface, const char *line, size_t len)
+{
+    /* settings, gain and the signal level */
+    agc_cfg_t cfg; float gain, rssi; int mode;
+
+	/* try to parse the input string */
+	if (sscanf(line, "AT+RADIO_AGC?%") != 1)
+		return EAT_SYNTAX;
+
+    /* get the settings and the state */
+    if (Radio_GetMode(&mode) != EOK || Radio_GetAGC(mode, &cfg) != EOK ||
+        Radio_GetAGCStatus(&gain, &rssi) != EOK)
+        return EFATAL;
+
+    /* buffer for the response */
+    char res[AT_RES_MAX_LINE_LEN];
+    /* render the response */
+    size_t res_len = snprintf(res, sizeof(res), 
+        "+RADIO_AGC: %.1f,%.1f,%.1f,%.1f,%.1f,%.1f" AT_LINE_END, 
+        cfg.attack * 1000, cfg.hang * 1000, cfg.decay * 1000, cfg.max_gain, 
+        gain, rssi);
+	/* execute command and report status */
+	return ATCmd_SendResponse(iface, res, res_len);
+}
+
+/* read the signal meter */
+static int ATCmdRadio_ProcRSSIRead(int iface, const char *line, size_t len)
+{
+    /* channel power, noise floor, squelch state */
+    float rssi, floor; int open;
+
+	/* try to parse the input string */
+	if (sscanf(line, "AT+RADIO_RSSI?%") != 1)
+		return EAT_SYNTAX;
+
+    /* get the measurements */
+    if (Meter_GetLevels(&rssi, &floor) != EOK ||
+        Meter_GetSquelch(0, &open) != EOK)
+        return EFATAL;
+
+    /* buffer for the response */
+    char res[AT_RES_MAX_LINE_LEN];
+    /* render the response */
+    size_t res_len = snprintf(res, sizeof(res), 
+        "+RADIO_RSSI: %.1f,%.1f,%.1f,%d" AT_LINE_END, rssi, floor, 
+        rssi - floor, open);
+	/* execute command and report status */
+	return ATCmd_SendResponse(iface, res, res_len);
+}
+
+/* set the squelch threshold */
+static int ATCmdRadio_ProcSquelchSet(int iface, const char *line, size_t len)
+{
+    /* threshold in dB */
+    float snr;
+
+	/* try to parse the input string */
+	if (sscanf(line, "AT+RADIO_SQUELCH=%e%", &snr) != 2)
+        return EAT_SYNTAX;
+	/* apply */
+	return Meter_SetSquelch(snr);
+}
+
+/* read the squelch threshold and state */
+static int ATCmdRadio_ProcSquelchRead(int iface, const char *line, size_t len)
+{
+    /* threshold, squelch state */
+    float snr; int open;
+
+	/* try to parse the input string */
+	if (sscanf(line, "AT+RADIO_SQUELCH?%") != 1)
+		return EAT_SYNTAX;
+
+    /* get the settings and the state */
+    if (Meter_GetSquelch(&snr, &open) != EOK)
+        return EFATAL;
+
+    /* buffer for the response */
+    char res[AT_RES_MAX_LINE_LEN];
+    /* render the response */
+    size_t res_len = snprintf(res, sizeof(res), 
+        "+RADIO_SQUELCH: %.1f,%d" AT_LINE_END, snr, open);
+	/* execute command and report status */
+	return ATCmd_SendResponse(iface, res, res_len);
+}
+
+/* set the noise blanker threshold */
+static int ATCmdRadio_ProcNBSet(int iface, const char *line, size_t len)
+{
+    /* threshold in dB */
+    float threshold;
+
+	/* try to parse the input string */
+	if (sscanf(line, "AT+RADIO_NB=%e%", &threshold) != 2)
+        return EAT_SYNTAX;
+	/* apply */
+	return Mix1_SetBlanker(threshold);
+}
+
+/* read the noise blanker threshold and statistics */
+static int ATCmdRadio_ProcNBRead(int iface, const char *line, size_t len)
+{
+    /* threshold, number of blanked samples */
+    float threshold; uint32_t blanked;
+
+	/* try to parse the input string */
+	if (sscanf(line, "AT+RADIO_NB?%") != 1)
+		return EAT_SYNTAX;
+
+    /* get the settings and the statistics */
+    if (Mix1_GetBlanker(&threshold, &blanked) != EOK)
+        return EFATAL;
+
+    /* buffer for the response */
+    char res[AT_RES_MAX_LINE_LEN];
+    /* render the response */
+    size_t res_len = snprintf(res, sizeof(res), 
+        "+RADIO_NB: %.1f,%u" AT_LINE_END, threshold, blanked);
+	/* execute command and report status */
+	return ATCmd_SendResponse(iface, res, res_len);
+}
+
+/* enable or disable the adaptive notch */
+static int ATCmdRadio_ProcNotchSet(int iface, const char *line, size_t len)
+{
+    /* enable flag */
+    int enable;
+
+	/* try to parse the input string */
+	if (sscanf(line, "AT+RADIO_NOTCH=%d%", &enable) != 2)
+        return EAT_SYNTAX;
+    /* only 0 and 1 are accepted */
+    if (enable != 0 && enable != 1)
+        return EAT_SYNTAX;
+    /* apply */
+    return Radio_SetNotch(enable);
+}
+
+/* read the adaptive notch setting */
+static int ATCmdRadio_ProcNotchRead(int iface, const char *line, size_t len)
+{
+    /* enable flag */
+    int enable;
+
+	/* try to parse the input string */
+	if (sscanf(line, "AT+RADIO_NOTCH?%") != 1)
+		return EAT_SYNTAX;
+
+    /* get the setting */
+    if (Radio_GetNotch(&enable) != EOK)
+        return EFATAL;
+
+    /* buffer for the response */
+    char res[AT_RES_MAX_LINE_LEN];
+    /* render the response */
+    size_t res_len = snprintf(res, sizeof(res), 
+        "+RADIO_NOTCH: %d" AT_LINE_END, enable);
+	/* execute command and report status */
+	return ATCmd_SendResponse(iface, res, res_len);
+}
+
+/* set the iq stream sampling rate */
+static int ATCmdRadio_ProcIQRateSet(int iface, const char *line, size_t len)
+{
+    /* sampling rate */
+    int rate;
+
+	/* try to parse the input string */
+	if (sscanf(line, "AT+RADIO_IQRATE=%d%", &rate) != 2)
+        return EAT_SYNTAX;
+	/* apply */
+	return Radio_SetIQRate(rate);
+}
+
+/* read the iq stream sampling rate */
+static int ATCmdRadio_ProcIQRateRead(int iface, const char *line, size_t len)
+{
+    /* sampling rate */
+    int rate;
+
+	/* try to parse the input string */
+	if (sscanf(line, "AT+RADIO_IQRATE?%") != 1)
+		return EAT_SYNTAX;
+
+    /* get the setting */
+    if (Radio_GetIQRate(&rate) != EOK)
+        return EFATAL;
+
+    /* buffer for the response */
+    char res[AT_RES_MAX_LINE_LEN];
+    /* render the response */
+    size_t res_len = snprintf(res, sizeof(res), 
+        "+RADIO_IQRATE: %d" AT_LINE_END, rate);
+	/* execute command and report status */
+	return ATCmd_SendResponse(iface, res, res_len);
+}
+
+/* set the raw rf capture format */
+static int ATCmdRadio_ProcRFCapSet(int iface, const char *line, size_t len)
+{
+    /* sample format and the decimation rate */
+    int format, dec;
+
+	/* try to parse the input string */
+	if (sscanf(line, "AT+RADIO_RFCAP=%d,%d%", &format, &dec) != 3)
+        return EAT_SYNTAX;
+	/* apply */
+	return RFCap_SetFormat(format, dec);
+}
+
+/* read the raw rf capture format and statistics */
+static int ATCmdRadio_ProcRFCapRead(int iface, const char *line, size_t len)
+{
+    /* sample format and the decimation rate, statistics */
+    int format, dec; rfcap_stats_t stats;
+
+	/* try to parse the input string */
+	if (sscanf(line, "AT+RADIO_RFCAP?%") != 1)
+		return EAT_SYNTAX;
+
+    /* get the settings and the statistics */
+    if (RFCap_GetFormat(&format, &dec) != EOK || 
+        RFCap_GetStats(&stats) != EOK)
+        return EFATAL;
+
+    /* buffer for the response */
+    char res[AT_RES_MAX_LINE_LEN];
+    /* render the response */
+    size_t res_len = snprintf(res, sizeof(res), 
+        "+RADIO_RFCAP: %d,%d,%u,%u,%u,%u,%u" AT_LINE_END, format, dec, 
+        stats.blocks, stats.sent, stats.dropped, stats.torn, stats.rate);
+	/* execute command and report status */
+	return ATCmd_SendResponse(iface, res, res_len);
+}
+
+/* set the iq notification format for the interface that issued the command */
+static int ATCmdRadio_ProcIQFormatSet(int iface, const char *line, size_t len)
+{
+    /* notification format */
+    int fmt;
+
+	/* try to parse the input string */
+	if (sscanf(line, "AT+RADIO_IQFMT=%d%", &fmt) != 2)
+        return EAT_SYNTAX;
+	/* apply */
+	return ATNtfRadio_SetIQFormat(iface, fmt);
+}
+
+/* read the iq notification format of the interface that issued the command */
+static int ATCmdRadio_ProcIQFormatRead(int iface, const char *line, 
+    size_t len)
+{
+    /* notification format */
+    int fmt;
+
+	/* try to parse the input string */
+	if (sscanf(line, "AT+RADIO_IQFMT?%") != 1)
+		return EAT_SYNTAX;
+
+    /* get the format */
+    if (ATNtfRadio_GetIQFormat(iface, &fmt) != EOK)
+        return EFATAL;
+
+    /* buffer for the response */
+    char res[AT_RES_MAX_LINE_LEN];
+    /* render the response */
+    size_t res_len = snprintf(res, sizeof(res), "+RADIO_IQFMT: %d" 
+        AT_LINE_END, fmt);
+	/* execute command and report status */
+	return ATCmd_SendResponse(iface, res, res_len);
+}
+
+/* read the carrier tracking status */
+static int ATCmdRadio_ProcCarrierRead(int iface, const char *line, 
+    size_t len)
+{
+    /* lock status and the offset */
+    int locked; float offset;
+
+	/* try to parse the input string */
+	if (sscanf(line, "AT+RADIO_CARRIER?%") != 1)
+		return EAT_SYNTAX;
+
+    /* get the status */
+    if (Radio_GetCarrier(&locked, &offset) != EOK)
+        return EFATAL;
+
+    /* buffer for the response */
+    char res[AT_RES_MAX_LINE_LEN];
+    /* render the response */
+    size_t res_len = snprintf(res, sizeof(res), 
+        "+RADIO_CARRIER: %d,%.3f" AT_LINE_END, locked, offset);
+	/* execute command and report status */
+	return ATCmd_SendResponse(iface, res, res_len);
+}
+
+/* report the processing stage profiling statistics */
+static int ATCmdRadio_ProcProfileRead(int iface, const char *line, 
+    size_t len)
+{
+    /* stage statistics */
+    prof_stats_t stats;
+    /* stage name */
+    const char *name;
+    /* buffer for the response */
+    char res[AT_RES_MAX_LINE_LEN];
+    /* response length */
+    size_t res_len; int rc = EOK;
+
+	/* try to parse the input string */
+	if (sscanf(line, "AT+RADIO_PROF?%") != 1)
+		return EAT_SYNTAX;
+
+    /* one line per stage */
+    for (int i = 0; i < RADIO_PROF_NUM && rc == EOK; i++) {
+        /* get the statistics */
+        if (Radio_GetProfile(i, &name, &stats) != EOK)
+            return EFATAL;
+        /* render the response */
+        res_len = snprintf(res, sizeof(res), 
+            "+RADIO_PROF: %s,%u,%u,%u,%u" AT_LINE_END, name, stats.min, 
+            stats.avg, stats.max, stats.p99);
+        /* send it */
+        rc = ATCmd_SendResponse(iface, res, res_len);
+    }
+
+	/* report status */
+	return rc;
+}
+
+/* reset the processing stage profiling statistics */
+static int ATCmdRadio_ProcProfileSet(int iface, const char *line, size_t len)
+{
+	/* try to parse the input string: only reset is supported */
+	if (sscanf(line, "AT+RADIO_PROF=0%") != 1)
+        return EAT_SYNTAX;
+    
+	/* reset the statistics */
+	return Radio_ResetProfile();
+}
+
+/* set the spectrum engine rate */
+static int ATCmdRadio_ProcSpectrumSet(int iface, const char *line, size_t len)
+{
+    /* lines per second and frames per line */
+    int rate, average;
+
+	/* try to parse the input string */
+	if (sscanf(line, "AT+RADIO_SPECTRUM=%d,%d%", &rate, &average) != 3)
+        return EAT_SYNTAX;
+
+	/* apply */
+	return Spectrum_SetRate(rate, average);
+}
+
+/* read the spectrum engine rate */
+static int ATCmdRadio_ProcSpectrumRead(int iface, const char *line,
+    size_t len)
+{
+    /* lines per second and frames per line */
+    int rate, average;
+
+	/* try to parse the input string */
+	if (sscanf(line, "AT+RADIO_SPECTRUM?%") != 1)
+		return EAT_SYNTAX;
+
+    /* get the settings */
+    if (Spectrum_GetRate(&rate, &average) != EOK)
+        return EFATAL;
+
+    /* buffer for the response */
+    char res[AT_RES_MAX_LINE_LEN];
+    /* render the response */
+    size_t res_len = snprintf(res, sizeof(res),
+        "+RADIO_SPECTRUM: %d,%d" AT_LINE_END, rate, average);
+	/* execute command and report status */
+	return ATCmd_SendResponse(iface, res, res_len);
+}
+
+/* start or stop the wideband scan */
+static int ATCmdRadio_ProcScanSet(int iface, const char *line, size_t len)
+{
+    /* frames per band */
+    int dwell;
+
+	/* try to parse the input string */
+	if (sscanf(line, "AT+RADIO_SCAN=%d%", &dwell) != 2)
+        return EAT_SYNTAX;
+
+	/* apply */
+	return Radio_Scan(dwell);
+}
+
+/* read the wideband scan progress */
+static int ATCmdRadio_ProcScanRead(int iface, const char *line, size_t len)
+{
+    /* scan status and the number of the bands done */
+    int running, bands;
+
+	/* try to parse the input string */
+	if (sscanf(line, "AT+RADIO_SCAN?%") != 1)
+		return EAT_SYNTAX;
+
+    /* get the progress */
+    if (Scan_GetProgress(&running, &bands) != EOK)
+        return EFATAL;
+
+    /* buffer for the response */
+    char res[AT_RES_MAX_LINE_LEN];
+    /* render the response */
+    size_t res_len = snprintf(res, sizeof(res),
+        "+RADIO_SCAN: %d,%d,%d" AT_LINE_END, running, bands, SCAN_BANDS);
+	/* execute command and report status */
+	return ATCmd_SendResponse(iface, res, res_len);
+}
+
+/* report the occupied channels from the wideband scan table */
+static int ATCmdRadio_ProcScanTableRead(int iface, const char *line,
+    size_t len)
+{
+    /* channel parameters */
+    float frequency, level, snr;
+    /* buffer for the response */
+    char res[AT_RES_MAX_LINE_LEN];
+    /* response length */
+    size_t res_len; int rc = EOK;
+
+	/* try to parse the input string */
+	if (sscanf(line, "AT+RADIO_SCAN_TABLE?%") != 1)
+		return EAT_SYNTAX;
+
+    /* one line per occupied channel, stop at the first channel that was not
+     * measured yet */
+    for (int c = 0; c < SCAN_CHANNELS && rc == EOK; c++) {
+        /* get the channel */
+        if (Scan_GetChannel(c, &frequency, &level, &snr) != EOK)
+            break;
+        /* not occupied */
+        if (snr < SCAN_THRESHOLD)
+            continue;
+        /* render the response */
+        res_len = snprintf(res, sizeof(res),
+            "+RADIO_SCAN_TABLE: %.0f,%.1f,%.1f" AT_LINE_END, frequency,
+            level, snr);
+        /* send it */
+        rc = ATCmd_SendResponse(iface, res, res_len);
+    }
+
+	/* report status */
+	return rc;
+}
+
 /* radio command list */
 const at_cmd_t at_cmd_radio_list[] = {
     /* tuning */
     { .cmd = "AT+RADIO_TUNE=", .func = ATCmdRadio_ProcFrequencySet },
     { .cmd = "AT+RADIO_TUNE?", .func = ATCmdRadio_ProcFrequencyRead },
+    /* demodulation mode */
+    { .cmd = "AT+RADIO_MODE=", .func = ATCmdRadio_ProcModeSet },
+    { .cmd = "AT+RADIO_MODE?", .func = ATCmdRadio_ProcModeRead },
+    /* cw beat frequency oscillator */
+    { .cmd = "AT+RADIO_BFO=", .func = ATCmdRadio_ProcBFOSet },
+    { .cmd = "AT+RADIO_BFO?", .func = ATCmdRadio_ProcBFORead },
+    /* automatic gain control */
+    { .cmd = "AT+RADIO_AGC=", .func = ATCmdRadio_ProcAGCSet },
+    { .cmd = "AT+RADIO_AGC?", .func = ATCmdRadio_ProcAGCRead },
+    /* noise blanker */
+    { .cmd = "AT+RADIO_NB=", .func = ATCmdRadio_ProcNBSet },
+    { .cmd = "AT+RADIO_NB?", .func = ATCmdRadio_ProcNBRead },
+    /* adaptive notch */
+    { .cmd = "AT+RADIO_NOTCH=", .func = ATCmdRadio_ProcNotchSet },
+    { .cmd = "AT+RADIO_NOTCH?", .func = ATCmdRadio_ProcNotchRead },
+    /* iq stream sampling rate */
+    { .cmd = "AT+RADIO_IQRATE=", .func = ATCmdRadio_ProcIQRateSet },
+    { .cmd = "AT+RADIO_IQRATE?", .func = ATCmdRadio_ProcIQRateRead },
+    /* raw rf capture */
+    { .cmd = "AT+RADIO_RFCAP=", .func = ATCmdRadio_ProcRFCapSet },
+    { .cmd = "AT+RADIO_RFCAP?", .func = ATCmdRadio_ProcRFCapRead },
+    /* iq notification format */
+    { .cmd = "AT+RADIO_IQFMT=", .func = ATCmdRadio_ProcIQFormatSet },
+    { .cmd = "AT+RADIO_IQFMT?", .func = ATCmdRadio_ProcIQFormatRead },
+    /* signal meter and squelch */
+    { .cmd = "AT+RADIO_RSSI?", .func = ATCmdRadio_ProcRSSIRead },
+    { .cmd = "AT+RADIO_SQUELCH=", .func = ATCmdRadio_ProcSquelchSet },
+    { .cmd = "AT+RADIO_SQUELCH?", .func = ATCmdRadio_ProcSquelchRead },
+    /* carrier tracking */
+    { .cmd = "AT+RADIO_CARRIER?", .func = ATCmdRadio_ProcCarrierRead },
+    /* wideband scan */
+    { .cmd = "AT+RADIO_SCAN=", .func = ATCmdRadio_ProcScanSet },
+    { .cmd = "AT+RADIO_SCAN?", .func = ATCmdRadio_ProcScanRead },
+    { .cmd = "AT+RADIO_SCAN_TABLE?", .func = ATCmdRadio_ProcScanTableRead },
+    /* spectrum engine */
+    { .cmd = "AT+RADIO_SPECTRUM=", .func = ATCmdRadio_ProcSpectrumSet },
+    { .cmd = "AT+RADIO_SPECTRUM?", .func = ATCmdRadio_ProcSpectrumRead },
+    /* profiling */
+    { .cmd = "AT+RADIO_PROF=", .func = ATCmdRadio_ProcProfileSet },
+    { .cmd = "AT+RADIO_PROF?", .func = ATCmdRadio_ProcProfileRead },
 
     /* end of the command list */
     { .cmd = 0 },
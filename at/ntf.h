@@ -21,6 +21,12 @@
 #define AT_NTF_MASK_DEBUG                               (0x00000001)
 /** @brief radio iq samples */
 #define AT_NTF_MASK_RADIO_IQ                            (0x00000002)
+/** @brief radio processing stage profiling statistics */
+#define AT_NTF_MASK_RADIO_PROF                          (0x00000004)
+/** @brief radio spectrum lines */
+#define AT_NTF_MASK_RADIO_SPECTRUM                      (0x00000008)
+/** @brief radio signal meter */
+#define AT_NTF_MASK_RADIO_RSSI                          (0x00000010)
 /** @} */
 /** @} */
 
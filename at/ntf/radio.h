@@ -10,6 +10,15 @@
 #ifndef AT_NTF_RADIO_H
 #define AT_NTF_RADIO_H
 
+#include "radio/iqframe.h"
+
+/* iq notification formats: base64 encoded floats within the text lines, 
+ * binary frames with 16 or 8-bit block floating point samples */
+#define AT_NTF_RADIO_IQFMT_TEXT                         0
+#define AT_NTF_RADIO_IQFMT_S16                          IQFRAME_FMT_S16
+#define AT_NTF_RADIO_IQFMT_S8                           IQFRAME_FMT_S8
+/* number of the formats */
+#define AT_NTF_RADIO_IQFMT_NUM                          3
 
 /* initialize radio notifications submodule */
 int ATNtfRadio_Init(void);
@@ -17,5 +26,9 @@ int ATNtfRadio_Init(void);
 void ATNtfRadio_Poll(void);
 /* store the iq data samples in at notifications buffer */
 int ATNtfRadio_PutIQSamples(const float *i, const float *q, int num);
+/* set the iq notification format for given interface */
+int ATNtfRadio_SetIQFormat(int iface, int fmt);
+/* get the iq notification format for given interface */
+int ATNtfRadio_GetIQFormat(int iface, int *fmt);
 
 #endif /* AT_NTF_RADIO_H */
@@ -15,7 +15,14 @@
 #include "err.h"
 #include "at/ntf.h"
 #include "at/rxtx.h"
+#include "at/ntf/radio.h"
 #include "base64/base64.h"
+#include "radio/iqframe.h"
+#include "radio/meter.h"
+#include "radio/radio.h"
+#include "radio/spectrum.h"
+#include "sys/time.h"
+#include "util/stdio.h"
 #include "util/elems.h"
 #include "util/minmax.h"
 #include "util/string.h"
@@ -23,69 +30,346 @@
 /* iqdata buffer */
 static struct iqdata {
     /* samples buffer */
-    struct iqdata_iq { float i, q; } PACKED ALIGNED(8) buf[128];
+    struct iqdata_iq { float i, q; } PACKED ALIGNED(8) 
+        buf[AT_NTF_RADIO_IQ_BUF_SIZE];
     /* pointers */
     uint32_t head, tail;
-} iqdata;
+    /* sampling rate of the stream and the one that was reported */
+    volatile int rate;
+    int rate_reported;
+    /* number of the iq pairs dropped due to the buffer overflow */
+    volatile uint32_t dropped;
+    /* binary frame sequence number */
+    uint16_t seq;
+    /* notification format for every interface */
+    int fmt[ATRXTX_IFACENUM];
+} iqdata = { .rate = BB_SAMPLING_RATE, .rate_reported = BB_SAMPLING_RATE };
 
-/* polling for the iq samples */
+/* iq samples have arrived */
+static int ATNtfRadio_IQDataCallback(void *ptr)
+{
+    /* cast event argument */
+    radio_iqdata_evarg_t *ea = ptr;
+    /* store the samples (overflows are accounted for) */
+    ATNtfRadio_PutIQSamples(ea->i, ea->q, ea->num);
+
+    /* report status */
+    return EOK;
+}
+
+/* iq stream sampling rate has changed */
+static int ATNtfRadio_IQRateCallback(void *ptr)
+{
+    /* cast event argument */
+    radio_iq_evarg_t *ea = ptr;
+    /* polling will report it */
+    iqdata.rate = ea->rate;
+
+    /* report status */
+    return EOK;
+}
+
+/* report the iq stream sampling rate change, samples at the previous rate 
+ * are dropped so that the new ones follow the report */
+static void ATNtfRadio_IQRatePoll(void)
+{
+    /* notification mask */
+    uint32_t mask;
+    /* current rate */
+    int rate = iqdata.rate;
+    /* response buffer */
+    char buf[AT_RES_MAX_LINE_LEN];
+
+    /* nothing has changed */
+    if (rate == iqdata.rate_reported)
+        return;
+    /* drop the samples */
+    iqdata.tail = iqdata.head, iqdata.rate_reported = rate;
+
+    /* render the notification */
+    int len = snprintf(buf, sizeof(buf), "+RADIO_IQRATE: %d" AT_LINE_END, 
+        rate);
+    /* send to all interested parties */
+    for (int iface = 0; iface < ATRXTX_IFACENUM; iface++) {
+        /* get notification mask for given interface */
+        ATNtf_GetNotificationMask(iface, &mask);
+        /* notifications enabled for given interface? */
+        if ((mask & AT_NTF_MASK_RADIO_IQ))
+            ATRxTx_SendResponse(iface, 1, buf, len);
+    }
+}
+
+/* get the maximal number of the iq pairs within the notification of given 
+ * format */
+static int ATNtfRadio_GetIQCapacity(int fmt)
+{
+    /* binary frames */
+    if (fmt != AT_NTF_RADIO_IQFMT_TEXT)
+        return IQFrame_GetMaxSamples(fmt, AT_RES_MAX_LINE_LEN);
+
+    /* get the number data characters that can be put into the response */
+    int max_chars = AT_RES_MAX_LINE_LEN - (sizeof("+RADIO_IQ: ") - 1) - 
+        sizeof(AT_LINE_END);
+    /* convert to maximal number of representable bytes when base64 is used */
+    return (max_chars / 4) * 3 / sizeof(struct iqdata_iq);
+}
+
+/* render the iq notification in given format, returns its length */
+static int ATNtfRadio_RenderIQ(int fmt, const struct iqdata_iq *iq, int num, 
+    char *buf, size_t size)
+{
+    /* binary frame */
+    if (fmt != AT_NTF_RADIO_IQFMT_TEXT)
+        return IQFrame_Encode(fmt, iqdata.seq, iqdata.dropped, 
+            (const float *)iq, num, buf, size);
+
+    /* current len of the response */
+    int len = snprintf(buf, size, "+RADIO_IQ: ");
+    /* encode data in base64 */
+    len += Base64_Encode(iq, sizeof(*iq) * num, buf + len, 
+        size - len - sizeof(AT_LINE_END));
+    /* append the line ending sequence */
+    memcpy(buf + len, AT_LINE_END, sizeof(AT_LINE_END));
+    /* return the length without the string terminator */
+    return len + sizeof(AT_LINE_END) - 1;
+}
+
+/* polling for the iq samples: every notification carries as many samples as 
+ * the interface with the least capacious format can take */
 static void ATNtfRadio_IQSamplesPoll(void)
 {
     /* data sent? */
 	int sent = 0;
     /* response buffer */
-    char buf[AT_RES_MAX_LINE_LEN] = "+RADIO_IQ: ";
-    /* current len of the response */
-    int len = sizeof("+RADIO_IQ: ") - 1;
+    char buf[AT_RES_MAX_LINE_LEN];
+    /* number of iq pairs within the notification */
+    int max_iqs = elems(iqdata.buf);
     
     /* notification mask */
     uint32_t mask;
     /* get mask for all notifications */
     ATNtf_GetNotificationORMask(&mask);
 	/* notification is disabled? */
-	if (!(mask & AT_NTF_MASK_RADIO_IQ))
-		iqdata.tail = iqdata.head;
-    /* no samples are stored */
-    if (iqdata.head - iqdata.tail < 16)
+	if (!(mask & AT_NTF_MASK_RADIO_IQ)) {
+		iqdata.tail = iqdata.head; return;
+    }
+
+    /* get the capacity of the notification */
+    for (int iface = 0; iface < ATRXTX_IFACENUM; iface++) {
+        /* get notification mask for given interface */
+        ATNtf_GetNotificationMask(iface, &mask);
+        /* notifications enabled for given interface? */
+        if ((mask & AT_NTF_MASK_RADIO_IQ))
+            max_iqs = min(max_iqs, 
+                ATNtfRadio_GetIQCapacity(iqdata.fmt[iface]));
+    }
+    /* wait for the complete notification */
+    if (iqdata.head - iqdata.tail < max_iqs)
         return;
 
-    /* get the number data characters that can be put into the response */
-    int max_chars = sizeof(buf) - len - sizeof(AT_LINE_END);
-    /* convert to maximal number of representable bytes when base64 is used */
-    int max_bytes = (max_chars / 4) * 3;
     /* get tail index */
     int t = iqdata.tail % elems(iqdata.buf);
-    /* limit the number of iq pairs to be sent in current line while not 
-     * wrapping within the circular buffer */
-    int max_iqs = min(iqdata.head - iqdata.tail, 
-        min(elems(iqdata.buf) - t, max_bytes / sizeof(struct iqdata_iq)));
+    /* do not wrap within the circular buffer */
+    int num = min(max_iqs, elems(iqdata.buf) - t);
+
+    /* render every format that is in use once */
+    for (int fmt = 0; fmt < AT_NTF_RADIO_IQFMT_NUM; fmt++) {
+        /* length of the rendered notification */
+        int len = -1;
+        /* send response */
+        for (int iface = 0; iface < ATRXTX_IFACENUM; iface++) {
+            /* get notification mask for given interface */
+            ATNtf_GetNotificationMask(iface, &mask);
+            /* notifications enabled for given interface? */
+            if (!(mask & AT_NTF_MASK_RADIO_IQ) || iqdata.fmt[iface] != fmt)
+                continue;
+            /* render the notification */
+            if (len < 0 && (len = ATNtfRadio_RenderIQ(fmt, iqdata.buf + t, 
+                num, buf, sizeof(buf))) < 0)
+                break;
+            /* send the actual data */
+            sent |= ATRxTx_SendResponse(iface, 1, buf, len) == EOK;
+        }
+    }
+
+    /* data was sent, update the buffer */
+    if (sent)
+        iqdata.tail += num, iqdata.seq++;
+}
+
+/* profiling notifications state */
+static struct profdata {
+    /* timestamp of the last report */
+    time_t ts;
+    /* next stage to be reported */
+    int stage;
+} profdata;
+
+/* polling for the profiling statistics: one stage is reported per poll so that 
+ * the transmission buffers do not get flooded */
+static void ATNtfRadio_ProfPoll(void)
+{
+    /* notification mask */
+    uint32_t mask;
+    /* stage statistics */
+    prof_stats_t stats;
+    /* stage name */
+    const char *name;
+    /* response buffer */
+    char buf[AT_RES_MAX_LINE_LEN];
+
+    /* get mask for all notifications */
+    ATNtf_GetNotificationORMask(&mask);
+    /* notification is disabled */
+    if (!(mask & AT_NTF_MASK_RADIO_PROF))
+        return;
+    /* report is not due yet */
+    if (profdata.stage == 0 && 
+        dtime(time(0), profdata.ts) < AT_NTF_RADIO_PROF_INTERVAL)
+        return;
+
+    /* get the statistics */
+    if (Radio_GetProfile(profdata.stage, &name, &stats) != EOK)
+        return;
+    /* render the notification */
+    int len = snprintf(buf, sizeof(buf), "+RADIO_PROF: %s,%u,%u,%u,%u" 
+        AT_LINE_END, name, stats.min, stats.avg, stats.max, stats.p99);
+
+    /* send to all interested parties */
+    for (int iface = 0; iface < ATRXTX_IFACENUM; iface++) {
+        /* get notification mask for given interface */
+        ATNtf_GetNotificationMask(iface, &mask);
+        /* notifications enabled for given interface? */
+        if ((mask & AT_NTF_MASK_RADIO_PROF))
+            ATRxTx_SendResponse(iface, 1, buf, len);
+    }
+
+    /* report started, store the timestamp */
+    if (profdata.stage == 0)
+        profdata.ts = time(0);
+    /* go to the next stage */
+    profdata.stage = (profdata.stage + 1) % RADIO_PROF_NUM;
+}
+
+/* spectrum notifications state */
+static struct spectrumdata {
+    /* line being sent */
+    uint8_t bins[SPECTRUM_SIZE];
+    /* its sequence number */
+    uint32_t seq;
+    /* next bin to be sent */
+    int offset;
+} spectrumdata = { .offset = SPECTRUM_SIZE };
+
+/* polling for the spectrum lines: every line is split into the chunks that fit
+ * within the response line, one chunk is sent per poll */
+static void ATNtfRadio_SpectrumPoll(void)
+{
+    /* notification mask */
+    uint32_t mask, seq;
+    /* data sent? */
+    int sent = 0;
+    /* response buffer */
+    char buf[AT_RES_MAX_LINE_LEN];
+
+    /* get mask for all notifications */
+    ATNtf_GetNotificationORMask(&mask);
+    /* notification is disabled */
+    if (!(mask & AT_NTF_MASK_RADIO_SPECTRUM))
+        return;
+    /* previous line was sent completely: check for the new one */
+    if (spectrumdata.offset == SPECTRUM_SIZE) {
+        /* no new line */
+        if (Spectrum_GetLine(&seq, 0) != EOK || seq == spectrumdata.seq)
+            return;
+        /* fetch it */
+        Spectrum_GetLine(&spectrumdata.seq, spectrumdata.bins);
+        spectrumdata.offset = 0;
+    }
+
+    /* render the header */
+    int len = snprintf(buf, sizeof(buf), "+RADIO_SPECTRUM: %u,%d,",
+        spectrumdata.seq, spectrumdata.offset);
+    /* get the number data characters that can be put into the response */
+    int max_chars = sizeof(buf) - len - sizeof(AT_LINE_END);
+    /* number of bins that fit in base64 */
+    int num = min(SPECTRUM_SIZE - spectrumdata.offset, (max_chars / 4) * 3);
 
     /* encode data in base64 */
-    int b64_len = Base64_Encode(iqdata.buf + t, 
-       sizeof(struct iqdata_iq) * max_iqs, buf + len, max_chars);
+    int b64_len = Base64_Encode(spectrumdata.bins + spectrumdata.offset,
+        num, buf + len, max_chars);
     /* append the line ending sequence */
     memcpy(buf + len + b64_len, AT_LINE_END, sizeof(AT_LINE_END));
 
-    /* send response */
-	for (int iface = 0; iface < ATRXTX_IFACENUM; iface++) {
+    /* send to all interested parties */
+    for (int iface = 0; iface < ATRXTX_IFACENUM; iface++) {
         /* get notification mask for given interface */
         ATNtf_GetNotificationMask(iface, &mask);
-		/* notifications enabled for given interface? */
-		if ((mask & AT_NTF_MASK_RADIO_IQ)) {
-			/* send the actual data */
-			sent |= ATRxTx_SendResponse(iface, 1, buf, len + b64_len + 
+        /* notifications enabled for given interface? */
+        if ((mask & AT_NTF_MASK_RADIO_SPECTRUM))
+            sent |= ATRxTx_SendResponse(iface, 1, buf, len + b64_len +
                 sizeof(AT_LINE_END) - 1) == EOK;
-		}
-	}
+    }
 
-    /* data was sent, update the buffer */
+    /* data was sent, go to the next chunk */
     if (sent)
-        iqdata.tail += max_iqs;
+        spectrumdata.offset += num;
+}
+
+/* timestamp of the last signal meter report */
+static time_t rssi_ts;
+
+/* polling for the signal meter: reported every AT_NTF_RADIO_RSSI_INTERVAL ms
+ * and right away when the squelch changes its state */
+static void ATNtfRadio_RSSIPoll(void)
+{
+    /* notification mask */
+    uint32_t mask;
+    /* measurements, squelch state */
+    float rssi, floor; int open;
+    /* last reported squelch state */
+    static int last_open = -1;
+    /* response buffer */
+    char buf[AT_RES_MAX_LINE_LEN];
+
+    /* get mask for all notifications */
+    ATNtf_GetNotificationORMask(&mask);
+    /* notification is disabled */
+    if (!(mask & AT_NTF_MASK_RADIO_RSSI))
+        return;
+    /* get the measurements */
+    if (Meter_GetLevels(&rssi, &floor) != EOK ||
+        Meter_GetSquelch(0, &open) != EOK)
+        return;
+    /* report is not due yet */
+    if (open == last_open &&
+        dtime(time(0), rssi_ts) < AT_NTF_RADIO_RSSI_INTERVAL)
+        return;
+
+    /* render the notification */
+    int len = snprintf(buf, sizeof(buf), "+RADIO_RSSI: %.1f,%.1f,%.1f,%d"
+        AT_LINE_END, rssi, floor, rssi - floor, open);
+
+    /* send to all interested parties */
+    for (int iface = 0; iface < ATRXTX_IFACENUM; iface++) {
+        /* get notification mask for given interface */
+        ATNtf_GetNotificationMask(iface, &mask);
+        /* notifications enabled for given interface? */
+        if ((mask & AT_NTF_MASK_RADIO_RSSI))
+            ATRxTx_SendResponse(iface, 1, buf, len);
+    }
+
+    /* store the timestamp and the reported state */
+    rssi_ts = time(0), last_open = open;
 }
 
 /* initialize radio notifications submodule */
 int ATNtfRadio_Init(void)
 {
+    /* listen to the iq stream rate changes */
+    Ev_RegisterCallback(&radio_iq_ev, ATNtfRadio_IQRateCallback);
+    /* listen to the iq samples */
+    Ev_RegisterCallback(&radio_iqdata_ev, ATNtfRadio_IQDataCallback);
     /* report status */
     return EOK;
 }
@@ -93,8 +377,15 @@ int ATNtfRadio_Init(void)
 /* poll radio notifications submodule */
 void ATNtfRadio_Poll(void)
 {
-    /* polling for the iq samples */
+    /* polling for the iq stream rate changes and the iq samples */
+    ATNtfRadio_IQRatePoll();
     ATNtfRadio_IQSamplesPoll();
+    /* polling for the profiling statistics */
+    ATNtfRadio_ProfPoll();
+    /* polling for the spectrum lines */
+    ATNtfRadio_SpectrumPoll();
+    /* polling for the signal meter */
+    ATNtfRadio_RSSIPoll();
 }
 
 /* store the iq data samples in at notifications buffer */
@@ -108,9 +399,11 @@ int ATNtfRadio_PutIQSamples(const float *i, const float *q, int num)
 	/* radio data notifications enabled? */
 	if (!(mask & AT_NTF_MASK_RADIO_IQ))
 		return EOK;
-    /* no space in buffer */
-    if (num > elems(iqdata.buf) - (iqdata.head - iqdata.tail))
-        return EFATAL;
+    /* no space in buffer: the receiving party learns about it from the 
+     * counter that goes with the binary frames */
+    if (num > elems(iqdata.buf) - (iqdata.head - iqdata.tail)) {
+        iqdata.dropped += num; return EFATAL;
+    }
     
     /* head element index */
     int h = iqdata.head % elems(iqdata.buf);
@@ -132,4 +425,31 @@ int ATNtfRadio_PutIQSamples(const float *i, const float *q, int num)
     iqdata.head += num;
     /* report status */
 	return EOK;
-}
\ No newline at end of file
+}
+
+/* set the iq notification format for given interface */
+int ATNtfRadio_SetIQFormat(int iface, int fmt)
+{
+    /* sanity check */
+    if (iface < 0 || iface >= ATRXTX_IFACENUM || fmt < 0 || 
+        fmt >= AT_NTF_RADIO_IQFMT_NUM)
+        return EFATAL;
+
+    /* store the format */
+    iqdata.fmt[iface] = fmt;
+    /* report status */
+    return EOK;
+}
+
+/* get the iq notification format for given interface */
+int ATNtfRadio_GetIQFormat(int iface, int *fmt)
+{
+    /* sanity check */
+    if (iface < 0 || iface >= ATRXTX_IFACENUM)
+        return EFATAL;
+
+    /* get the format */
+    *fmt = iqdata.fmt[iface];
+    /* report status */
+    return EOK;
+}
@@ -0,0 +1,46 @@
+/**
+ * @file cobs.h
+ * 
+ * @date 2026-10-17
+ * @author twatorowski 
+ * 
+ * @brief Consistent Overhead Byte Stuffing: encoded data carries no zero 
+ * bytes (so that zeros can delimit the frames) at the cost of at most one 
+ * byte per every 254 bytes of the input (plus one).
+ */
+
+#ifndef COBS_COBS_H_
+#define COBS_COBS_H_
+
+#include <stddef.h>
+
+/** @brief size of the encoded data (worst case) for given input size */
+#define COBS_ENCODED_SIZE(size)                         \
+    ((size) + (size) / 254 + 1)
+
+/**
+ * @brief Encode the data with COBS. Output must not overlap the input.
+ * 
+ * @param in input data pointer
+ * @param in_size size of the input data
+ * @param out output data pointer
+ * @param out_size maximal size of the output buffer
+ * 
+ * @return int actual encoded data size, EFATAL if it does not fit
+ */
+int COBS_Encode(const void *in, size_t in_size, void *out, size_t out_size);
+
+/**
+ * @brief Decode the COBS encoded data (with no delimiters). Can work in-situ.
+ * 
+ * @param in pointer to COBS encoded data
+ * @param in_size size of the input data
+ * @param out output data pointer
+ * @param out_size maximal size of the output buffer
+ * 
+ * @return int decoded data size, EFATAL if the input is malformed (zero 
+ * bytes, codes that point past the end) or if it does not fit
+ */
+int COBS_Decode(const void *in, size_t in_size, void *out, size_t out_size);
+
+#endif /* COBS_COBS_H_ */
@@ -0,0 +1,93 @@
+/**
+ * @file cobs.c
+ * 
+ * @date 2026-10-17
+ * @author twatorowski 
+ * 
+ * @brief Consistent Overhead Byte Stuffing. Every zero byte of the input is 
+ * replaced by the code byte that tells how far the next one is (the input is 
+ * taken as if it was followed by the zero), the runs of 254 non-zero bytes 
+ * get the code byte (0xff) that is not followed by the zero.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "compiler.h"
+#include "err.h"
+
+/* encode with cobs */
+int OPTIMIZE("O2") COBS_Encode(const void *in, size_t in_size, void *out, 
+    size_t out_size)
+{
+    /* pointers */
+    const uint8_t *inp = in, *end = inp + in_size; 
+    uint8_t *outp = out, *out_end = outp + out_size;
+    /* position of the code byte of the current run, run length (with the 
+     * code byte) */
+    uint8_t *code = outp++; uint8_t len = 1;
+
+    /* sanity check for the output size */
+    if (!out_size)
+        return EFATAL;
+
+    /* process all bytes */
+    for (; inp != end; inp++) {
+        /* zero ends the run */
+        if (*inp == 0) {
+            *code = len, code = outp++, len = 1;
+        /* non-zero bytes get copied */
+        } else {
+            /* no room */
+            if (outp == out_end)
+                return EFATAL;
+            *outp++ = *inp, len++;
+            /* maximal run length reached (unless it was the last byte) */
+            if (len == 0xff && inp + 1 != end)
+                *code = len, code = outp++, len = 1;
+        }
+        /* no room for the next code byte */
+        if (outp > out_end)
+            return EFATAL;
+    }
+    /* close the last run */
+    *code = len;
+
+    /* return the number of bytes written */
+    return outp - (uint8_t *)out;
+}
+
+/* decode cobs data */
+int OPTIMIZE("O2") COBS_Decode(const void *in, size_t in_size, void *out, 
+    size_t out_size)
+{
+    /* pointers */
+    const uint8_t *inp = in, *end = inp + in_size;
+    uint8_t *outp = out, *out_end = outp + out_size;
+
+    /* process all runs */
+    while (inp != end) {
+        /* run length */
+        uint8_t len = *inp++;
+        /* zeros do not belong here, run must end within the data */
+        if (!len || len - 1 > end - inp || len - 1 > out_end - outp)
+            return EFATAL;
+        /* copy the run (in-situ safe: the output never overtakes the 
+         * input) */
+        for (uint8_t k = 1; k < len; k++) {
+            if (!*inp)
+                return EFATAL;
+            *outp++ = *inp++;
+        }
+        /* the zero that followed the run (but not after the last one and not 
+         * after the maximal ones) */
+        if (len != 0xff && inp != end) {
+            if (outp == out_end)
+                return EFATAL;
+            *outp++ = 0;
+        }
+    }
+
+	/* report the number of bytes */
+	return outp - (uint8_t *)out;
+}
@@ -22,6 +22,8 @@
 #define PACKED				__attribute__ ((packed))
 /* alignment */
 #define ALIGNED(x)			__attribute__ ((aligned (x)))
+/* type may be used to access objects of other types */
+#define MAY_ALIAS			__attribute__ ((may_alias))
 /* enfoce function being always inline */
 #define ALWAYS_INLINE		__attribute__ ((always_inline))
 /* variable unused */
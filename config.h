@@ -65,6 +65,16 @@
 #define AT_RES_MAX_LINE_LEN                         256
 /** @brief at command line ending sequence */
 #define AT_LINE_END                                 "\r\n"
+/** @brief interval between the radio profiling notifications [ms] */
+#define AT_NTF_RADIO_PROF_INTERVAL                  1000
+/** @brief interval between the radio signal meter notifications [ms] */
+#define AT_NTF_RADIO_RSSI_INTERVAL                  250
+/** @brief size of the iq notifications buffer [iq pairs] (10ms of the 
+ * widest stream that the serial link can carry) */
+#define AT_NTF_RADIO_IQ_BUF_SIZE                    512
+/** @brief largest binary iq frame (with the delimiters): frames go through 
+ * the same buffers as the response lines do */
+#define IQFRAME_MAX_SIZE                            AT_RES_MAX_LINE_LEN
 /** @} */
 
 /** @name LED configuration */
@@ -119,12 +129,180 @@
 #define RF_SAMPLING_BITS                            12
 /** @} */
 
+/** @name 1st stage mixer */
+/** @{ */
+/** @brief use the packed (dual 16-bit multiply) mixing kernel instead of the 
+ * scalar one */
+#define MIX1_PACKED                                 1
+/** @brief noise blanker threshold: sample pairs this many dB above the 
+ * average are treated as impulses (0 - disabled) */
+#define MIX1_NB_THRESHOLD                           15
+/** @brief number of samples blanked before and after the impulse */
+#define MIX1_NB_PRE                                 2
+#define MIX1_NB_POST                                8
+/** @brief time constant of the average power tracking, expressed as the power 
+ * of 2 of the number of the lut-long blocks */
+#define MIX1_NB_AVG_SHIFT                           6
+/** @} */
+
 /** @name IQ Decimators */
 /** @{ */
-/** @brief decimation rate */
+/** @brief decimation rate that gives the baseband sampling rate (the one 
+ * that the channel path works at), decimators start with it */
 #define DEC_DECIMATION_RATE                         50
+/** @brief lowest decimation rate (the widest iq stream): decimators run at it 
+ * and the baseband is derived with the half-band filter, buffers are sized 
+ * for it */
+#define DEC_MIN_DECIMATION_RATE                     25
 /** maximal input word bit width */
 #define DEC_MAX_INPUT_BITS                          14
+/** @brief use the software decimator (radio/sdec) instead of the DFSDM */
+#define DEC_SOFTWARE                                0
+/** @} */
+
+/** @name IQ stream */
+/** @{ */
+/** @brief highest decimation rate of the iq stream (the narrowest one), rates 
+ * go from DEC_MIN_DECIMATION_RATE up to this one in powers of 2 */
+#define IQ_MAX_DECIMATION_RATE                      200
+/** @} */
+
+/** @name Half-band decimators */
+/** @{ */
+/** @brief number of the filter taps (4k + 3, so that the outermost taps are 
+ * not the zero ones): flat up to 0.2 of the input rate, 75dB of rejection
+ * from 0.3 on */
+#define HBAND_TAPS                                  55
+/** @brief largest number of the filter taps (the history is sized for it) */
+#define HBAND_MAX_TAPS                              HBAND_TAPS
+/** @} */
+
+/** @name Triangular decimators */
+/** @{ */
+/** @brief highest decimation rate (the history is sized for it) */
+#define TRIDEC_MAX_RATE                             8
+/** @} */
+
+/** @name Software IQ Decimators */
+/** @{ */
+/** @brief maximal number of the half-band stages after the cic filter */
+#define SDEC_MAX_HB_STAGES                          2
+/** @brief minimal decimation rate of the cic filter */
+#define SDEC_MIN_CIC_RATE                           4
+/** @brief number of the half-band filter taps (4k + 3) */
+#define SDEC_HB_TAPS                                19
+/** @} */
+
+/** @name Synchronous AM demodulator */
+/** @{ */
+/** @brief natural frequency of the carrier pll in Hz */
+#define DEMODSAM_PLL_FN                             30
+/** @brief maximal carrier offset that is tracked in Hz */
+#define DEMODSAM_MAX_OFFSET                         1000
+/** @} */
+
+/** @name CW demodulator */
+/** @{ */
+/** @brief default beat frequency oscillator pitch in Hz */
+#define DEMODCW_PITCH                               700
+/** @brief run the goertzel detectors that produce the keying envelope */
+#define DEMODCW_GOERTZEL                            1
+/** @} */
+
+/** @name Automatic gain control */
+/** @{ */
+/** @brief audio peak level that the agc aims at (relative to the dac full
+ * scale, at the unity volume) */
+#define AGC_TARGET                                  0.25f
+/** @brief look-ahead (audio delay) in samples */
+#define AGC_LOOKAHEAD                               96
+/** @} */
+
+/** @name Adaptive notch */
+/** @{ */
+/** @brief number of the predictor taps (at the internal rate) */
+#define NOTCH_TAPS                                  64
+/** @brief decorrelation delay of the predictor in samples (at the internal
+ * rate): speech does not correlate over that distance, steady tones do */
+#define NOTCH_DECORRELATION                         24
+/** @brief normalized lms step size: the larger it gets the faster the tones
+ * are found and the more of the speech gets eaten */
+#define NOTCH_MU                                    0.003f
+/** @} */
+
+/** @name Signal meter and squelch */
+/** @{ */
+/** @brief dft size: the decimated band is split into that many bins, the
+ * one at the center is the channel, the ones a quarter of the band away
+ * measure the noise floor */
+#define METER_SIZE                                  16
+/** @brief time constant of the channel power averaging in ms */
+#define METER_TIME                                  50
+/** @brief time constant of the noise floor averaging in ms */
+#define METER_FLOOR_TIME                            500
+/** @brief squelch closes when the snr drops this many dB below the
+ * threshold */
+#define SQUELCH_HYSTERESIS                          3
+/** @brief time that the squelch stays open for after the snr drop in ms */
+#define SQUELCH_HANG                                200
+/** @} */
+
+/** @name Polyphase channelizer */
+/** @{ */
+/** @brief maximal number of channels */
+#define CHAN_MAX_CHANNELS                           256
+/** @brief number of the prototype filter taps per polyphase branch */
+#define CHAN_TAPS_PER_BRANCH                        8
+/** @} */
+
+/** @name Fast Fourier Transform */
+/** @{ */
+/** @brief maximal transform size (twiddle factor tables in flash are
+ * generated for this size) */
+#define FFT_MAX_SIZE                                1024
+/** @} */
+
+/** @name Power spectrum */
+/** @{ */
+/** @brief largest frame size (the window and the transform buffers are sized
+ * for it) */
+#define PSPEC_MAX_SIZE                              256
+/** @} */
+
+/** @name Spectrum engine */
+/** @{ */
+/** @brief number of bins (fft size, no more than PSPEC_MAX_SIZE) */
+#define SPECTRUM_SIZE                               256
+/** @brief default number of spectrum lines per second */
+#define SPECTRUM_RATE                               10
+/** @brief default number of frames averaged within a line */
+#define SPECTRUM_AVERAGE                            4
+/** @brief maximal number of frames averaged within a line */
+#define SPECTRUM_MAX_AVERAGE                        64
+/** @} */
+
+/** @name Wideband scan */
+/** @{ */
+/** @brief fft size (no more than PSPEC_MAX_SIZE, bin spacing needs to divide
+ * the channel width) */
+#define SCAN_SIZE                                   256
+/** @brief channel width (needs to divide the 1st local oscillator band
+ * spacing) */
+#define SCAN_CHANNEL_WIDTH                          3000
+/** @brief maximal number of frames averaged per band */
+#define SCAN_MAX_DWELL                              64
+/** @brief number of the rf frames that get skipped after the re-tuning */
+#define SCAN_SETTLE                                 2
+/** @brief channels that are this many dB above the noise floor are
+ * reported as occupied */
+#define SCAN_THRESHOLD                              10
+/** @} */
+
+/** @name Raw rf capture */
+/** @{ */
+/** @brief number of the rf blocks (halves of the rf buffer) over which the 
+ * sustained throughput is measured */
+#define RFCAP_RATE_BLOCKS                           500
 /** @} */
 
 /** @name Baseband Sampling rate (after the decimation) */
@@ -137,7 +315,27 @@
 /** @{ */
 /** @brief serial audio interface sampling rate */
 #define SAI1_SAMPLING_RATE                          BB_SAMPLING_RATE
-/** */
+/** @brief PLLSAI1 multiplier and divider, the sai clock is 
+ * CPUCLOCK_REF_FREQ * N / P and the frame takes 512 of its periods */
+#define SAI1_PLL_N                                  43
+#define SAI1_PLL_P                                  7
+/** @brief sampling rate that the dac actually gets (no N/P pair gives the 
+ * exact one) */
+#define SAI1_ACTUAL_SAMPLING_RATE                   \
+    (CPUCLOCK_REF_FREQ * (float)SAI1_PLL_N / SAI1_PLL_P / 512)
+/** @} */
+
+/** @name Asynchronous sample rate converter */
+/** @{ */
+/** @brief number of the interpolation filter taps */
+#define ASRC_TAPS                                   16
+/** @brief number of the interpolation filter phases (the ones in between 
+ * are interpolated linearly) */
+#define ASRC_PHASES                                 32
+/** @brief maximal deviation from the nominal ratio in ppm */
+#define ASRC_MAX_PPM                                1000
+/** @brief time constant of the fill level servo in ms */
+#define ASRC_SERVO_TIME                             500
 /** @} */
 
 /** @name USB module */
@@ -152,28 +350,40 @@
 #define USB_VCP_TX_SIZE                             32
 /** @brief reception packet size (must be a power of 2) */
 #define USB_VCP_RX_SIZE                             32
-/** @brief usb audio sampling rate */
+/** @brief rf capture bulk endpoint packet size (full speed maximum) */
+#define USB_RFCAP_TX_SIZE                           64
+/** @brief usb audio (iq) sampling rate: the one that the adc clock and the 
+ * decimation give, reported by the clock source entity */
 #define USB_AUDIO_SRC_SAMPLING_RATE                 BB_SAMPLING_RATE
 /** @brief usb audio frame rate */
 #define USB_AUDIO_SRC_FRAME_RATE                    1000
-/** @brief usb audio sampling rate */
-#define USB_AUDIO_SRC_SAMPLES_PER_FRAME             \
-    (USB_AUDIO_SRC_SAMPLING_RATE / USB_AUDIO_SRC_FRAME_RATE)
-/** @brief usb audio: bits per sample (8, 16, 24, 32) */
-#define USB_AUDIO_SRC_BITS_PER_SAMPLE               32
-/** @brief usb audio frame size: mono mode */
-#define USB_AUDIO_SRC_MONO_SIZE                     \
-    (1 * USB_AUDIO_SRC_SAMPLING_RATE * USB_AUDIO_SRC_BITS_PER_SAMPLE / \
-     USB_AUDIO_SRC_FRAME_RATE / 8)
-/** @brief usb audio frame size: stereo mode */
-#define USB_AUDIO_SRC_STEREO_SIZE                   \
-    (2 * USB_AUDIO_SRC_SAMPLING_RATE * USB_AUDIO_SRC_BITS_PER_SAMPLE / \
-     USB_AUDIO_SRC_FRAME_RATE / 8)
-/** @brief usb audio max transfer size */
-#define USB_AUDIO_SRC_MAX_TFER_SIZE                 512
+/** @brief usb audio: highest sampling rate of the 16-bit format and of the 
+ * 24/32-bit formats (full speed isochronous packet carries up to 1023 
+ * bytes) */
+#define USB_AUDIO_SRC_MAX_RATE_16                   192000
+#define USB_AUDIO_SRC_MAX_RATE_32                   96000
+/** @brief usb audio packet size for given sampling rate and the number of 
+ * bytes per sample: stereo, one sample more than the nominal number for the 
+ * pacing */
+#define USB_AUDIO_SRC_PACKET_SIZE(rate, bytes)      \
+    (((rate) / USB_AUDIO_SRC_FRAME_RATE + 1) * 2 * (bytes))
+/** @brief usb audio max transfer size (largest of all the formats) */
+#define USB_AUDIO_SRC_MAX_TFER_SIZE                 \
+    USB_AUDIO_SRC_PACKET_SIZE(USB_AUDIO_SRC_MAX_RATE_32, 4)
+/** @brief usb audio buffer size in frames (at the highest sampling rate) */
+#define USB_AUDIO_SRC_BUF_FRAMES                    8
+/** @brief usb audio latency: fill level of the buffer that the pacing keeps 
+ * in frames (the radio delivers the samples every 2 frames) */
+#define USB_AUDIO_SRC_LATENCY                       4
+/** @brief usb audio pacing: time constants (in frames) of the fill level 
+ * smoothing and of the fill level servo */
+#define USB_AUDIO_SRC_FILL_TIME                     32
+#define USB_AUDIO_SRC_SERVO_TIME                    500
 /** @brief usb uses common fifo for reception so we need to set it's size to 
- * hold the largest packet possible */
-#define USB_RX_FIFO_SIZE                            512
+ * hold the largest packets possible (control endpoint: two of them with the 
+ * status words, well above the minimum given in the reference manual), the 
+ * rest of the 1.25kB of the fifo memory goes to the in endpoints */
+#define USB_RX_FIFO_SIZE                            192
 /** @} */
 
 
@@ -0,0 +1,37 @@
+/**
+ * @file cyccnt.h
+ * 
+ * @date 2026-10-17
+ * @author twatorowski 
+ * 
+ * @brief CPU cycle counter (DWT CYCCNT). Wraps around every 2^32 cycles 
+ * (~59s @ 72MHz) so differences of up to that are always valid.
+ */
+
+#ifndef DEV_CYCCNT_H_
+#define DEV_CYCCNT_H_
+
+#include <stdint.h>
+
+#include "compiler.h"
+#include "stm32l476/dwt.h"
+
+/**
+ * @brief Initialize and start the cycle counter
+ * 
+ * @return int status (@ref ERR_ERROR_CODES) 
+ */
+int CycCnt_Init(void);
+
+/**
+ * @brief Get the current value of the cycle counter.
+ * 
+ * @return uint32_t number of cpu cycles elapsed 
+ */
+static inline ALWAYS_INLINE uint32_t CycCnt_GetValue(void)
+{
+    /* read the counter register */
+    return DWT->CYCCNT;
+}
+
+#endif /* DEV_CYCCNT_H_ */
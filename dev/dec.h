@@ -22,15 +22,18 @@ extern sem_t dec_sem;
 typedef struct dec_cbarg {
     /**< number of samples */
     int num;
-    /**< downsampled data for the I channel */
-    float *i;
-    /**< downsampled data for the Q channel */
-    float *q; 
+    /**< downsampled data for the I channel (Q31) */
+    int32_t *i;
+    /**< downsampled data for the Q channel (Q31) */
+    int32_t *q; 
 } dec_cbarg_t;
 
-/** @brief decimator interrupt routine */
+/** @brief decimator interrupt routine: I channel transfer complete */
 void Dec_DMA1C4Isr(void);
 
+/** @brief decimator interrupt routine: Q channel transfer complete */
+void Dec_DMA1C5Isr(void);
+
 /**
  * @brief Initialize two decimator channels for I and Q data
  * 
@@ -38,25 +41,38 @@ void Dec_DMA1C4Isr(void);
  */
 int Dec_Init(void);
 
-/* perform filtration and decimation */
+/**
+ * @brief Change the decimation rate. Filters are set up from scratch, so the 
+ * first few samples that follow carry the transient. Must be called with the 
+ * decimator locked (no decimation in progress).
+ * 
+ * @param rate decimation rate, the filter output for the full scale input 
+ * must fit within the 24-bit data register (up to 63, DEC_DECIMATION_RATE is 
+ * the one in use after the initialization)
+ * 
+ * @return int status code (EFATAL for unsupported rate)
+ */
+int Dec_SetDecimationRate(int rate);
 
 /**
  * @brief Perform data filtration & decimation using SINC^3 filter. Decimation 
- * rate is specifier by the #define DEC_DECIMATION_RATE
+ * rate is the one set with Dec_SetDecimationRate() (DEC_DECIMATION_RATE by 
+ * default), the gain follows rate^3 (rate of 25 gives 8 times smaller output 
+ * than the rate of 50). Completion is reported after both of the channels are 
+ * done. Data is delivered in the Q31 format (full scale is from -1 to +1), 
+ * conversion to the floating point is left to the consumer so that it does 
+ * not take place within the interrupt.
  * 
  * @param i input I data (signed numbers 12 bits wide)
  * @param q input Q data (signed numbers 12 bits wide)
  * @param num number of input samples
- * @param i_out normalized (full scale is from -1  to +1) and decimated I 
- *        channel data
- * @param q_out normalized/decimated Q channel data
+ * @param i_out decimated I channel data (Q31)
+ * @param q_out decimated Q channel data (Q31)
  * @param cb callback to be called when the decimation is over
  * 
  * @return dec_cbarg_t * callback argument for sync calls, null for async calls
  */
 dec_cbarg_t * Dec_Decimate(const int16_t *i, const int16_t *q, int num, 
-    float *i_out,  float *q_out, cb_t cb);
-
-
+    int32_t *i_out, int32_t *q_out, cb_t cb);
 
 #endif /* DEV_DEC_H */
@@ -35,5 +35,13 @@ int SAI1A_Init(void);
  */
 void SAI1A_StartStreaming(const int32_t *ptr, int num);
 
+/**
+ * @brief Get the position of the sample that is going to be sent next
+ * 
+ * @return int index within the buffer given to SAI1A_StartStreaming() (0 if 
+ * the streaming is not started)
+ */
+int SAI1A_GetPosition(void);
+
 
 #endif /* DEV_SAI1A_H_ */
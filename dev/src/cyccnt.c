@@ -0,0 +1,33 @@
+/**
+ * @file cyccnt.c
+ * 
+ * @date 2026-10-17
+ * @author twatorowski 
+ * 
+ * @brief CPU cycle counter (DWT CYCCNT).
+ */
+
+#include "err.h"
+#include "dev/cyccnt.h"
+#include "stm32l476/coredebug.h"
+#include "stm32l476/dwt.h"
+#include "sys/critical.h"
+
+/* initialize the cycle counter */
+int CycCnt_Init(void)
+{
+    /* enter critical section */
+    Critical_Enter();
+
+    /* enable the trace and debug blocks (dwt included) */
+    COREDEBUG->DEMCR |= COREDEBUG_DEMCR_TRCENA;
+    /* reset the counter */
+    DWT->CYCCNT = 0;
+    /* start counting */
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA;
+
+    /* exit critical section */
+    Critical_Exit();
+    /* report status */
+    return EOK;
+}
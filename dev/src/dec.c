@@ -8,9 +8,9 @@
  */
 
 #include "assert.h"
+#include "config.h"
 #include "err.h"
 #include "dev/dec.h"
-#include "dsp/float_fixp.h"
 #include "stm32l476/rcc.h"
 #include "stm32l476/dfsdm.h"
 #include "stm32l476/dma.h"
@@ -31,31 +31,21 @@ sem_t dec_sem;
 static volatile cb_t callback;
 /* callback argument */
 static dec_cbarg_t callback_arg;
-/* buffer pointer */
-static union {int32_t *i32; float *fl; } samples_i, samples_q;
-/* number of processed samples */
-static int samples_num;
-
-/* decimation dma interrupt */
-void OPTIMIZE("O0") Dec_DMA1C4Isr(void)
+/* number of channels that have completed the transfer */
+static int channels_done;
+/* decimation rate in use */
+static int rate = DEC_DECIMATION_RATE;
+
+/* called when the channel has completed the transfer, calls the callback 
+ * after both channels are done */
+static void Dec_ChannelComplete(void)
 {
-    /* synchronize both channels */
-    while ((DMA1->ISR & (DMA_ISR_TCIF4 | DMA_ISR_TCIF5)) != 
-        (DMA_ISR_TCIF4 | DMA_ISR_TCIF5));
-    /* clear flags */
-    DMA1->IFCR = DMA_ISR_TCIF4 | DMA_ISR_TCIF5;
-
-    /* disable the interrupt */
-	NVIC_DISABLEINT(STM32_INT_DMA1C4);
-
-    /* convert fixed point notation to floating point */
-    FloatFixp_Fixp32ToFloat(samples_i.i32, samples_num, 31, samples_i.fl);
-    FloatFixp_Fixp32ToFloat(samples_q.i32, samples_num, 31, samples_q.fl);
-
-    /* set-up the callback argument */
-    callback_arg.num = samples_num;
-    /* store data pointers */
-    callback_arg.i = samples_i.fl, callback_arg.q = samples_q.fl;
+    /* both dma interrupts have the same priority so they cannot preempt each
+     * other, no need for the atomic operations here */
+    if (++channels_done < 2)
+        return;
+    /* reset the counter */
+    channels_done = 0;
 
 	/* sync call */
 	if (callback == CB_SYNC) {
@@ -66,6 +56,85 @@ void OPTIMIZE("O0") Dec_DMA1C4Isr(void)
 	}
 }
 
+/* decimation dma interrupt: I channel */
+void Dec_DMA1C4Isr(void)
+{
+    /* clear flag */
+    DMA1->IFCR = DMA_ISR_TCIF4;
+    /* disable the interrupt */
+	NVIC_DISABLEINT(STM32_INT_DMA1C4);
+    /* account the channel */
+    Dec_ChannelComplete();
+}
+
+/* decimation dma interrupt: Q channel */
+void Dec_DMA1C5Isr(void)
+{
+    /* clear flag */
+    DMA1->IFCR = DMA_ISR_TCIF5;
+    /* disable the interrupt */
+	NVIC_DISABLEINT(STM32_INT_DMA1C5);
+    /* account the channel */
+    Dec_ChannelComplete();
+}
+
+/* check if the decimation rate is supported: the sinc^3 output of the full
+ * scale input (gain of rate^3) has to fit within the 24-bit data register
+ * after the fixed right shift of 8 bits */
+static int Dec_CheckRate(int r)
+{
+    /* sinc^3 output for the full scale input after the shift */
+    int64_t peak = (int64_t)r * r * r << (DEC_MAX_INPUT_BITS - 1 - 8);
+    /* does it fit? */
+    return r > 0 && peak <= 0x7fffff ? EOK : EFATAL;
+}
+
+/* (re)configure the filters for the current rate and start them */
+static void Dec_StartFilters(void)
+{
+	/* 0th Filter: mapped to channel 0 (I samples), decimation by 50 (by
+	 * default), sinc^3 filter, bit growth = N*log2(R) = 3 * log2(50) ~= 17,
+	 * output data width = input data width + bit growth = 14b + 17b = 31b,
+	 * but since the output register can only handle 24 bit data we need to
+	 * shift by 8 (done in input channel configuration) */
+	/* disable block */
+	DFSDMF0->CR1 &= ~DFSDM_CR1_DFEN;
+	/* enable fast conversion, enable dma requests  */
+	DFSDMF0->CR1 = DFSDM_CR1_FAST | DFSDM_CR1_RDMAEN;
+	/* sinc^3 filter, decimation rate, no integration */
+	DFSDMF0->FCR = DFSDM_FCR_FORD_1 | DFSDM_FCR_FORD_0 |
+        (rate - 1) << LSB(DFSDM_FCR_FOSR) | 
+        0 << LSB(DFSDM_FCR_IOSR);
+	/* select regular channel 0, continuous conversion */
+	DFSDMF0->CR1 |= DFSDM_CR1_RCONT | 0 << LSB(DFSDM_CR1_RCH);
+	/* enable filtering */
+	DFSDMF0->CR1 |= DFSDM_CR1_DFEN;
+
+	/* 1st Filter: mapped to channel 1 (Q samples), same as the 0th one */
+	/* disable block */
+	DFSDMF1->CR1 &= ~DFSDM_CR1_DFEN;
+	/* enable fast conversion, enable dma requests  */
+	DFSDMF1->CR1 = DFSDM_CR1_FAST | DFSDM_CR1_RDMAEN;
+	/* sinc^3 filter, decimation rate, no integration */
+	DFSDMF1->FCR = DFSDM_FCR_FORD_1 | DFSDM_FCR_FORD_0  | 
+        (rate - 1) << LSB(DFSDM_FCR_FOSR) |
+        0 << LSB(DFSDM_FCR_IOSR);
+	/* select regular channel 0, continuous conversion */
+	DFSDMF1->CR1 |= DFSDM_CR1_RCONT | 1 << LSB(DFSDM_CR1_RCH);
+	/* enable filtering */
+	DFSDMF1->CR1 |= DFSDM_CR1_DFEN;
+
+	/* start filter operation */
+	DFSDMF0->CR1 |= DFSDM_CR1_RSWSTART;
+    DFSDMF1->CR1 |= DFSDM_CR1_RSWSTART;
+	/* initialize filter, this needs to be done because filter is not willing to
+	 * output any data before it's integrators and combs are filled (decimation
+	 * factor * filter order samples are needed) */
+	for (int i = 0; i < rate * 50; i++) {
+		DFSDMC1->CHDATINR = 0; DFSDMC0->CHDATINR = 0; 
+    }
+}
+
 /* initialize decimator for in-phase channel */
 int Dec_Init(void)
 {
@@ -105,12 +174,12 @@ int Dec_Init(void)
 	/* set source register */
 	DMA1C5->CPAR = (uint32_t)&DFSDMF1->RDATAR;
 
-	/* set interrupt priority */
+	/* set interrupt priorities (must be equal, see Dec_ChannelComplete()) */
 	NVIC_SETINTPRI(STM32_INT_DMA1C4, INT_PRI_DEC);
+	NVIC_SETINTPRI(STM32_INT_DMA1C5, INT_PRI_DEC);
 
-    /* this is prepared for only one decimation rate */
-    assert(DEC_DECIMATION_RATE == 50, "unsupported decimation factor",
-        DEC_DECIMATION_RATE);
+    /* default rate must be supported */
+    assert(Dec_CheckRate(rate) == EOK, "unsupported decimation factor", rate);
 
 	/* enable interface */
 	DFSDMC0->CHCFGR1 |= DFSDM_CHCFGR1_DFSDMEN;
@@ -131,55 +200,8 @@ int Dec_Init(void)
 	/* enable channel */
 	DFSDMC1->CHCFGR1 |= DFSDM_CHCFGR1_CHEN;
 
-	/* 0th Filter: mapped to channel 0 (I samples), decimation by 50, sinc^4
-	 * filter, bit growth = N*log2(R) = 3 * log2(50) ~= 18, output data width =
-	 * input data width + bit growth = 14b + 18b = 32b, but since the output
-	 * register can only handle 24 bit data we need to shift by 6 (done in
-	 * input channel configuration) */
-	/* disable block */
-	DFSDMF0->CR1 &= ~DFSDM_CR1_DFEN;
-	/* enable fast conversion, enable dma requests  */
-	DFSDMF0->CR1 = DFSDM_CR1_FAST | DFSDM_CR1_RDMAEN;
-	/* sinc^3 filter, decimation by 50, no integration */
-	DFSDMF0->FCR = DFSDM_FCR_FORD_1 | DFSDM_FCR_FORD_0 |
-        (DEC_DECIMATION_RATE - 1) << LSB(DFSDM_FCR_FOSR) | 
-        0 << LSB(DFSDM_FCR_IOSR);
-	/* select regular channel 0, continuous conversion */
-	DFSDMF0->CR1 |= DFSDM_CR1_RCONT | 0 << LSB(DFSDM_CR1_RCH);
-	/* enable filtering */
-	DFSDMF0->CR1 |= DFSDM_CR1_DFEN;
-
-	/* 1st Filter: mapped to channel 1 (Q samples), decimation by 50, sinc^3
-	 * filter, bit growth = N*log2(R) = 3 * log2(50) ~= 18, output data width =
-	 * input data width + bit growth = 14b + 18b = 32b, but since the output
-	 * register can only handle 24 bit data we need to shift by 8 (done in
-	 * input channel configuration) */
-	/* disable block */
-	DFSDMF1->CR1 &= ~DFSDM_CR1_DFEN;
-	/* enable fast conversion, enable dma requests  */
-	DFSDMF1->CR1 = DFSDM_CR1_FAST | DFSDM_CR1_RDMAEN;
-	/* sinc^3 filter, decimation by 50, no integration */
-	DFSDMF1->FCR = DFSDM_FCR_FORD_1 | DFSDM_FCR_FORD_0  | 
-        (DEC_DECIMATION_RATE - 1) << LSB(DFSDM_FCR_FOSR) |
-        0 << LSB(DFSDM_FCR_IOSR);
-	/* select regular channel 0, continuous conversion */
-	DFSDMF1->CR1 |= DFSDM_CR1_RCONT | 1 << LSB(DFSDM_CR1_RCH);
-	/* enable filtering */
-	DFSDMF1->CR1 |= DFSDM_CR1_DFEN;
-
-	/* start filter operation */
-	DFSDMF0->CR1 |= DFSDM_CR1_RSWSTART;
-    DFSDMF1->CR1 |= DFSDM_CR1_RSWSTART;
-	/* initialize filter, this needs to be done because filter is not willing to
-	 * output any data before it's integrators and combs are filled (decimation
-	 * factor * filter order samples are needed) */
-	for (int i = 0; i < DEC_DECIMATION_RATE *50; i++) {
-		DFSDMC1->CHDATINR = 0; DFSDMC0->CHDATINR = 0; 
-    }
-
-    /* sanity check */
-    assert(sizeof(int32_t) == sizeof(float), 
-        "int32_t must have the same size as the float for this code to work", 0);
+	/* set up the filters */
+	Dec_StartFilters();
 
 	/* exit critical section */
 	Critical_Exit();
@@ -191,25 +213,54 @@ int Dec_Init(void)
 	return EOK;
 }
 
+/* change the decimation rate */
+int Dec_SetDecimationRate(int r)
+{
+    /* sanity check */
+    if (Dec_CheckRate(r) != EOK)
+        return EFATAL;
+    /* nothing to do */
+    if (r == rate)
+        return EOK;
+
+    /* store the rate */
+    rate = r;
+    /* filters need to be set up from scratch */
+    Critical_Enter();
+    Dec_StartFilters();
+    Critical_Exit();
+
+    /* report status */
+    return EOK;
+}
+
 /* perform filtration and decimation */
 dec_cbarg_t * Dec_Decimate(const int16_t *i, const int16_t *q, int num, 
-    float *i_out,  float *q_out, cb_t cb)
+    int32_t *i_out, int32_t *q_out, cb_t cb)
 {
     /* call is synchronous? */
     int sync = cb == CB_SYNC;
 
-	/* store callback */
-	callback = cb;
-	/* store output buffer size and pointer */
-	samples_num = num / DEC_DECIMATION_RATE;
-    /* store the output buffer pointers */
-    samples_i.fl = i_out, samples_q.fl = q_out;
+    /* number of output samples */
+    int samples_num = num / rate;
 
     /* sanity check for the number of samples */
-    assert(samples_num * DEC_DECIMATION_RATE == num, 
+    assert(samples_num * rate == num, 
         "number of samples is not divisible by the decimation factor", 
         num);
 
+	/* store callback */
+	callback = cb;
+    /* no channel has completed the transfer yet */
+    channels_done = 0;
+    /* drop any stale completion flags */
+    DMA1->IFCR = DMA_ISR_TCIF4 | DMA_ISR_TCIF5;
+	NVIC_CLEARPENDING(STM32_INT_DMA1C4);
+	NVIC_CLEARPENDING(STM32_INT_DMA1C5);
+    /* set-up the callback argument */
+    callback_arg.num = samples_num;
+    callback_arg.i = i_out, callback_arg.q = q_out;
+
 	/* prepare output dma for I samples */
 	DMA1C4->CCR &= ~DMA_CCR_EN;
 	/* set data destination pointer */
@@ -246,8 +297,9 @@ dec_cbarg_t * Dec_Decimate(const int16_t *i, const int16_t *q, int num,
 	/* enable dma */
 	DMA2C2->CCR |= DMA_CCR_EN;
 
-    /* enable the interrupt */
+    /* enable the interrupts */
 	NVIC_ENABLEINT(STM32_INT_DMA1C4);
+	NVIC_ENABLEINT(STM32_INT_DMA1C5);
 
 	/* sync call was made? */
 	while (sync && callback == CB_SYNC);
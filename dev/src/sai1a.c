@@ -28,6 +28,8 @@
 
 /* sai1a access semaphore */
 sem_t sai1a_sem;
+/* size of the streamed buffer */
+static int buf_num;
 
 /* initialize sai1a interface that feeds the DAC with data */
 int SAI1A_Init(void)
@@ -52,10 +54,13 @@ int SAI1A_Init(void)
     /* sanity check for the clock reference */
     assert(CPUCLOCK_REF_FREQ == 4000000, "unusable reference frequency", 0);
 
+    /* the P divider is either 7 or 17, we use the former */
+    assert(SAI1_PLL_P == 7, "unsupported pll divider", SAI1_PLL_P);
     /* generate SAI1 clock: REF = 4MHz, N = 43, VCO = 4 * 43 = 172MHz,
-     * P = 7 -> pll output = sai clock = VCO/7 ~= 24.5174MHz, 
-     * frame_clock = sai clock / 2 * 256 =  95.982kHz / 2 ~= 48ksps */
-	RCC->PLLSAI1CFGR = 43 << LSB(RCC_PLLSAI1CFGR_PLLSAI1N) | 
+     * P = 7 -> pll output = sai clock = VCO/7 ~= 24.5714MHz, 
+     * frame_clock = sai clock / (2 * 256) ~= 47.991ksps (see 
+     * SAI1_ACTUAL_SAMPLING_RATE) */
+	RCC->PLLSAI1CFGR = SAI1_PLL_N << LSB(RCC_PLLSAI1CFGR_PLLSAI1N) | 
         RCC_PLLSAI1CFGR_PLLSAI1PEN;
 	/* enable pll */
 	RCC->CR |= RCC_CR_PLLSAI1ON;
@@ -115,7 +120,7 @@ void SAI1A_StartStreaming(const int32_t *ptr, int num)
 	/* set memory address */
 	DMA2C1->CMAR = (uint32_t)ptr;
 	/* set buffer size */
-	DMA2C1->CNDTR = num;
+	DMA2C1->CNDTR = buf_num = num;
 	/* enable dma */
 	DMA2C1->CCR |= DMA_CCR_EN;
 
@@ -125,3 +130,16 @@ void SAI1A_StartStreaming(const int32_t *ptr, int num)
 	/* exit critical section */
 	Critical_Exit();
 }
+
+/* get the streaming position */
+int SAI1A_GetPosition(void)
+{
+    /* dma counts the transfers down, starting over at the end of the 
+     * buffer */
+    int left = DMA2C1->CNDTR;
+    /* not streaming */
+    if (!buf_num)
+        return 0;
+    /* position within the buffer */
+    return left ? buf_num - left : 0;
+}
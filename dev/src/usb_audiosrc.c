@@ -7,15 +7,19 @@
  * @brief USB Audio Source
  */
 
+#include "config.h"
 #include "err.h"
 #include "dev/await.h"
 #include "dev/invoke.h"
 #include "dev/usb.h"
 #include "dev/usbcore.h"
 #include "dev/usb_audiosrc.h"
+#include "dev/usb_audiostream.h"
+#include "sys/critical.h"
 #include "sys/time.h"
 #include "util/elems.h"
 #include "util/minmax.h"
+#include "util/string.h"
 
 #define DEBUG
 #include "debug.h"
@@ -25,24 +29,37 @@ ev_t usb_audio_ev;
 
 /* current interface working mode */
 static int mode;
+/* sampling rates offered to the host, the current one */
+static uint32_t rates[USB_AUDIO_SRC_MAX_RATES] = { 
+    USB_AUDIO_SRC_SAMPLING_RATE };
+static int rates_num = 1;
+static uint32_t rate = USB_AUDIO_SRC_SAMPLING_RATE;
+/* buffer for the control requests */
+static uint8_t ctl_buf[2 + 12 * USB_AUDIO_SRC_MAX_RATES];
 
 /* usb sample type */
 typedef struct { int32_t l, r; } usb_buf_elem_t;
 /* data buffer */
-static usb_buf_elem_t buf[USB_AUDIO_SRC_SAMPLES_PER_FRAME * 4];
-/* linear memory space buffer */
-static usb_buf_elem_t buf_lin[USB_AUDIO_SRC_MAX_TFER_SIZE / 
-    sizeof(usb_buf_elem_t)];
+static usb_buf_elem_t buf[USB_AUDIO_SRC_MAX_RATE_16 / 
+    USB_AUDIO_SRC_FRAME_RATE * USB_AUDIO_SRC_BUF_FRAMES];
+/* linear memory space buffer (packed samples) */
+static uint8_t buf_lin[USB_AUDIO_SRC_MAX_TFER_SIZE] 
+    __attribute__((aligned(4)));
 /* head and tail pointers */
 static uint32_t usb_head, usb_tail;
+/* packet pacing */
+static usb_audio_pace_t pace;
 
-/* get samples from the buffer */
-static int USBAudioSrc_GetSamples(usb_buf_elem_t *ptr, int num)
+/* get samples from the buffer, pack them into the format of the current 
+ * mode */
+static int USBAudioSrc_GetSamples(uint8_t *ptr, int num)
 {
     /* space used within buffer, overall number frames to get, tail index */
     uint32_t space_used, frames_to_get, tail;
     /* samples to get before/after the circular buffer wraps */
     uint32_t frames_to_get_bwrap, frames_to_get_awrap;
+    /* bytes per sample: modes follow the sample widths */
+    int bytes = mode + 1;
 
     /* space used */
     space_used = usb_head - usb_tail;
@@ -55,37 +72,110 @@ static int USBAudioSrc_GetSamples(usb_buf_elem_t *ptr, int num)
     frames_to_get_awrap = frames_to_get - frames_to_get_bwrap;
 
     /* read data */
-    for (int i = 0; i < (int)frames_to_get_bwrap; i++, ptr++)
-        ptr->l = buf[tail + i].l, ptr->r = buf[tail + i].r;
-    
+    ptr += USBAudioStream_Pack(&buf[tail].l, frames_to_get_bwrap, bytes, ptr);
     /* read data */
-    for (int i = 0; i < (int)frames_to_get_awrap; i++, ptr++)
-        ptr->l = buf[i].l, ptr->r = buf[i].r;
+    ptr += USBAudioStream_Pack(&buf[0].l, frames_to_get_awrap, bytes, ptr);
     
     /* update the tail pointer */
     usb_tail += frames_to_get;
-    /* return the number of frames fetched from the buffer */
-    return frames_to_get;
+    /* return the number of bytes fetched from the buffer */
+    return frames_to_get * 2 * bytes;
 }
 
 /* data transfer complete callback */
 static int USBAudioSrc_DataCallback(void *arg)
 {   
-    /* space used in buffer */
-    uint32_t space_used = usb_head - usb_tail;
-    /* number of frames to fetch */
-    uint32_t frames_to_get = USB_AUDIO_SRC_SAMPLES_PER_FRAME;
-
-    /* buffer is getting full, use larger transfers */
-    if (space_used > elems(buf) / 2)
-        frames_to_get = elems(buf_lin);
+    /* number of frames to fetch: the nominal number for this usb frame 
+     * corrected by the fill level */
+    int frames_to_get = USBAudioStream_Pace(&pace, usb_head - usb_tail);
 
     /* get samples to the buffer */
-    int frames_fetched = USBAudioSrc_GetSamples(buf_lin, frames_to_get);
+    int size = USBAudioSrc_GetSamples(buf_lin, frames_to_get);
     /* send buffer contents */
-    USB_StartINTransfer(USB_EP1, buf_lin, 
-        frames_fetched * sizeof(usb_buf_elem_t), 
-        USBAudioSrc_DataCallback);
+    USB_StartINTransfer(USB_EP1, buf_lin, size, USBAudioSrc_DataCallback);
+    /* report status */
+    return EOK;
+}
+
+/* (re)start the streaming */
+static void USBAudioSrc_Start(void)
+{
+    /* bytes per sample */
+    int bytes = mode + 1;
+    /* max number of samples per packet, fill level to be kept */
+    int max_num = USB_AUDIO_SRC_PACKET_SIZE(mode == USB_AUDIO_SRC_MODE_S16 ?
+        USB_AUDIO_SRC_MAX_RATE_16 : USB_AUDIO_SRC_MAX_RATE_32, bytes) / 
+        (2 * bytes);
+    int target = rate * USB_AUDIO_SRC_LATENCY / USB_AUDIO_SRC_FRAME_RATE;
+
+    /* rate too high for the format: the packets are truncated */
+    if (USBAudioStream_PaceInit(&pace, rate, target, max_num) != EOK)
+        USBAudioStream_PaceInit(&pace, (max_num - 1) * 
+            USB_AUDIO_SRC_FRAME_RATE, target, max_num);
+    /* start over with the empty buffer */
+    usb_tail = usb_head;
+}
+
+/* clock source requests */
+static int USBAudioSrc_ClockRequest(usbcore_req_evarg_t *a)
+{
+    /* setup frame */
+    usb_setup_t *s = a->setup;
+    /* control selector, attribute */
+    int cs = s->value >> 8, req = s->request;
+
+    /* get requests */
+    if (s->request_type & USB_SETUP_REQTYPE_DIR) {
+        /* current sampling frequency */
+        if (cs == USB_AUDIO_SRC_CS_SAM_FREQ && req == USB_AUDIO_SRC_REQ_CUR) {
+            for (int k = 0; k < 4; k++)
+                ctl_buf[k] = rate >> (8 * k);
+            a->size = 4;
+        /* list of the sampling frequencies */
+        } else if (cs == USB_AUDIO_SRC_CS_SAM_FREQ && 
+            req == USB_AUDIO_SRC_REQ_RANGE) {
+            a->size = USBAudioStream_FreqRange(rates, rates_num, ctl_buf, 
+                sizeof(ctl_buf));
+        /* clock is always valid */
+        } else if (cs == USB_AUDIO_SRC_CS_CLOCK_VALID && 
+            req == USB_AUDIO_SRC_REQ_CUR) {
+            ctl_buf[0] = 1, a->size = 1;
+        /* unsupported */
+        } else {
+            return EFATAL;
+        }
+        /* host gets no more than it has asked for */
+        a->ptr = ctl_buf, a->size = min(a->size, s->length);
+    /* sampling frequency is the only one that can be set */
+    } else if (cs == USB_AUDIO_SRC_CS_SAM_FREQ && req == USB_AUDIO_SRC_REQ_CUR 
+        && s->length == 4) {
+        /* data stage is yet to come */
+        if (!a->ptr) {
+            a->ptr = ctl_buf, a->size = 4;
+        /* got the data */
+        } else {
+            /* requested rate */
+            uint32_t r = ctl_buf[0] | ctl_buf[1] << 8 | ctl_buf[2] << 16 | 
+                (uint32_t)ctl_buf[3] << 24;
+            /* look for it within the offered ones */
+            int k; for (k = 0; k < rates_num && rates[k] != r; k++);
+            /* not supported */
+            if (k == rates_num)
+                return EFATAL;
+            /* rate has changed */
+            if (r != rate) {
+                /* store, restart the pacing */
+                rate = r; USBAudioSrc_Start();
+                /* prepare event argument, notify the producer */
+                usb_audio_evarg_t ea = { .mode = mode, .rate = rate };
+                Ev_Notify(&usb_audio_ev, &ea);
+            }
+        }
+    /* unsupported */
+    } else {
+        return EFATAL;
+    }
+
     /* report status */
     return EOK;
 }
@@ -114,19 +204,28 @@ static int USBAudioSrc_RequestCallback(void *arg)
                 int iface_alt_num = s->value;
                 /* show message */
 				dprintf("inum = %d, alt = %d\n", iface_num, iface_alt_num);
-                /* alternate setting 1: sampling mode */
-                if (!mode && iface_alt_num) {
-                    /* start sending audio */
-                    USBAudioSrc_DataCallback(0);
+                /* not our interface or unknown setting */
+                if (iface_num != 1 || iface_alt_num > USB_AUDIO_SRC_MODE_S32)
+                    break;
+                /* alternate settings 1-3: sampling mode */
+                if (iface_alt_num) {
+                    /* streaming was disabled */
+                    int was_off = !mode;
+                    /* (re)start the pacing with the new format */
+                    mode = iface_alt_num; USBAudioSrc_Start();
+                    /* start sending audio (the transfers go on by 
+                     * themselves once started) */
+                    if (was_off)
+                        USBAudioSrc_DataCallback(0);
                 /* alternate setting 0: disabled mode */
-                } else if (mode && !iface_alt_num) {
+                } else if (mode) {
                     USB_DisableINEndpoint(USB_EP1);
                 }
                 /* update the 'opened' state */
                 mode = iface_alt_num;
 
                 /* prepare event argument */
-                usb_audio_evarg_t ea = { .mode = mode };
+                usb_audio_evarg_t ea = { .mode = mode, .rate = rate };
                 /* generate an event */
                 Ev_Notify(&usb_audio_ev, &ea);
 
@@ -135,6 +234,10 @@ static int USBAudioSrc_RequestCallback(void *arg)
 			} break;   
             }
         }
+    /* class specific requests addressed to the clock source entity */
+    } else if (type == USB_SETUP_REQTYPE_TYPE_CLASS && 
+        s->index == USB_AUDIO_SRC_CLOCK_ID << 8) {
+        a->status = USBAudioSrc_ClockRequest(a);
     }
 
     /* report status callback */
@@ -160,12 +263,12 @@ static int USBAudioSrc_ResetCallback(void *arg)
     mode = USB_AUDIO_SRC_MODE_OFF;
 
     /* prepare event argument */
-    usb_audio_evarg_t ea = { .mode = mode };
+    usb_audio_evarg_t ea = { .mode = mode, .rate = rate };
     /* generate an event */
     Ev_Notify(&usb_audio_ev, &ea);
 
 	/* prepare fifos */
-    /* interrupt transfers */
+    /* isochronous transfers: the whole packet must fit */
 	USB_SetTxFifoSize(USB_EP1, USB_AUDIO_SRC_MAX_TFER_SIZE / 4);
 	/* flush fifos */
 	USB_FlushTxFifo(USB_EP1);
@@ -203,6 +306,41 @@ int USBAudioSrc_Init(void)
 	return EOK;
 }
 
+/* set the sampling rates offered to the host */
+int USBAudioSrc_SetRates(const uint32_t *r, int num)
+{
+    /* sanity check */
+    if (num < 1 || num > USB_AUDIO_SRC_MAX_RATES)
+        return EFATAL;
+
+    /* store the list, first rate is the current one */
+    memcpy(rates, r, num * sizeof(rates[0]));
+    rates_num = num, rate = rates[0];
+
+    /* report status */
+    return EOK;
+}
+
+/* select the current sampling rate */
+int USBAudioSrc_SetRate(uint32_t r)
+{
+    /* look for it within the offered ones */
+    int k; for (k = 0; k < rates_num && rates[k] != r; k++);
+    /* not supported */
+    if (k == rates_num)
+        return EFATAL;
+
+    /* rate has changed: restart the pacing (the data callback uses it) */
+    if (r != rate) {
+        Critical_Enter();
+        rate = r; USBAudioSrc_Start();
+        Critical_Exit();
+    }
+
+    /* report status */
+    return EOK;
+}
+
 /* put samples into the usb buffer */
 int USBAudioSrc_PutSamples(const int32_t *l, const int32_t *r, int num)
 {
@@ -234,4 +372,37 @@ int USBAudioSrc_PutSamples(const int32_t *l, const int32_t *r, int num)
     usb_head += frames_to_store;
     /* return the number of frames stored */
     return frames_to_store;
+}
+
+/* get the space within the buffer for direct writing */
+int USBAudioSrc_AcquireSpace(int num, usb_audio_span_t *span)
+{
+    /* space left, overall number of frames to store, head element index */
+    uint32_t space_left, frames_to_store, head;
+
+    /* space left */
+    space_left = elems(buf) - (usb_head - usb_tail);
+    /* buffer may be getting full */
+    frames_to_store = min(space_left, (unsigned)num);
+    /* get the head pointer */
+    head = usb_head % elems(buf);
+
+    /* part before the buffer wraps */
+    span->ptr[0] = &buf[head].l;
+    span->num[0] = min(frames_to_store, elems(buf) - head);
+    /* part after the buffer wraps */
+    span->ptr[1] = &buf[0].l;
+    span->num[1] = frames_to_store - span->num[0];
+
+    /* return the number of frames that can be stored */
+    return frames_to_store;
+}
+
+/* commit samples written directly to the buffer */
+int USBAudioSrc_CommitSamples(int num)
+{
+    /* update the head pointer */
+    usb_head += num;
+    /* return the number of frames stored */
+    return num;
 }
\ No newline at end of file
@@ -0,0 +1,114 @@
+/**
+ * @file usb_audiostream.c
+ * 
+ * @date 2026-10-17
+ * @author twatorowski 
+ * 
+ * @brief USB Audio Source: hardware independent parts of the streaming. The 
+ * endpoint is asynchronous: the device decides how many samples go into 
+ * every packet, so the host needs no feedback and sees the true adc rate.
+ */
+
+#include <stdint.h>
+
+#include "config.h"
+#include "err.h"
+#include "dev/usb_audiostream.h"
+#include "util/minmax.h"
+
+/* initialize the pacing */
+int USBAudioStream_PaceInit(usb_audio_pace_t *pace, uint32_t rate, 
+    int target, int max_num)
+{
+    /* nominal number of samples per frame (Q16) */
+    uint64_t step = ((uint64_t)rate << 16) / USB_AUDIO_SRC_FRAME_RATE;
+
+    /* there must be the room for an extra sample */
+    if (!rate || (step >> 16) + 1 > (uint64_t)max_num)
+        return EFATAL;
+
+    /* store the settings */
+    pace->step = step, pace->acc = 0;
+    pace->target = target, pace->max_num = max_num;
+    /* wait for the buffer to fill up */
+    pace->fill = 0, pace->started = 0, pace->underruns = 0;
+
+    /* report status */
+    return EOK;
+}
+
+/* get the number of samples for the next packet */
+int USBAudioStream_Pace(usb_audio_pace_t *pace, int fill)
+{
+    /* nothing is sent until the target fill level is reached, this is what 
+     * makes the latency deterministic */
+    if (!pace->started) {
+        /* still filling up */
+        if (fill < pace->target)
+            return 0;
+        /* start with the current level */
+        pace->started = 1, pace->fill = fill;
+    }
+
+    /* fill level changes in steps as the samples are delivered in blocks, 
+     * only its average matters */
+    pace->fill += (fill - pace->fill) * (1.0f / USB_AUDIO_SRC_FILL_TIME);
+    /* trim (Q16): the level above the target means that the adc runs faster 
+     * than the nominal rate (in the usb frame time), limited to a sample per 
+     * frame */
+    float trim = (pace->fill - pace->target) * (65536.0f / 
+        USB_AUDIO_SRC_SERVO_TIME);
+    trim = min(65536.0f, max(-65536.0f, trim));
+
+    /* accumulate, whole samples go to this frame */
+    int32_t acc = (int32_t)(pace->acc + pace->step) + (int32_t)trim;
+    acc = max(0, acc);
+    int num = acc >> 16; pace->acc = acc & 0xffff;
+
+    /* limit to what is available */
+    if (num > fill)
+        num = fill, pace->underruns++;
+    /* return the number of samples */
+    return min(num, pace->max_num);
+}
+
+/* pack the samples */
+int USBAudioStream_Pack(const int32_t *lr, int num, int bytes, uint8_t *out)
+{
+    /* output pointer */
+    uint8_t *o = out;
+
+    /* all the samples */
+    for (int i = 0; i < 2 * num; i++) {
+        /* most significant bytes go last */
+        uint32_t x = lr[i];
+        for (int b = 4 - bytes; b < 4; b++)
+            *o++ = x >> (8 * b);
+    }
+
+    /* return the number of bytes */
+    return o - out;
+}
+
+/* build the sampling frequency range */
+int USBAudioStream_FreqRange(const uint32_t *rates, int num, uint8_t *out, 
+    int size)
+{
+    /* response size */
+    int len = min(size, 2 + 12 * num);
+
+    /* number of subranges */
+    uint8_t hdr[2] = { num, num >> 8 };
+    for (int k = 0; k < min(len, 2); k++)
+        out[k] = hdr[k];
+    /* min, max and the resolution of every subrange */
+    for (int k = 2; k < len; k++) {
+        /* subrange and the byte within it */
+        int r = (k - 2) / 12, b = (k - 2) % 12;
+        /* discrete rates: min = max, resolution is 0 */
+        out[k] = b < 8 ? rates[r] >> (8 * (b % 4)) : 0;
+    }
+
+    /* return the size */
+    return len;
+}
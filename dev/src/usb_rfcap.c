@@ -0,0 +1,121 @@
+/**
+ * @file usb_rfcap.c
+ * 
+ * @date 2026-10-17
+ * @author twatorowski 
+ * 
+ * @brief USB raw rf capture: vendor specific interface with a single bulk in 
+ * endpoint
+ */
+
+#include "config.h"
+#include "err.h"
+#include "dev/invoke.h"
+#include "dev/usb.h"
+#include "dev/usb_rfcap.h"
+#include "sys/critical.h"
+
+/* parts of the transfer: the header and the data */
+static const void *ptrs[2];
+static size_t sizes[2];
+/* part being sent, number of bytes sent so far */
+static int part;
+static size_t sent;
+/* transfer finished callback (set while the transfer is on) */
+static volatile cb_t callback;
+
+/* data sent callback */
+static int USBRFCap_DataCallback(void *arg)
+{
+    /* cast event argument */
+    usb_cbarg_t *ca = arg;
+    /* callback to be called */
+    cb_t cb;
+
+    /* nothing is being sent (reset that came in between the transfers) */
+    if (!callback)
+        return EOK;
+    /* account the bytes */
+    sent += ca->size;
+    /* next non-empty part */
+    for (part++; part < 2 && !sizes[part]; part++);
+    /* still got something to send */
+    if (ca->error == EOK && part < 2) {
+        USB_StartINTransfer(USB_EP4, (void *)ptrs[part], sizes[part], 
+            USBRFCap_DataCallback);
+    /* all done: the callback may start the next transfer right away */
+    } else {
+        usb_cbarg_t arg = { .error = ca->error, .size = sent };
+        cb = callback, callback = 0, cb(&arg);
+    }
+
+    /* report status */
+    return EOK;
+}
+
+/* usb reset callback */
+static int USBRFCap_ResetCallback(void *arg)
+{
+    /* bulk in: a single packet at the time */
+    USB_SetTxFifoSize(USB_EP4, USB_RFCAP_TX_SIZE / 4);
+    /* flush fifo */
+    USB_FlushTxFifo(USB_EP4);
+    /* configure endpoint */
+    USB_ConfigureINEndpoint(USB_EP4, USB_EPTYPE_BULK, USB_RFCAP_TX_SIZE);
+
+    /* the transfer that was on gets finished with an error */
+    static const usb_cbarg_t ca = { .error = EUSB_RESET, .size = 0 };
+    if (callback)
+        Invoke_CallMeElsewhere(USBRFCap_DataCallback, (void *)&ca);
+
+    /* report status */
+    return EOK;
+}
+
+/* usb callback */
+static int USBRFCap_USBCallback(void *arg)
+{
+    /* cast event argument */
+    usb_evarg_t *ea = arg;
+    /* processing according to event type */
+    switch (ea->type) {
+    case USB_EVARG_TYPE_RESET : USBRFCap_ResetCallback(arg); break;
+    }
+
+    /* report status */
+    return EOK;
+}
+
+/* initialize the rf capture endpoint */
+int USBRFCap_Init(void)
+{
+    /* listen to usb reset events */
+    Ev_RegisterCallback(&usb_ev, USBRFCap_USBCallback);
+
+    /* report status */
+    return EOK;
+}
+
+/* send the data */
+int USBRFCap_Send(const void *hdr, size_t hdr_size, const void *ptr, 
+    size_t size, cb_t cb)
+{
+    /* previous transfer is still on */
+    Critical_Enter();
+    if (callback) {
+        Critical_Exit(); return EBUSY;
+    }
+    /* claim the endpoint */
+    callback = cb;
+    Critical_Exit();
+
+    /* store the parts */
+    ptrs[0] = hdr, sizes[0] = hdr_size, ptrs[1] = ptr, sizes[1] = size;
+    /* header goes first */
+    part = 0, sent = 0;
+    USB_StartINTransfer(USB_EP4, (void *)hdr, hdr_size, 
+        USBRFCap_DataCallback);
+
+    /* report status */
+    return EOK;
+}
@@ -403,10 +403,12 @@ static void USBCore_ProcessSetupData(usb_setup_t *s)
 	/* event for class specific requests */
 	usbcore_req_evarg_t arg = {s, EFATAL, ctl_ptr, ctl_size};
 
-	/* resulting data pointer */
-	void *ptr = 0;
+	/* resulting data pointer: the one given during the setup stage when the 
+	 * data out stage has completed, so that the class handlers can tell 
+	 * that the data is there */
+	void *ptr = ctl_ptr;
 	/* resulting data size */
-	size_t size = 0;
+	size_t size = ctl_size;
 
 	/* standard request */
 	if (type == USB_SETUP_REQTYPE_TYPE_STANDARD) {
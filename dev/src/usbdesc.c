@@ -9,16 +9,17 @@
 
 #include "config.h"
 #include "err.h"
+#include "dev/usb_audiosrc.h"
 #include "dev/usbdesc.h"
 #include "util/elems.h"
 
 /* USB Configuration Descriptor */
-static const uint8_t usb_config0_descriptor[217] = {
+static const uint8_t usb_config0_descriptor[301] = {
     /* Configuration Descriptor */
     0x09,                   /* bLength: Configuration Descriptor size */
     0x02,  	                /* bDescriptorType: Configuration */
-    0xD9, 0x00,             /* wTotalLength: no of returned bytes */
-    0x04,                   /* bNumInterfaces: 4 interfaces */
+    0x2D, 0x01,             /* wTotalLength: no of returned bytes */
+    0x05,                   /* bNumInterfaces: 5 interfaces */
     0x01,                   /* bConfigurationValue: Configuration value */
     0x00,                   /* iConfiguration: Index of string descriptor describing
                              * the configuration */
@@ -26,7 +27,7 @@ static const uint8_t usb_config0_descriptor[217] = {
     0x32,                   /* MaxPower 100 mA */
 
     /* 
-     * FIRST FUNCTION: Audio Source 
+     * FIRST FUNCTION: Audio Source (USB Audio Class 2.0)
      */
 
     /* Interface Association Descriptor */
@@ -36,11 +37,11 @@ static const uint8_t usb_config0_descriptor[217] = {
     0x02,                   /* bInterfaceCount */
     0x01,                   /* bFunctionClass: Audio */
     0x00,                   /* bFunctionSubClass */
-    0x00,                   /* bFunctionProtocol */
+    0x20,                   /* bFunctionProtocol: AF_VERSION_02_00 */
     0x02,                   /* iFunction */
 
-       /* INTERFACE 0: AudioControl */
-    /* USB Microphone Standard interface descriptor */
+    /* INTERFACE 0: AudioControl */
+    /* Standard AC Interface Descriptor */
     0x09,      				/* bLength */
     0x04,        			/* bDescriptorType: interface desc. */
     0x00,                   /* bInterfaceNumber */
@@ -48,44 +49,59 @@ static const uint8_t usb_config0_descriptor[217] = {
     0x00,                   /* bNumEndpoints */
     0x01,               	/* bInterfaceClass */
     0x01,          			/* bInterfaceSubClass */
-    0x00,             		/* bInterfaceProtocol */
+    0x20,             		/* bInterfaceProtocol: IP_VERSION_02_00 */
     0x00,                   /* iInterface */
 
-    /* USB Microphone Class-specific AudioControl Interface Descriptor */
+    /* Class-specific AC Interface Header Descriptor */
     0x09,   				/* bLength */
     0x24,      				/* bDescriptorType: audio descriptor type */
     0x01,                 	/* bDescriptorSubtype: audio control header */
-    0x00, 0x01,        		/* bcdADC */
-    0x1E, 0x00,             /* wTotalLength */
-    0x01,                   /* bInCollection */
-    0x01,                   /* baInterfaceNr */
+    0x00, 0x02,        		/* bcdADC: 2.00 */
+    0x06,                   /* bCategory: converter */
+    0x2E, 0x00,             /* wTotalLength */
+    0x00,                   /* bmControls: none */
 
-    /* USB Microphone Input Terminal Descriptor */
-    0x0C,       			/* bLength */
+    /* Clock Source Descriptor */
+    0x08,                   /* bLength */
+    0x24,                   /* bDescriptorType: audio descriptor type */
+    0x0A,                   /* bDescriptorSubtype: clock source */
+    USB_AUDIO_SRC_CLOCK_ID, /* bClockID */
+    0x03,                   /* bmAttributes: internal programmable clock, not 
+                             * synchronized to sof (derived from the adc) */
+    0x07,                   /* bmControls: frequency read/write, validity 
+                             * read only */
+    0x00,                   /* bAssocTerminal */
+    0x00,                   /* iClockSource */
+
+    /* Input Terminal Descriptor */
+    0x11,       			/* bLength */
     0x24,      				/* bDescriptorType: audio descriptor type */
-    0x02,         			/* bDescriptorSubtype: control input terminal */
+    0x02,         			/* bDescriptorSubtype: input terminal */
     0x01,                   /* bTerminalID */
-    0x03, 0x06,             /* wTerminal: microphone */
+    0x10, 0x07,             /* wTerminalType: radio receiver */
     0x00,                   /* bAssocTerminal */
-    0x02,                   /* bNrChannels: 2 (stereo) */
-    0x03, 0x00,             /* wChannelConfig: left front, right front */
+    USB_AUDIO_SRC_CLOCK_ID, /* bCSourceID */
+    0x02,                   /* bNrChannels: 2 (i and q) */
+    0x00, 0x00, 0x00, 0x00, /* bmChannelConfig: no spatial location */
     0x00,                   /* iChannelNames */
+    0x00, 0x00,             /* bmControls: none */
     0x04,                   /* iTerminal */
 
-    /* USB Microphone Output Terminal Descriptor */
-    0x09,                   /* bLength */
+    /* Output Terminal Descriptor */
+    0x0C,                   /* bLength */
     0x24,                   /* bDescriptorType: audio descriptor type */
-    0x03,                   /* bDescriptorSubtype: control output terminal */
+    0x03,                   /* bDescriptorSubtype: output terminal */
     0x02,                   /* bTerminalID */
-    0x01, 0x01,             /* wTerminal: USB Streaming. */
+    0x01, 0x01,             /* wTerminalType: USB Streaming. */
     0x00,                   /* bAssocTerminal: none */
     0x01,                   /* bSourceID: from input terminal */
+    USB_AUDIO_SRC_CLOCK_ID, /* bCSourceID */
+    0x00, 0x00,             /* bmControls: none */
     0x00,                   /* iTerminal */
 
 
     /* INTERFACE 1: AudioStreaming ALT 0 (Disabled Mode) */
-    /* USB Microphone Standard AS Interface Descriptor 
-        * Zero-Bandwidth interface */
+    /* Standard AS Interface Descriptor: Zero-Bandwidth interface */
     0x09,                   /* bLength */
     0x04,                   /* bDescriptorType: interface desc. */
     0x01,                   /* bInterfaceNumber */
@@ -93,11 +109,11 @@ static const uint8_t usb_config0_descriptor[217] = {
     0x00,                   /* bNumEndpoints */
     0x01,                   /* bInterfaceClass : audio */
     0x02,                   /* bInterfaceSubclass: audio streaming */
-    0x00,                   /* bInterfaceProtocol */
+    0x20,                   /* bInterfaceProtocol: IP_VERSION_02_00 */
     0x00,                   /* iInterface */
 
-    /* INTERFACE 1: AudioStreaming ALT 1 (Mono Mode) */
-    /* USB Microphone Standard AS Interface Descriptor */
+    /* INTERFACE 1: AudioStreaming ALT 1 (16-bit Mode) */
+    /* Standard AS Interface Descriptor */
     0x09,                   /* bLength */
     0x04,                   /* bDescriptorType: interface desc. */
     0x01,                   /* bInterfaceNumber */
@@ -105,57 +121,51 @@ static const uint8_t usb_config0_descriptor[217] = {
     0x01,                   /* bNumEndpoints:  1 endpoint */
     0x01,                   /* bInterfaceClass : audio */
     0x02,                   /* bInterfaceSubclass: audio streaming */
-    0x00,                   /* bInterfaceProtocol */
+    0x20,                   /* bInterfaceProtocol: IP_VERSION_02_00 */
     0x00,                   /* iInterface */
 
-    /*  USB Microphone Class-specific AS General Interface Descriptor */
-    0x07,                   /* bLength */
+    /* Class-specific AS General Interface Descriptor */
+    0x10,                   /* bLength */
     0x24,                   /* bDescriptorType: class spec interface desc. */
     0x01,                   /* bDescriptorSubtype: general descriptor */
     0x02,                   /* bTerminalLink: output terminal */
-    0x00,                   /* bDelay:  Interface delay. */
-    0x01, 0x00,             /* wFormatTag: PCM Format */
+    0x00,                   /* bmControls: none */
+    0x01,                   /* bFormatType: type I */
+    0x01, 0x00, 0x00, 0x00, /* bmFormats: PCM */
+    0x02,                   /* bNrChannels: 2 (i and q) */
+    0x00, 0x00, 0x00, 0x00, /* bmChannelConfig: no spatial location */
+    0x00,                   /* iChannelNames */
 
-    /*  USB Microphone Type I Format Type Descriptor */
-    0x0B,                   /* bLength */
+    /* Type I Format Type Descriptor */
+    0x06,                   /* bLength */
     0x24,                   /* bDescriptorType: class spec interface desc. */
     0x02,                   /* bDescriptorSubtype: format type */
-    0x01,                   /* bFormatType */
-    0x01,                   /* bNrChannels: 1 */
-    /* bSubFrameSize: Four bytes per audio subframe. */
-    USB_AUDIO_SRC_BITS_PER_SAMPLE / 8,
-    /* bBitResolution 32 bits per sample. */     
-    USB_AUDIO_SRC_BITS_PER_SAMPLE,          
-    0x01,                   /* bSamFreqType: One frequency supported. */
-    /* sampling frequency */
-    ((USB_AUDIO_SRC_SAMPLING_RATE >>  0) & 0xFF), 
-    ((USB_AUDIO_SRC_SAMPLING_RATE >>  8) & 0xFF), 
-    ((USB_AUDIO_SRC_SAMPLING_RATE >> 16) & 0xFF),
+    0x01,                   /* bFormatType: type I */
+    0x02,                   /* bSubslotSize: 2 bytes per sample */
+    0x10,                   /* bBitResolution: 16 bits */
 
     /* ENDPOINT 1 IN */
-    /*  USB Microphone Standard Endpoint Descriptor */
-    0x09,                   /* bLength */
+    /* Standard Endpoint Descriptor */
+    0x07,                   /* bLength */
     0x05,                   /* bDescriptorType: endpoint desc. */
     0x81,                   /* bEndpointAddress: IN1 */
-    0x0D,                   /* bmAttributes: Isochronous-synchronous */
-    /* wMaxPacketSize: channels * sps * bytes_per_subframe / 1000 */
-    ((USB_AUDIO_SRC_MAX_TFER_SIZE >> 0) & 0xFF), 
-    ((USB_AUDIO_SRC_MAX_TFER_SIZE >> 8) & 0xFF),
+    0x05,                   /* bmAttributes: Isochronous-asynchronous */
+    /* wMaxPacketSize: highest rate of the format, one extra sample */
+    USB_AUDIO_SRC_PACKET_SIZE(USB_AUDIO_SRC_MAX_RATE_16, 2) & 0xFF,
+    USB_AUDIO_SRC_PACKET_SIZE(USB_AUDIO_SRC_MAX_RATE_16, 2) >> 8,
     0x01,                   /* bInterval: One packet per frame. */
-    0x00,                   /* bRefresh */
-    0x00,                   /* bSynchAddress */
 
-    /* USB Microphone Class-specific Isoc. Audio Data Endpoint Descriptor */
-    0x07,                   /* bLength */
+    /* Class-specific Isoc. Audio Data Endpoint Descriptor */
+    0x08,                   /* bLength */
     0x25,                   /* bDescriptorType: class spec. endpoint desc. */
     0x01,                   /* bDescriptorSubtype: general */
     0x00,                   /* bmAttributes: nothing */
+    0x00,                   /* bmControls: none */
     0x00,                   /* bLockDelayUnits */
     0x00, 0x00,             /* wLockDelay */
 
-
-    /* INTERFACE 1: AudioStreaming ALT 2 (Stereo Mode) */
-    /* USB Microphone Standard AS Interface Descriptor */
+    /* INTERFACE 1: AudioStreaming ALT 2 (24-bit Mode) */
+    /* Standard AS Interface Descriptor */
     0x09,                   /* bLength */
     0x04,                   /* bDescriptorType: interface desc. */
     0x01,                   /* bInterfaceNumber */
@@ -163,51 +173,98 @@ static const uint8_t usb_config0_descriptor[217] = {
     0x01,                   /* bNumEndpoints:  1 endpoint */
     0x01,                   /* bInterfaceClass : audio */
     0x02,                   /* bInterfaceSubclass: audio streaming */
-    0x00,                   /* bInterfaceProtocol */
+    0x20,                   /* bInterfaceProtocol: IP_VERSION_02_00 */
     0x00,                   /* iInterface */
 
-    /*  USB Microphone Class-specific AS General Interface Descriptor */
-    0x07,                   /* bLength */
+    /* Class-specific AS General Interface Descriptor */
+    0x10,                   /* bLength */
     0x24,                   /* bDescriptorType: class spec interface desc. */
     0x01,                   /* bDescriptorSubtype: general descriptor */
     0x02,                   /* bTerminalLink: output terminal */
-    0x00,                   /* bDelay:  Interface delay. */
-    0x01, 0x00,             /* wFormatTag: PCM Format */
+    0x00,                   /* bmControls: none */
+    0x01,                   /* bFormatType: type I */
+    0x01, 0x00, 0x00, 0x00, /* bmFormats: PCM */
+    0x02,                   /* bNrChannels: 2 (i and q) */
+    0x00, 0x00, 0x00, 0x00, /* bmChannelConfig: no spatial location */
+    0x00,                   /* iChannelNames */
 
-    /*  USB Microphone Type I Format Type Descriptor */
-    0x0B,                   /* bLength */
+    /* Type I Format Type Descriptor */
+    0x06,                   /* bLength */
     0x24,                   /* bDescriptorType: class spec interface desc. */
     0x02,                   /* bDescriptorSubtype: format type */
-    0x01,                   /* bFormatType */
-    0x02,                   /* bNrChannels: 2 */
-    /* bSubFrameSize: no of bytes per audio subframe. */
-    USB_AUDIO_SRC_BITS_PER_SAMPLE / 8,
-    /* bBitResolution no of bits per sample. */     
-    USB_AUDIO_SRC_BITS_PER_SAMPLE, 
-    0x01,                   /* bSamFreqType: One frequency supported. */
-    /* sampling frequency */
-    ((USB_AUDIO_SRC_SAMPLING_RATE >>  0) & 0xFF), 
-    ((USB_AUDIO_SRC_SAMPLING_RATE >>  8) & 0xFF), 
-    ((USB_AUDIO_SRC_SAMPLING_RATE >> 16) & 0xFF),
+    0x01,                   /* bFormatType: type I */
+    0x03,                   /* bSubslotSize: 3 bytes per sample */
+    0x18,                   /* bBitResolution: 24 bits */
 
     /* ENDPOINT 1 IN */
-    /*  USB Microphone Standard Endpoint Descriptor */
-    0x09,                   /* bLength */
+    /* Standard Endpoint Descriptor */
+    0x07,                   /* bLength */
     0x05,                   /* bDescriptorType: endpoint desc. */
     0x81,                   /* bEndpointAddress: IN1 */
-    0x01,                   /* bmAttributes: Isochronous-synchronous */
-    /* wMaxPacketSize: channels * sps * bytes_per_subframe / 1000 */
-    (((USB_AUDIO_SRC_MAX_TFER_SIZE) >> 0) & 0xFF), 
-    (((USB_AUDIO_SRC_MAX_TFER_SIZE) >> 8) & 0xFF),
+    0x05,                   /* bmAttributes: Isochronous-asynchronous */
+    /* wMaxPacketSize: highest rate of the format, one extra sample */
+    USB_AUDIO_SRC_PACKET_SIZE(USB_AUDIO_SRC_MAX_RATE_32, 3) & 0xFF,
+    USB_AUDIO_SRC_PACKET_SIZE(USB_AUDIO_SRC_MAX_RATE_32, 3) >> 8,
     0x01,                   /* bInterval: One packet per frame. */
-    0x00,                   /* bRefresh */
-    0x00,                   /* bSynchAddress */
 
-    /* USB Microphone Class-specific Isoc. Audio Data Endpoint Descriptor */
+    /* Class-specific Isoc. Audio Data Endpoint Descriptor */
+    0x08,                   /* bLength */
+    0x25,                   /* bDescriptorType: class spec. endpoint desc. */
+    0x01,                   /* bDescriptorSubtype: general */
+    0x00,                   /* bmAttributes: nothing */
+    0x00,                   /* bmControls: none */
+    0x00,                   /* bLockDelayUnits */
+    0x00, 0x00,             /* wLockDelay */
+
+    /* INTERFACE 1: AudioStreaming ALT 3 (32-bit Mode) */
+    /* Standard AS Interface Descriptor */
+    0x09,                   /* bLength */
+    0x04,                   /* bDescriptorType: interface desc. */
+    0x01,                   /* bInterfaceNumber */
+    0x03,                   /* bAlternateSetting: 3 */
+    0x01,                   /* bNumEndpoints:  1 endpoint */
+    0x01,                   /* bInterfaceClass : audio */
+    0x02,                   /* bInterfaceSubclass: audio streaming */
+    0x20,                   /* bInterfaceProtocol: IP_VERSION_02_00 */
+    0x00,                   /* iInterface */
+
+    /* Class-specific AS General Interface Descriptor */
+    0x10,                   /* bLength */
+    0x24,                   /* bDescriptorType: class spec interface desc. */
+    0x01,                   /* bDescriptorSubtype: general descriptor */
+    0x02,                   /* bTerminalLink: output terminal */
+    0x00,                   /* bmControls: none */
+    0x01,                   /* bFormatType: type I */
+    0x01, 0x00, 0x00, 0x00, /* bmFormats: PCM */
+    0x02,                   /* bNrChannels: 2 (i and q) */
+    0x00, 0x00, 0x00, 0x00, /* bmChannelConfig: no spatial location */
+    0x00,                   /* iChannelNames */
+
+    /* Type I Format Type Descriptor */
+    0x06,                   /* bLength */
+    0x24,                   /* bDescriptorType: class spec interface desc. */
+    0x02,                   /* bDescriptorSubtype: format type */
+    0x01,                   /* bFormatType: type I */
+    0x04,                   /* bSubslotSize: 4 bytes per sample */
+    0x20,                   /* bBitResolution: 32 bits */
+
+    /* ENDPOINT 1 IN */
+    /* Standard Endpoint Descriptor */
     0x07,                   /* bLength */
+    0x05,                   /* bDescriptorType: endpoint desc. */
+    0x81,                   /* bEndpointAddress: IN1 */
+    0x05,                   /* bmAttributes: Isochronous-asynchronous */
+    /* wMaxPacketSize: highest rate of the format, one extra sample */
+    USB_AUDIO_SRC_PACKET_SIZE(USB_AUDIO_SRC_MAX_RATE_32, 4) & 0xFF,
+    USB_AUDIO_SRC_PACKET_SIZE(USB_AUDIO_SRC_MAX_RATE_32, 4) >> 8,
+    0x01,                   /* bInterval: One packet per frame. */
+
+    /* Class-specific Isoc. Audio Data Endpoint Descriptor */
+    0x08,                   /* bLength */
     0x25,                   /* bDescriptorType: class spec. endpoint desc. */
     0x01,                   /* bDescriptorSubtype: general */
     0x00,                   /* bmAttributes: nothing */
+    0x00,                   /* bmControls: none */
     0x00,                   /* bLockDelayUnits */
     0x00, 0x00,             /* wLockDelay */
 
@@ -300,6 +357,30 @@ static const uint8_t usb_config0_descriptor[217] = {
     /* wMaxPacketSize: */
     USB_VCP_RX_SIZE & 0xff, USB_VCP_RX_SIZE >> 8,
     0x00,                   /* bInterval: ignore for Bulk transfer */
+
+    /* 
+     * THIRD FUNCTION: Raw RF Capture (Vendor Specific)
+     */
+
+    /* INTERFACE 4: Vendor specific interface descriptor */
+    0x09,                   /* bLength: Interface Descriptor size */
+    0x04,                   /* bDescriptorType: Interface */
+    0x04,                   /* bInterfaceNumber: Number of Interface */
+    0x00,                   /* bAlternateSetting: Alternate setting */
+    0x01,                   /* bNumEndpoints: One endpoint used */
+    0xFF,                   /* bInterfaceClass: Vendor Specific */
+    0x00,                   /* bInterfaceSubClass: */
+    0x00,                   /* bInterfaceProtocol: */
+    0x06,                   /* iInterface: */
+
+    /* ENDPOINT 4 IN Descriptor */
+    0x07,                   /* bLength: Endpoint Descriptor size */
+    0x05,                   /* bDescriptorType: Endpoint */
+    0x84,                   /* bEndpointAddress: (IN4) */
+    0x02,                   /* bmAttributes: Bulk */
+    /* wMaxPacketSize: */
+    USB_RFCAP_TX_SIZE & 0xff, USB_RFCAP_TX_SIZE >> 8,
+    0x00,                   /* bInterval: ignore for Bulk transfer */
 };
 
 /* language ID */
@@ -360,6 +441,14 @@ static const uint8_t usb_string5_descriptor[] = {
     'l', 0,
 };
 
+/* function 3 string */
+static const uint8_t usb_string6_descriptor[] = {
+    0x16,                   /* bLength */
+    0x03,                   /* bDescriptorType */
+    'R', 0, 'F', 0, ' ', 0, 'C', 0, 'a', 0, 'p', 0,
+    't', 0, 'u', 0, 'r', 0, 'e', 0,
+};
+
 /* usb standard device descriptor */
 const uint8_t usb_device_descriptor[] = {
     0x12,                   /* bLength */
@@ -407,6 +496,7 @@ const uint8_t * usb_string_descriptors[] = {
     usb_string3_descriptor,
     usb_string4_descriptor,
     usb_string5_descriptor,
+    usb_string6_descriptor,
 };
 
 /* number of descriptors */
@@ -415,9 +505,9 @@ const int usb_config_descriptors_num = elems(usb_config_descriptors);
 /* string descriptors number */
 const int usb_string_descriptors_num = elems(usb_string_descriptors);
 /* number of interfaces */
-const int usb_interfaces_num = 4;
+const int usb_interfaces_num = 5;
 /* number of used endpoints */
-const int usb_endpoints_num = 3;
+const int usb_endpoints_num = 5;
 
 /* Initialize all dynamically generated descriptors */
 int USBDesc_Init(void)
@@ -11,25 +11,59 @@
 #define USB_AUDIOSRC_H
 
 #include <stddef.h>
+#include <stdint.h>
 
 #include "sys/ev.h"
 
-/** @name USB audio working modes */
+/** @name USB audio working modes (alternate settings of the streaming 
+ * interface) */
 /** @{ */
 /** @brief no audio streaming */
 #define USB_AUDIO_SRC_MODE_OFF                    0
-/** @brief streaming in mono mode */
-#define USB_AUDIO_SRC_MODE_MONO                   1
-/** @brief streaming in stereo mode */
-#define USB_AUDIO_SRC_MODE_STEREO                 2
+/** @brief streaming 16-bit samples */
+#define USB_AUDIO_SRC_MODE_S16                    1
+/** @brief streaming 24-bit samples */
+#define USB_AUDIO_SRC_MODE_S24                    2
+/** @brief streaming 32-bit samples */
+#define USB_AUDIO_SRC_MODE_S32                    3
 /** @} */
 
+/** @brief id of the clock source entity */
+#define USB_AUDIO_SRC_CLOCK_ID                    0x03
+
+/** @name USB audio class 2.0 requests */
+/** @{ */
+/** @brief current setting attribute */
+#define USB_AUDIO_SRC_REQ_CUR                     0x01
+/** @brief range attribute */
+#define USB_AUDIO_SRC_REQ_RANGE                   0x02
+/** @brief clock source: sampling frequency control selector */
+#define USB_AUDIO_SRC_CS_SAM_FREQ                  0x01
+/** @brief clock source: clock validity control selector */
+#define USB_AUDIO_SRC_CS_CLOCK_VALID              0x02
+/** @} */
+
+/** @brief max number of the sampling rates offered to the host */
+#define USB_AUDIO_SRC_MAX_RATES                   8
+
 /** @brief event argument */
 typedef struct usb_audio_evarg {
     /**< current mode of operation */
     int mode;
+    /**< sampling rate selected by the host */
+    uint32_t rate;
 } usb_audio_evarg_t;
 
+/** @brief space within the usb buffer given as (up to) two continuous parts 
+ * (before and after the circular buffer wraps). Each part is an array of 
+ * interleaved l/r samples */
+typedef struct usb_audio_span {
+    /**< pointers to the parts */
+    int32_t *ptr[2];
+    /**< number of pairs of samples in each of the parts */
+    int num[2];
+} usb_audio_span_t;
+
 /** @brief data request event */
 extern ev_t usb_audio_ev;
 
@@ -40,6 +74,29 @@ extern ev_t usb_audio_ev;
  */
 int USBAudioSrc_Init(void);
 
+/**
+ * @brief Set the sampling rates offered to the host (listed by the clock 
+ * source). Host selects one of them and the event is generated, current rate 
+ * is the first one until then.
+ * 
+ * @param rates sampling rates in Hz (as they come from the adc clock)
+ * @param num number of the rates (up to USB_AUDIO_SRC_MAX_RATES)
+ * 
+ * @return int status code
+ */
+int USBAudioSrc_SetRates(const uint32_t *rates, int num);
+
+/**
+ * @brief Select the current sampling rate on the device side (when the 
+ * producer changes it by itself). No event is generated and the host is not 
+ * notified, it sees the new rate with the next request for it.
+ * 
+ * @param rate sampling rate in Hz (one of the offered ones)
+ * 
+ * @return int status code (EFATAL if the rate is not offered)
+ */
+int USBAudioSrc_SetRate(uint32_t rate);
+
 /**
  * @brief Store audio samples within the usb buffer
  * 
@@ -51,4 +108,27 @@ int USBAudioSrc_Init(void);
  */
 int USBAudioSrc_PutSamples(const int32_t *l, const int32_t *r, int num);
 
+/**
+ * @brief Get the space within the usb buffer so that the samples can be 
+ * written directly to it. Samples become visible to the usb after the call 
+ * to USBAudioSrc_CommitSamples(). 
+ * 
+ * @param num number of pairs of samples that are to be written
+ * @param span placeholder for the description of the space
+ * 
+ * @return int number of pairs of samples that can be written (may be less 
+ * than num when the buffer is getting full)
+ */
+int USBAudioSrc_AcquireSpace(int num, usb_audio_span_t *span);
+
+/**
+ * @brief Commit the samples that were written to the space obtained with 
+ * USBAudioSrc_AcquireSpace().
+ * 
+ * @param num number of pairs of samples written
+ * 
+ * @return int number of pairs of samples committed
+ */
+int USBAudioSrc_CommitSamples(int num);
+
 #endif /* USB_AUDIOSRC_H */
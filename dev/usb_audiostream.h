@@ -0,0 +1,90 @@
+/**
+ * @file usb_audiostream.h
+ * 
+ * @date 2026-10-17
+ * @author twatorowski 
+ * 
+ * @brief USB Audio Source: hardware independent parts of the streaming, i.e. 
+ * the per-frame pacing of the isochronous packets, packing of the samples 
+ * into the formats of the alternate settings and the clock source range 
+ * response
+ */
+
+#ifndef USB_AUDIOSTREAM_H
+#define USB_AUDIOSTREAM_H
+
+#include <stdint.h>
+
+/** @brief pacing of the packets */
+typedef struct usb_audio_pace {
+    /**< nominal number of samples per frame (Q16) */
+    uint32_t step;
+    /**< fractional part of the number of samples carried over (Q16) */
+    uint32_t acc;
+    /**< fill level of the buffer to be kept, max samples per packet */
+    int target, max_num;
+    /**< smoothed fill level */
+    float fill;
+    /**< streaming has started (target fill level was reached) */
+    int started;
+    /**< number of frames that got fewer samples than they should */
+    uint32_t underruns;
+} usb_audio_pace_t;
+
+/**
+ * @brief Initialize the pacing
+ * 
+ * @param pace pacing state
+ * @param rate sampling rate in Hz
+ * @param target fill level of the buffer to be kept (in samples), nothing 
+ * is sent until it is reached
+ * @param max_num max number of samples per packet
+ * 
+ * @return int status (EFATAL for the rates that do not fit the packet)
+ */
+int USBAudioStream_PaceInit(usb_audio_pace_t *pace, uint32_t rate, 
+    int target, int max_num);
+
+/**
+ * @brief Get the number of samples for the next packet. Nominal number of 
+ * samples (with the fractional part carried over) is trimmed by the slow 
+ * servo that keeps the fill level at the target: this follows the difference 
+ * between the adc clock and the usb frame clock without the jitter of the 
+ * occasional large packets.
+ * 
+ * @param pace pacing state
+ * @param fill number of samples waiting in the buffer
+ * 
+ * @return int number of samples to be sent
+ */
+int USBAudioStream_Pace(usb_audio_pace_t *pace, int fill);
+
+/**
+ * @brief Pack the samples into the little endian format of the given width 
+ * (most significant bits of the Q31 samples are taken)
+ * 
+ * @param lr interleaved left/right (i/q) samples
+ * @param num number of pairs of samples
+ * @param bytes bytes per sample (2, 3 or 4)
+ * @param out output buffer
+ * 
+ * @return int number of bytes written
+ */
+int USBAudioStream_Pack(const int32_t *lr, int num, int bytes, uint8_t *out);
+
+/**
+ * @brief Build the response to the RANGE request of the sampling frequency 
+ * control: the list of discrete rates (subranges with min = max)
+ * 
+ * @param rates supported rates
+ * @param num number of the rates
+ * @param out output buffer
+ * @param size size of the output buffer
+ * 
+ * @return int number of bytes written (the list is truncated to the buffer 
+ * size)
+ */
+int USBAudioStream_FreqRange(const uint32_t *rates, int num, uint8_t *out, 
+    int size);
+
+#endif /* USB_AUDIOSTREAM_H */
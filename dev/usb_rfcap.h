@@ -0,0 +1,46 @@
+/**
+ * @file usb_rfcap.h
+ * 
+ * @date 2026-10-17
+ * @author twatorowski 
+ * 
+ * @brief USB raw rf capture: vendor specific interface with a single bulk in 
+ * endpoint that carries whatever the capture logic hands over. Transfers are 
+ * made straight from the caller's memory, nothing gets copied.
+ */
+
+#ifndef DEV_USB_RFCAP_H
+#define DEV_USB_RFCAP_H
+
+#include <stddef.h>
+
+#include "sys/cb.h"
+
+/**
+ * @brief Initialize the rf capture endpoint (needs to go after the audio 
+ * source and the virtual com port as the fifo memory is assigned in the 
+ * endpoint order)
+ * 
+ * @return int status (@ref ERR_ERROR_CODES) 
+ */
+int USBRFCap_Init(void);
+
+/**
+ * @brief Send the data over the bulk endpoint. Transfer is made of two parts 
+ * (the header and the data, the latter may be empty) that are sent one after 
+ * the other. Both must stay intact until the callback is called (from the 
+ * interrupt context, with the usb_cbarg_t that gives the number of bytes 
+ * sent and the error code, EUSB_RESET if the bus was reset meanwhile).
+ * 
+ * @param hdr header pointer
+ * @param hdr_size header size in bytes
+ * @param ptr data pointer
+ * @param size data size in bytes
+ * @param cb transfer finished callback
+ * 
+ * @return int status (EBUSY if the previous transfer is still on)
+ */
+int USBRFCap_Send(const void *hdr, size_t hdr_size, const void *ptr, 
+    size_t size, cb_t cb);
+
+#endif /* DEV_USB_RFCAP_H */
@@ -0,0 +1,97 @@
+/**
+ * @file asrc.h
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Asynchronous sample rate converter: polyphase interpolation filter
+ * that produces the samples at any fractional position of the input stream
+ * and the fill level servo that adjusts the conversion ratio so that the
+ * buffer of the sink that runs from its own clock neither over- nor
+ * underflows.
+ */
+
+#ifndef DSP_ASRC_H
+#define DSP_ASRC_H
+
+#include <stdint.h>
+
+#include "config.h"
+
+/** @brief delay introduced by the interpolation filter in input samples */
+#define ASRC_DELAY                                      (ASRC_TAPS / 2)
+
+/** @brief sample rate converter */
+typedef struct asrc {
+    /** input history, every sample is stored twice so that the filter always
+     * sees the contiguous window */
+    float hist[2 * ASRC_TAPS];
+    /** position within the history */
+    int idx;
+    /** position of the next output sample relative to the center of the
+     * window and the distance between the output samples (in input samples,
+     * Q32: float accumulation would drift) */
+    uint64_t pos, step;
+    /** nominal conversion ratio and the one in use (input samples per
+     * output sample) */
+    float nominal, ratio;
+    /** fill level to be kept, servo time constant (in samples) */
+    float target, tau;
+    /** servo integrator, smoothed fill level */
+    float integ, fill;
+} asrc_t;
+
+/**
+ * @brief Initialize the converter
+ *
+ * @param asrc converter
+ * @param ratio nominal conversion ratio: input sampling rate divided by the
+ * sink sampling rate (0.5 - 2)
+ * @param target fill level of the sink buffer to be kept by the servo (in
+ * samples)
+ * @param tau servo time constant (in samples)
+ *
+ * @return int status (EFATAL for unsupported ratio)
+ */
+int ASRC_Init(asrc_t *asrc, float ratio, float target, float tau);
+
+/**
+ * @brief Convert the samples. Number of the output samples follows the
+ * conversion ratio, the fractional part is carried over to the next call.
+ *
+ * @param asrc converter
+ * @param in input samples
+ * @param num number of the input samples
+ * @param out output samples (room for num / ratio + 1 samples is needed,
+ * ratio is within ASRC_MAX_PPM of the nominal one)
+ *
+ * @return int number of the output samples
+ */
+int ASRC_Process(asrc_t *asrc, const float *in, int num, float *out);
+
+/**
+ * @brief Update the conversion ratio on the basis of the fill level of the
+ * sink buffer: fill level that is too high means that the sink runs slower
+ * than it was assumed, so the ratio is increased (fewer samples are
+ * produced). Proportional-integral control, well damped with the time
+ * constant given at the initialization.
+ *
+ * @param asrc converter
+ * @param fill number of samples that wait in the sink buffer
+ * @param num number of the input samples processed since the last update
+ */
+void ASRC_Servo(asrc_t *asrc, float fill, int num);
+
+/**
+ * @brief Get the converter state
+ *
+ * @param asrc converter
+ * @param ppm place to put the deviation of the ratio from the nominal one to
+ * (in ppm, may be NULL)
+ * @param fill place to put the smoothed fill level to (may be NULL)
+ *
+ * @return int status
+ */
+int ASRC_GetStatus(const asrc_t *asrc, float *ppm, float *fill);
+
+#endif /* DSP_ASRC_H */
@@ -5,12 +5,19 @@
  * @date 2019-12-01
  * @author twatorowski 
  * 
- * @brief Biquadratic filter implementation. Uses Transposed form II.
+ * @brief Biquadratic filter implementation. Uses Transposed form II for the 
+ * floating point data and Direct Form I with 64-bit accumulation for the 
+ * fixed point (Q31/Q15) data.
  */
 
 #ifndef DSP_BIQUAD_H_
 #define DSP_BIQUAD_H_
 
+#include <stdint.h>
+
+/** @brief maximal number of sections in the cascade */
+#define BIQUAD_MAX_SECTIONS                             4
+
 /** @brief biquadratic filter taps */
 typedef struct biquad_taps {
     /** denominator coefficients */
@@ -27,6 +34,46 @@ typedef struct biquad {
     const biquad_taps_t *taps;
 } biquad_t;
 
+/** @brief biquadratic filter taps quantized for the Q31 data. Coefficients 
+ * are stored in the Q(31 - shift) format, denominator coefficients are stored 
+ * negated so that all the products can be accumulated */
+typedef struct biquad_q31_taps {
+    /** denominator coefficients (negated) */
+    int32_t a1, a2;
+    /** numerator taps */
+    int32_t b0, b1, b2;
+    /** number of integer bits of the coefficients */
+    int shift;
+} biquad_q31_taps_t;
+
+/** @brief biquadratic filter struct for the Q31 data */
+typedef struct biquad_q31 {
+    /** delay line: x[n-1], x[n-2], y[n-1], y[n-2] */
+    int32_t dl[4];
+    /** pointer to the structure holding the taps */
+    const biquad_q31_taps_t *taps;
+} biquad_q31_t;
+
+/** @brief biquadratic filter taps quantized for the Q15 data. Coefficients 
+ * are stored in the Q(15 - shift) format, denominator coefficients are stored 
+ * negated so that all the products can be accumulated */
+typedef struct biquad_q15_taps {
+    /** denominator coefficients (negated) */
+    int16_t a1, a2;
+    /** numerator taps */
+    int16_t b0, b1, b2;
+    /** number of integer bits of the coefficients */
+    int shift;
+} biquad_q15_taps_t;
+
+/** @brief biquadratic filter struct for the Q15 data */
+typedef struct biquad_q15 {
+    /** delay line: x[n-1], x[n-2], y[n-1], y[n-2] */
+    int16_t dl[4];
+    /** pointer to the structure holding the taps */
+    const biquad_q15_taps_t *taps;
+} biquad_q15_t;
+
 /**
  * @brief Set the new taps and reset the delay line.
  * 
@@ -46,4 +93,89 @@ void BiQuad_SetTaps(biquad_t *bq, const biquad_taps_t *taps);
  */
 void BiQuad_Filter(const float *src, int len, biquad_t *bq, float *dst);
 
+/**
+ * @brief Apply Filtration using the cascade of biquadratic IIR filters to a 
+ * pair of channels (I and Q) in a single pass: each sample goes through all 
+ * of the sections before the next one is fetched. Produces exactly the same 
+ * results as the consecutive calls to BiQuad_Filter() for every section and 
+ * every channel. Can work in-situ.
+ * 
+ * @param i in-phase channel data to be filtered
+ * @param q quadrature channel data to be filtered
+ * @param len length of data to be filtered
+ * @param bq_i filter sections for the in-phase channel
+ * @param bq_q filter sections for the quadrature channel
+ * @param sections number of sections (up to BIQUAD_MAX_SECTIONS)
+ * @param i_out pointer for the in-phase channel output data
+ * @param q_out pointer for the quadrature channel output data
+ */
+void BiQuad_FilterCascadeIQ(const float *i, const float *q, int len, 
+    biquad_t *bq_i, biquad_t *bq_q, int sections, float *i_out, float *q_out);
+
+/**
+ * @brief Quantize the floating point taps for the use with the Q31 filter. 
+ * The number of integer bits is chosen automatically so that the largest 
+ * coefficient still fits.
+ * 
+ * @param taps floating point taps
+ * @param q31 quantized taps
+ * 
+ * @return int status (EFATAL if coefficients are too large to be represented)
+ */
+int BiQuad_QuantizeQ31(const biquad_taps_t *taps, biquad_q31_taps_t *q31);
+
+/**
+ * @brief Quantize the floating point taps for the use with the Q15 filter. 
+ * The number of integer bits is chosen automatically so that the largest 
+ * coefficient still fits.
+ * 
+ * @param taps floating point taps
+ * @param q15 quantized taps
+ * 
+ * @return int status (EFATAL if coefficients are too large to be represented)
+ */
+int BiQuad_QuantizeQ15(const biquad_taps_t *taps, biquad_q15_taps_t *q15);
+
+/**
+ * @brief Set the new taps and reset the delay line of the Q31 filter.
+ * 
+ * @param bq filter to be set up.
+ * @param taps pointer to taps structure or null if you just want to reset the 
+ * delay line
+ */
+void BiQuad_SetTapsQ31(biquad_q31_t *bq, const biquad_q31_taps_t *taps);
+
+/**
+ * @brief Set the new taps and reset the delay line of the Q15 filter.
+ * 
+ * @param bq filter to be set up.
+ * @param taps pointer to taps structure or null if you just want to reset the 
+ * delay line
+ */
+void BiQuad_SetTapsQ15(biquad_q15_t *bq, const biquad_q15_taps_t *taps);
+
+/**
+ * @brief Apply Filtration to the Q31 data using biquadratic IIR filter with 
+ * 64-bit accumulator. Output is rounded and saturated. Can work in-situ.
+ * 
+ * @param src data to be filtered
+ * @param len length of data to be filtered
+ * @param bq filter structure
+ * @param dst pointer for the output data
+ */
+void BiQuad_FilterQ31(const int32_t *src, int len, biquad_q31_t *bq, 
+    int32_t *dst);
+
+/**
+ * @brief Apply Filtration to the Q15 data using biquadratic IIR filter with 
+ * 64-bit accumulator. Output is rounded and saturated. Can work in-situ.
+ * 
+ * @param src data to be filtered
+ * @param len length of data to be filtered
+ * @param bq filter structure
+ * @param dst pointer for the output data
+ */
+void BiQuad_FilterQ15(const int16_t *src, int len, biquad_q15_t *bq, 
+    int16_t *dst);
+
 #endif /* DSP_BIQUAD_H */
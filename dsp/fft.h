@@ -0,0 +1,55 @@
+/**
+ * @file fft.h
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Fast Fourier Transform of the complex data (in-situ, radix-4
+ * decimation in time with a single radix-2 stage for the sizes that are not
+ * the powers of 4). Twiddle factors are stored in flash.
+ */
+
+#ifndef DSP_FFT_H
+#define DSP_FFT_H
+
+#include <stdint.h>
+
+/**
+ * @brief Forward transform of the floating point data:
+ * X[k] = sum(x[n] * exp(-j * 2 * pi * k * n / size)), no scaling is applied.
+ *
+ * @param re real parts (replaced with the result)
+ * @param im imaginary parts (replaced with the result)
+ * @param size transform size (power of 2, no more than FFT_MAX_SIZE)
+ *
+ * @return int status (EFATAL for unsupported size)
+ */
+int FFT_Float(float *re, float *im, int size);
+
+/**
+ * @brief Forward transform of the Q31 data. Every stage scales the data down
+ * so that the result is X[k] / size (with X[k] defined as for FFT_Float()).
+ * Input samples need to have the magnitude below 1.0 (sqrt(re^2 + im^2)) for
+ * the transform not to overflow.
+ *
+ * @param re real parts (replaced with the result)
+ * @param im imaginary parts (replaced with the result)
+ * @param size transform size (power of 2, no more than FFT_MAX_SIZE)
+ *
+ * @return int status (EFATAL for unsupported size)
+ */
+int FFT_Q31(int32_t *re, int32_t *im, int size);
+
+/**
+ * @brief Forward transform of the Q15 data, same scaling and input
+ * constraints as for the FFT_Q31().
+ *
+ * @param re real parts (replaced with the result)
+ * @param im imaginary parts (replaced with the result)
+ * @param size transform size (power of 2, no more than FFT_MAX_SIZE)
+ *
+ * @return int status (EFATAL for unsupported size)
+ */
+int FFT_Q15(int16_t *re, int16_t *im, int size);
+
+#endif /* DSP_FFT_H */
@@ -0,0 +1,58 @@
+/**
+ * @file hband.h
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Half-band decimator: the low pass filter with the cutoff at the
+ * quarter of the input sampling rate followed by the decimation by 2. Every
+ * other tap of the half-band filter is zero, so only the ones that are not
+ * get computed and only for the samples that make it to the output.
+ */
+
+#ifndef DSP_HBAND_H
+#define DSP_HBAND_H
+
+#include "config.h"
+
+/** @brief half-band decimator */
+typedef struct hband {
+    /** number of the filter taps */
+    int taps_num;
+    /** non-zero taps apart from the center one, taps[j] is used for the
+     * samples that are 2 * j + 1 samples away from the center */
+    float taps[(HBAND_MAX_TAPS + 1) / 4];
+    /** input history, every sample is stored twice so that the filter always
+     * sees the contiguous window */
+    float hist[2 * HBAND_MAX_TAPS];
+    /** position within the history */
+    int idx;
+    /** decimation phase: the next input sample produces the output */
+    int phase;
+} hband_t;
+
+/**
+ * @brief Initialize the decimator (compute the taps, empty history). The
+ * filter delays the signal by taps / 2 input samples.
+ *
+ * @param hb decimator
+ * @param taps number of the filter taps (4k + 3, so that the outermost taps
+ * are not the zero ones, no more than HBAND_MAX_TAPS)
+ */
+void HBand_Init(hband_t *hb, int taps);
+
+/**
+ * @brief Filter and decimate the samples. Can be performed in-situ, the odd
+ * number of samples is allowed (the decimation phase is carried over to the
+ * next call).
+ *
+ * @param hb decimator
+ * @param in input samples
+ * @param num number of the input samples
+ * @param out output samples (room for num / 2 + 1 samples is needed)
+ *
+ * @return int number of the output samples
+ */
+int HBand_Decimate(hband_t *hb, const float *in, int num, float *out);
+
+#endif /* DSP_HBAND_H */
@@ -0,0 +1,74 @@
+/**
+ * @file pspec.h
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Power spectrum of the complex frames: the frame is windowed (hann),
+ * converted to Q31, transformed with FFT_Q31() and the power of the bins gets
+ * accumulated in the floating point.
+ */
+
+#ifndef DSP_PSPEC_H
+#define DSP_PSPEC_H
+
+#include <stdint.h>
+
+#include "config.h"
+
+/** @brief accumulated power of the full scale complex tone (normalized input
+ * of 1.0) within its bin per frame: the tone ends up with the amplitude of
+ * 1/4 in the Q31 after the 1/2 input scaling and the window (coherent gain of
+ * 1/2) */
+#define PSPEC_FULL_SCALE                                                    \
+    (0.25f * 2147483648.0f * 0.25f * 2147483648.0f)
+/** @brief factor by which the window spreads the power of the noise (the
+ * equivalent noise bandwidth of the hann window in bins) */
+#define PSPEC_NOISE_BW                                  1.5f
+
+/** @brief power spectrum */
+typedef struct pspec {
+    /** frame size */
+    int size;
+    /** window scaled to half of the Q31 range so that the magnitude of the
+     * saturated complex input stays below 1.0 */
+    float window[PSPEC_MAX_SIZE];
+    /** transform buffers */
+    int32_t re[PSPEC_MAX_SIZE], im[PSPEC_MAX_SIZE];
+} pspec_t;
+
+/**
+ * @brief Initialize the power spectrum (compute the window)
+ *
+ * @param ps power spectrum
+ * @param size frame size (power of 2, no more than PSPEC_MAX_SIZE and
+ * FFT_MAX_SIZE)
+ *
+ * @return int status (EFATAL for unsupported sizes)
+ */
+int PSpec_Init(pspec_t *ps, int size);
+
+/**
+ * @brief Window the frame and convert it to Q31. Frame buffers can be
+ * overwritten as soon as this function returns.
+ *
+ * @param ps power spectrum
+ * @param i I samples of the frame (normalized, full scale is 1.0)
+ * @param q Q samples of the frame
+ */
+void PSpec_Load(pspec_t *ps, const float *i, const float *q);
+
+/**
+ * @brief Transform the loaded frame and accumulate the power of the
+ * consecutive bins. Bin indices wrap around, so the negative frequencies are
+ * addressed with the negative indices.
+ *
+ * @param ps power spectrum
+ * @param acc power accumulators
+ * @param first index of the first bin
+ * @param num number of the bins
+ * @param add add to the accumulators (0 overwrites them)
+ */
+void PSpec_Accumulate(pspec_t *ps, float *acc, int first, int num, int add);
+
+#endif /* DSP_PSPEC_H */
@@ -0,0 +1,171 @@
+/**
+ * @file asrc.c
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Asynchronous sample rate converter. The interpolation filter is the
+ * blackman windowed sinc, ASRC_TAPS long, tabulated for ASRC_PHASES + 1
+ * fractional positions (the last one repeats the first one shifted by a
+ * sample). Every output sample is the dot product of the input window with
+ * the two neighbouring phases, results are interpolated linearly. The servo
+ * is the proportional-integral controller of the ratio that looks at the
+ * fill level of the sink buffer.
+ */
+
+#include "compiler.h"
+#include "config.h"
+#include "err.h"
+#include "dsp/asrc.h"
+#include "util/fp.h"
+#include "util/minmax.h"
+
+/* filter cutoff frequency relative to the input sampling rate */
+#define ASRC_CUTOFF                         0.45f
+
+/* one input sample in the position format (Q32) */
+#define ASRC_ONE                            ((uint64_t)1 << 32)
+
+/* filter phases */
+static float taps[ASRC_PHASES + 1][ASRC_TAPS];
+/* phases were computed */
+static int taps_ready;
+
+/* compute the filter phases */
+static void ASRC_ComputeTaps(void)
+{
+    /* go through all the phases */
+    for (int p = 0; p <= ASRC_PHASES; p++) {
+        /* sum of the taps (for the normalization) */
+        float sum = 0;
+        /* go through all the taps */
+        for (int k = 0; k < ASRC_TAPS; k++) {
+            /* distance from the output sample: tap k holds the input sample
+             * that is k - ASRC_TAPS / 2 + 1 samples away from the center */
+            float t = k - ASRC_TAPS / 2 + 1 - (float)p / ASRC_PHASES;
+            /* sinc */
+            float x = 2 * fp_PI * ASRC_CUTOFF * t;
+            float h = fp_fabs(x) < 1e-6f ? 1 : fp_sin(x) / x;
+            /* blackman window spanning the whole filter */
+            float w = 2 * fp_PI * t / ASRC_TAPS;
+            h *= 0.42f + 0.5f * fp_cos(w) + 0.08f * fp_cos(2 * w);
+            /* store */
+            taps[p][k] = h, sum += h;
+        }
+        /* unity gain at dc for every phase */
+        for (int k = 0; k < ASRC_TAPS; k++)
+            taps[p][k] /= sum;
+    }
+    /* all done */
+    taps_ready = 1;
+}
+
+/* initialize the converter */
+int ASRC_Init(asrc_t *asrc, float ratio, float target, float tau)
+{
+    /* sanity check */
+    if (ratio < 0.5f || ratio > 2.0f || tau <= 0)
+        return EFATAL;
+    /* filter is shared by all the converters */
+    if (!taps_ready)
+        ASRC_ComputeTaps();
+
+    /* empty history */
+    for (int k = 0; k < 2 * ASRC_TAPS; k++)
+        asrc->hist[k] = 0;
+    /* first output sample is produced with the first input sample */
+    asrc->idx = 0, asrc->pos = ASRC_ONE;
+    /* nominal ratio, servo */
+    asrc->nominal = asrc->ratio = ratio;
+    asrc->step = (uint64_t)((double)ratio * ASRC_ONE);
+    asrc->target = target, asrc->tau = tau;
+    asrc->integ = 0, asrc->fill = target;
+
+    /* report status */
+    return EOK;
+}
+
+/* convert the samples */
+int OPTIMIZE("O3") LOOP_UNROLL ASRC_Process(asrc_t *asrc, const float *in,
+    int num, float *out)
+{
+    /* local copies of the state */
+    uint64_t pos = asrc->pos, step = asrc->step;
+    int idx = asrc->idx;
+    /* number of the output samples */
+    int out_num = 0;
+
+    /* process all input samples */
+    for (int n = 0; n < num; n++) {
+        /* store in the history (twice) */
+        asrc->hist[idx] = asrc->hist[idx + ASRC_TAPS] = in[n];
+        /* the window starts with the oldest sample */
+        if (++idx == ASRC_TAPS)
+            idx = 0;
+        /* window has moved by one sample */
+        const float *x = asrc->hist + idx; pos -= ASRC_ONE;
+
+        /* produce all the output samples that fall before the next input
+         * sample */
+        for (; pos < ASRC_ONE; pos += step) {
+            /* phase and the interpolation factor */
+            float f = (uint32_t)pos * ((float)ASRC_PHASES / ASRC_ONE);
+            int p = (int)f; f -= p;
+            /* apply both phases */
+            const float *h0 = taps[p], *h1 = taps[p + 1];
+            float y0 = 0, y1 = 0;
+            for (int k = 0; k < ASRC_TAPS; k++)
+                y0 += h0[k] * x[k], y1 += h1[k] * x[k];
+            /* interpolate between them */
+            out[out_num++] = y0 + f * (y1 - y0);
+        }
+    }
+
+    /* store the state */
+    asrc->pos = pos, asrc->idx = idx;
+    /* return the number of samples produced */
+    return out_num;
+}
+
+/* update the conversion ratio */
+void ASRC_Servo(asrc_t *asrc, float fill, int num)
+{
+    /* limit of the correction */
+    const float limit = ASRC_MAX_PPM * 1e-6f;
+    /* the sink takes whole samples so the fill level jitters by a sample
+     * or so between the updates, that would frequency modulate the output
+     * through the proportional term: the level is smoothed first (with the
+     * time constant 4 times shorter than the one of the loop) */
+    asrc->fill += (fill - asrc->fill) * min(1.0f, 4 * num / asrc->tau);
+    /* fill level error */
+    float err = asrc->fill - asrc->target;
+
+    /* the fill level integrates the ratio error: with the proportional gain
+     * of 1/tau and the integral gain of 1/(2 tau^2) the loop is well
+     * damped (zeta = 0.707) */
+    float integ = asrc->integ + err * num / (2 * fp_sq(asrc->tau));
+    integ = min(limit, max(-limit, integ));
+    /* correction */
+    float c = err / asrc->tau + integ;
+    /* the integrator is frozen while the correction is saturated so that it
+     * does not wind up during the pull-in */
+    if (fp_fabs(c) <= limit)
+        asrc->integ = integ;
+    c = min(limit, max(-limit, c));
+
+    /* new ratio */
+    asrc->ratio = asrc->nominal * (1 + c);
+    asrc->step = (uint64_t)((double)asrc->ratio * ASRC_ONE);
+}
+
+/* get the converter state */
+int ASRC_GetStatus(const asrc_t *asrc, float *ppm, float *fill)
+{
+    /* report the values */
+    if (ppm)
+        *ppm = (asrc->ratio / asrc->nominal - 1) * 1e6f;
+    if (fill)
+        *fill = asrc->fill;
+    /* report status */
+    return EOK;
+}
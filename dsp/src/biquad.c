@@ -4,11 +4,32 @@
  * @date 2019-12-01
  * @author twatorowski 
  * 
- * @brief Biquadratic IIR filter implementation using floating point arithmetic
+ * @brief Biquadratic IIR filter implementation using floating point and fixed 
+ * point arithmetic
  */
 
+#include <stdint.h>
+
+#include "assert.h"
 #include "compiler.h"
+#include "err.h"
+#include "arch/arch.h"
 #include "dsp/biquad.h"
+#include "util/fp.h"
+
+/* single step of the transposed form II biquad: shared by all the filter 
+ * variants so that they produce exactly the same results */
+static inline ALWAYS_INLINE float BiQuad_Step(float x, float a1, float a2, 
+    float b0, float b1, float b2, float *w1, float *w2)
+{
+    /* get the output value */
+    float y = x * b0 + *w1;
+    /* calculate */
+    *w1 = x * b1 - y * a1 + *w2;
+    *w2 = x * b2 - y * a2;
+    /* return the output value */
+    return y;
+}
 
 /* reset the delay line of the biquad filter */
 void BiQuad_SetTaps(biquad_t *bq, const biquad_taps_t *taps)
@@ -19,9 +40,11 @@ void BiQuad_SetTaps(biquad_t *bq, const biquad_taps_t *taps)
     bq->dl[0] = 0, bq->dl[1] = 0;
 }
 
-/* biquadratic iir filter implementation, transposed form II */
-void OPTIMIZE("O3") LOOP_UNROLL BiQuad_Filter(const float *src, int len, 
-    biquad_t *bq, float *dst)
+/* biquadratic iir filter implementation, transposed form II. Reassociation of 
+ * the floating point operations is disabled for all the filter variants so 
+ * that they always produce the same results */
+void OPTIMIZE("O3,unroll-loops,no-associative-math") BiQuad_Filter(
+    const float *src, int len, biquad_t *bq, float *dst)
 {
     /* taps pointer */
     const biquad_taps_t *t = bq->taps;
@@ -29,21 +52,225 @@ void OPTIMIZE("O3") LOOP_UNROLL BiQuad_Filter(const float *src, int len,
     float w1 = bq->dl[0], w2 = bq->dl[1];
     /* read the taps */
     float a1 = t->a1, a2 = t->a2, b0 = t->b0, b1 = t->b1, b2 = t->b2;
-    /* input and output variables */
-    float x, y;
+    /* process all the samples */
+    for (int i = 0; i < len; i++)
+        *dst++ = BiQuad_Step(*src++, a1, a2, b0, b1, b2, &w1, &w2);
+
+    /* update the delay line */
+    bq->dl[0] = w1, bq->dl[1] = w2;
+}
+
+/* cascade of biquadratic iir filters for the pair of channels */
+void OPTIMIZE("O3,unroll-loops,no-associative-math") BiQuad_FilterCascadeIQ(
+    const float *i, const float *q, int len, biquad_t *bq_i, biquad_t *bq_q, 
+    int sections, float *i_out, float *q_out)
+{
+    /* local copies of the taps and the delay lines */
+    float a1[BIQUAD_MAX_SECTIONS], a2[BIQUAD_MAX_SECTIONS];
+    float b0[BIQUAD_MAX_SECTIONS], b1[BIQUAD_MAX_SECTIONS];
+    float b2[BIQUAD_MAX_SECTIONS];
+    float w1i[BIQUAD_MAX_SECTIONS], w2i[BIQUAD_MAX_SECTIONS];
+    float w1q[BIQUAD_MAX_SECTIONS], w2q[BIQUAD_MAX_SECTIONS];
+    /* input/output variables */
+    float xi, xq;
+    /* section counter */
+    int s;
+
+    /* sanity check */
+    assert(sections > 0 && sections <= BIQUAD_MAX_SECTIONS, 
+        "unsupported number of sections", sections);
+
+    /* read the taps and the delay lines (both channels share the taps) */
+    for (s = 0; s < sections; s++) {
+        const biquad_taps_t *t = bq_i[s].taps;
+        a1[s] = t->a1, a2[s] = t->a2, b0[s] = t->b0, b1[s] = t->b1;
+        b2[s] = t->b2;
+        w1i[s] = bq_i[s].dl[0], w2i[s] = bq_i[s].dl[1];
+        w1q[s] = bq_q[s].dl[0], w2q[s] = bq_q[s].dl[1];
+    }
+
+    /* process all the samples */
+    for (int n = 0; n < len; n++) {
+        /* fetch the samples */
+        xi = i[n], xq = q[n];
+        /* go through all the sections, the output of the section is the 
+         * input of the next one */
+        for (s = 0; s < sections; s++) {
+            xi = BiQuad_Step(xi, a1[s], a2[s], b0[s], b1[s], b2[s], &w1i[s], 
+                &w2i[s]);
+            xq = BiQuad_Step(xq, a1[s], a2[s], b0[s], b1[s], b2[s], &w1q[s], 
+                &w2q[s]);
+        }
+        /* store data in the destination arrays */
+        i_out[n] = xi, q_out[n] = xq;
+    }
+
+    /* update the delay lines */
+    for (s = 0; s < sections; s++) {
+        bq_i[s].dl[0] = w1i[s], bq_i[s].dl[1] = w2i[s];
+        bq_q[s].dl[0] = w1q[s], bq_q[s].dl[1] = w2q[s];
+    }
+}
+
+/* find the number of integer bits needed to represent all the coefficients 
+ * using 'bits'-wide words, returns -1 if there is no such number */
+static int BiQuad_GetShift(const biquad_taps_t *taps, int bits)
+{
+    /* coefficients */
+    const float c[] = { taps->a1, taps->a2, taps->b0, taps->b1, taps->b2 };
+    /* largest magnitude */
+    float max = 0;
+
+    /* look for the largest coefficient */
+    for (int i = 0; i < 5; i++)
+        if (fp_fabs(c[i]) > max) max = fp_fabs(c[i]);
+    /* go with the smallest shift that does not cause the overflow after 
+     * the rounding, leave at least one fractional bit */
+    for (int shift = 0; shift < bits - 1; shift++)
+        if (fp_round(ldexpf(max, bits - 1 - shift)) < ldexpf(1, bits - 1))
+            return shift;
+    /* coefficients are too large */
+    return -1;
+}
+
+/* quantize the coefficient to the Q(bits - 1 - shift) format */
+static int32_t BiQuad_QuantizeCoeff(float c, int bits, int shift)
+{
+    /* scale and round */
+    return (int32_t)fp_round(ldexpf(c, bits - 1 - shift));
+}
+
+/* saturate the 64-bit value so that it fits within 'bits' bits */
+static inline ALWAYS_INLINE int32_t BiQuad_Sat64(int64_t x, const int bits)
+{
+    /* representable range */
+    const int64_t max = ((int64_t)1 << (bits - 1)) - 1, min = -max - 1;
+    /* clip */
+    return x > max ? max : x < min ? min : x;
+}
+
+/* quantize the taps for the q31 filter */
+int BiQuad_QuantizeQ31(const biquad_taps_t *taps, biquad_q31_taps_t *q31)
+{
+    /* number of integer bits */
+    int shift = BiQuad_GetShift(taps, 32);
+    /* unable to represent the coefficients */
+    if (shift < 0)
+        return EFATAL;
+
+    /* store the coefficients, denominator ones are negated */
+    q31->a1 = -BiQuad_QuantizeCoeff(taps->a1, 32, shift);
+    q31->a2 = -BiQuad_QuantizeCoeff(taps->a2, 32, shift);
+    q31->b0 = BiQuad_QuantizeCoeff(taps->b0, 32, shift);
+    q31->b1 = BiQuad_QuantizeCoeff(taps->b1, 32, shift);
+    q31->b2 = BiQuad_QuantizeCoeff(taps->b2, 32, shift);
+    q31->shift = shift;
+    /* report status */
+    return EOK;
+}
+
+/* quantize the taps for the q15 filter */
+int BiQuad_QuantizeQ15(const biquad_taps_t *taps, biquad_q15_taps_t *q15)
+{
+    /* number of integer bits */
+    int shift = BiQuad_GetShift(taps, 16);
+    /* unable to represent the coefficients */
+    if (shift < 0)
+        return EFATAL;
+
+    /* store the coefficients, denominator ones are negated */
+    q15->a1 = -BiQuad_QuantizeCoeff(taps->a1, 16, shift);
+    q15->a2 = -BiQuad_QuantizeCoeff(taps->a2, 16, shift);
+    q15->b0 = BiQuad_QuantizeCoeff(taps->b0, 16, shift);
+    q15->b1 = BiQuad_QuantizeCoeff(taps->b1, 16, shift);
+    q15->b2 = BiQuad_QuantizeCoeff(taps->b2, 16, shift);
+    q15->shift = shift;
+    /* report status */
+    return EOK;
+}
+
+/* reset the delay line of the q31 biquad filter */
+void BiQuad_SetTapsQ31(biquad_q31_t *bq, const biquad_q31_taps_t *taps)
+{
+    /* update taps if requested */
+    if (taps) bq->taps = taps;
+    /* reset the delay line */
+    bq->dl[0] = bq->dl[1] = bq->dl[2] = bq->dl[3] = 0;
+}
+
+/* reset the delay line of the q15 biquad filter */
+void BiQuad_SetTapsQ15(biquad_q15_t *bq, const biquad_q15_taps_t *taps)
+{
+    /* update taps if requested */
+    if (taps) bq->taps = taps;
+    /* reset the delay line */
+    bq->dl[0] = bq->dl[1] = bq->dl[2] = bq->dl[3] = 0;
+}
+
+/* biquadratic iir filter for the q31 data, direct form I */
+void OPTIMIZE("O3") LOOP_UNROLL BiQuad_FilterQ31(const int32_t *src, int len, 
+    biquad_q31_t *bq, int32_t *dst)
+{
+    /* taps pointer */
+    const biquad_q31_taps_t *t = bq->taps;
+    /* read the taps */
+    int32_t a1 = t->a1, a2 = t->a2, b0 = t->b0, b1 = t->b1, b2 = t->b2;
+    /* read the delay line */
+    int32_t x1 = bq->dl[0], x2 = bq->dl[1], y1 = bq->dl[2], y2 = bq->dl[3];
+    /* products are in Q(62 - shift) format, this is the right shift needed 
+     * to get back to Q31 and the rounding constant */
+    const int sh = 31 - t->shift; const int64_t rnd = (int64_t)1 << (sh - 1);
 
     /* process all the samples */
     for (int i = 0; i < len; i++) {
-        x = *src++;
-        /* get the output value */
-        y = x * b0 + w1;
-        /* calculate */
-        w1 = x * b1 - y * a1 + w2;
-        w2 = x * b2 - y * a2;
-        /* store data in the destination array */
-        *dst++ = y;
+        /* fetch the sample */
+        int32_t x0 = *src++;
+        /* multiply and accumulate */
+        int64_t acc = Arch_SMLAL(b0, x0, rnd);
+        acc = Arch_SMLAL(b1, x1, acc); acc = Arch_SMLAL(b2, x2, acc);
+        acc = Arch_SMLAL(a1, y1, acc); acc = Arch_SMLAL(a2, y2, acc);
+        /* scale back and saturate */
+        int32_t y0 = BiQuad_Sat64(acc >> sh, 32);
+        /* shift the delay line */
+        x2 = x1, x1 = x0, y2 = y1, y1 = y0;
+        /* store the output value */
+        *dst++ = y0;
     }
 
     /* update the delay line */
-    bq->dl[0] = w1, bq->dl[1] = w2;
-}
\ No newline at end of file
+    bq->dl[0] = x1, bq->dl[1] = x2, bq->dl[2] = y1, bq->dl[3] = y2;
+}
+
+/* biquadratic iir filter for the q15 data, direct form I */
+void OPTIMIZE("O3") LOOP_UNROLL BiQuad_FilterQ15(const int16_t *src, int len, 
+    biquad_q15_t *bq, int16_t *dst)
+{
+    /* taps pointer */
+    const biquad_q15_taps_t *t = bq->taps;
+    /* read the taps */
+    int32_t a1 = t->a1, a2 = t->a2, b0 = t->b0, b1 = t->b1, b2 = t->b2;
+    /* read the delay line */
+    int32_t x1 = bq->dl[0], x2 = bq->dl[1], y1 = bq->dl[2], y2 = bq->dl[3];
+    /* products are in Q(30 - shift) format, this is the right shift needed 
+     * to get back to Q15 and the rounding constant */
+    const int sh = 15 - t->shift; const int64_t rnd = (int64_t)1 << (sh - 1);
+
+    /* process all the samples */
+    for (int i = 0; i < len; i++) {
+        /* fetch the sample */
+        int32_t x0 = *src++;
+        /* multiply and accumulate */
+        int64_t acc = Arch_SMLAL(b0, x0, rnd);
+        acc = Arch_SMLAL(b1, x1, acc); acc = Arch_SMLAL(b2, x2, acc);
+        acc = Arch_SMLAL(a1, y1, acc); acc = Arch_SMLAL(a2, y2, acc);
+        /* scale back and saturate */
+        int32_t y0 = BiQuad_Sat64(acc >> sh, 16);
+        /* shift the delay line */
+        x2 = x1, x1 = x0, y2 = y1, y1 = y0;
+        /* store the output value */
+        *dst++ = y0;
+    }
+
+    /* update the delay line */
+    bq->dl[0] = x1, bq->dl[1] = x2, bq->dl[2] = y1, bq->dl[3] = y2;
+}
@@ -0,0 +1,882 @@
+/**
+ * @file fft.c
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Fast Fourier Transform of the complex data. Data is put in the
+ * bit-reversed order first and then the transforms of length L are merged in
+ * fours into the transforms of length 4L. Every radix-4 butterfly does the
+ * work of two radix-2 stages with 3 complex multiplications instead of 4:
+ *
+ * t0 = A[k], t1 = W(2L)^k * B[k], t2 = W(4L)^k * C[k], t3 = W(4L)^3k * D[k]
+ * X[k] = t0 + t1 + t2 + t3,            X[k + 2L] = t0 + t1 - (t2 + t3)
+ * X[k + L] = t0 - t1 - j(t2 - t3),     X[k + 3L] = t0 - t1 + j(t2 - t3)
+ *
+ * where A, B, C, D are the consecutive transforms of length L (which is what
+ * the bit reversal and the previous stages produce, no digit reversal is
+ * needed). Sizes that are not powers of 4 start with a single radix-2 stage.
+ */
+
+#include <stdint.h>
+
+#include "compiler.h"
+#include "config.h"
+#include "err.h"
+#include "dsp/fft.h"
+
+/* tables below were generated for this size */
+#if FFT_MAX_SIZE != 1024
+#error "twiddle factor tables need to be regenerated"
+#endif
+
+/* twiddle factors: sin(2 * pi * k / FFT_MAX_SIZE) for the whole period. The
+ * twiddle factor exp(-j * 2 * pi * k / FFT_MAX_SIZE) is formed as
+ * tw[k + FFT_MAX_SIZE / 4] - j * tw[k], radix-4 stages use k < 3/4 *
+ * FFT_MAX_SIZE so the index never wraps */
+static const float tw_float[FFT_MAX_SIZE] = {
+    +0.000000e+00, +6.135885e-03, +1.227154e-02, +1.840673e-02,
+    +2.454123e-02, +3.067480e-02, +3.680722e-02, +4.293826e-02,
+    +4.906768e-02, +5.519525e-02, +6.132074e-02, +6.744392e-02,
+    +7.356457e-02, +7.968244e-02, +8.579731e-02, +9.190895e-02,
+    +9.801714e-02, +1.041216e-01, +1.102222e-01, +1.163186e-01,
+    +1.224107e-01, +1.284981e-01, +1.345807e-01, +1.406582e-01,
+    +1.467305e-01, +1.527972e-01, +1.588582e-01, +1.649131e-01,
+    +1.709619e-01, +1.770042e-01, +1.830399e-01, +1.890687e-01,
+    +1.950903e-01, +2.011046e-01, +2.071114e-01, +2.131103e-01,
+    +2.191012e-01, +2.250839e-01, +2.310581e-01, +2.370236e-01,
+    +2.429802e-01, +2.489276e-01, +2.548656e-01, +2.607941e-01,
+    +2.667128e-01, +2.726214e-01, +2.785197e-01, +2.844075e-01,
+    +2.902847e-01, +2.961509e-01, +3.020059e-01, +3.078496e-01,
+    +3.136818e-01, +3.195020e-01, +3.253103e-01, +3.311063e-01,
+    +3.368899e-01, +3.426607e-01, +3.484187e-01, +3.541635e-01,
+    +3.598951e-01, +3.656130e-01, +3.713172e-01, +3.770074e-01,
+    +3.826834e-01, +3.883450e-01, +3.939920e-01, +3.996242e-01,
+    +4.052413e-01, +4.108432e-01, +4.164295e-01, +4.220003e-01,
+    +4.275551e-01, +4.330938e-01, +4.386162e-01, +4.441221e-01,
+    +4.496113e-01, +4.550836e-01, +4.605387e-01, +4.659765e-01,
+    +4.713967e-01, +4.767992e-01, +4.821838e-01, +4.875502e-01,
+    +4.928982e-01, +4.982277e-01, +5.035384e-01, +5.088301e-01,
+    +5.141028e-01, +5.193560e-01, +5.245897e-01, +5.298036e-01,
+    +5.349976e-01, +5.401714e-01, +5.453250e-01, +5.504580e-01,
+    +5.555702e-01, +5.606616e-01, +5.657318e-01, +5.707808e-01,
+    +5.758082e-01, +5.808139e-01, +5.857978e-01, +5.907597e-01,
+    +5.956993e-01, +6.006165e-01, +6.055111e-01, +6.103828e-01,
+    +6.152316e-01, +6.200572e-01, +6.248595e-01, +6.296383e-01,
+    +6.343933e-01, +6.391245e-01, +6.438316e-01, +6.485144e-01,
+    +6.531729e-01, +6.578067e-01, +6.624158e-01, +6.669999e-01,
+    +6.715590e-01, +6.760927e-01, +6.806010e-01, +6.850837e-01,
+    +6.895406e-01, +6.939715e-01, +6.983762e-01, +7.027547e-01,
+    +7.071068e-01, +7.114322e-01, +7.157308e-01, +7.200025e-01,
+    +7.242471e-01, +7.284644e-01, +7.326543e-01, +7.368166e-01,
+    +7.409511e-01, +7.450578e-01, +7.491364e-01, +7.531868e-01,
+    +7.572088e-01, +7.612024e-01, +7.651672e-01, +7.691033e-01,
+    +7.730104e-01, +7.768885e-01, +7.807372e-01, +7.845566e-01,
+    +7.883464e-01, +7.921066e-01, +7.958369e-01, +7.995372e-01,
+    +8.032075e-01, +8.068476e-01, +8.104572e-01, +8.140363e-01,
+    +8.175848e-01, +8.211025e-01, +8.245893e-01, +8.280451e-01,
+    +8.314696e-01, +8.348629e-01, +8.382247e-01, +8.415550e-01,
+    +8.448536e-01, +8.481203e-01, +8.513552e-01, +8.545580e-01,
+    +8.577286e-01, +8.608670e-01, +8.639728e-01, +8.670462e-01,
+    +8.700870e-01, +8.730950e-01, +8.760701e-01, +8.790122e-01,
+    +8.819213e-01, +8.847971e-01, +8.876396e-01, +8.904487e-01,
+    +8.932243e-01, +8.959662e-01, +8.986745e-01, +9.013488e-01,
+    +9.039893e-01, +9.065957e-01, +9.091680e-01, +9.117060e-01,
+    +9.142098e-01, +9.166791e-01, +9.191139e-01, +9.215140e-01,
+    +9.238795e-01, +9.262102e-01, +9.285061e-01, +9.307669e-01,
+    +9.329928e-01, +9.351835e-01, +9.373390e-01, +9.394592e-01,
+    +9.415441e-01, +9.435934e-01, +9.456073e-01, +9.475856e-01,
+    +9.495282e-01, +9.514350e-01, +9.533060e-01, +9.551412e-01,
+    +9.569404e-01, +9.587035e-01, +9.604305e-01, +9.621214e-01,
+    +9.637761e-01, +9.653944e-01, +9.669765e-01, +9.685221e-01,
+    +9.700313e-01, +9.715039e-01, +9.729400e-01, +9.743394e-01,
+    +9.757021e-01, +9.770281e-01, +9.783174e-01, +9.795698e-01,
+    +9.807853e-01, +9.819639e-01, +9.831055e-01, +9.842101e-01,
+    +9.852777e-01, +9.863081e-01, +9.873014e-01, +9.882576e-01,
+    +9.891765e-01, +9.900582e-01, +9.909027e-01, +9.917098e-01,
+    +9.924796e-01, +9.932119e-01, +9.939070e-01, +9.945646e-01,
+    +9.951847e-01, +9.957674e-01, +9.963126e-01, +9.968203e-01,
+    +9.972904e-01, +9.977230e-01, +9.981181e-01, +9.984756e-01,
+    +9.987954e-01, +9.990777e-01, +9.993224e-01, +9.995294e-01,
+    +9.996988e-01, +9.998306e-01, +9.999247e-01, +9.999812e-01,
+    +1.000000e+00, +9.999812e-01, +9.999247e-01, +9.998306e-01,
+    +9.996988e-01, +9.995294e-01, +9.993224e-01, +9.990777e-01,
+    +9.987954e-01, +9.984756e-01, +9.981181e-01, +9.977230e-01,
+    +9.972904e-01, +9.968203e-01, +9.963126e-01, +9.957674e-01,
+    +9.951847e-01, +9.945646e-01, +9.939070e-01, +9.932119e-01,
+    +9.924796e-01, +9.917098e-01, +9.909027e-01, +9.900582e-01,
+    +9.891765e-01, +9.882576e-01, +9.873014e-01, +9.863081e-01,
+    +9.852777e-01, +9.842101e-01, +9.831055e-01, +9.819639e-01,
+    +9.807853e-01, +9.795698e-01, +9.783174e-01, +9.770281e-01,
+    +9.757021e-01, +9.743394e-01, +9.729400e-01, +9.715039e-01,
+    +9.700313e-01, +9.685221e-01, +9.669765e-01, +9.653944e-01,
+    +9.637761e-01, +9.621214e-01, +9.604305e-01, +9.587035e-01,
+    +9.569404e-01, +9.551412e-01, +9.533060e-01, +9.514350e-01,
+    +9.495282e-01, +9.475856e-01, +9.456073e-01, +9.435934e-01,
+    +9.415441e-01, +9.394592e-01, +9.373390e-01, +9.351835e-01,
+    +9.329928e-01, +9.307669e-01, +9.285061e-01, +9.262102e-01,
+    +9.238795e-01, +9.215140e-01, +9.191139e-01, +9.166791e-01,
+    +9.142098e-01, +9.117060e-01, +9.091680e-01, +9.065957e-01,
+    +9.039893e-01, +9.013488e-01, +8.986745e-01, +8.959662e-01,
+    +8.932243e-01, +8.904487e-01, +8.876396e-01, +8.847971e-01,
+    +8.819213e-01, +8.790122e-01, +8.760701e-01, +8.730950e-01,
+    +8.700870e-01, +8.670462e-01, +8.639728e-01, +8.608670e-01,
+    +8.577286e-01, +8.545580e-01, +8.513552e-01, +8.481203e-01,
+    +8.448536e-01, +8.415550e-01, +8.382247e-01, +8.348629e-01,
+    +8.314696e-01, +8.280451e-01, +8.245893e-01, +8.211025e-01,
+    +8.175848e-01, +8.140363e-01, +8.104572e-01, +8.068476e-01,
+    +8.032075e-01, +7.995372e-01, +7.958369e-01, +7.921066e-01,
+    +7.883464e-01, +7.845566e-01, +7.807372e-01, +7.768885e-01,
+    +7.730104e-01, +7.691033e-01, +7.651672e-01, +7.612024e-01,
+    +7.572088e-01, +7.531868e-01, +7.491364e-01, +7.450578e-01,
+    +7.409511e-01, +7.368166e-01, +7.326543e-01, +7.284644e-01,
+    +7.242471e-01, +7.200025e-01, +7.157308e-01, +7.114322e-01,
+    +7.071068e-01, +7.027547e-01, +6.983762e-01, +6.939715e-01,
+    +6.895406e-01, +6.850837e-01, +6.806010e-01, +6.760927e-01,
+    +6.715590e-01, +6.669999e-01, +6.624158e-01, +6.578067e-01,
+    +6.531729e-01, +6.485144e-01, +6.438316e-01, +6.391245e-01,
+    +6.343933e-01, +6.296383e-01, +6.248595e-01, +6.200572e-01,
+    +6.152316e-01, +6.103828e-01, +6.055111e-01, +6.006165e-01,
+    +5.956993e-01, +5.907597e-01, +5.857978e-01, +5.808139e-01,
+    +5.758082e-01, +5.707808e-01, +5.657318e-01, +5.606616e-01,
+    +5.555702e-01, +5.504580e-01, +5.453250e-01, +5.401714e-01,
+    +5.349976e-01, +5.298036e-01, +5.245897e-01, +5.193560e-01,
+    +5.141028e-01, +5.088301e-01, +5.035384e-01, +4.982277e-01,
+    +4.928982e-01, +4.875502e-01, +4.821838e-01, +4.767992e-01,
+    +4.713967e-01, +4.659765e-01, +4.605387e-01, +4.550836e-01,
+    +4.496113e-01, +4.441221e-01, +4.386162e-01, +4.330938e-01,
+    +4.275551e-01, +4.220003e-01, +4.164295e-01, +4.108432e-01,
+    +4.052413e-01, +3.996242e-01, +3.939920e-01, +3.883450e-01,
+    +3.826834e-01, +3.770074e-01, +3.713172e-01, +3.656130e-01,
+    +3.598951e-01, +3.541635e-01, +3.484187e-01, +3.426607e-01,
+    +3.368899e-01, +3.311063e-01, +3.253103e-01, +3.195020e-01,
+    +3.136818e-01, +3.078496e-01, +3.020059e-01, +2.961509e-01,
+    +2.902847e-01, +2.844075e-01, +2.785197e-01, +2.726214e-01,
+    +2.667128e-01, +2.607941e-01, +2.548656e-01, +2.489276e-01,
+    +2.429802e-01, +2.370236e-01, +2.310581e-01, +2.250839e-01,
+    +2.191012e-01, +2.131103e-01, +2.071114e-01, +2.011046e-01,
+    +1.950903e-01, +1.890687e-01, +1.830399e-01, +1.770042e-01,
+    +1.709619e-01, +1.649131e-01, +1.588582e-01, +1.527972e-01,
+    +1.467305e-01, +1.406582e-01, +1.345807e-01, +1.284981e-01,
+    +1.224107e-01, +1.163186e-01, +1.102222e-01, +1.041216e-01,
+    +9.801714e-02, +9.190895e-02, +8.579731e-02, +7.968244e-02,
+    +7.356457e-02, +6.744392e-02, +6.132074e-02, +5.519525e-02,
+    +4.906768e-02, +4.293826e-02, +3.680722e-02, +3.067480e-02,
+    +2.454123e-02, +1.840673e-02, +1.227154e-02, +6.135885e-03,
+    +1.224647e-16, -6.135885e-03, -1.227154e-02, -1.840673e-02,
+    -2.454123e-02, -3.067480e-02, -3.680722e-02, -4.293826e-02,
+    -4.906768e-02, -5.519525e-02, -6.132074e-02, -6.744392e-02,
+    -7.356457e-02, -7.968244e-02, -8.579731e-02, -9.190895e-02,
+    -9.801714e-02, -1.041216e-01, -1.102222e-01, -1.163186e-01,
+    -1.224107e-01, -1.284981e-01, -1.345807e-01, -1.406582e-01,
+    -1.467305e-01, -1.527972e-01, -1.588582e-01, -1.649131e-01,
+    -1.709619e-01, -1.770042e-01, -1.830399e-01, -1.890687e-01,
+    -1.950903e-01, -2.011046e-01, -2.071114e-01, -2.131103e-01,
+    -2.191012e-01, -2.250839e-01, -2.310581e-01, -2.370236e-01,
+    -2.429802e-01, -2.489276e-01, -2.548656e-01, -2.607941e-01,
+    -2.667128e-01, -2.726214e-01, -2.785197e-01, -2.844075e-01,
+    -2.902847e-01, -2.961509e-01, -3.020059e-01, -3.078496e-01,
+    -3.136818e-01, -3.195020e-01, -3.253103e-01, -3.311063e-01,
+    -3.368899e-01, -3.426607e-01, -3.484187e-01, -3.541635e-01,
+    -3.598951e-01, -3.656130e-01, -3.713172e-01, -3.770074e-01,
+    -3.826834e-01, -3.883450e-01, -3.939920e-01, -3.996242e-01,
+    -4.052413e-01, -4.108432e-01, -4.164295e-01, -4.220003e-01,
+    -4.275551e-01, -4.330938e-01, -4.386162e-01, -4.441221e-01,
+    -4.496113e-01, -4.550836e-01, -4.605387e-01, -4.659765e-01,
+    -4.713967e-01, -4.767992e-01, -4.821838e-01, -4.875502e-01,
+    -4.928982e-01, -4.982277e-01, -5.035384e-01, -5.088301e-01,
+    -5.141028e-01, -5.193560e-01, -5.245897e-01, -5.298036e-01,
+    -5.349976e-01, -5.401714e-01, -5.453250e-01, -5.504580e-01,
+    -5.555702e-01, -5.606616e-01, -5.657318e-01, -5.707808e-01,
+    -5.758082e-01, -5.808139e-01, -5.857978e-01, -5.907597e-01,
+    -5.956993e-01, -6.006165e-01, -6.055111e-01, -6.103828e-01,
+    -6.152316e-01, -6.200572e-01, -6.248595e-01, -6.296383e-01,
+    -6.343933e-01, -6.391245e-01, -6.438316e-01, -6.485144e-01,
+    -6.531729e-01, -6.578067e-01, -6.624158e-01, -6.669999e-01,
+    -6.715590e-01, -6.760927e-01, -6.806010e-01, -6.850837e-01,
+    -6.895406e-01, -6.939715e-01, -6.983762e-01, -7.027547e-01,
+    -7.071068e-01, -7.114322e-01, -7.157308e-01, -7.200025e-01,
+    -7.242471e-01, -7.284644e-01, -7.326543e-01, -7.368166e-01,
+    -7.409511e-01, -7.450578e-01, -7.491364e-01, -7.531868e-01,
+    -7.572088e-01, -7.612024e-01, -7.651672e-01, -7.691033e-01,
+    -7.730104e-01, -7.768885e-01, -7.807372e-01, -7.845566e-01,
+    -7.883464e-01, -7.921066e-01, -7.958369e-01, -7.995372e-01,
+    -8.032075e-01, -8.068476e-01, -8.104572e-01, -8.140363e-01,
+    -8.175848e-01, -8.211025e-01, -8.245893e-01, -8.280451e-01,
+    -8.314696e-01, -8.348629e-01, -8.382247e-01, -8.415550e-01,
+    -8.448536e-01, -8.481203e-01, -8.513552e-01, -8.545580e-01,
+    -8.577286e-01, -8.608670e-01, -8.639728e-01, -8.670462e-01,
+    -8.700870e-01, -8.730950e-01, -8.760701e-01, -8.790122e-01,
+    -8.819213e-01, -8.847971e-01, -8.876396e-01, -8.904487e-01,
+    -8.932243e-01, -8.959662e-01, -8.986745e-01, -9.013488e-01,
+    -9.039893e-01, -9.065957e-01, -9.091680e-01, -9.117060e-01,
+    -9.142098e-01, -9.166791e-01, -9.191139e-01, -9.215140e-01,
+    -9.238795e-01, -9.262102e-01, -9.285061e-01, -9.307669e-01,
+    -9.329928e-01, -9.351835e-01, -9.373390e-01, -9.394592e-01,
+    -9.415441e-01, -9.435934e-01, -9.456073e-01, -9.475856e-01,
+    -9.495282e-01, -9.514350e-01, -9.533060e-01, -9.551412e-01,
+    -9.569404e-01, -9.587035e-01, -9.604305e-01, -9.621214e-01,
+    -9.637761e-01, -9.653944e-01, -9.669765e-01, -9.685221e-01,
+    -9.700313e-01, -9.715039e-01, -9.729400e-01, -9.743394e-01,
+    -9.757021e-01, -9.770281e-01, -9.783174e-01, -9.795698e-01,
+    -9.807853e-01, -9.819639e-01, -9.831055e-01, -9.842101e-01,
+    -9.852777e-01, -9.863081e-01, -9.873014e-01, -9.882576e-01,
+    -9.891765e-01, -9.900582e-01, -9.909027e-01, -9.917098e-01,
+    -9.924796e-01, -9.932119e-01, -9.939070e-01, -9.945646e-01,
+    -9.951847e-01, -9.957674e-01, -9.963126e-01, -9.968203e-01,
+    -9.972904e-01, -9.977230e-01, -9.981181e-01, -9.984756e-01,
+    -9.987954e-01, -9.990777e-01, -9.993224e-01, -9.995294e-01,
+    -9.996988e-01, -9.998306e-01, -9.999247e-01, -9.999812e-01,
+    -1.000000e+00, -9.999812e-01, -9.999247e-01, -9.998306e-01,
+    -9.996988e-01, -9.995294e-01, -9.993224e-01, -9.990777e-01,
+    -9.987954e-01, -9.984756e-01, -9.981181e-01, -9.977230e-01,
+    -9.972904e-01, -9.968203e-01, -9.963126e-01, -9.957674e-01,
+    -9.951847e-01, -9.945646e-01, -9.939070e-01, -9.932119e-01,
+    -9.924796e-01, -9.917098e-01, -9.909027e-01, -9.900582e-01,
+    -9.891765e-01, -9.882576e-01, -9.873014e-01, -9.863081e-01,
+    -9.852777e-01, -9.842101e-01, -9.831055e-01, -9.819639e-01,
+    -9.807853e-01, -9.795698e-01, -9.783174e-01, -9.770281e-01,
+    -9.757021e-01, -9.743394e-01, -9.729400e-01, -9.715039e-01,
+    -9.700313e-01, -9.685221e-01, -9.669765e-01, -9.653944e-01,
+    -9.637761e-01, -9.621214e-01, -9.604305e-01, -9.587035e-01,
+    -9.569404e-01, -9.551412e-01, -9.533060e-01, -9.514350e-01,
+    -9.495282e-01, -9.475856e-01, -9.456073e-01, -9.435934e-01,
+    -9.415441e-01, -9.394592e-01, -9.373390e-01, -9.351835e-01,
+    -9.329928e-01, -9.307669e-01, -9.285061e-01, -9.262102e-01,
+    -9.238795e-01, -9.215140e-01, -9.191139e-01, -9.166791e-01,
+    -9.142098e-01, -9.117060e-01, -9.091680e-01, -9.065957e-01,
+    -9.039893e-01, -9.013488e-01, -8.986745e-01, -8.959662e-01,
+    -8.932243e-01, -8.904487e-01, -8.876396e-01, -8.847971e-01,
+    -8.819213e-01, -8.790122e-01, -8.760701e-01, -8.730950e-01,
+    -8.700870e-01, -8.670462e-01, -8.639728e-01, -8.608670e-01,
+    -8.577286e-01, -8.545580e-01, -8.513552e-01, -8.481203e-01,
+    -8.448536e-01, -8.415550e-01, -8.382247e-01, -8.348629e-01,
+    -8.314696e-01, -8.280451e-01, -8.245893e-01, -8.211025e-01,
+    -8.175848e-01, -8.140363e-01, -8.104572e-01, -8.068476e-01,
+    -8.032075e-01, -7.995372e-01, -7.958369e-01, -7.921066e-01,
+    -7.883464e-01, -7.845566e-01, -7.807372e-01, -7.768885e-01,
+    -7.730104e-01, -7.691033e-01, -7.651672e-01, -7.612024e-01,
+    -7.572088e-01, -7.531868e-01, -7.491364e-01, -7.450578e-01,
+    -7.409511e-01, -7.368166e-01, -7.326543e-01, -7.284644e-01,
+    -7.242471e-01, -7.200025e-01, -7.157308e-01, -7.114322e-01,
+    -7.071068e-01, -7.027547e-01, -6.983762e-01, -6.939715e-01,
+    -6.895406e-01, -6.850837e-01, -6.806010e-01, -6.760927e-01,
+    -6.715590e-01, -6.669999e-01, -6.624158e-01, -6.578067e-01,
+    -6.531729e-01, -6.485144e-01, -6.438316e-01, -6.391245e-01,
+    -6.343933e-01, -6.296383e-01, -6.248595e-01, -6.200572e-01,
+    -6.152316e-01, -6.103828e-01, -6.055111e-01, -6.006165e-01,
+    -5.956993e-01, -5.907597e-01, -5.857978e-01, -5.808139e-01,
+    -5.758082e-01, -5.707808e-01, -5.657318e-01, -5.606616e-01,
+    -5.555702e-01, -5.504580e-01, -5.453250e-01, -5.401714e-01,
+    -5.349976e-01, -5.298036e-01, -5.245897e-01, -5.193560e-01,
+    -5.141028e-01, -5.088301e-01, -5.035384e-01, -4.982277e-01,
+    -4.928982e-01, -4.875502e-01, -4.821838e-01, -4.767992e-01,
+    -4.713967e-01, -4.659765e-01, -4.605387e-01, -4.550836e-01,
+    -4.496113e-01, -4.441221e-01, -4.386162e-01, -4.330938e-01,
+    -4.275551e-01, -4.220003e-01, -4.164295e-01, -4.108432e-01,
+    -4.052413e-01, -3.996242e-01, -3.939920e-01, -3.883450e-01,
+    -3.826834e-01, -3.770074e-01, -3.713172e-01, -3.656130e-01,
+    -3.598951e-01, -3.541635e-01, -3.484187e-01, -3.426607e-01,
+    -3.368899e-01, -3.311063e-01, -3.253103e-01, -3.195020e-01,
+    -3.136818e-01, -3.078496e-01, -3.020059e-01, -2.961509e-01,
+    -2.902847e-01, -2.844075e-01, -2.785197e-01, -2.726214e-01,
+    -2.667128e-01, -2.607941e-01, -2.548656e-01, -2.489276e-01,
+    -2.429802e-01, -2.370236e-01, -2.310581e-01, -2.250839e-01,
+    -2.191012e-01, -2.131103e-01, -2.071114e-01, -2.011046e-01,
+    -1.950903e-01, -1.890687e-01, -1.830399e-01, -1.770042e-01,
+    -1.709619e-01, -1.649131e-01, -1.588582e-01, -1.527972e-01,
+    -1.467305e-01, -1.406582e-01, -1.345807e-01, -1.284981e-01,
+    -1.224107e-01, -1.163186e-01, -1.102222e-01, -1.041216e-01,
+    -9.801714e-02, -9.190895e-02, -8.579731e-02, -7.968244e-02,
+    -7.356457e-02, -6.744392e-02, -6.132074e-02, -5.519525e-02,
+    -4.906768e-02, -4.293826e-02, -3.680722e-02, -3.067480e-02,
+    -2.454123e-02, -1.840673e-02, -1.227154e-02, -6.135885e-03,
+};
+
+/* same as above, Q31 */
+static const int32_t tw_q31[FFT_MAX_SIZE] = {
+    +0x00000000, +0x00c90f88, +0x01921d20, +0x025b26d7, +0x03242abf,
+    +0x03ed26e6, +0x04b6195d, +0x057f0035, +0x0647d97c, +0x0710a345,
+    +0x07d95b9e, +0x08a2009a, +0x096a9049, +0x0a3308bd, +0x0afb6805,
+    +0x0bc3ac35, +0x0c8bd35e, +0x0d53db92, +0x0e1bc2e4, +0x0ee38766,
+    +0x0fab272b, +0x1072a048, +0x1139f0cf, +0x120116d5, +0x12c8106f,
+    +0x138edbb1, +0x145576b1, +0x151bdf86, +0x15e21445, +0x16a81305,
+    +0x176dd9de, +0x183366e9, +0x18f8b83c, +0x19bdcbf3, +0x1a82a026,
+    +0x1b4732ef, +0x1c0b826a, +0x1ccf8cb3, +0x1d934fe5, +0x1e56ca1e,
+    +0x1f19f97b, +0x1fdcdc1b, +0x209f701c, +0x2161b3a0, +0x2223a4c5,
+    +0x22e541af, +0x23a6887f, +0x24677758, +0x25280c5e, +0x25e845b6,
+    +0x26a82186, +0x27679df4, +0x2826b928, +0x28e5714b, +0x29a3c485,
+    +0x2a61b101, +0x2b1f34eb, +0x2bdc4e6f, +0x2c98fbba, +0x2d553afc,
+    +0x2e110a62, +0x2ecc681e, +0x2f875262, +0x3041c761, +0x30fbc54d,
+    +0x31b54a5e, +0x326e54c7, +0x3326e2c3, +0x33def287, +0x34968250,
+    +0x354d9057, +0x36041ad9, +0x36ba2014, +0x376f9e46, +0x382493b0,
+    +0x38d8fe93, +0x398cdd32, +0x3a402dd2, +0x3af2eeb7, +0x3ba51e29,
+    +0x3c56ba70, +0x3d07c1d6, +0x3db832a6, +0x3e680b2c, +0x3f1749b8,
+    +0x3fc5ec98, +0x4073f21d, +0x4121589b, +0x41ce1e65, +0x427a41d0,
+    +0x4325c135, +0x43d09aed, +0x447acd50, +0x452456bd, +0x45cd358f,
+    +0x46756828, +0x471cece7, +0x47c3c22f, +0x4869e665, +0x490f57ee,
+    +0x49b41533, +0x4a581c9e, +0x4afb6c98, +0x4b9e0390, +0x4c3fdff4,
+    +0x4ce10034, +0x4d8162c4, +0x4e210617, +0x4ebfe8a5, +0x4f5e08e3,
+    +0x4ffb654d, +0x5097fc5e, +0x5133cc94, +0x51ced46e, +0x5269126e,
+    +0x53028518, +0x539b2af0, +0x5433027d, +0x54ca0a4b, +0x556040e2,
+    +0x55f5a4d2, +0x568a34a9, +0x571deefa, +0x57b0d256, +0x5842dd54,
+    +0x58d40e8c, +0x59646498, +0x59f3de12, +0x5a82799a, +0x5b1035cf,
+    +0x5b9d1154, +0x5c290acc, +0x5cb420e0, +0x5d3e5237, +0x5dc79d7c,
+    +0x5e50015d, +0x5ed77c8a, +0x5f5e0db3, +0x5fe3b38d, +0x60686ccf,
+    +0x60ec3830, +0x616f146c, +0x61f1003f, +0x6271fa69, +0x62f201ac,
+    +0x637114cc, +0x63ef3290, +0x646c59bf, +0x64e88926, +0x6563bf92,
+    +0x65ddfbd3, +0x66573cbb, +0x66cf8120, +0x6746c7d8, +0x67bd0fbd,
+    +0x683257ab, +0x68a69e81, +0x6919e320, +0x698c246c, +0x69fd614a,
+    +0x6a6d98a4, +0x6adcc964, +0x6b4af279, +0x6bb812d1, +0x6c242960,
+    +0x6c8f351c, +0x6cf934fc, +0x6d6227fa, +0x6dca0d14, +0x6e30e34a,
+    +0x6e96a99d, +0x6efb5f12, +0x6f5f02b2, +0x6fc19385, +0x7023109a,
+    +0x708378ff, +0x70e2cbc6, +0x71410805, +0x719e2cd2, +0x71fa3949,
+    +0x72552c85, +0x72af05a7, +0x7307c3d0, +0x735f6626, +0x73b5ebd1,
+    +0x740b53fb, +0x745f9dd1, +0x74b2c884, +0x7504d345, +0x7555bd4c,
+    +0x75a585cf, +0x75f42c0b, +0x7641af3d, +0x768e0ea6, +0x76d94989,
+    +0x77235f2d, +0x776c4edb, +0x77b417df, +0x77fab989, +0x78403329,
+    +0x78848414, +0x78c7aba2, +0x7909a92d, +0x794a7c12, +0x798a23b1,
+    +0x79c89f6e, +0x7a05eead, +0x7a4210d8, +0x7a7d055b, +0x7ab6cba4,
+    +0x7aef6323, +0x7b26cb4f, +0x7b5d039e, +0x7b920b89, +0x7bc5e290,
+    +0x7bf88830, +0x7c29fbee, +0x7c5a3d50, +0x7c894bde, +0x7cb72724,
+    +0x7ce3ceb2, +0x7d0f4218, +0x7d3980ec, +0x7d628ac6, +0x7d8a5f40,
+    +0x7db0fdf8, +0x7dd6668f, +0x7dfa98a8, +0x7e1d93ea, +0x7e3f57ff,
+    +0x7e5fe493, +0x7e7f3957, +0x7e9d55fc, +0x7eba3a39, +0x7ed5e5c6,
+    +0x7ef05860, +0x7f0991c4, +0x7f2191b4, +0x7f3857f6, +0x7f4de451,
+    +0x7f62368f, +0x7f754e80, +0x7f872bf3, +0x7f97cebd, +0x7fa736b4,
+    +0x7fb563b3, +0x7fc25596, +0x7fce0c3e, +0x7fd8878e, +0x7fe1c76b,
+    +0x7fe9cbc0, +0x7ff09478, +0x7ff62182, +0x7ffa72d1, +0x7ffd885a,
+    +0x7fff6216, +0x7fffffff, +0x7fff6216, +0x7ffd885a, +0x7ffa72d1,
+    +0x7ff62182, +0x7ff09478, +0x7fe9cbc0, +0x7fe1c76b, +0x7fd8878e,
+    +0x7fce0c3e, +0x7fc25596, +0x7fb563b3, +0x7fa736b4, +0x7f97cebd,
+    +0x7f872bf3, +0x7f754e80, +0x7f62368f, +0x7f4de451, +0x7f3857f6,
+    +0x7f2191b4, +0x7f0991c4, +0x7ef05860, +0x7ed5e5c6, +0x7eba3a39,
+    +0x7e9d55fc, +0x7e7f3957, +0x7e5fe493, +0x7e3f57ff, +0x7e1d93ea,
+    +0x7dfa98a8, +0x7dd6668f, +0x7db0fdf8, +0x7d8a5f40, +0x7d628ac6,
+    +0x7d3980ec, +0x7d0f4218, +0x7ce3ceb2, +0x7cb72724, +0x7c894bde,
+    +0x7c5a3d50, +0x7c29fbee, +0x7bf88830, +0x7bc5e290, +0x7b920b89,
+    +0x7b5d039e, +0x7b26cb4f, +0x7aef6323, +0x7ab6cba4, +0x7a7d055b,
+    +0x7a4210d8, +0x7a05eead, +0x79c89f6e, +0x798a23b1, +0x794a7c12,
+    +0x7909a92d, +0x78c7aba2, +0x78848414, +0x78403329, +0x77fab989,
+    +0x77b417df, +0x776c4edb, +0x77235f2d, +0x76d94989, +0x768e0ea6,
+    +0x7641af3d, +0x75f42c0b, +0x75a585cf, +0x7555bd4c, +0x7504d345,
+    +0x74b2c884, +0x745f9dd1, +0x740b53fb, +0x73b5ebd1, +0x735f6626,
+    +0x7307c3d0, +0x72af05a7, +0x72552c85, +0x71fa3949, +0x719e2cd2,
+    +0x71410805, +0x70e2cbc6, +0x708378ff, +0x7023109a, +0x6fc19385,
+    +0x6f5f02b2, +0x6efb5f12, +0x6e96a99d, +0x6e30e34a, +0x6dca0d14,
+    +0x6d6227fa, +0x6cf934fc, +0x6c8f351c, +0x6c242960, +0x6bb812d1,
+    +0x6b4af279, +0x6adcc964, +0x6a6d98a4, +0x69fd614a, +0x698c246c,
+    +0x6919e320, +0x68a69e81, +0x683257ab, +0x67bd0fbd, +0x6746c7d8,
+    +0x66cf8120, +0x66573cbb, +0x65ddfbd3, +0x6563bf92, +0x64e88926,
+    +0x646c59bf, +0x63ef3290, +0x637114cc, +0x62f201ac, +0x6271fa69,
+    +0x61f1003f, +0x616f146c, +0x60ec3830, +0x60686ccf, +0x5fe3b38d,
+    +0x5f5e0db3, +0x5ed77c8a, +0x5e50015d, +0x5dc79d7c, +0x5d3e5237,
+    +0x5cb420e0, +0x5c290acc, +0x5b9d1154, +0x5b1035cf, +0x5a82799a,
+    +0x59f3de12, +0x59646498, +0x58d40e8c, +0x5842dd54, +0x57b0d256,
+    +0x571deefa, +0x568a34a9, +0x55f5a4d2, +0x556040e2, +0x54ca0a4b,
+    +0x5433027d, +0x539b2af0, +0x53028518, +0x5269126e, +0x51ced46e,
+    +0x5133cc94, +0x5097fc5e, +0x4ffb654d, +0x4f5e08e3, +0x4ebfe8a5,
+    +0x4e210617, +0x4d8162c4, +0x4ce10034, +0x4c3fdff4, +0x4b9e0390,
+    +0x4afb6c98, +0x4a581c9e, +0x49b41533, +0x490f57ee, +0x4869e665,
+    +0x47c3c22f, +0x471cece7, +0x46756828, +0x45cd358f, +0x452456bd,
+    +0x447acd50, +0x43d09aed, +0x4325c135, +0x427a41d0, +0x41ce1e65,
+    +0x4121589b, +0x4073f21d, +0x3fc5ec98, +0x3f1749b8, +0x3e680b2c,
+    +0x3db832a6, +0x3d07c1d6, +0x3c56ba70, +0x3ba51e29, +0x3af2eeb7,
+    +0x3a402dd2, +0x398cdd32, +0x38d8fe93, +0x382493b0, +0x376f9e46,
+    +0x36ba2014, +0x36041ad9, +0x354d9057, +0x34968250, +0x33def287,
+    +0x3326e2c3, +0x326e54c7, +0x31b54a5e, +0x30fbc54d, +0x3041c761,
+    +0x2f875262, +0x2ecc681e, +0x2e110a62, +0x2d553afc, +0x2c98fbba,
+    +0x2bdc4e6f, +0x2b1f34eb, +0x2a61b101, +0x29a3c485, +0x28e5714b,
+    +0x2826b928, +0x27679df4, +0x26a82186, +0x25e845b6, +0x25280c5e,
+    +0x24677758, +0x23a6887f, +0x22e541af, +0x2223a4c5, +0x2161b3a0,
+    +0x209f701c, +0x1fdcdc1b, +0x1f19f97b, +0x1e56ca1e, +0x1d934fe5,
+    +0x1ccf8cb3, +0x1c0b826a, +0x1b4732ef, +0x1a82a026, +0x19bdcbf3,
+    +0x18f8b83c, +0x183366e9, +0x176dd9de, +0x16a81305, +0x15e21445,
+    +0x151bdf86, +0x145576b1, +0x138edbb1, +0x12c8106f, +0x120116d5,
+    +0x1139f0cf, +0x1072a048, +0x0fab272b, +0x0ee38766, +0x0e1bc2e4,
+    +0x0d53db92, +0x0c8bd35e, +0x0bc3ac35, +0x0afb6805, +0x0a3308bd,
+    +0x096a9049, +0x08a2009a, +0x07d95b9e, +0x0710a345, +0x0647d97c,
+    +0x057f0035, +0x04b6195d, +0x03ed26e6, +0x03242abf, +0x025b26d7,
+    +0x01921d20, +0x00c90f88, +0x00000000, -0x00c90f88, -0x01921d20,
+    -0x025b26d7, -0x03242abf, -0x03ed26e6, -0x04b6195d, -0x057f0035,
+    -0x0647d97c, -0x0710a345, -0x07d95b9e, -0x08a2009a, -0x096a9049,
+    -0x0a3308bd, -0x0afb6805, -0x0bc3ac35, -0x0c8bd35e, -0x0d53db92,
+    -0x0e1bc2e4, -0x0ee38766, -0x0fab272b, -0x1072a048, -0x1139f0cf,
+    -0x120116d5, -0x12c8106f, -0x138edbb1, -0x145576b1, -0x151bdf86,
+    -0x15e21445, -0x16a81305, -0x176dd9de, -0x183366e9, -0x18f8b83c,
+    -0x19bdcbf3, -0x1a82a026, -0x1b4732ef, -0x1c0b826a, -0x1ccf8cb3,
+    -0x1d934fe5, -0x1e56ca1e, -0x1f19f97b, -0x1fdcdc1b, -0x209f701c,
+    -0x2161b3a0, -0x2223a4c5, -0x22e541af, -0x23a6887f, -0x24677758,
+    -0x25280c5e, -0x25e845b6, -0x26a82186, -0x27679df4, -0x2826b928,
+    -0x28e5714b, -0x29a3c485, -0x2a61b101, -0x2b1f34eb, -0x2bdc4e6f,
+    -0x2c98fbba, -0x2d553afc, -0x2e110a62, -0x2ecc681e, -0x2f875262,
+    -0x3041c761, -0x30fbc54d, -0x31b54a5e, -0x326e54c7, -0x3326e2c3,
+    -0x33def287, -0x34968250, -0x354d9057, -0x36041ad9, -0x36ba2014,
+    -0x376f9e46, -0x382493b0, -0x38d8fe93, -0x398cdd32, -0x3a402dd2,
+    -0x3af2eeb7, -0x3ba51e29, -0x3c56ba70, -0x3d07c1d6, -0x3db832a6,
+    -0x3e680b2c, -0x3f1749b8, -0x3fc5ec98, -0x4073f21d, -0x4121589b,
+    -0x41ce1e65, -0x427a41d0, -0x4325c135, -0x43d09aed, -0x447acd50,
+    -0x452456bd, -0x45cd358f, -0x46756828, -0x471cece7, -0x47c3c22f,
+    -0x4869e665, -0x490f57ee, -0x49b41533, -0x4a581c9e, -0x4afb6c98,
+    -0x4b9e0390, -0x4c3fdff4, -0x4ce10034, -0x4d8162c4, -0x4e210617,
+    -0x4ebfe8a5, -0x4f5e08e3, -0x4ffb654d, -0x5097fc5e, -0x5133cc94,
+    -0x51ced46e, -0x5269126e, -0x53028518, -0x539b2af0, -0x5433027d,
+    -0x54ca0a4b, -0x556040e2, -0x55f5a4d2, -0x568a34a9, -0x571deefa,
+    -0x57b0d256, -0x5842dd54, -0x58d40e8c, -0x59646498, -0x59f3de12,
+    -0x5a82799a, -0x5b1035cf, -0x5b9d1154, -0x5c290acc, -0x5cb420e0,
+    -0x5d3e5237, -0x5dc79d7c, -0x5e50015d, -0x5ed77c8a, -0x5f5e0db3,
+    -0x5fe3b38d, -0x60686ccf, -0x60ec3830, -0x616f146c, -0x61f1003f,
+    -0x6271fa69, -0x62f201ac, -0x637114cc, -0x63ef3290, -0x646c59bf,
+    -0x64e88926, -0x6563bf92, -0x65ddfbd3, -0x66573cbb, -0x66cf8120,
+    -0x6746c7d8, -0x67bd0fbd, -0x683257ab, -0x68a69e81, -0x6919e320,
+    -0x698c246c, -0x69fd614a, -0x6a6d98a4, -0x6adcc964, -0x6b4af279,
+    -0x6bb812d1, -0x6c242960, -0x6c8f351c, -0x6cf934fc, -0x6d6227fa,
+    -0x6dca0d14, -0x6e30e34a, -0x6e96a99d, -0x6efb5f12, -0x6f5f02b2,
+    -0x6fc19385, -0x7023109a, -0x708378ff, -0x70e2cbc6, -0x71410805,
+    -0x719e2cd2, -0x71fa3949, -0x72552c85, -0x72af05a7, -0x7307c3d0,
+    -0x735f6626, -0x73b5ebd1, -0x740b53fb, -0x745f9dd1, -0x74b2c884,
+    -0x7504d345, -0x7555bd4c, -0x75a585cf, -0x75f42c0b, -0x7641af3d,
+    -0x768e0ea6, -0x76d94989, -0x77235f2d, -0x776c4edb, -0x77b417df,
+    -0x77fab989, -0x78403329, -0x78848414, -0x78c7aba2, -0x7909a92d,
+    -0x794a7c12, -0x798a23b1, -0x79c89f6e, -0x7a05eead, -0x7a4210d8,
+    -0x7a7d055b, -0x7ab6cba4, -0x7aef6323, -0x7b26cb4f, -0x7b5d039e,
+    -0x7b920b89, -0x7bc5e290, -0x7bf88830, -0x7c29fbee, -0x7c5a3d50,
+    -0x7c894bde, -0x7cb72724, -0x7ce3ceb2, -0x7d0f4218, -0x7d3980ec,
+    -0x7d628ac6, -0x7d8a5f40, -0x7db0fdf8, -0x7dd6668f, -0x7dfa98a8,
+    -0x7e1d93ea, -0x7e3f57ff, -0x7e5fe493, -0x7e7f3957, -0x7e9d55fc,
+    -0x7eba3a39, -0x7ed5e5c6, -0x7ef05860, -0x7f0991c4, -0x7f2191b4,
+    -0x7f3857f6, -0x7f4de451, -0x7f62368f, -0x7f754e80, -0x7f872bf3,
+    -0x7f97cebd, -0x7fa736b4, -0x7fb563b3, -0x7fc25596, -0x7fce0c3e,
+    -0x7fd8878e, -0x7fe1c76b, -0x7fe9cbc0, -0x7ff09478, -0x7ff62182,
+    -0x7ffa72d1, -0x7ffd885a, -0x7fff6216, -0x7fffffff, -0x7fff6216,
+    -0x7ffd885a, -0x7ffa72d1, -0x7ff62182, -0x7ff09478, -0x7fe9cbc0,
+    -0x7fe1c76b, -0x7fd8878e, -0x7fce0c3e, -0x7fc25596, -0x7fb563b3,
+    -0x7fa736b4, -0x7f97cebd, -0x7f872bf3, -0x7f754e80, -0x7f62368f,
+    -0x7f4de451, -0x7f3857f6, -0x7f2191b4, -0x7f0991c4, -0x7ef05860,
+    -0x7ed5e5c6, -0x7eba3a39, -0x7e9d55fc, -0x7e7f3957, -0x7e5fe493,
+    -0x7e3f57ff, -0x7e1d93ea, -0x7dfa98a8, -0x7dd6668f, -0x7db0fdf8,
+    -0x7d8a5f40, -0x7d628ac6, -0x7d3980ec, -0x7d0f4218, -0x7ce3ceb2,
+    -0x7cb72724, -0x7c894bde, -0x7c5a3d50, -0x7c29fbee, -0x7bf88830,
+    -0x7bc5e290, -0x7b920b89, -0x7b5d039e, -0x7b26cb4f, -0x7aef6323,
+    -0x7ab6cba4, -0x7a7d055b, -0x7a4210d8, -0x7a05eead, -0x79c89f6e,
+    -0x798a23b1, -0x794a7c12, -0x7909a92d, -0x78c7aba2, -0x78848414,
+    -0x78403329, -0x77fab989, -0x77b417df, -0x776c4edb, -0x77235f2d,
+    -0x76d94989, -0x768e0ea6, -0x7641af3d, -0x75f42c0b, -0x75a585cf,
+    -0x7555bd4c, -0x7504d345, -0x74b2c884, -0x745f9dd1, -0x740b53fb,
+    -0x73b5ebd1, -0x735f6626, -0x7307c3d0, -0x72af05a7, -0x72552c85,
+    -0x71fa3949, -0x719e2cd2, -0x71410805, -0x70e2cbc6, -0x708378ff,
+    -0x7023109a, -0x6fc19385, -0x6f5f02b2, -0x6efb5f12, -0x6e96a99d,
+    -0x6e30e34a, -0x6dca0d14, -0x6d6227fa, -0x6cf934fc, -0x6c8f351c,
+    -0x6c242960, -0x6bb812d1, -0x6b4af279, -0x6adcc964, -0x6a6d98a4,
+    -0x69fd614a, -0x698c246c, -0x6919e320, -0x68a69e81, -0x683257ab,
+    -0x67bd0fbd, -0x6746c7d8, -0x66cf8120, -0x66573cbb, -0x65ddfbd3,
+    -0x6563bf92, -0x64e88926, -0x646c59bf, -0x63ef3290, -0x637114cc,
+    -0x62f201ac, -0x6271fa69, -0x61f1003f, -0x616f146c, -0x60ec3830,
+    -0x60686ccf, -0x5fe3b38d, -0x5f5e0db3, -0x5ed77c8a, -0x5e50015d,
+    -0x5dc79d7c, -0x5d3e5237, -0x5cb420e0, -0x5c290acc, -0x5b9d1154,
+    -0x5b1035cf, -0x5a82799a, -0x59f3de12, -0x59646498, -0x58d40e8c,
+    -0x5842dd54, -0x57b0d256, -0x571deefa, -0x568a34a9, -0x55f5a4d2,
+    -0x556040e2, -0x54ca0a4b, -0x5433027d, -0x539b2af0, -0x53028518,
+    -0x5269126e, -0x51ced46e, -0x5133cc94, -0x5097fc5e, -0x4ffb654d,
+    -0x4f5e08e3, -0x4ebfe8a5, -0x4e210617, -0x4d8162c4, -0x4ce10034,
+    -0x4c3fdff4, -0x4b9e0390, -0x4afb6c98, -0x4a581c9e, -0x49b41533,
+    -0x490f57ee, -0x4869e665, -0x47c3c22f, -0x471cece7, -0x46756828,
+    -0x45cd358f, -0x452456bd, -0x447acd50, -0x43d09aed, -0x4325c135,
+    -0x427a41d0, -0x41ce1e65, -0x4121589b, -0x4073f21d, -0x3fc5ec98,
+    -0x3f1749b8, -0x3e680b2c, -0x3db832a6, -0x3d07c1d6, -0x3c56ba70,
+    -0x3ba51e29, -0x3af2eeb7, -0x3a402dd2, -0x398cdd32, -0x38d8fe93,
+    -0x382493b0, -0x376f9e46, -0x36ba2014, -0x36041ad9, -0x354d9057,
+    -0x34968250, -0x33def287, -0x3326e2c3, -0x326e54c7, -0x31b54a5e,
+    -0x30fbc54d, -0x3041c761, -0x2f875262, -0x2ecc681e, -0x2e110a62,
+    -0x2d553afc, -0x2c98fbba, -0x2bdc4e6f, -0x2b1f34eb, -0x2a61b101,
+    -0x29a3c485, -0x28e5714b, -0x2826b928, -0x27679df4, -0x26a82186,
+    -0x25e845b6, -0x25280c5e, -0x24677758, -0x23a6887f, -0x22e541af,
+    -0x2223a4c5, -0x2161b3a0, -0x209f701c, -0x1fdcdc1b, -0x1f19f97b,
+    -0x1e56ca1e, -0x1d934fe5, -0x1ccf8cb3, -0x1c0b826a, -0x1b4732ef,
+    -0x1a82a026, -0x19bdcbf3, -0x18f8b83c, -0x183366e9, -0x176dd9de,
+    -0x16a81305, -0x15e21445, -0x151bdf86, -0x145576b1, -0x138edbb1,
+    -0x12c8106f, -0x120116d5, -0x1139f0cf, -0x1072a048, -0x0fab272b,
+    -0x0ee38766, -0x0e1bc2e4, -0x0d53db92, -0x0c8bd35e, -0x0bc3ac35,
+    -0x0afb6805, -0x0a3308bd, -0x096a9049, -0x08a2009a, -0x07d95b9e,
+    -0x0710a345, -0x0647d97c, -0x057f0035, -0x04b6195d, -0x03ed26e6,
+    -0x03242abf, -0x025b26d7, -0x01921d20, -0x00c90f88,
+};
+
+/* same as above, Q15 */
+static const int16_t tw_q15[FFT_MAX_SIZE] = {
+        +0,   +201,   +402,   +603,   +804,  +1005,  +1206,  +1407,
+     +1608,  +1809,  +2009,  +2210,  +2411,  +2611,  +2811,  +3012,
+     +3212,  +3412,  +3612,  +3812,  +4011,  +4211,  +4410,  +4609,
+     +4808,  +5007,  +5205,  +5404,  +5602,  +5800,  +5998,  +6195,
+     +6393,  +6590,  +6787,  +6983,  +7180,  +7376,  +7571,  +7767,
+     +7962,  +8157,  +8351,  +8546,  +8740,  +8933,  +9127,  +9319,
+     +9512,  +9704,  +9896, +10088, +10279, +10469, +10660, +10850,
+    +11039, +11228, +11417, +11605, +11793, +11980, +12167, +12354,
+    +12540, +12725, +12910, +13095, +13279, +13463, +13646, +13828,
+    +14010, +14192, +14373, +14553, +14733, +14912, +15091, +15269,
+    +15447, +15624, +15800, +15976, +16151, +16326, +16500, +16673,
+    +16846, +17018, +17190, +17361, +17531, +17700, +17869, +18037,
+    +18205, +18372, +18538, +18703, +18868, +19032, +19195, +19358,
+    +19520, +19681, +19841, +20001, +20160, +20318, +20475, +20632,
+    +20788, +20943, +21097, +21251, +21403, +21555, +21706, +21856,
+    +22006, +22154, +22302, +22449, +22595, +22740, +22884, +23028,
+    +23170, +23312, +23453, +23593, +23732, +23870, +24008, +24144,
+    +24279, +24414, +24548, +24680, +24812, +24943, +25073, +25202,
+    +25330, +25457, +25583, +25708, +25833, +25956, +26078, +26199,
+    +26320, +26439, +26557, +26674, +26791, +26906, +27020, +27133,
+    +27246, +27357, +27467, +27576, +27684, +27791, +27897, +28002,
+    +28106, +28209, +28311, +28411, +28511, +28610, +28707, +28803,
+    +28899, +28993, +29086, +29178, +29269, +29359, +29448, +29535,
+    +29622, +29707, +29792, +29875, +29957, +30038, +30118, +30196,
+    +30274, +30350, +30425, +30499, +30572, +30644, +30715, +30784,
+    +30853, +30920, +30986, +31050, +31114, +31177, +31238, +31298,
+    +31357, +31415, +31471, +31527, +31581, +31634, +31686, +31737,
+    +31786, +31834, +31881, +31927, +31972, +32015, +32058, +32099,
+    +32138, +32177, +32214, +32251, +32286, +32319, +32352, +32383,
+    +32413, +32442, +32470, +32496, +32522, +32546, +32568, +32590,
+    +32610, +32629, +32647, +32664, +32679, +32693, +32706, +32718,
+    +32729, +32738, +32746, +32753, +32758, +32762, +32766, +32767,
+    +32767, +32767, +32766, +32762, +32758, +32753, +32746, +32738,
+    +32729, +32718, +32706, +32693, +32679, +32664, +32647, +32629,
+    +32610, +32590, +32568, +32546, +32522, +32496, +32470, +32442,
+    +32413, +32383, +32352, +32319, +32286, +32251, +32214, +32177,
+    +32138, +32099, +32058, +32015, +31972, +31927, +31881, +31834,
+    +31786, +31737, +31686, +31634, +31581, +31527, +31471, +31415,
+    +31357, +31298, +31238, +31177, +31114, +31050, +30986, +30920,
+    +30853, +30784, +30715, +30644, +30572, +30499, +30425, +30350,
+    +30274, +30196, +30118, +30038, +29957, +29875, +29792, +29707,
+    +29622, +29535, +29448, +29359, +29269, +29178, +29086, +28993,
+    +28899, +28803, +28707, +28610, +28511, +28411, +28311, +28209,
+    +28106, +28002, +27897, +27791, +27684, +27576, +27467, +27357,
+    +27246, +27133, +27020, +26906, +26791, +26674, +26557, +26439,
+    +26320, +26199, +26078, +25956, +25833, +25708, +25583, +25457,
+    +25330, +25202, +25073, +24943, +24812, +24680, +24548, +24414,
+    +24279, +24144, +24008, +23870, +23732, +23593, +23453, +23312,
+    +23170, +23028, +22884, +22740, +22595, +22449, +22302, +22154,
+    +22006, +21856, +21706, +21555, +21403, +21251, +21097, +20943,
+    +20788, +20632, +20475, +20318, +20160, +20001, +19841, +19681,
+    +19520, +19358, +19195, +19032, +18868, +18703, +18538, +18372,
+    +18205, +18037, +17869, +17700, +17531, +17361, +17190, +17018,
+    +16846, +16673, +16500, +16326, +16151, +15976, +15800, +15624,
+    +15447, +15269, +15091, +14912, +14733, +14553, +14373, +14192,
+    +14010, +13828, +13646, +13463, +13279, +13095, +12910, +12725,
+    +12540, +12354, +12167, +11980, +11793, +11605, +11417, +11228,
+    +11039, +10850, +10660, +10469, +10279, +10088,  +9896,  +9704,
+     +9512,  +9319,  +9127,  +8933,  +8740,  +8546,  +8351,  +8157,
+     +7962,  +7767,  +7571,  +7376,  +7180,  +6983,  +6787,  +6590,
+     +6393,  +6195,  +5998,  +5800,  +5602,  +5404,  +5205,  +5007,
+     +4808,  +4609,  +4410,  +4211,  +4011,  +3812,  +3612,  +3412,
+     +3212,  +3012,  +2811,  +2611,  +2411,  +2210,  +2009,  +1809,
+     +1608,  +1407,  +1206,  +1005,   +804,   +603,   +402,   +201,
+        +0,   -201,   -402,   -603,   -804,  -1005,  -1206,  -1407,
+     -1608,  -1809,  -2009,  -2210,  -2411,  -2611,  -2811,  -3012,
+     -3212,  -3412,  -3612,  -3812,  -4011,  -4211,  -4410,  -4609,
+     -4808,  -5007,  -5205,  -5404,  -5602,  -5800,  -5998,  -6195,
+     -6393,  -6590,  -6787,  -6983,  -7180,  -7376,  -7571,  -7767,
+     -7962,  -8157,  -8351,  -8546,  -8740,  -8933,  -9127,  -9319,
+     -9512,  -9704,  -9896, -10088, -10279, -10469, -10660, -10850,
+    -11039, -11228, -11417, -11605, -11793, -11980, -12167, -12354,
+    -12540, -12725, -12910, -13095, -13279, -13463, -13646, -13828,
+    -14010, -14192, -14373, -14553, -14733, -14912, -15091, -15269,
+    -15447, -15624, -15800, -15976, -16151, -16326, -16500, -16673,
+    -16846, -17018, -17190, -17361, -17531, -17700, -17869, -18037,
+    -18205, -18372, -18538, -18703, -18868, -19032, -19195, -19358,
+    -19520, -19681, -19841, -20001, -20160, -20318, -20475, -20632,
+    -20788, -20943, -21097, -21251, -21403, -21555, -21706, -21856,
+    -22006, -22154, -22302, -22449, -22595, -22740, -22884, -23028,
+    -23170, -23312, -23453, -23593, -23732, -23870, -24008, -24144,
+    -24279, -24414, -24548, -24680, -24812, -24943, -25073, -25202,
+    -25330, -25457, -25583, -25708, -25833, -25956, -26078, -26199,
+    -26320, -26439, -26557, -26674, -26791, -26906, -27020, -27133,
+    -27246, -27357, -27467, -27576, -27684, -27791, -27897, -28002,
+    -28106, -28209, -28311, -28411, -28511, -28610, -28707, -28803,
+    -28899, -28993, -29086, -29178, -29269, -29359, -29448, -29535,
+    -29622, -29707, -29792, -29875, -29957, -30038, -30118, -30196,
+    -30274, -30350, -30425, -30499, -30572, -30644, -30715, -30784,
+    -30853, -30920, -30986, -31050, -31114, -31177, -31238, -31298,
+    -31357, -31415, -31471, -31527, -31581, -31634, -31686, -31737,
+    -31786, -31834, -31881, -31927, -31972, -32015, -32058, -32099,
+    -32138, -32177, -32214, -32251, -32286, -32319, -32352, -32383,
+    -32413, -32442, -32470, -32496, -32522, -32546, -32568, -32590,
+    -32610, -32629, -32647, -32664, -32679, -32693, -32706, -32718,
+    -32729, -32738, -32746, -32753, -32758, -32762, -32766, -32767,
+    -32767, -32767, -32766, -32762, -32758, -32753, -32746, -32738,
+    -32729, -32718, -32706, -32693, -32679, -32664, -32647, -32629,
+    -32610, -32590, -32568, -32546, -32522, -32496, -32470, -32442,
+    -32413, -32383, -32352, -32319, -32286, -32251, -32214, -32177,
+    -32138, -32099, -32058, -32015, -31972, -31927, -31881, -31834,
+    -31786, -31737, -31686, -31634, -31581, -31527, -31471, -31415,
+    -31357, -31298, -31238, -31177, -31114, -31050, -30986, -30920,
+    -30853, -30784, -30715, -30644, -30572, -30499, -30425, -30350,
+    -30274, -30196, -30118, -30038, -29957, -29875, -29792, -29707,
+    -29622, -29535, -29448, -29359, -29269, -29178, -29086, -28993,
+    -28899, -28803, -28707, -28610, -28511, -28411, -28311, -28209,
+    -28106, -28002, -27897, -27791, -27684, -27576, -27467, -27357,
+    -27246, -27133, -27020, -26906, -26791, -26674, -26557, -26439,
+    -26320, -26199, -26078, -25956, -25833, -25708, -25583, -25457,
+    -25330, -25202, -25073, -24943, -24812, -24680, -24548, -24414,
+    -24279, -24144, -24008, -23870, -23732, -23593, -23453, -23312,
+    -23170, -23028, -22884, -22740, -22595, -22449, -22302, -22154,
+    -22006, -21856, -21706, -21555, -21403, -21251, -21097, -20943,
+    -20788, -20632, -20475, -20318, -20160, -20001, -19841, -19681,
+    -19520, -19358, -19195, -19032, -18868, -18703, -18538, -18372,
+    -18205, -18037, -17869, -17700, -17531, -17361, -17190, -17018,
+    -16846, -16673, -16500, -16326, -16151, -15976, -15800, -15624,
+    -15447, -15269, -15091, -14912, -14733, -14553, -14373, -14192,
+    -14010, -13828, -13646, -13463, -13279, -13095, -12910, -12725,
+    -12540, -12354, -12167, -11980, -11793, -11605, -11417, -11228,
+    -11039, -10850, -10660, -10469, -10279, -10088,  -9896,  -9704,
+     -9512,  -9319,  -9127,  -8933,  -8740,  -8546,  -8351,  -8157,
+     -7962,  -7767,  -7571,  -7376,  -7180,  -6983,  -6787,  -6590,
+     -6393,  -6195,  -5998,  -5800,  -5602,  -5404,  -5205,  -5007,
+     -4808,  -4609,  -4410,  -4211,  -4011,  -3812,  -3612,  -3412,
+     -3212,  -3012,  -2811,  -2611,  -2411,  -2210,  -2009,  -1809,
+     -1608,  -1407,  -1206,  -1005,   -804,   -603,   -402,   -201,
+};
+
+/* check the size, returns the base 2 logarithm of it or -1 if the size is not
+ * supported */
+static int FFT_Log2(int size)
+{
+    /* logarithm */
+    int l = 0;
+
+    /* size must be a power of two within the twiddle table */
+    if (size < 2 || size > FFT_MAX_SIZE || (size & (size - 1)))
+        return -1;
+    /* count the bits */
+    while ((1 << l) < size)
+        l++;
+
+    /* report the logarithm */
+    return l;
+}
+
+/* advance the bit reversed counter */
+static inline ALWAYS_INLINE int FFT_NextReversed(int r, int size)
+{
+    /* carry propagates from the msb down */
+    int bit = size >> 1;
+    for (; r & bit; bit >>= 1)
+        r ^= bit;
+    /* report the next value */
+    return r | bit;
+}
+
+/* forward transform of the floating point data */
+int OPTIMIZE("O3") FFT_Float(float *re, float *im, int size)
+{
+    /* size check */
+    int log2 = FFT_Log2(size);
+    if (log2 < 0)
+        return EFATAL;
+
+    /* bit reversal permutation */
+    for (int n = 1, r = 0; n < size; n++) {
+        /* swap every pair once */
+        if (n < (r = FFT_NextReversed(r, size))) {
+            float t_re = re[n], t_im = im[n];
+            re[n] = re[r], im[n] = im[r];
+            re[r] = t_re, im[r] = t_im;
+        }
+    }
+
+    /* length of the transforms produced so far */
+    int len = 1;
+    /* odd power of two: single radix-2 stage with no twiddle factors */
+    if (log2 & 1) {
+        for (int a = 0; a < size; a += 2) {
+            float t_re = re[a + 1], t_im = im[a + 1];
+            re[a + 1] = re[a] - t_re, im[a + 1] = im[a] - t_im;
+            re[a] = re[a] + t_re, im[a] = im[a] + t_im;
+        }
+        len = 2;
+    }
+
+    /* radix-4 stages */
+    for (; len < size; len <<= 2) {
+        /* twiddle table stride for the W(4L) */
+        int stride = FFT_MAX_SIZE / (len << 2);
+        /* all the butterflies that share the twiddle factors */
+        for (int k = 0; k < len; k++) {
+            /* twiddle factors: W(4L)^k, W(4L)^2k, W(4L)^3k */
+            int k1 = k * stride, k2 = k1 * 2, k3 = k1 * 3;
+            float w1c = tw_float[k1 + FFT_MAX_SIZE / 4], w1s = tw_float[k1];
+            float w2c = tw_float[k2 + FFT_MAX_SIZE / 4], w2s = tw_float[k2];
+            float w3c = tw_float[k3 + FFT_MAX_SIZE / 4], w3s = tw_float[k3];
+
+            for (int a = k; a < size; a += len << 2) {
+                /* indices of the butterfly inputs/outputs */
+                int b = a + len, c = b + len, d = c + len;
+                /* inputs multiplied by the twiddle factors: (x_re + j x_im) *
+                 * (w_cos - j w_sin) */
+                float t1_re = re[b] * w2c + im[b] * w2s;
+                float t1_im = im[b] * w2c - re[b] * w2s;
+                float t2_re = re[c] * w1c + im[c] * w1s;
+                float t2_im = im[c] * w1c - re[c] * w1s;
+                float t3_re = re[d] * w3c + im[d] * w3s;
+                float t3_im = im[d] * w3c - re[d] * w3s;
+                /* sums and differences */
+                float s01_re = re[a] + t1_re, s01_im = im[a] + t1_im;
+                float d01_re = re[a] - t1_re, d01_im = im[a] - t1_im;
+                float s23_re = t2_re + t3_re, s23_im = t2_im + t3_im;
+                float d23_re = t2_re - t3_re, d23_im = t2_im - t3_im;
+                /* outputs */
+                re[a] = s01_re + s23_re, im[a] = s01_im + s23_im;
+                re[c] = s01_re - s23_re, im[c] = s01_im - s23_im;
+                re[b] = d01_re + d23_im, im[b] = d01_im - d23_re;
+                re[d] = d01_re - d23_im, im[d] = d01_im + d23_re;
+            }
+        }
+    }
+
+    /* report status */
+    return EOK;
+}
+
+/* forward transform of the Q31 data */
+int OPTIMIZE("O3") FFT_Q31(int32_t *re, int32_t *im, int size)
+{
+    /* size check */
+    int log2 = FFT_Log2(size);
+    if (log2 < 0)
+        return EFATAL;
+
+    /* bit reversal permutation */
+    for (int n = 1, r = 0; n < size; n++) {
+        /* swap every pair once */
+        if (n < (r = FFT_NextReversed(r, size))) {
+            int32_t t_re = re[n], t_im = im[n];
+            re[n] = re[r], im[n] = im[r];
+            re[r] = t_re, im[r] = t_im;
+        }
+    }
+
+    /* length of the transforms produced so far */
+    int len = 1;
+    /* odd power of two: single radix-2 stage with the data scaled by 1/2 */
+    if (log2 & 1) {
+        for (int a = 0; a < size; a += 2) {
+            int32_t a_re = re[a] >> 1, a_im = im[a] >> 1;
+            int32_t t_re = re[a + 1] >> 1, t_im = im[a + 1] >> 1;
+            re[a + 1] = a_re - t_re, im[a + 1] = a_im - t_im;
+            re[a] = a_re + t_re, im[a] = a_im + t_im;
+        }
+        len = 2;
+    }
+
+    /* radix-4 stages, data is scaled by 1/4 */
+    for (; len < size; len <<= 2) {
+        /* twiddle table stride for the W(4L) */
+        int stride = FFT_MAX_SIZE / (len << 2);
+        /* all the butterflies that share the twiddle factors */
+        for (int k = 0; k < len; k++) {
+            /* twiddle factors: W(4L)^k, W(4L)^2k, W(4L)^3k */
+            int k1 = k * stride, k2 = k1 * 2, k3 = k1 * 3;
+            int64_t w1c = tw_q31[k1 + FFT_MAX_SIZE / 4], w1s = tw_q31[k1];
+            int64_t w2c = tw_q31[k2 + FFT_MAX_SIZE / 4], w2s = tw_q31[k2];
+            int64_t w3c = tw_q31[k3 + FFT_MAX_SIZE / 4], w3s = tw_q31[k3];
+
+            for (int a = k; a < size; a += len << 2) {
+                /* indices of the butterfly inputs/outputs */
+                int b = a + len, c = b + len, d = c + len;
+                /* inputs multiplied by the twiddle factors and scaled by 1/4
+                 * (Q62 products, the sums do not overflow as long as the
+                 * magnitude of the input is below 1.0) */
+                int32_t t0_re = re[a] >> 2, t0_im = im[a] >> 2;
+                int32_t t1_re = (re[b] * w2c + im[b] * w2s) >> 33;
+                int32_t t1_im = (im[b] * w2c - re[b] * w2s) >> 33;
+                int32_t t2_re = (re[c] * w1c + im[c] * w1s) >> 33;
+                int32_t t2_im = (im[c] * w1c - re[c] * w1s) >> 33;
+                int32_t t3_re = (re[d] * w3c + im[d] * w3s) >> 33;
+                int32_t t3_im = (im[d] * w3c - re[d] * w3s) >> 33;
+                /* sums and differences */
+                int32_t s01_re = t0_re + t1_re, s01_im = t0_im + t1_im;
+                int32_t d01_re = t0_re - t1_re, d01_im = t0_im - t1_im;
+                int32_t s23_re = t2_re + t3_re, s23_im = t2_im + t3_im;
+                int32_t d23_re = t2_re - t3_re, d23_im = t2_im - t3_im;
+                /* outputs */
+                re[a] = s01_re + s23_re, im[a] = s01_im + s23_im;
+                re[c] = s01_re - s23_re, im[c] = s01_im - s23_im;
+                re[b] = d01_re + d23_im, im[b] = d01_im - d23_re;
+                re[d] = d01_re - d23_im, im[d] = d01_im + d23_re;
+            }
+        }
+    }
+
+    /* report status */
+    return EOK;
+}
+
+/* forward transform of the Q15 data */
+int OPTIMIZE("O3") FFT_Q15(int16_t *re, int16_t *im, int size)
+{
+    /* size check */
+    int log2 = FFT_Log2(size);
+    if (log2 < 0)
+        return EFATAL;
+
+    /* bit reversal permutation */
+    for (int n = 1, r = 0; n < size; n++) {
+        /* swap every pair once */
+        if (n < (r = FFT_NextReversed(r, size))) {
+            int16_t t_re = re[n], t_im = im[n];
+            re[n] = re[r], im[n] = im[r];
+            re[r] = t_re, im[r] = t_im;
+        }
+    }
+
+    /* length of the transforms produced so far */
+    int len = 1;
+    /* odd power of two: single radix-2 stage with the data scaled by 1/2 */
+    if (log2 & 1) {
+        for (int a = 0; a < size; a += 2) {
+            int16_t a_re = re[a] >> 1, a_im = im[a] >> 1;
+            int16_t t_re = re[a + 1] >> 1, t_im = im[a + 1] >> 1;
+            re[a + 1] = a_re - t_re, im[a + 1] = a_im - t_im;
+            re[a] = a_re + t_re, im[a] = a_im + t_im;
+        }
+        len = 2;
+    }
+
+    /* radix-4 stages, data is scaled by 1/4 */
+    for (; len < size; len <<= 2) {
+        /* twiddle table stride for the W(4L) */
+        int stride = FFT_MAX_SIZE / (len << 2);
+        /* all the butterflies that share the twiddle factors */
+        for (int k = 0; k < len; k++) {
+            /* twiddle factors: W(4L)^k, W(4L)^2k, W(4L)^3k */
+            int k1 = k * stride, k2 = k1 * 2, k3 = k1 * 3;
+            int32_t w1c = tw_q15[k1 + FFT_MAX_SIZE / 4], w1s = tw_q15[k1];
+            int32_t w2c = tw_q15[k2 + FFT_MAX_SIZE / 4], w2s = tw_q15[k2];
+            int32_t w3c = tw_q15[k3 + FFT_MAX_SIZE / 4], w3s = tw_q15[k3];
+
+            for (int a = k; a < size; a += len << 2) {
+                /* indices of the butterfly inputs/outputs */
+                int b = a + len, c = b + len, d = c + len;
+                /* inputs multiplied by the twiddle factors and scaled by 1/4
+                 * (Q30 products) */
+                int32_t t0_re = re[a] >> 2, t0_im = im[a] >> 2;
+                int32_t t1_re = (re[b] * w2c + im[b] * w2s) >> 17;
+                int32_t t1_im = (im[b] * w2c - re[b] * w2s) >> 17;
+                int32_t t2_re = (re[c] * w1c + im[c] * w1s) >> 17;
+                int32_t t2_im = (im[c] * w1c - re[c] * w1s) >> 17;
+                int32_t t3_re = (re[d] * w3c + im[d] * w3s) >> 17;
+                int32_t t3_im = (im[d] * w3c - re[d] * w3s) >> 17;
+                /* sums and differences */
+                int32_t s01_re = t0_re + t1_re, s01_im = t0_im + t1_im;
+                int32_t d01_re = t0_re - t1_re, d01_im = t0_im - t1_im;
+                int32_t s23_re = t2_re + t3_re, s23_im = t2_im + t3_im;
+                int32_t d23_re = t2_re - t3_re, d23_im = t2_im - t3_im;
+                /* outputs */
+                re[a] = s01_re + s23_re, im[a] = s01_im + s23_im;
+                re[c] = s01_re - s23_re, im[c] = s01_im - s23_im;
+                re[b] = d01_re + d23_im, im[b] = d01_im - d23_re;
+                re[d] = d01_re - d23_im, im[d] = d01_im + d23_re;
+            }
+        }
+    }
+
+    /* report status */
+    return EOK;
+}
@@ -0,0 +1,101 @@
+/**
+ * @file hband.c
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Half-band decimator. The filter is the blackman windowed sinc, the
+ * center tap is always 0.5 and the taps that are an even number of samples
+ * away from it are zeros, so a N taps long filter costs (N + 1) / 4
+ * multiplications per output sample (the taps are symmetrical and the
+ * samples that share the tap get added first).
+ */
+
+#include "assert.h"
+#include "compiler.h"
+#include "config.h"
+#include "dsp/hband.h"
+#include "util/fp.h"
+
+/* compute the filter taps */
+static void HBand_ComputeTaps(hband_t *hb)
+{
+    /* number of the non-zero taps apart from the center one */
+    int num = (hb->taps_num + 1) / 4;
+    /* sum of the taps (for the normalization) */
+    float sum = 0;
+
+    /* go through all the non-zero taps */
+    for (int j = 0; j < num; j++) {
+        /* distance from the center, position within the window */
+        int n = 2 * j + 1, m = hb->taps_num / 2 + n + 1;
+        /* window value (window is two samples longer than the filter so that
+         * the outermost taps are not zeroed) */
+        float w = 0.42f - 0.5f * fp_cos(2 * fp_PI * m / (hb->taps_num + 1)) +
+            0.08f * fp_cos(4 * fp_PI * m / (hb->taps_num + 1));
+        /* sinc */
+        hb->taps[j] = w * fp_sin(fp_PI * n / 2) / (fp_PI * n);
+        sum += 2 * hb->taps[j];
+    }
+    /* unity gain at dc: the center tap brings the other half */
+    for (int j = 0; j < num; j++)
+        hb->taps[j] *= 0.5f / sum;
+}
+
+/* initialize the decimator */
+void HBand_Init(hband_t *hb, int taps)
+{
+    /* sanity check */
+    assert(taps % 4 == 3 && taps <= HBAND_MAX_TAPS,
+        "unsupported number of the half-band filter taps", taps);
+
+    /* compute the filter */
+    hb->taps_num = taps;
+    HBand_ComputeTaps(hb);
+
+    /* empty history */
+    for (int k = 0; k < 2 * taps; k++)
+        hb->hist[k] = 0;
+    /* first output is produced with the second input sample */
+    hb->idx = 0, hb->phase = 0;
+}
+
+/* filter and decimate */
+int OPTIMIZE("O3") LOOP_UNROLL HBand_Decimate(hband_t *hb, const float *in,
+    int num, float *out)
+{
+    /* local copies of the state */
+    int idx = hb->idx, phase = hb->phase;
+    /* filter length, number of the non-zero taps apart from the center one */
+    int taps = hb->taps_num, taps_nz = (taps + 1) / 4;
+    /* number of the output samples */
+    int out_num = 0;
+
+    /* process all input samples */
+    for (int n = 0; n < num; n++) {
+        /* store in the history (twice) */
+        hb->hist[idx] = hb->hist[idx + taps] = in[n];
+        /* the window starts with the oldest sample */
+        if (++idx == taps)
+            idx = 0;
+        /* only every second sample produces the output */
+        if ((phase = !phase))
+            continue;
+
+        /* center of the window */
+        const float *c = hb->hist + idx + taps / 2;
+        /* center tap */
+        float acc = 0.5f * c[0];
+        /* symmetrical taps */
+        for (int j = 0; j < taps_nz; j++)
+            acc += hb->taps[j] * (c[-2 * j - 1] + c[2 * j + 1]);
+        /* store the result (the input sample was already consumed so this
+         * works in-situ) */
+        out[out_num++] = acc;
+    }
+
+    /* store the state */
+    hb->idx = idx, hb->phase = phase;
+    /* return the number of samples produced */
+    return out_num;
+}
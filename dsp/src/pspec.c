@@ -0,0 +1,63 @@
+/**
+ * @file pspec.c
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Power spectrum of the complex frames
+ */
+
+#include <stdint.h>
+
+#include "compiler.h"
+#include "config.h"
+#include "err.h"
+#include "dsp/fft.h"
+#include "dsp/pspec.h"
+#include "util/fp.h"
+#include "util/minmax.h"
+
+/* initialize the power spectrum */
+int PSpec_Init(pspec_t *ps, int size)
+{
+    /* window and the fft must be able to handle the frame */
+    if (size < 1 || size > PSPEC_MAX_SIZE || size > FFT_MAX_SIZE ||
+        (size & (size - 1)))
+        return EFATAL;
+
+    /* prepare the window (hann) */
+    ps->size = size;
+    for (int n = 0; n < size; n++)
+        ps->window[n] = 1073741823.0f * (0.5f - 0.5f *
+            fp_cos(2 * fp_PI * n / size));
+
+    /* report status */
+    return EOK;
+}
+
+/* window the frame and convert it to Q31 */
+void OPTIMIZE("O3") PSpec_Load(pspec_t *ps, const float *i, const float *q)
+{
+    /* full scale limit for the windowed samples */
+    const float lim = ps->window[ps->size / 2];
+
+    /* apply window and convert to Q31 */
+    for (int n = 0; n < ps->size; n++) {
+        ps->re[n] = (int32_t)min(lim, max(-lim, i[n] * ps->window[n]));
+        ps->im[n] = (int32_t)min(lim, max(-lim, q[n] * ps->window[n]));
+    }
+}
+
+/* transform and accumulate the power */
+void OPTIMIZE("O3") PSpec_Accumulate(pspec_t *ps, float *acc, int first,
+    int num, int add)
+{
+    /* do the transform */
+    FFT_Q31(ps->re, ps->im, ps->size);
+    /* accumulate the power of the bins in use */
+    for (int m = 0; m < num; m++) {
+        int k = (m + first) & (ps->size - 1);
+        float re = ps->re[k], im = ps->im[k];
+        acc[m] = (add ? acc[m] : 0) + re * re + im * im;
+    }
+}
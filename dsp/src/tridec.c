@@ -0,0 +1,62 @@
+/**
+ * @file tridec.c
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Triangular (sinc^2) decimator
+ */
+
+#include "assert.h"
+#include "compiler.h"
+#include "config.h"
+#include "dsp/tridec.h"
+
+/* initialize the decimator */
+void TriDec_Init(tridec_t *td, int rate)
+{
+    /* sanity check */
+    assert(rate > 0 && rate <= TRIDEC_MAX_RATE,
+        "unsupported decimation rate", rate);
+
+    /* empty history */
+    td->rate = rate;
+    for (int k = 0; k < rate - 1; k++)
+        td->hist[k] = 0;
+}
+
+/* filter and decimate */
+int OPTIMIZE("O3") LOOP_UNROLL TriDec_Decimate(tridec_t *td,
+    const float *in, int num, float *out)
+{
+    /* shorthand */
+    const int r = td->rate;
+    /* number of the output samples */
+    int m, num_out = num / r;
+
+    /* sanity check for the number of samples */
+    assert(num_out * r == num, "number of samples is not divisible by the "
+        "decimation factor", num);
+
+    /* triangular window: weights 1..r..1 (normalized by r^2), the older
+     * half of the window comes from the history */
+    for (m = 0; m < num_out; m++, in += r) {
+        /* accumulator */
+        float acc = 0;
+        /* older samples */
+        for (int k = 0; k < r - 1; k++)
+            acc += (k + 1) * td->hist[k];
+        /* current samples */
+        for (int k = 0; k < r; k++)
+            acc += (r - k) * in[k];
+        /* update the history before the output overwrites the input (in situ
+         * processing) */
+        for (int k = 0; k < r - 1; k++)
+            td->hist[k] = in[k + 1];
+        /* store the result */
+        out[m] = acc * (1.0f / (r * r));
+    }
+
+    /* return the number of samples produced */
+    return num_out;
+}
@@ -0,0 +1,47 @@
+/**
+ * @file tridec.h
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Triangular (sinc^2) decimator: every output sample is the weighted
+ * sum of the 2 * rate - 1 input samples with the weights 1..rate..1, which
+ * puts the zeros of the response at the multiples of the output sampling
+ * rate where the aliases would come from.
+ */
+
+#ifndef DSP_TRIDEC_H
+#define DSP_TRIDEC_H
+
+#include "config.h"
+
+/** @brief triangular decimator */
+typedef struct tridec {
+    /** decimation rate */
+    int rate;
+    /** last samples of the previous block (older half of the window) */
+    float hist[TRIDEC_MAX_RATE - 1];
+} tridec_t;
+
+/**
+ * @brief Initialize the decimator (empty history)
+ *
+ * @param td decimator
+ * @param rate decimation rate (no more than TRIDEC_MAX_RATE)
+ */
+void TriDec_Init(tridec_t *td, int rate);
+
+/**
+ * @brief Filter and decimate the samples, unity gain at dc. Can be performed
+ * in-situ.
+ *
+ * @param td decimator
+ * @param in input samples
+ * @param num number of the input samples (must be divisible by the rate)
+ * @param out output samples
+ *
+ * @return int number of the output samples
+ */
+int TriDec_Decimate(tridec_t *td, const float *in, int num, float *out);
+
+#endif /* DSP_TRIDEC_H */
@@ -0,0 +1,228 @@
+/**
+ * @file arch.h
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Host (Linux) replacement for the architecture dependent
+ * instructions. Shadows the /arch/arch.h when the host include directory is
+ * put in front of the repository root. Everything here runs single-threaded
+ * so the exclusive access/interrupt masking primitives collapse to plain
+ * memory accesses.
+ */
+
+#ifndef ARCH_ARCH_H_
+#define ARCH_ARCH_H_
+
+#include <stdint.h>
+#include "compiler.h"
+
+/**
+ * @brief Do nothing
+ */
+static inline ALWAYS_INLINE void Arch_NOP(void)
+{
+}
+
+/**
+ * @brief Load a word from memory. There is no exclusive monitor on the host so
+ * this is a simple read.
+ *
+ * @param src source address to load from. must be 32-bit aligned
+ * @return 32-bit value present at address @p ptr
+ */
+static inline ALWAYS_INLINE uint32_t Arch_LDREX(volatile void *src)
+{
+    /* plain read */
+    return *(volatile uint32_t *)src;
+}
+
+/**
+ * @brief Store a word to memory. Always succeeds on the host.
+ *
+ * @param dst destination address to store to. must be 32-bit aligned.
+ * @param value value to be stored
+ * @return 0 in case of success, 1 otherwise
+ */
+static inline ALWAYS_INLINE int Arch_STREX(volatile void *dst, uint32_t value)
+{
+    /* plain write */
+    *(volatile uint32_t *)dst = value;
+    /* report success */
+    return 0;
+}
+
+/**
+ * @brief Data synchronization barrier. Compiler barrier on the host.
+ */
+static inline ALWAYS_INLINE void Arch_DSB(void)
+{
+    /* prevent the compiler from reordering memory accesses */
+    ASM volatile ("" ::: "memory");
+}
+
+/**
+ * @brief Instruction synchronization barrier. Compiler barrier on the host.
+ */
+static inline ALWAYS_INLINE void Arch_ISB(void)
+{
+    /* prevent the compiler from reordering memory accesses */
+    ASM volatile ("" ::: "memory");
+}
+
+/**
+ * @brief There are no interrupt priorities on the host, so this does nothing.
+ *
+ * @param x value to be written
+ */
+static inline ALWAYS_INLINE void Arch_WriteBasepri(int x)
+{
+}
+
+/**
+ * @brief read the BASEPRI register value.
+ *
+ * @return always 0 on the host
+ */
+static inline ALWAYS_INLINE uint32_t Arch_ReadBASEPRI(void)
+{
+    /* no masking */
+    return 0;
+}
+
+/**
+ * @brief read the PRIMASK register value.
+ *
+ * @return always 0 on the host
+ */
+static inline ALWAYS_INLINE uint32_t Arch_ReadPRIMASK(void)
+{
+    /* no masking */
+    return 0;
+}
+
+/**
+ * @brief Returns the value of the stack pointer
+ *
+ * @return stack pointer value (approximated by the frame address)
+ */
+static inline ALWAYS_INLINE void * Arch_ReadMSP(void)
+{
+    /* best we can do */
+    return __builtin_frame_address(0);
+}
+
+/**
+ * @brief Returns the value of the interrupt program status register
+ *
+ * @return always 0 (thread mode) on the host
+ */
+static inline ALWAYS_INLINE uint32_t Arch_ReadIPSR(void)
+{
+    /* thread mode */
+    return 0;
+}
+
+/**
+ * @brief signed saturate the 'x' to be representable in 'bit' bits wide
+ * signed word
+ *
+ * @param x value
+ * @param bit number of bits that the x value shall be contained within
+ *
+ * @return uint32_t signed-saturated version of the word
+ */
+static inline ALWAYS_INLINE int32_t Arch_SSAT(int32_t x, const int bit)
+{
+    /* representable range */
+    const int32_t max = (int32_t)((1UL << (bit - 1)) - 1), min = -max - 1;
+    /* clip */
+    return x > max ? max : x < min ? min : x;
+}
+
+/**
+ * @brief signed multiply the bottom halves of two words and accumulate:
+ * x[15:0] * y[15:0] + acc
+ *
+ * @param x 1st operand (two packed halfwords)
+ * @param y 2nd operand (two packed halfwords)
+ * @param acc accumulator value
+ *
+ * @return int32_t result
+ */
+static inline ALWAYS_INLINE int32_t Arch_SMLABB(uint32_t x, uint32_t y,
+    int32_t acc)
+{
+    /* wrap-around addition, just like the instruction does */
+    return (int32_t)((uint32_t)((int16_t)x * (int16_t)y) + (uint32_t)acc);
+}
+
+/**
+ * @brief signed multiply the top halves of two words and accumulate:
+ * x[31:16] * y[31:16] + acc
+ *
+ * @param x 1st operand (two packed halfwords)
+ * @param y 2nd operand (two packed halfwords)
+ * @param acc accumulator value
+ *
+ * @return int32_t result
+ */
+static inline ALWAYS_INLINE int32_t Arch_SMLATT(uint32_t x, uint32_t y,
+    int32_t acc)
+{
+    /* wrap-around addition, just like the instruction does */
+    return (int32_t)((uint32_t)((int16_t)(x >> 16) * (int16_t)(y >> 16)) +
+        (uint32_t)acc);
+}
+
+/**
+ * @brief signed dual multiply and add: x[15:0] * y[15:0] +
+ * x[31:16] * y[31:16]
+ *
+ * @param x 1st operand (two packed halfwords)
+ * @param y 2nd operand (two packed halfwords)
+ *
+ * @return int32_t result
+ */
+static inline ALWAYS_INLINE int32_t Arch_SMUAD(uint32_t x, uint32_t y)
+{
+    /* wrap-around addition, just like the instruction does */
+    return (int32_t)((uint32_t)((int16_t)x * (int16_t)y) +
+        (uint32_t)((int16_t)(x >> 16) * (int16_t)(y >> 16)));
+}
+
+/**
+ * @brief pack halfwords: bottom half is taken from 'b', top half from 't'
+ * shifted left by 'lsl' bits
+ *
+ * @param b word that provides the bottom half
+ * @param t word that provides the top half (after shifting)
+ * @param lsl left shift applied to 't'
+ *
+ * @return uint32_t packed word
+ */
+static inline ALWAYS_INLINE uint32_t Arch_PKHBT(uint32_t b, uint32_t t,
+    const int lsl)
+{
+    /* combine */
+    return (b & 0xffff) | ((t << lsl) & 0xffff0000);
+}
+
+/**
+ * @brief signed multiply two words and accumulate the 64-bit result:
+ * x * y + acc
+ *
+ * @param x 1st operand
+ * @param y 2nd operand
+ * @param acc 64-bit accumulator value
+ *
+ * @return int64_t result
+ */
+static inline ALWAYS_INLINE int64_t Arch_SMLAL(int32_t x, int32_t y,
+    int64_t acc)
+{
+    /* wrap-around addition, just like the instruction does */
+    return (int64_t)((uint64_t)acc + (uint64_t)((int64_t)x * y));
+}
+
+#endif /* ARCH_ARCH_H_ */
@@ -0,0 +1,115 @@
+/**
+ * @file arch_fpu.h
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Host (Linux) replacement for the fpu instructions. Mimics the
+ * behavior of the cortex-m4 fpv4 instructions (rounding towards zero and
+ * saturation during the float -> fixed point conversions) so that the results
+ * obtained on the host match the ones from the target.
+ */
+
+#ifndef ARCH_ARCH_FPU_H_
+#define ARCH_ARCH_FPU_H_
+
+#include <math.h>
+#include <stdint.h>
+#include "compiler.h"
+
+/**
+ * @brief compute the square root
+ *
+ * @param x number to compute the square root of
+ *
+ * @return square root value
+ */
+static inline ALWAYS_INLINE float Arch_VSQRT(float x)
+{
+    /* use the libm */
+    return sqrtf(x);
+}
+
+/**
+ * @brief compute the absolute value of the floating point number
+ *
+ * @param x number to compute the absolute value of
+ *
+ * @return absolute value
+ */
+static inline ALWAYS_INLINE float Arch_VABS(float x)
+{
+    /* use the libm */
+    return fabsf(x);
+}
+
+/**
+ * @brief convert the floating point to signed 32-bit fixed point notation. For
+ * numbers that exceed the fixed point notation boundaries saturation is used.
+ *
+ * @param x floating point number to convert
+ * @param frac_bits number of fractional bits
+ *
+ * @return signed fixed point number
+ */
+static inline ALWAYS_INLINE int32_t Arch_VCVT_S32_F32(float x,
+    const int frac_bits)
+{
+    /* scaled value: scaling by the power of two is exact */
+    float v = x * (float)(1ULL << frac_bits);
+    /* truncate the value clamped to the range that converts safely (largest
+     * float below 2^31 is 2^31 - 128) */
+    int32_t r = (int32_t)fminf(fmaxf(v, -2147483648.0f), 2147483520.0f);
+    /* saturate and round towards zero just like vcvt does */
+    return v >= 2147483648.0f ? INT32_MAX : r;
+}
+
+/**
+ * @brief convert the floating point to signed 16-bit fixed point notation. For
+ * numbers that exceed the fixed point notation boundaries saturation is used.
+ *
+ * @param x floating point number to convert
+ * @param frac_bits number of fractional bits
+ *
+ * @return signed fixed point number
+ */
+static inline ALWAYS_INLINE int16_t Arch_VCVT_S16_F32(float x,
+    const int frac_bits)
+{
+    /* scaled value: scaling by the power of two is exact */
+    float v = x * (float)(1ULL << frac_bits);
+    /* saturate and round towards zero just like vcvt does */
+    return (int16_t)fminf(fmaxf(v, -32768.0f), 32767.0f);
+}
+
+/**
+ * @brief Convert signed 32-bit fixed point notation number to floating point.
+ *
+ * @param x input value in SQx.y format
+ * @param frac_bits number of fractional bits ('y' in SQx.y)
+ *
+ * @return converted number in a floating point representation
+ */
+static inline ALWAYS_INLINE float Arch_VCVT_F32_S32(int32_t x,
+    const int frac_bits)
+{
+    /* scale by the power of two */
+    return ldexpf((float)x, -frac_bits);
+}
+
+/**
+ * @brief Convert signed 16-bit fixed point notation number to floating point.
+ *
+ * @param x input value in SQx.y format
+ * @param frac_bits number of fractional bits ('y' in SQx.y)
+ *
+ * @return converted number in a floating point representation
+ */
+static inline ALWAYS_INLINE float Arch_VCVT_F32_S16(int16_t x,
+    const int frac_bits)
+{
+    /* scale by the power of two */
+    return ldexpf((float)x, -frac_bits);
+}
+
+#endif /* ARCH_ARCH_FPU_H_ */
@@ -0,0 +1,54 @@
+/**
+ * @file cyccnt.h
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Host (Linux) replacement for the CPU cycle counter. Uses the
+ * monotonic clock scaled to the CPUCLOCK_FREQ so that the numbers can be
+ * compared against the cycle budgets of the target. Tests that need the
+ * exact numbers switch to the fake clock (see HostCycCnt_SetStep()).
+ */
+
+#ifndef DEV_CYCCNT_H_
+#define DEV_CYCCNT_H_
+
+#include <stdint.h>
+#include <time.h>
+
+#include "compiler.h"
+#include "config.h"
+
+/** @brief fake clock: number of cycles that every read adds (0 - the
+ * monotonic clock is used) and the current value */
+extern uint32_t host_cyccnt_step, host_cyccnt_value;
+
+/**
+ * @brief Initialize and start the cycle counter
+ *
+ * @return int status (@ref ERR_ERROR_CODES)
+ */
+int CycCnt_Init(void);
+
+/**
+ * @brief Get the current value of the 'cycle counter'.
+ *
+ * @return uint32_t number of CPUCLOCK_FREQ periods elapsed
+ */
+static inline ALWAYS_INLINE uint32_t CycCnt_GetValue(void)
+{
+    /* fake clock advances with every read */
+    if (host_cyccnt_step)
+        return host_cyccnt_value += host_cyccnt_step;
+
+    /* time specification */
+    struct timespec ts;
+    /* read the clock */
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    /* convert to cpu clock periods, wrap around the same way that the target
+     * counter does */
+    return (uint32_t)(((uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec) *
+        (CPUCLOCK_FREQ / 1000000) / 1000);
+}
+
+#endif /* DEV_CYCCNT_H_ */
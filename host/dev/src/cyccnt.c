@@ -0,0 +1,30 @@
+/**
+ * @file cyccnt.c
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Host stand-in for the CPU cycle counter. The monotonic clock is
+ * always running so there is nothing to be done here.
+ */
+
+#include "err.h"
+#include "dev/cyccnt.h"
+#include "host/host.h"
+
+/* fake clock step and value */
+uint32_t host_cyccnt_step, host_cyccnt_value;
+
+/* initialize the cycle counter */
+int CycCnt_Init(void)
+{
+    /* report status */
+    return EOK;
+}
+
+/* switch between the fake clock and the monotonic one */
+void HostCycCnt_SetStep(uint32_t step)
+{
+    /* every read adds the step from now on */
+    host_cyccnt_step = step;
+}
@@ -0,0 +1,205 @@
+/**
+ * @file dec.c
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Host stand-in for the DFSDM based decimators for the I/Q channels.
+ * Models the peripheral configuration done by /dev/src/dec.c bit by bit:
+ * sinc^3 filter in fast continuous mode, integrator oversampling = 1,
+ * right bit shift of 8 and the 24-bit RDATAR register layout that is fetched
+ * by the dma and then interpreted as the Q31 number. Channel completions are
+ * counted just like on the target, they can be raised in any order by the
+ * tests.
+ */
+
+#include "assert.h"
+#include "config.h"
+#include "err.h"
+#include "dev/dec.h"
+#include "host/host.h"
+#include "sys/cb.h"
+#include "sys/sem.h"
+
+/* decimator semaphore */
+sem_t dec_sem;
+
+/* sinc^3 filter state: integrators and comb delay lines */
+typedef struct dec_sinc3 {
+    /* integrators */
+    uint32_t int1, int2, int3;
+    /* comb delay elements */
+    uint32_t comb1, comb2, comb3;
+    /* input sample counter used for selecting the output samples */
+    int cnt;
+} dec_sinc3_t;
+
+/* filters for both channels */
+static dec_sinc3_t flt_i, flt_q;
+/* callback */
+static cb_t callback;
+/* callback argument */
+static dec_cbarg_t callback_arg;
+/* number of channels that have completed the transfer */
+static int channels_done;
+/* completions are raised by the test code */
+static int manual_completion;
+/* decimation rate in use */
+static int rate = DEC_DECIMATION_RATE;
+
+/* process the data with the sinc^3 filter. The arithmetic is done modulo 2^32
+ * as the combs remove any overflows that the integrators have produced.
+ * 'channel' is the regular channel number that gets appended to the data
+ * register contents just like the RDATACH field does in the peripheral */
+static void Dec_Sinc3(dec_sinc3_t *f, const int16_t *in, int num, int channel,
+    int32_t *out)
+{
+    /* local copies of the state */
+    uint32_t i1 = f->int1, i2 = f->int2, i3 = f->int3;
+    uint32_t c1 = f->comb1, c2 = f->comb2, c3 = f->comb3, d1, d2, d3;
+    /* input counter */
+    int cnt = f->cnt;
+
+    /* process all samples */
+    for (int k = 0; k < num; k++) {
+        /* integrator section */
+        i1 += (uint32_t)(int32_t)in[k]; i2 += i1; i3 += i2;
+        /* decimation */
+        if (++cnt < rate)
+            continue;
+        /* reset the counter */
+        cnt = 0;
+        /* comb section */
+        d1 = i3 - c1; c1 = i3;
+        d2 = d1 - c2; c2 = d1;
+        d3 = d2 - c3; c3 = d2;
+        /* data right shift (DTRBS = 8) and the 24 bit data register */
+        int32_t data = (int32_t)d3 >> 8;
+        /* saturate to 24 bits as the peripheral does */
+        if (data > 0x7fffff) data = 0x7fffff;
+        if (data < -0x800000) data = -0x800000;
+        /* RDATAR = data << 8 | RDATACH */
+        *out++ = (int32_t)((uint32_t)data << 8) | channel;
+    }
+
+    /* store the state */
+    f->int1 = i1, f->int2 = i2, f->int3 = i3;
+    f->comb1 = c1, f->comb2 = c2, f->comb3 = c3;
+    f->cnt = cnt;
+}
+
+/* called when the channel has completed the transfer, calls the callback
+ * after both channels are done */
+static void Dec_ChannelComplete(void)
+{
+    /* not all channels are done */
+    if (++channels_done < 2)
+        return;
+    /* reset the counter */
+    channels_done = 0;
+
+    /* sync call */
+    if (callback == CB_SYNC) {
+        callback = CB_NONE;
+    /* async call was made? */
+    } else if (callback != CB_NONE) {
+        callback(&callback_arg);
+    }
+}
+
+/* decimation dma interrupt: I channel */
+void Dec_DMA1C4Isr(void)
+{
+    /* account the channel */
+    Dec_ChannelComplete();
+}
+
+/* decimation dma interrupt: Q channel */
+void Dec_DMA1C5Isr(void)
+{
+    /* account the channel */
+    Dec_ChannelComplete();
+}
+
+/* check if the decimation rate is supported: the sinc^3 output of the full
+ * scale input (gain of rate^3) has to fit within the 24-bit data register
+ * after the fixed right shift of 8 bits */
+static int Dec_CheckRate(int r)
+{
+    /* sinc^3 output for the full scale input after the shift */
+    int64_t peak = (int64_t)r * r * r << (DEC_MAX_INPUT_BITS - 1 - 8);
+    /* does it fit? */
+    return r > 0 && peak <= 0x7fffff ? EOK : EFATAL;
+}
+
+/* initialize decimator */
+int Dec_Init(void)
+{
+    /* default rate must be supported */
+    assert(Dec_CheckRate(rate) == EOK, "unsupported decimation factor", rate);
+    /* reset the filters, this is equivalent to feeding the zeros during the
+     * peripheral initialization */
+    flt_i = (dec_sinc3_t) { 0 }, flt_q = (dec_sinc3_t) { 0 };
+
+    /* release the device */
+    Sem_Release(&dec_sem);
+    /* report status */
+    return EOK;
+}
+
+/* change the decimation rate */
+int Dec_SetDecimationRate(int r)
+{
+    /* sanity check */
+    if (Dec_CheckRate(r) != EOK)
+        return EFATAL;
+    /* the peripheral gets set up from scratch, the integrators and combs
+     * start empty */
+    if (r != rate)
+        rate = r, flt_i = (dec_sinc3_t) { 0 }, flt_q = (dec_sinc3_t) { 0 };
+
+    /* report status */
+    return EOK;
+}
+
+/* perform filtration and decimation */
+dec_cbarg_t * Dec_Decimate(const int16_t *i, const int16_t *q, int num,
+    int32_t *i_out, int32_t *q_out, cb_t cb)
+{
+    /* number of output samples */
+    int samples_num = num / rate;
+
+    /* sanity check for the number of samples */
+    assert(samples_num * rate == num,
+        "number of samples is not divisible by the decimation factor",
+        num);
+    /* nobody would complete the sync call */
+    assert(!(manual_completion && cb == CB_SYNC),
+        "sync call with manual completions", 0);
+
+    /* store callback */
+    callback = cb;
+    /* no channel has completed the transfer yet */
+    channels_done = 0;
+    /* set-up the callback argument */
+    callback_arg.num = samples_num;
+    callback_arg.i = i_out, callback_arg.q = q_out;
+
+    /* run both channels */
+    Dec_Sinc3(&flt_i, i, num, 0, i_out);
+    Dec_Sinc3(&flt_q, q, num, 1, q_out);
+
+    /* 'transfer complete' */
+    if (!manual_completion)
+        Dec_DMA1C4Isr(), Dec_DMA1C5Isr();
+
+    /* report the argument for sync calls */
+    return cb == CB_SYNC ? &callback_arg : 0;
+}
+
+/* select the way the completions are raised */
+void HostDec_SetManualCompletion(int manual)
+{
+    /* store */
+    manual_completion = manual;
+}
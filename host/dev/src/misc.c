@@ -0,0 +1,118 @@
+/**
+ * @file misc.c
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Host stand-ins for the drivers that have no meaning outside of the
+ * target (display, joystick, audio dac, usb core, awaiting and invoking).
+ * Asynchronous operations complete immediately.
+ */
+
+#include "err.h"
+#include "dev/await.h"
+#include "dev/cs43l22.h"
+#include "dev/display.h"
+#include "dev/invoke.h"
+#include "dev/joystick.h"
+#include "dev/usb.h"
+#include "host/host.h"
+
+/* semaphores */
+sem_t cs43l22_sem, display_sem;
+/* events */
+ev_t joystick_ev, usb_ev;
+
+/* display contents */
+static char display[7];
+/* callback argument for the dac operations */
+static cs43l22_cbarg_t cs43l22_cbarg;
+
+/* call the callback right away */
+void * Await_CallMeLater(int ms, cb_t cb, void *arg)
+{
+    /* no time flows on the host */
+    cb(arg);
+    /* report pointer */
+    return 0;
+}
+
+/* call the callback right away */
+void * Invoke_CallMeElsewhere(cb_t cb, void *arg)
+{
+    /* there is only one context on the host */
+    cb(arg);
+    /* report pointer */
+    return 0;
+}
+
+/* initialize dac */
+int CS43L22_Init(void)
+{
+    /* release the semaphore */
+    Sem_Release(&cs43l22_sem);
+    /* report status */
+    return EOK;
+}
+
+/* all dac operations complete immediately */
+static cs43l22_cbarg_t * CS43L22_Complete(cb_t cb)
+{
+    /* set-up the argument */
+    cs43l22_cbarg.error = EOK;
+    /* call the callback */
+    if (cb != CB_SYNC && cb != CB_NONE)
+        cb(&cs43l22_cbarg);
+    /* report the argument */
+    return cb == CB_SYNC ? &cs43l22_cbarg : 0;
+}
+
+/* dac operations */
+cs43l22_cbarg_t * CS43L22_ReadID(cb_t cb) { return CS43L22_Complete(cb); }
+cs43l22_cbarg_t * CS43L22_Initialize(cb_t cb) { return CS43L22_Complete(cb); }
+cs43l22_cbarg_t * CS43L22_Play(cb_t cb) { return CS43L22_Complete(cb); }
+cs43l22_cbarg_t * CS43L22_SetVolume(int db, cb_t cb)
+{
+    return CS43L22_Complete(cb);
+}
+
+/* initialize display */
+int Display_Init(void)
+{
+    /* release the semaphore */
+    Sem_Release(&display_sem);
+    /* report status */
+    return EOK;
+}
+
+/* set character */
+void Display_SetCharacter(int pos, char c)
+{
+    /* store within the buffer */
+    if (pos >= 0 && pos < (int)sizeof(display) - 1)
+        display[pos] = c;
+}
+
+/* 'refresh' the display */
+void * Display_Update(cb_t cb)
+{
+    /* call the callback */
+    if (cb != CB_SYNC && cb != CB_NONE)
+        cb(0);
+    /* report pointer */
+    return 0;
+}
+
+/* get the display contents */
+const char * HostDisplay_GetContents(void)
+{
+    /* display buffer is always zero-terminated */
+    return display;
+}
+
+/* usb connection */
+int USB_Connect(int enable)
+{
+    /* report status */
+    return EOK;
+}
@@ -0,0 +1,88 @@
+/**
+ * @file rfin.c
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Host stand-in for the RF Input driver module. Instead of the ADC+DMA
+ * the samples are pushed by the replay harness, one half of the circular
+ * buffer at the time, which results in the same sequence of HT/FT events that
+ * the target produces.
+ */
+
+#include <string.h>
+
+#include "assert.h"
+#include "err.h"
+#include "dev/rfin.h"
+#include "host/host.h"
+
+/* system event */
+ev_t rfin_ev;
+/* data pointer, */
+static int16_t *samples;
+/* data buffer size in number of samples */
+static int samples_num;
+/* currently written half */
+static int half;
+
+/* 'adc dma1 interrupt' */
+void RFIn_DMA1C1Isr(void)
+{
+    /* event argument */
+    rfin_evarg_t ea = { .type = RFIN_TYPE_HT, .num = samples_num / 2,
+        .samples = samples };
+
+    /* full transfer occured? */
+    if (half) {
+        ea.type = RFIN_TYPE_FT; ea.samples = &samples[samples_num / 2];
+    }
+    /* switch halves */
+    half = !half;
+
+    /* notify others */
+    Ev_Notify(&rfin_ev, &ea);
+}
+
+/* radio frequency input */
+int RFIn_Init(void)
+{
+    /* report status */
+    return EOK;
+}
+
+/* configure sampling */
+void RFIn_StartSampling(int16_t *ptr, int num)
+{
+    /* must be divisible by two */
+    assert(num % 2 == 0, "uneven number of samples", num);
+
+    /* store the buffer */
+    samples = ptr, samples_num = num, half = 0;
+}
+
+/* push the samples into the buffer */
+int HostRFIn_Feed(const int16_t *ptr, int num)
+{
+    /* sampling was not started */
+    if (!samples)
+        return ENOINIT;
+    /* data must cover exactly one half of the buffer */
+    if (num != samples_num / 2)
+        return EFATAL;
+
+    /* 'dma' transfer */
+    memcpy(samples + half * samples_num / 2, ptr, num * sizeof(*ptr));
+    /* 'interrupt' */
+    RFIn_DMA1C1Isr();
+
+    /* report status */
+    return EOK;
+}
+
+/* return the number of samples per single event */
+int HostRFIn_GetHalfSize(void)
+{
+    /* half of the buffer */
+    return samples_num / 2;
+}
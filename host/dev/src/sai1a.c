@@ -0,0 +1,61 @@
+/**
+ * @file sai1a.c
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Host stand-in for the Serial Audio Interface. Mimics the circular dma
+ * that feeds the DAC: the replay harness drains the buffer at the audio rate.
+ */
+
+#include "err.h"
+#include "dev/sai1a.h"
+#include "host/host.h"
+
+/* sai1a access semaphore */
+sem_t sai1a_sem;
+
+/* streamed buffer */
+static const int32_t *buf;
+/* buffer size and the 'dma' read pointer */
+static int buf_num, buf_tail;
+
+/* initialize sai1a interface that feeds the DAC with data */
+int SAI1A_Init(void)
+{
+    /* release the semaphore */
+    Sem_Release(&sai1a_sem);
+    /* report status */
+    return EOK;
+}
+
+/* start streaming data */
+void SAI1A_StartStreaming(const int32_t *ptr, int num)
+{
+    /* store the buffer */
+    buf = ptr, buf_num = num, buf_tail = 0;
+}
+
+/* get the streaming position */
+int SAI1A_GetPosition(void)
+{
+    /* 'dma' read pointer */
+    return buf ? buf_tail : 0;
+}
+
+/* get the samples that would have been sent to the dac */
+int HostSAI1A_Drain(int32_t *ptr, int num)
+{
+    /* streaming is not active */
+    if (!buf)
+        return 0;
+
+    /* copy data while following the circular buffer */
+    for (int i = 0; i < num; i++) {
+        ptr[i] = buf[buf_tail];
+        if (++buf_tail == buf_num) buf_tail = 0;
+    }
+
+    /* report the number of samples */
+    return num;
+}
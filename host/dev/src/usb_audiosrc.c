@@ -0,0 +1,168 @@
+/**
+ * @file usb_audiosrc.c
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Host stand-in for the USB Audio Source. Keeps the same circular
+ * buffer as the target does, the replay harness plays the role of the usb host
+ * that fetches the data on every usb frame.
+ */
+
+#include <string.h>
+
+#include "err.h"
+#include "dev/usb_audiosrc.h"
+#include "host/host.h"
+#include "util/elems.h"
+#include "util/minmax.h"
+
+/* system event */
+ev_t usb_audio_ev;
+
+/* usb sample type */
+typedef struct { int32_t l, r; } usb_buf_elem_t;
+/* data buffer */
+static usb_buf_elem_t buf[USB_AUDIO_SRC_MAX_RATE_16 / 
+    USB_AUDIO_SRC_FRAME_RATE * USB_AUDIO_SRC_BUF_FRAMES];
+/* head and tail pointers */
+static uint32_t usb_head, usb_tail;
+/* sampling rates offered to the host, the current one */
+static uint32_t rates[USB_AUDIO_SRC_MAX_RATES] = { 
+    USB_AUDIO_SRC_SAMPLING_RATE };
+static int rates_num = 1;
+static uint32_t rate = USB_AUDIO_SRC_SAMPLING_RATE;
+
+/* initialize audio source */
+int USBAudioSrc_Init(void)
+{
+    /* report status */
+    return EOK;
+}
+
+/* set the sampling rates offered to the host */
+int USBAudioSrc_SetRates(const uint32_t *r, int num)
+{
+    /* sanity check */
+    if (num < 1 || num > USB_AUDIO_SRC_MAX_RATES)
+        return EFATAL;
+
+    /* store the list, first rate is the current one */
+    memcpy(rates, r, num * sizeof(rates[0]));
+    rates_num = num, rate = rates[0];
+
+    /* report status */
+    return EOK;
+}
+
+/* select the current sampling rate */
+int USBAudioSrc_SetRate(uint32_t r)
+{
+    /* look for it within the offered ones */
+    int k; for (k = 0; k < rates_num && rates[k] != r; k++);
+    /* not supported */
+    if (k == rates_num)
+        return EFATAL;
+    /* start over with the empty buffer (as the pacing restart does) */
+    if (r != rate)
+        rate = r, usb_tail = usb_head;
+
+    /* report status */
+    return EOK;
+}
+
+/* put samples into the usb buffer */
+int USBAudioSrc_PutSamples(const int32_t *l, const int32_t *r, int num)
+{
+    /* space left, overall number of frames to store */
+    uint32_t space_left = elems(buf) - (usb_head - usb_tail);
+    uint32_t frames_to_store = min(space_left, (unsigned)num);
+
+    /* store data */
+    for (uint32_t i = 0; i < frames_to_store; i++, usb_head++) {
+        buf[usb_head % elems(buf)].l = *l++;
+        buf[usb_head % elems(buf)].r = *r++;
+    }
+
+    /* return the number of frames stored */
+    return frames_to_store;
+}
+
+/* get the space within the buffer for direct writing */
+int USBAudioSrc_AcquireSpace(int num, usb_audio_span_t *span)
+{
+    /* space left, overall number of frames to store, head element index */
+    uint32_t space_left, frames_to_store, head;
+
+    /* space left */
+    space_left = elems(buf) - (usb_head - usb_tail);
+    /* buffer may be getting full */
+    frames_to_store = min(space_left, (unsigned)num);
+    /* get the head pointer */
+    head = usb_head % elems(buf);
+
+    /* part before the buffer wraps */
+    span->ptr[0] = &buf[head].l;
+    span->num[0] = min(frames_to_store, elems(buf) - head);
+    /* part after the buffer wraps */
+    span->ptr[1] = &buf[0].l;
+    span->num[1] = frames_to_store - span->num[0];
+
+    /* return the number of frames that can be stored */
+    return frames_to_store;
+}
+
+/* commit samples written directly to the buffer */
+int USBAudioSrc_CommitSamples(int num)
+{
+    /* update the head pointer */
+    usb_head += num;
+    /* return the number of frames stored */
+    return num;
+}
+
+/* fetch the samples as the usb host would do */
+int HostUSBAudioSrc_GetSamples(int32_t *lr, int num)
+{
+    /* number of frames to get */
+    uint32_t frames_to_get = min(usb_head - usb_tail, (unsigned)num);
+
+    /* read data */
+    for (uint32_t i = 0; i < frames_to_get; i++, usb_tail++) {
+        *lr++ = buf[usb_tail % elems(buf)].l;
+        *lr++ = buf[usb_tail % elems(buf)].r;
+    }
+
+    /* return the number of frames fetched from the buffer */
+    return frames_to_get;
+}
+
+/* select the sampling rate as the usb host does */
+int HostUSBAudioSrc_SelectRate(uint32_t r)
+{
+    /* look for it within the offered ones */
+    int k; for (k = 0; k < rates_num && rates[k] != r; k++);
+    /* not supported */
+    if (k == rates_num)
+        return EFATAL;
+
+    /* rate has changed */
+    if (r != rate) {
+        /* store, start over with the empty buffer */
+        rate = r, usb_tail = usb_head;
+        /* prepare event argument, notify the producer */
+        usb_audio_evarg_t ea = { .mode = USB_AUDIO_SRC_MODE_S32, 
+            .rate = rate };
+        Ev_Notify(&usb_audio_ev, &ea);
+    }
+
+    /* report status */
+    return EOK;
+}
+
+/* get the current sampling rate */
+uint32_t HostUSBAudioSrc_GetRate(void)
+{
+    /* report the rate */
+    return rate;
+}
@@ -0,0 +1,79 @@
+/**
+ * @file usb_rfcap.c
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Host loopback stand-in for the USB raw rf capture endpoint. The 
+ * transfer is not copied anywhere: the replay harness plays the role of the 
+ * usb host and reads the data straight from the memory it was given in, as 
+ * the usb core does, so the data that gets overwritten before it is read 
+ * shows up the same way it would on the target.
+ */
+
+#include <string.h>
+
+#include "err.h"
+#include "dev/usb.h"
+#include "dev/usb_rfcap.h"
+#include "host/host.h"
+#include "util/minmax.h"
+
+/* parts of the transfer: the header and the data */
+static const uint8_t *ptrs[2];
+static size_t sizes[2];
+/* part being read, offset within it, number of bytes read so far */
+static int part;
+static size_t offs, sent;
+/* transfer finished callback (set while the transfer is on) */
+static cb_t callback;
+
+/* initialize the rf capture endpoint */
+int USBRFCap_Init(void)
+{
+    /* report status */
+    return EOK;
+}
+
+/* send the data */
+int USBRFCap_Send(const void *hdr, size_t hdr_size, const void *ptr, 
+    size_t size, cb_t cb)
+{
+    /* previous transfer is still on */
+    if (callback)
+        return EBUSY;
+
+    /* store the parts */
+    ptrs[0] = hdr, sizes[0] = hdr_size, ptrs[1] = ptr, sizes[1] = size;
+    /* start with the header */
+    part = 0, offs = 0, sent = 0, callback = cb;
+
+    /* report status */
+    return EOK;
+}
+
+/* read the data as the usb host would do */
+int HostUSBRFCap_Read(void *ptr, int size)
+{
+    /* number of bytes read */
+    int num = 0;
+
+    /* read as long as there is a transfer and the room for the data */
+    while (callback && num < size) {
+        /* bytes to take from the current part */
+        int n = min((size_t)(size - num), sizes[part] - offs);
+        memcpy((uint8_t *)ptr + num, ptrs[part] + offs, n);
+        num += n, offs += n, sent += n;
+        /* part is done, skip the empty ones */
+        for (; part < 2 && offs == sizes[part]; part++)
+            offs = 0;
+        /* transfer is done: the callback may start the next one */
+        if (part == 2) {
+            usb_cbarg_t arg = { .error = EOK, .size = sent };
+            cb_t cb = callback; callback = 0; cb(&arg);
+        }
+    }
+
+    /* return the number of bytes read */
+    return num;
+}
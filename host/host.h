@@ -0,0 +1,112 @@
+/**
+ * @file host.h
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Host (Linux) build: hooks that allow the replay harness to play the
+ * role of the hardware, i.e. to push the adc data and to pull the samples that
+ * would have been sent to the dac and to the usb host.
+ */
+
+#ifndef HOST_HOST_H
+#define HOST_HOST_H
+
+#include <stdint.h>
+
+/**
+ * @brief Push the rf samples as if they were sampled by the adc. Exactly one
+ * half of the buffer given to RFIn_StartSampling() is expected per call. Rf
+ * event is generated before this function returns.
+ *
+ * @param ptr samples
+ * @param num number of samples
+ *
+ * @return int status (@ref ERR_ERROR_CODES)
+ */
+int HostRFIn_Feed(const int16_t *ptr, int num);
+
+/**
+ * @brief Returns the number of samples that are delivered with a single rf
+ * event.
+ *
+ * @return int number of samples, 0 when sampling was not started
+ */
+int HostRFIn_GetHalfSize(void);
+
+/**
+ * @brief Select how the decimator 'dma' completions are raised: automatically
+ * (I channel, then Q channel) before Dec_Decimate() returns or manually, by
+ * calling Dec_DMA1C4Isr() and Dec_DMA1C5Isr() in any order.
+ *
+ * @param manual 1 for manual completions, 0 for automatic ones
+ */
+void HostDec_SetManualCompletion(int manual);
+
+/**
+ * @brief Get the samples that the sai would send to the dac.
+ *
+ * @param ptr destination buffer
+ * @param num number of samples to get
+ *
+ * @return int number of samples fetched (0 if the streaming is not started)
+ */
+int HostSAI1A_Drain(int32_t *ptr, int num);
+
+/**
+ * @brief Get the samples that the usb host would read from the audio source
+ *
+ * @param lr destination buffer for the interleaved left/right samples
+ * @param num max number of sample pairs to get
+ *
+ * @return int number of sample pairs fetched
+ */
+int HostUSBAudioSrc_GetSamples(int32_t *lr, int num);
+
+/**
+ * @brief Select the sampling rate of the audio source the way the usb host 
+ * does (set request to the clock source): the buffer is flushed and the event 
+ * is generated if the rate has changed
+ *
+ * @param rate sampling rate in Hz (one of the offered ones)
+ *
+ * @return int status (EFATAL if the rate is not offered)
+ */
+int HostUSBAudioSrc_SelectRate(uint32_t rate);
+
+/**
+ * @brief Get the current sampling rate of the audio source
+ *
+ * @return uint32_t sampling rate in Hz
+ */
+uint32_t HostUSBAudioSrc_GetRate(void);
+
+/**
+ * @brief Read the data from the rf capture endpoint as the usb host would do 
+ * (straight from the memory the transfer was started with). The transfer 
+ * callback is called once all of its data is read.
+ *
+ * @param ptr destination buffer
+ * @param size max number of bytes to read (the bus budget)
+ *
+ * @return int number of bytes read
+ */
+int HostUSBRFCap_Read(void *ptr, int size);
+
+/**
+ * @brief Replace the monotonic clock behind the cycle counter with the fake
+ * one that advances by the fixed number of cycles with every read, so that
+ * the profiler gathers the exact, repeatable numbers.
+ *
+ * @param step cycles per read, 0 goes back to the monotonic clock
+ */
+void HostCycCnt_SetStep(uint32_t step);
+
+/**
+ * @brief Get the string that is shown on the display
+ *
+ * @return const char * display contents
+ */
+const char * HostDisplay_GetContents(void);
+
+#endif /* HOST_HOST_H */
@@ -0,0 +1,344 @@
+/**
+ * @file iqframe.c
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Host (Linux) decoder of the iq notifications. Reads the AT link
+ * straight from the serial port (and configures the notification format) or
+ * the capture of it from the file/standard input, tells the binary frames
+ * from the text lines, decodes both the binary frames and the legacy base64
+ * '+RADIO_IQ: ' lines, tells the pairs dropped by the device from the frames
+ * lost on the way and reports the throughput.
+ *
+ * Output format: raw, interleaved I/Q 32-bit floats (full scale is 1.0) @
+ * the iq stream sampling rate.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "config.h"
+#include "at/ntf.h"
+#include "at/ntf/radio.h"
+#include "base64/base64.h"
+#include "radio/iqframe.h"
+
+/* size of a single read */
+#define READ_SIZE                           4096
+/* size of the text line buffer */
+#define LINE_SIZE                           1024
+/* serial link baudrate */
+#define TTY_BAUDRATE                        B1500000
+
+/* stream source: serial port or the file */
+static int tty_fd = -1;
+static FILE *in;
+/* stop request */
+static volatile sig_atomic_t stop;
+
+/* statistics: binary frames, text notifications, malformed frames and
+ * notifications, frames lost on the way (sequence gaps), pairs dropped by the
+ * device, pairs decoded, other text lines, bytes received, bytes skipped */
+static long frames, texts, bad, lost, dropped, pairs, lines, bytes, skipped;
+/* iq stream sampling rate as reported by the device (0 - unknown) */
+static int rate;
+/* output file */
+static FILE *out;
+
+/* show the usage information */
+static void Main_Usage(const char *name)
+{
+    fprintf(stderr, "usage: %s (-t /dev/ttyXXX [-f text|s16|s8] | -i stream) "
+        "[-o samples_out] [-n pairs]\n", name);
+}
+
+/* get the monotonic time in seconds */
+static double Main_GetTime(void)
+{
+    /* time specification */
+    struct timespec ts;
+    /* read the clock */
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    /* convert */
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* stop on ctrl+c */
+static void Main_Signal(int sig)
+{
+    /* finish with the current read */
+    stop = 1;
+}
+
+/* read the piece of the stream, returns the number of bytes, 0 at the end */
+static int Main_Read(uint8_t *ptr, int size)
+{
+    /* file or the standard input */
+    if (in)
+        return fread(ptr, 1, size, in);
+
+    /* serial port: interrupted reads are not the end of the stream */
+    int rc;
+    while ((rc = read(tty_fd, ptr, size)) < 0 && errno == EINTR && !stop);
+    /* report the number of bytes or the end of the stream */
+    return rc < 0 ? 0 : rc;
+}
+
+/* open the serial port in the raw mode and configure the notifications */
+static int Main_OpenTTY(const char *name, int fmt)
+{
+    /* terminal settings */
+    struct termios tio;
+    /* configuration commands */
+    char cmd[64];
+
+    /* open the port */
+    if ((tty_fd = open(name, O_RDWR | O_NOCTTY)) < 0 ||
+        tcgetattr(tty_fd, &tio) < 0)
+        return -1;
+    /* raw mode, no flow control, the reads return whatever has arrived */
+    cfmakeraw(&tio);
+    tio.c_cflag |= CLOCAL | CREAD, tio.c_cflag &= ~CRTSCTS;
+    tio.c_cc[VMIN] = 1, tio.c_cc[VTIME] = 0;
+    cfsetispeed(&tio, TTY_BAUDRATE), cfsetospeed(&tio, TTY_BAUDRATE);
+    if (tcsetattr(tty_fd, TCSANOW, &tio) < 0)
+        return -1;
+
+    /* select the format and enable the iq notifications */
+    int len = snprintf(cmd, sizeof(cmd), "AT+RADIO_IQFMT=%d\r\n"
+        "AT+NTFYEN=%d\r\n", fmt, AT_NTF_MASK_RADIO_IQ);
+    return write(tty_fd, cmd, len) == len ? 0 : -1;
+}
+
+/* store the decoded samples */
+static void Main_Store(const float *iq, int num)
+{
+    /* write to the output file */
+    if (out)
+        fwrite(iq, 2 * sizeof(*iq), num, out);
+    /* update the statistics */
+    pairs += num;
+}
+
+/* process the binary frame (the data between the delimiters) */
+static void Main_ProcFrame(uint8_t *frame, int size)
+{
+    /* decoded samples */
+    static float iq[2 * IQFRAME_MAX_SIZE];
+    /* previous frame header */
+    static iqframe_hdr_t prev; static int have_prev;
+    /* frame header */
+    iqframe_hdr_t hdr;
+
+    /* decode the frame */
+    int num = IQFrame_Decode(frame, size, &hdr, iq);
+    if (num < 0) {
+        bad++; return;
+    }
+
+    /* frames lost on the way, pairs dropped by the device */
+    if (have_prev) {
+        lost += (uint16_t)(hdr.seq - prev.seq - 1);
+        dropped += hdr.dropped - prev.dropped;
+    }
+    /* store the header */
+    prev = hdr, have_prev = 1;
+
+    /* store the samples */
+    Main_Store(iq, num), frames++;
+}
+
+/* process the text line */
+static void Main_ProcLine(char *line, int len)
+{
+    /* decoded samples */
+    static float iq[LINE_SIZE / 4];
+    /* notification prefix */
+    static const char prefix[] = "+RADIO_IQ: ";
+
+    /* strip the line ending */
+    while (len && (line[len - 1] == '\r' || line[len - 1] == '\n'))
+        line[--len] = 0;
+    /* empty line */
+    if (!len)
+        return;
+
+    /* sampling rate report */
+    if (sscanf(line, "+RADIO_IQRATE: %d", &rate) == 1) {
+        lines++; fprintf(stderr, "%s\n", line); return;
+    }
+    /* other line */
+    if (strncmp(line, prefix, sizeof(prefix) - 1)) {
+        lines++; fprintf(stderr, "%s\n", line); return;
+    }
+
+    /* base64 data */
+    char *b64 = line + sizeof(prefix) - 1;
+    int b64_len = len - (sizeof(prefix) - 1);
+    /* the decoder does not check the characters */
+    int valid = b64_len >= 4 && b64_len % 4 == 0;
+    for (int k = 0; valid && k < b64_len; k++)
+        valid = strchr("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz"
+            "0123456789+/=", b64[k]) != 0;
+    /* decode */
+    int size = valid ? Base64_Decode(b64, b64_len, iq, sizeof(iq)) : -1;
+    if (size < 0 || size % (2 * sizeof(*iq))) {
+        bad++; return;
+    }
+
+    /* store the samples */
+    Main_Store(iq, size / (2 * sizeof(*iq))), texts++;
+}
+
+/* program main function */
+int main(int argc, char *argv[])
+{
+    /* file names */
+    const char *tty_name = 0, *in_name = 0, *out_name = 0;
+    /* notification format */
+    int fmt = AT_NTF_RADIO_IQFMT_S16;
+    /* number of pairs to read (0 - all) */
+    long max_pairs = 0;
+    /* option */
+    int opt;
+
+    /* parse the command line */
+    while ((opt = getopt(argc, argv, "t:f:i:o:n:")) != -1) {
+        switch (opt) {
+        case 't' : tty_name = optarg; break;
+        case 'i' : in_name = optarg; break;
+        case 'o' : out_name = optarg; break;
+        case 'n' : max_pairs = atol(optarg); break;
+        case 'f' : {
+            /* format names */
+            if (!strcmp(optarg, "text")) fmt = AT_NTF_RADIO_IQFMT_TEXT;
+            else if (!strcmp(optarg, "s16")) fmt = AT_NTF_RADIO_IQFMT_S16;
+            else if (!strcmp(optarg, "s8")) fmt = AT_NTF_RADIO_IQFMT_S8;
+            else { Main_Usage(argv[0]); return EXIT_FAILURE; }
+        } break;
+        default : Main_Usage(argv[0]); return EXIT_FAILURE;
+        }
+    }
+
+    /* exactly one source is a must */
+    if (!tty_name == !in_name) {
+        Main_Usage(argv[0]); return EXIT_FAILURE;
+    }
+    /* open the stream file ('-' is the standard input) */
+    if (in_name && !(in = strcmp(in_name, "-") ? fopen(in_name, "rb") :
+        stdin)) {
+        perror("fopen"); return EXIT_FAILURE;
+    }
+    /* open the serial port */
+    if (tty_name && Main_OpenTTY(tty_name, fmt) < 0) {
+        perror(tty_name); return EXIT_FAILURE;
+    }
+    /* open the output file */
+    if (out_name && !(out = fopen(out_name, "wb"))) {
+        perror("fopen"); return EXIT_FAILURE;
+    }
+    /* finish gracefully on ctrl+c */
+    signal(SIGINT, Main_Signal);
+
+    /* read buffer */
+    static uint8_t buf[READ_SIZE];
+    /* text line and the binary frame being collected */
+    static char line[LINE_SIZE]; static uint8_t frame[IQFRAME_MAX_SIZE];
+    int line_num = 0, frame_num = 0;
+    /* within the binary frame? */
+    int in_frame = 0;
+    /* time of the first byte */
+    double start = Main_GetTime(), first = 0;
+
+    /* read until the end of the stream */
+    while (!stop && (!max_pairs || pairs < max_pairs)) {
+        /* read the data */
+        int n = Main_Read(buf, sizeof(buf));
+        if (!n)
+            break;
+        /* first data */
+        if (!bytes)
+            first = Main_GetTime();
+        bytes += n;
+
+        /* process all bytes */
+        for (int k = 0; k < n; k++) {
+            /* text: the delimiter starts the frame, the line feed ends the
+             * line */
+            if (!in_frame) {
+                /* frames never interrupt the lines: what came before the
+                 * delimiter was the tail of the frame (the stream was joined
+                 * in the middle of it) and the delimiter was the closing one */
+                if (buf[k] == IQFRAME_DELIM && line_num) {
+                    skipped += line_num + 1, line_num = 0;
+                } else if (buf[k] == IQFRAME_DELIM) {
+                    in_frame = 1, frame_num = 0;
+                } else if (line_num < LINE_SIZE - 1) {
+                    line[line_num++] = buf[k];
+                }
+                /* complete line (the ones that are too long get truncated
+                 * and fail to decode) */
+                if (!in_frame && buf[k] == '\n') {
+                    line[line_num] = 0;
+                    Main_ProcLine(line, line_num), line_num = 0;
+                }
+                continue;
+            }
+
+            /* binary frame data */
+            if (buf[k] != IQFRAME_DELIM) {
+                /* frame is too long: the delimiter that started it was not
+                 * the opening one, count it as malformed when it ends */
+                if (frame_num < (int)sizeof(frame))
+                    frame[frame_num] = buf[k];
+                frame_num++;
+                continue;
+            }
+            /* back-to-back delimiters */
+            if (!frame_num)
+                continue;
+            /* frame that decodes goes back to the text, the one that does
+             * not may have been the text with the closing delimiter of the
+             * frame that came before it (synchronization) so the delimiter
+             * is treated as the opening one */
+            long prev_bad = bad;
+            Main_ProcFrame(frame, frame_num <= (int)sizeof(frame) ?
+                frame_num : 0);
+            in_frame = bad != prev_bad, frame_num = 0;
+        }
+    }
+
+    /* time it took to receive the stream */
+    double elapsed = Main_GetTime() - (bytes ? first : start);
+    /* stream duration (when the rate was reported) */
+    double duration = rate ? (double)(pairs + dropped) / rate : 0;
+    /* show the summary */
+    fprintf(stderr, "frames = %ld, text notifications = %ld, pairs = %ld, "
+        "other lines = %ld, bytes = %ld (%.2f per pair), skipped bytes = "
+        "%ld\n", frames, texts, pairs, lines, bytes, pairs ?
+        (double)bytes / pairs : 0, skipped);
+    fprintf(stderr, "malformed = %ld, frames lost = %ld, "
+        "pairs dropped by the device = %ld\n", bad, lost, dropped);
+    fprintf(stderr, "stream time = %.3f s @ %d Hz, throughput = %.1f kB/s "
+        "(%.1f kB/s, %.0f pairs/s of the wall clock time)\n", duration, rate,
+        duration > 0 ? bytes / duration * 1e-3 : 0,
+        elapsed > 0 ? bytes / elapsed * 1e-3 : 0,
+        elapsed > 0 ? pairs / elapsed : 0);
+
+    /* close files */
+    if (in && in != stdin) fclose(in);
+    if (tty_fd >= 0) close(tty_fd);
+    if (out) fclose(out);
+
+    /* frames lost on the way are an error */
+    return lost || bad ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,250 @@
+/**
+ * @file main.c
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Host (Linux) replay harness. Feeds the recorded adc captures through
+ * the receiver exactly the way the rf input driver does on the target and
+ * writes the iq data (as sent to the usb host) and the audio (as sent to the
+ * dac) to files.
+ *
+ * Capture format: raw, signed 16-bit little endian samples @ RF_SAMPLING_FREQ
+ * with the adc offset already applied (the same data that lands in the 'rf'
+ * buffer of the radio module).
+ * IQ output: raw, interleaved I/Q signed 32-bit samples (Q31) @ the iq stream
+ * rate (selected the way the usb host does, BB_SAMPLING_RATE by default)
+ * Audio output: raw, signed 32-bit samples (24 bits used) @ BB_SAMPLING_RATE
+ * RF capture output: the raw rf capture stream as read from the bulk endpoint
+ * by the 'usb host' that moves at most the given number of bytes per second
+ * (see host/rfcap.c for the reader)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "config.h"
+#include "err.h"
+#include "dev/cs43l22.h"
+#include "dev/dec.h"
+#include "dev/display.h"
+#include "dev/rfin.h"
+#include "dev/sai1a.h"
+#include "dev/usb_audiosrc.h"
+#include "dev/usb_rfcap.h"
+#include "host/host.h"
+#include "radio/mix1.h"
+#include "radio/radio.h"
+#include "radio/rfcap.h"
+
+/* show the usage information */
+static void Main_Usage(const char *name)
+{
+    fprintf(stderr, "usage: %s -i capture [-f frequency] [-q iq_out] "
+        "[-a audio_out] [-m AM|USB|LSB|SAM|CW] [-b nb_threshold] [-n] "
+        "[-r iq_rate] [-c rfcap_out] [-x s16|u8] [-d 1|2|4] "
+        "[-u bus_bytes_per_s]\n",
+        name);
+}
+
+/* get the monotonic time in seconds */
+static double Main_GetTime(void)
+{
+    /* time specification */
+    struct timespec ts;
+    /* read the clock */
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    /* convert */
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* program main function */
+int main(int argc, char *argv[])
+{
+    /* file names */
+    const char *in_name = 0, *iq_name = 0, *audio_name = 0, *cap_name = 0;
+    /* files */
+    FILE *in, *iq = 0, *audio = 0, *cap = 0;
+    /* frequency to tune to */
+    float frequency = 225000;
+    /* demodulation mode */
+    int mode = RADIO_MODE_AM;
+    /* noise blanker threshold */
+    float nb_threshold = MIX1_NB_THRESHOLD;
+    /* adaptive notch */
+    int notch = 0;
+    /* iq stream sampling rate */
+    int iq_rate = BB_SAMPLING_RATE;
+    /* rf capture format, decimation rate, usb bus throughput (full speed bulk 
+     * transfers get about that much in practice) */
+    int cap_format = RFCAP_FMT_U8, cap_dec = 4; long bus_rate = 1000000;
+    /* mode name */
+    const char *n;
+    /* option */
+    int opt;
+
+    /* parse the command line */
+    while ((opt = getopt(argc, argv, "i:f:q:a:m:b:nr:c:x:d:u:")) != -1) {
+        switch (opt) {
+        case 'i' : in_name = optarg; break;
+        case 'f' : frequency = atof(optarg); break;
+        case 'q' : iq_name = optarg; break;
+        case 'a' : audio_name = optarg; break;
+        case 'b' : nb_threshold = atof(optarg); break;
+        case 'n' : notch = 1; break;
+        case 'r' : iq_rate = atoi(optarg); break;
+        case 'c' : cap_name = optarg; break;
+        case 'd' : cap_dec = atoi(optarg); break;
+        case 'u' : bus_rate = atol(optarg); break;
+        case 'x' : cap_format = !strcmp(optarg, "s16") ? RFCAP_FMT_S16 : 
+            !strcmp(optarg, "u8") ? RFCAP_FMT_U8 : RFCAP_FMT_OFF; break;
+        /* look for the mode with matching name */
+        case 'm' : {
+            for (mode = 0; (n = Radio_GetModeName(mode)) &&
+                strcmp(n, optarg); mode++);
+            if (!n) {
+                Main_Usage(argv[0]); return EXIT_FAILURE;
+            }
+        } break;
+        default : Main_Usage(argv[0]); return EXIT_FAILURE;
+        }
+    }
+
+    /* input file is a must */
+    if (!in_name) {
+        Main_Usage(argv[0]); return EXIT_FAILURE;
+    }
+    /* open files */
+    if (!(in = fopen(in_name, "rb")) ||
+        (iq_name && !(iq = fopen(iq_name, "wb"))) ||
+        (audio_name && !(audio = fopen(audio_name, "wb"))) ||
+        (cap_name && !(cap = fopen(cap_name, "wb")))) {
+        perror("fopen"); return EXIT_FAILURE;
+    }
+
+    /* bring up the 'drivers' in the same order as the target does */
+    RFIn_Init();
+    Dec_Init();
+    SAI1A_Init();
+    USBAudioSrc_Init();
+    USBRFCap_Init();
+    Display_Init();
+    CS43L22_Init();
+
+    /* initialize the radio receiver logic */
+    Radio_Init();
+    /* tune */
+    if (Radio_SetFrequency(frequency) != EOK) {
+        fprintf(stderr, "unsupported frequency\n"); return EXIT_FAILURE;
+    }
+    /* select the demodulation mode */
+    Radio_SetMode(mode);
+    /* set up the noise blanker */
+    if (Mix1_SetBlanker(nb_threshold) != EOK) {
+        fprintf(stderr, "unsupported noise blanker threshold\n");
+        return EXIT_FAILURE;
+    }
+    /* enable the adaptive notch */
+    Radio_SetNotch(notch);
+    /* 'usb host' selects the iq stream rate */
+    if (HostUSBAudioSrc_SelectRate(iq_rate) != EOK) {
+        fprintf(stderr, "unsupported iq rate\n"); return EXIT_FAILURE;
+    }
+    /* enable the rf capture */
+    if (cap && (cap_format == RFCAP_FMT_OFF || bus_rate <= 0 || 
+        RFCap_SetFormat(cap_format, cap_dec) != EOK)) {
+        fprintf(stderr, "unsupported rf capture format\n"); 
+        return EXIT_FAILURE;
+    }
+
+    /* number of samples per rf event and the corresponding number of the
+     * baseband samples and of the iq samples (at most) */
+    const int rf_num = HostRFIn_GetHalfSize();
+    const int bb_num = rf_num / DEC_DECIMATION_RATE;
+    const int iq_max = rf_num / DEC_MIN_DECIMATION_RATE;
+    /* data buffers */
+    int16_t *rf = malloc(rf_num * sizeof(*rf));
+    int32_t *iq_buf = malloc(iq_max * 2 * sizeof(*iq_buf));
+    int32_t *audio_buf = malloc(bb_num * sizeof(*audio_buf));
+    /* bus budget of a single frame (with the fraction carried over) */
+    double cap_budget = 0;
+    uint8_t *cap_buf = malloc(bus_rate * rf_num / RF_SAMPLING_FREQ + 1);
+    /* statistics */
+    long frames = 0, cap_bytes = 0; double elapsed = 0;
+
+    /* process all full frames from the capture */
+    while (fread(rf, sizeof(*rf), rf_num, in) == (size_t)rf_num) {
+        /* time the processing */
+        double start = Main_GetTime();
+        /* let the receiver do it's job */
+        HostRFIn_Feed(rf, rf_num);
+        /* update the statistics */
+        elapsed += Main_GetTime() - start, frames++;
+
+        /* 'usb host' reads the iq samples */
+        int iq_num = HostUSBAudioSrc_GetSamples(iq_buf, iq_max);
+        if (iq) fwrite(iq_buf, sizeof(*iq_buf) * 2, iq_num, iq);
+        /* 'dac' consumes the audio samples */
+        int audio_num = HostSAI1A_Drain(audio_buf, bb_num);
+        if (audio) fwrite(audio_buf, sizeof(*audio_buf), audio_num, audio);
+        /* 'usb host' reads the rf capture as fast as the bus allows */
+        if (cap) {
+            cap_budget += (double)bus_rate * rf_num / RF_SAMPLING_FREQ;
+            int cap_num = HostUSBRFCap_Read(cap_buf, (int)cap_budget);
+            fwrite(cap_buf, 1, cap_num, cap);
+            cap_budget -= (int)cap_budget, cap_bytes += cap_num;
+        }
+    }
+
+    /* actual frequency */
+    float f; Radio_GetFrequency(&f);
+    /* number of processed samples */
+    double samples = (double)frames * rf_num;
+    /* show the summary */
+    fprintf(stderr, "tuned to %.3f Hz, display: '%s'\n", f,
+        HostDisplay_GetContents());
+    /* noise blanker statistics */
+    uint32_t blanked; Mix1_GetBlanker(0, &blanked);
+    if (nb_threshold)
+        fprintf(stderr, "noise blanker: %u samples blanked\n", blanked);
+    /* carrier tracking status */
+    int locked; float offset; Radio_GetCarrier(&locked, &offset);
+    if (mode == RADIO_MODE_SAM)
+        fprintf(stderr, "carrier: %s, offset = %.3f Hz\n", locked ? 
+            "locked" : "not locked", offset);
+    /* rf capture statistics */
+    rfcap_stats_t cs; RFCap_GetStats(&cs);
+    if (cap)
+        fprintf(stderr, "rf capture: blocks = %u, sent = %u, dropped = %u, "
+            "torn = %u, %ld bytes read, throughput = %.1f kB/s\n", cs.blocks, 
+            cs.sent, cs.dropped, cs.torn, cap_bytes, samples > 0 ? 
+            cap_bytes / samples * RF_SAMPLING_FREQ * 1e-3 : 0);
+    fprintf(stderr, "frames = %ld, samples = %.0f, time = %.3f s, "
+        "throughput = %.3f Msps (%.1fx real-time)\n", frames, samples,
+        elapsed, elapsed > 0 ? samples / elapsed * 1e-6 : 0,
+        elapsed > 0 ? samples / elapsed / RF_SAMPLING_FREQ : 0);
+    /* show the processing stage profile (in host cpu clock equivalents) */
+    for (int i = 0; i < RADIO_PROF_NUM; i++) {
+        /* statistics */
+        prof_stats_t s; const char *name;
+        /* get the stage statistics */
+        Radio_GetProfile(i, &name, &s);
+        fprintf(stderr, "%-10s min = %7u, avg = %7u, max = %7u, "
+            "p99 = %7u\n", name, s.min, s.avg, s.max, s.p99);
+    }
+
+    /* release resources */
+    free(rf), free(iq_buf), free(audio_buf), free(cap_buf);
+    /* close files */
+    fclose(in);
+    if (iq) fclose(iq);
+    if (audio) fclose(audio);
+    if (cap) fclose(cap);
+
+    /* report status */
+    return EXIT_SUCCESS;
+}
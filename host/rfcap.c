@@ -0,0 +1,239 @@
+/**
+ * @file rfcap.c
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Host (Linux) reader of the raw rf capture stream. Reads the stream
+ * straight from the device (usbfs, no additional libraries needed) or from
+ * the file/standard input (the stream stored as is or the output of the
+ * replay harness), checks the block headers, tells the blocks dropped by the
+ * device from the ones lost on the way, unpacks the samples and reports the
+ * sustained throughput.
+ *
+ * Output format: raw, signed 16-bit little endian samples (adc lsb) @
+ * RF_SAMPLING_FREQ / decimation rate.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/usbdevice_fs.h>
+
+#include "config.h"
+#include "radio/rfcap.h"
+#include "util/minmax.h"
+
+/* rf capture interface number and the bulk in endpoint address */
+#define RFCAP_IFACE                         4
+#define RFCAP_EP_ADDR                       0x84
+/* size of a single usb read, usb read timeout [ms] */
+#define READ_SIZE                           16384
+#define READ_TIMEOUT                        1000
+/* size of the stream buffer (holds a couple of the largest blocks) */
+#define BUF_SIZE                            (4 * READ_SIZE)
+
+/* stream source: usbfs device or the file */
+static int usb_fd = -1;
+static FILE *in;
+/* stop request */
+static volatile sig_atomic_t stop;
+
+/* show the usage information */
+static void Main_Usage(const char *name)
+{
+    fprintf(stderr, "usage: %s (-u /dev/bus/usb/BBB/DDD | -i stream) "
+        "[-o samples_out] [-n blocks] [-z]\n", name);
+}
+
+/* get the monotonic time in seconds */
+static double Main_GetTime(void)
+{
+    /* time specification */
+    struct timespec ts;
+    /* read the clock */
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    /* convert */
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* stop on ctrl+c */
+static void Main_Signal(int sig)
+{
+    /* finish with the current block */
+    stop = 1;
+}
+
+/* read the piece of the stream, returns the number of bytes, 0 at the end */
+static int Main_Read(uint8_t *ptr, int size)
+{
+    /* file or the standard input */
+    if (in)
+        return fread(ptr, 1, size, in);
+
+    /* bulk transfer */
+    struct usbdevfs_bulktransfer bt = { .ep = RFCAP_EP_ADDR, .len = size,
+        .timeout = READ_TIMEOUT, .data = ptr };
+    /* timeouts are not fatal: the capture may be disabled for a while */
+    int rc;
+    while ((rc = ioctl(usb_fd, USBDEVFS_BULK, &bt)) < 0 && errno == ETIMEDOUT
+        && !stop);
+    /* report the number of bytes or the end of the stream */
+    return rc < 0 ? 0 : rc;
+}
+
+/* program main function */
+int main(int argc, char *argv[])
+{
+    /* file names */
+    const char *usb_name = 0, *in_name = 0, *out_name = 0;
+    /* output file */
+    FILE *out = 0;
+    /* number of blocks to read (0 - all), fill the gaps with zeros */
+    long max_blocks = 0; int zeros = 0;
+    /* option */
+    int opt;
+
+    /* parse the command line */
+    while ((opt = getopt(argc, argv, "u:i:o:n:z")) != -1) {
+        switch (opt) {
+        case 'u' : usb_name = optarg; break;
+        case 'i' : in_name = optarg; break;
+        case 'o' : out_name = optarg; break;
+        case 'n' : max_blocks = atol(optarg); break;
+        case 'z' : zeros = 1; break;
+        default : Main_Usage(argv[0]); return EXIT_FAILURE;
+        }
+    }
+
+    /* exactly one source is a must */
+    if (!usb_name == !in_name) {
+        Main_Usage(argv[0]); return EXIT_FAILURE;
+    }
+    /* open the stream file ('-' is the standard input) */
+    if (in_name && !(in = strcmp(in_name, "-") ? fopen(in_name, "rb") :
+        stdin)) {
+        perror("fopen"); return EXIT_FAILURE;
+    }
+    /* open the device and claim the rf capture interface */
+    if (usb_name) {
+        unsigned int iface = RFCAP_IFACE;
+        if ((usb_fd = open(usb_name, O_RDWR)) < 0 ||
+            ioctl(usb_fd, USBDEVFS_CLAIMINTERFACE, &iface) < 0) {
+            perror(usb_name); return EXIT_FAILURE;
+        }
+    }
+    /* open the output file */
+    if (out_name && !(out = fopen(out_name, "wb"))) {
+        perror("fopen"); return EXIT_FAILURE;
+    }
+    /* finish gracefully on ctrl+c */
+    signal(SIGINT, Main_Signal);
+
+    /* stream buffer and the amount of data within it */
+    static uint8_t buf[BUF_SIZE]; int buf_num = 0;
+    /* unpacked samples */
+    static int16_t samples[RFCAP_BLOCK_SIZE];
+    /* the gap filler */
+    static const int16_t silence[RFCAP_BLOCK_SIZE];
+    /* previous block header */
+    rfcap_hdr_t prev = { .magic = 0 };
+    /* statistics: blocks and bytes received, samples written, blocks missing
+     * (dropped by the device and lost on the way), torn, number of bytes
+     * skipped while looking for the header, restarts of the capture */
+    long blocks = 0, bytes = 0, written = 0, dropped = 0, lost = 0, torn = 0;
+    long skipped = 0, restarts = 0;
+    /* duration of the stream (in the rf samples) */
+    double span = 0;
+    /* time of the first block */
+    double start = Main_GetTime(), first = 0;
+
+    /* read until the end of the stream */
+    for (int eos = 0; !eos && !stop && (!max_blocks || blocks < max_blocks);) {
+        /* fill the buffer */
+        int n = Main_Read(buf + buf_num, min(READ_SIZE, BUF_SIZE - buf_num));
+        buf_num += n, eos = n == 0;
+
+        /* process all complete blocks */
+        int offs = 0;
+        while (buf_num - offs >= (int)sizeof(rfcap_hdr_t)) {
+            /* block header */
+            rfcap_hdr_t hdr; memcpy(&hdr, buf + offs, sizeof(hdr));
+            int size = RFCap_GetPayloadSize(&hdr);
+            /* not a valid header: resynchronize */
+            if (size < 0) {
+                offs++, skipped++; continue;
+            }
+            /* payload is not complete */
+            if (buf_num - offs < (int)sizeof(hdr) + size)
+                break;
+
+            /* unpack the samples */
+            int num = RFCap_Unpack(&hdr, buf + offs + sizeof(hdr), samples);
+            offs += sizeof(hdr) + size;
+
+            /* first block */
+            if (!blocks) {
+                first = Main_GetTime();
+            /* capture was restarted (counters start over) */
+            } else if (hdr.seq <= prev.seq || hdr.dropped < prev.dropped) {
+                restarts++;
+            /* continuation: missing blocks shall be covered by the counter of
+             * the dropped ones */
+            } else {
+                /* format has changed */
+                if (hdr.format != prev.format || hdr.dec != prev.dec)
+                    fprintf(stderr, "format change at block %u\n", hdr.seq);
+                /* blocks missing, blocks that the device has dropped */
+                long gap = hdr.seq - prev.seq - 1;
+                long drop = hdr.dropped - prev.dropped;
+                dropped += drop, lost += gap - drop;
+                torn += (uint16_t)(hdr.torn - prev.torn);
+                /* keep the time alignment */
+                for (long k = 0; zeros && out && k < gap; k++)
+                    fwrite(silence, sizeof(*silence), prev.num, out);
+                written += zeros ? gap * prev.num : 0;
+                span += gap * prev.num * prev.dec;
+            }
+
+            /* store the samples */
+            if (out)
+                fwrite(samples, sizeof(*samples), num, out);
+            /* update the statistics */
+            blocks++, bytes += sizeof(hdr) + size, written += num;
+            span += num * hdr.dec, prev = hdr;
+        }
+
+        /* move the leftover to the beginning of the buffer */
+        memmove(buf, buf + offs, buf_num - offs), buf_num -= offs;
+    }
+
+    /* time it took to receive the stream */
+    double elapsed = Main_GetTime() - (blocks ? first : start);
+    /* stream duration */
+    double duration = span / RF_SAMPLING_FREQ;
+    /* show the summary */
+    fprintf(stderr, "blocks = %ld, samples = %ld, bytes = %ld, "
+        "skipped bytes = %ld, restarts = %ld\n", blocks, written, bytes,
+        skipped, restarts);
+    fprintf(stderr, "missing blocks: dropped = %ld, lost = %ld, torn = %ld\n",
+        dropped, lost, torn);
+    fprintf(stderr, "stream time = %.3f s, throughput = %.1f kB/s "
+        "(%.1f kB/s of the wall clock time)\n", duration, duration > 0 ?
+        bytes / duration * 1e-3 : 0, elapsed > 0 ? bytes / elapsed * 1e-3 : 0);
+
+    /* close files */
+    if (in && in != stdin) fclose(in);
+    if (usb_fd >= 0) close(usb_fd);
+    if (out) fclose(out);
+
+    /* blocks lost on the way are an error */
+    return lost ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,41 @@
+/**
+ * @file debug.c
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Host stand-ins for the debugging facilities: debug strings go to the
+ * stderr and failed asserts terminate the process instead of resetting the mcu
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "err.h"
+#include "debug_dump.h"
+#include "reset.h"
+#include "at/ntf/debug.h"
+
+/* storage space for storing mcu state during critical failures */
+debug_assert_info_t debug_assert_info;
+
+/* there is no mcu to reset, report the assert and bail out */
+void Reset_ResetMCU(void)
+{
+    /* assert information is present? */
+    if (debug_assert_info.valid == DEBUG_VALID_ENTRY)
+        fprintf(stderr, "assert: %s (info = %#lx)\n",
+            debug_assert_info.message,
+            (unsigned long)debug_assert_info.additional_info);
+    /* terminate */
+    abort();
+}
+
+/* send debug data to the stderr */
+int ATNtfDebug_PutDebugData(const char *str, size_t len)
+{
+    /* write the string */
+    fwrite(str, 1, len, stderr);
+    /* report status */
+    return EOK;
+}
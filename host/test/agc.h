@@ -0,0 +1,20 @@
+/**
+ * @file agc.h
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Host test: automatic gain control
+ */
+
+#ifndef HOST_TEST_AGC_H
+#define HOST_TEST_AGC_H
+
+/**
+ * @brief Run the test
+ *
+ * @return int status (EOK if passed)
+ */
+int TestAGC_Run(void);
+
+#endif /* HOST_TEST_AGC_H */
@@ -0,0 +1,20 @@
+/**
+ * @file asrc.h
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Host test: asynchronous sample rate converter
+ */
+
+#ifndef HOST_TEST_ASRC_H
+#define HOST_TEST_ASRC_H
+
+/**
+ * @brief Run the test
+ *
+ * @return int status (EOK if passed)
+ */
+int TestASRC_Run(void);
+
+#endif /* HOST_TEST_ASRC_H */
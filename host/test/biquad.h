@@ -0,0 +1,20 @@
+/**
+ * @file biquad.h
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Host test: biquadratic filters
+ */
+
+#ifndef HOST_TEST_BIQUAD_H
+#define HOST_TEST_BIQUAD_H
+
+/**
+ * @brief Run the test
+ *
+ * @return int status (EOK if passed)
+ */
+int TestBiQuad_Run(void);
+
+#endif /* HOST_TEST_BIQUAD_H */
@@ -0,0 +1,20 @@
+/**
+ * @file chan.h
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Host test: polyphase channelizer
+ */
+
+#ifndef HOST_TEST_CHAN_H
+#define HOST_TEST_CHAN_H
+
+/**
+ * @brief Run the test
+ *
+ * @return int status (EOK if passed)
+ */
+int TestChan_Run(void);
+
+#endif /* HOST_TEST_CHAN_H */
@@ -0,0 +1,20 @@
+/**
+ * @file dec.h
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Host test: decimator completion logic
+ */
+
+#ifndef HOST_TEST_DEC_H
+#define HOST_TEST_DEC_H
+
+/**
+ * @brief Run the test
+ *
+ * @return int status (EOK if passed)
+ */
+int TestDec_Run(void);
+
+#endif /* HOST_TEST_DEC_H */
@@ -0,0 +1,20 @@
+/**
+ * @file demod_cw.h
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Host test: cw demodulator
+ */
+
+#ifndef HOST_TEST_DEMOD_CW_H
+#define HOST_TEST_DEMOD_CW_H
+
+/**
+ * @brief Run the test
+ *
+ * @return int status (EOK if passed)
+ */
+int TestDemodCW_Run(void);
+
+#endif /* HOST_TEST_DEMOD_CW_H */
@@ -0,0 +1,20 @@
+/**
+ * @file demod_sam.h
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Host test: synchronous am demodulator
+ */
+
+#ifndef HOST_TEST_DEMOD_SAM_H
+#define HOST_TEST_DEMOD_SAM_H
+
+/**
+ * @brief Run the test
+ *
+ * @return int status (EOK if passed)
+ */
+int TestDemodSAM_Run(void);
+
+#endif /* HOST_TEST_DEMOD_SAM_H */
@@ -0,0 +1,20 @@
+/**
+ * @file demod_ssb.h
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Host test: single sideband demodulator
+ */
+
+#ifndef HOST_TEST_DEMOD_SSB_H
+#define HOST_TEST_DEMOD_SSB_H
+
+/**
+ * @brief Run the test
+ *
+ * @return int status (EOK if passed)
+ */
+int TestDemodSSB_Run(void);
+
+#endif /* HOST_TEST_DEMOD_SSB_H */
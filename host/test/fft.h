@@ -0,0 +1,20 @@
+/**
+ * @file fft.h
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Host test: fast fourier transform
+ */
+
+#ifndef HOST_TEST_FFT_H
+#define HOST_TEST_FFT_H
+
+/**
+ * @brief Run the test
+ *
+ * @return int status (EOK if passed)
+ */
+int TestFFT_Run(void);
+
+#endif /* HOST_TEST_FFT_H */
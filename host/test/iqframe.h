@@ -0,0 +1,20 @@
+/**
+ * @file iqframe.h
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Host test: binary framed iq notifications
+ */
+
+#ifndef HOST_TEST_IQFRAME_H
+#define HOST_TEST_IQFRAME_H
+
+/**
+ * @brief Run the test
+ *
+ * @return int status (EOK if passed)
+ */
+int TestIQFrame_Run(void);
+
+#endif /* HOST_TEST_IQFRAME_H */
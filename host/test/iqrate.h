@@ -0,0 +1,20 @@
+/**
+ * @file iqrate.h
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Host test: runtime selectable iq stream sampling rate
+ */
+
+#ifndef HOST_TEST_IQRATE_H
+#define HOST_TEST_IQRATE_H
+
+/**
+ * @brief Run the test
+ *
+ * @return int status (EOK if passed)
+ */
+int TestIQRate_Run(void);
+
+#endif /* HOST_TEST_IQRATE_H */
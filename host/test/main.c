@@ -0,0 +1,107 @@
+/**
+ * @file main.c
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Host (Linux) regression test runner. Runs all the tests (or the ones
+ * given by name in the command line) and reports the overall status with the
+ * exit code.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "err.h"
+#include "host/test/agc.h"
+#include "host/test/asrc.h"
+#include "host/test/biquad.h"
+#include "host/test/chan.h"
+#include "host/test/dec.h"
+#include "host/test/demod_cw.h"
+#include "host/test/demod_sam.h"
+#include "host/test/demod_ssb.h"
+#include "host/test/fft.h"
+#include "host/test/iqframe.h"
+#include "host/test/iqrate.h"
+#include "host/test/meter.h"
+#include "host/test/mix1.h"
+#include "host/test/mix2.h"
+#include "host/test/nb.h"
+#include "host/test/notch.h"
+#include "host/test/prof.h"
+#include "host/test/rfcap.h"
+#include "host/test/scan.h"
+#include "host/test/sdec.h"
+#include "host/test/spectrum.h"
+#include "host/test/uac2.h"
+#include "util/elems.h"
+
+/* list of tests */
+static const struct {
+    /* test name */
+    const char *name;
+    /* test function */
+    int (*run)(void);
+} tests[] = {
+    { "prof", TestProf_Run },
+    { "mix1", TestMix1_Run },
+    { "nb", TestNB_Run },
+    { "mix2", TestMix2_Run },
+    { "biquad", TestBiQuad_Run },
+    { "sdec", TestSDec_Run },
+    { "dec", TestDec_Run },
+    { "demod_ssb", TestDemodSSB_Run },
+    { "demod_sam", TestDemodSAM_Run },
+    { "demod_cw", TestDemodCW_Run },
+    { "chan", TestChan_Run },
+    { "fft", TestFFT_Run },
+    { "spectrum", TestSpectrum_Run },
+    { "scan", TestScan_Run },
+    { "agc", TestAGC_Run },
+    { "meter", TestMeter_Run },
+    { "notch", TestNotch_Run },
+    { "asrc", TestASRC_Run },
+    { "uac2", TestUAC2_Run },
+    { "iqrate", TestIQRate_Run },
+    { "rfcap", TestRFCap_Run },
+    { "iqframe", TestIQFrame_Run },
+};
+
+/* returns true if the test was selected in the command line */
+static int Main_IsSelected(const char *name, int argc, char *argv[])
+{
+    /* no names given: run everything */
+    if (argc < 2)
+        return 1;
+    /* look for the name */
+    for (int i = 1; i < argc; i++)
+        if (!strcmp(argv[i], name))
+            return 1;
+    /* not selected */
+    return 0;
+}
+
+/* program main function */
+int main(int argc, char *argv[])
+{
+    /* number of failed tests */
+    int failed = 0;
+
+    /* run selected tests */
+    for (int i = 0; i < (int)elems(tests); i++) {
+        /* skip unselected ones */
+        if (!Main_IsSelected(tests[i].name, argc, argv))
+            continue;
+        /* run the test */
+        printf("%s:\n", tests[i].name);
+        int rc = tests[i].run();
+        /* show the result */
+        printf("%s: %s\n", tests[i].name, rc == EOK ? "PASSED" : "FAILED");
+        failed += rc != EOK;
+    }
+
+    /* report status */
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,20 @@
+/**
+ * @file meter.h
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Host test: signal meter and squelch
+ */
+
+#ifndef HOST_TEST_METER_H
+#define HOST_TEST_METER_H
+
+/**
+ * @brief Run the test
+ *
+ * @return int status (EOK if passed)
+ */
+int TestMeter_Run(void);
+
+#endif /* HOST_TEST_METER_H */
@@ -0,0 +1,20 @@
+/**
+ * @file mix1.h
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Host test: 1st stage mixer
+ */
+
+#ifndef HOST_TEST_MIX1_H
+#define HOST_TEST_MIX1_H
+
+/**
+ * @brief Run the test
+ *
+ * @return int status (EOK if passed)
+ */
+int TestMix1_Run(void);
+
+#endif /* HOST_TEST_MIX1_H */
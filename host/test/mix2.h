@@ -0,0 +1,20 @@
+/**
+ * @file mix2.h
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Host test: 2nd stage mixer fused with the usb data preparation
+ */
+
+#ifndef HOST_TEST_MIX2_H
+#define HOST_TEST_MIX2_H
+
+/**
+ * @brief Run the test
+ *
+ * @return int status (EOK if passed)
+ */
+int TestMix2_Run(void);
+
+#endif /* HOST_TEST_MIX2_H */
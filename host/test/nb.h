@@ -0,0 +1,20 @@
+/**
+ * @file nb.h
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Host test: noise blanker
+ */
+
+#ifndef HOST_TEST_NB_H
+#define HOST_TEST_NB_H
+
+/**
+ * @brief Run the test
+ *
+ * @return int status (EOK if passed)
+ */
+int TestNB_Run(void);
+
+#endif /* HOST_TEST_NB_H */
@@ -0,0 +1,20 @@
+/**
+ * @file notch.h
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Host test: adaptive notch
+ */
+
+#ifndef HOST_TEST_NOTCH_H
+#define HOST_TEST_NOTCH_H
+
+/**
+ * @brief Run the test
+ *
+ * @return int status (EOK if passed)
+ */
+int TestNotch_Run(void);
+
+#endif /* HOST_TEST_NOTCH_H */
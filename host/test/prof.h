@@ -0,0 +1,21 @@
+/**
+ * @file prof.h
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Host test: execution time profiler and the stage cycle budgets of
+ * the radio receiver
+ */
+
+#ifndef HOST_TEST_PROF_H
+#define HOST_TEST_PROF_H
+
+/**
+ * @brief Run the test
+ *
+ * @return int status (EOK if passed)
+ */
+int TestProf_Run(void);
+
+#endif /* HOST_TEST_PROF_H */
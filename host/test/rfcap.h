@@ -0,0 +1,20 @@
+/**
+ * @file rfcap.h
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Host test: raw rf capture over the usb bulk endpoint
+ */
+
+#ifndef HOST_TEST_RFCAP_H
+#define HOST_TEST_RFCAP_H
+
+/**
+ * @brief Run the test
+ *
+ * @return int status (EOK if passed)
+ */
+int TestRFCap_Run(void);
+
+#endif /* HOST_TEST_RFCAP_H */
@@ -0,0 +1,20 @@
+/**
+ * @file scan.h
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Host test: wideband scan
+ */
+
+#ifndef HOST_TEST_SCAN_H
+#define HOST_TEST_SCAN_H
+
+/**
+ * @brief Run the test
+ *
+ * @return int status (EOK if passed)
+ */
+int TestScan_Run(void);
+
+#endif /* HOST_TEST_SCAN_H */
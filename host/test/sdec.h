@@ -0,0 +1,20 @@
+/**
+ * @file sdec.h
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Host test: software decimators
+ */
+
+#ifndef HOST_TEST_SDEC_H
+#define HOST_TEST_SDEC_H
+
+/**
+ * @brief Run the test
+ *
+ * @return int status (EOK if passed)
+ */
+int TestSDec_Run(void);
+
+#endif /* HOST_TEST_SDEC_H */
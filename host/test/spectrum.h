@@ -0,0 +1,20 @@
+/**
+ * @file spectrum.h
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Host test: spectrum engine
+ */
+
+#ifndef HOST_TEST_SPECTRUM_H
+#define HOST_TEST_SPECTRUM_H
+
+/**
+ * @brief Run the test
+ *
+ * @return int status (EOK if passed)
+ */
+int TestSpectrum_Run(void);
+
+#endif /* HOST_TEST_SPECTRUM_H */
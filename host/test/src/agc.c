@@ -0,0 +1,167 @@
+/**
+ * @file agc.c
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Host test: automatic gain control. Tone bursts that are 60dB apart
+ * must come out at the target level, the sudden 60dB rise must not overshoot
+ * thanks to the look-ahead and the gain must be held for the hang time. Whole
+ * receiver tuned to the am stations that differ by 60dB must produce the
+ * audio of the same level without clipping.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "config.h"
+#include "err.h"
+#include "host/host.h"
+#include "host/test/agc.h"
+#include "host/test/test.h"
+#include "radio/agc.h"
+#include "radio/radio.h"
+
+/* baseband samples per rf frame */
+#define BLOCK_SIZE                      96
+/* tone frequency */
+#define TONE_FREQ                       1000.0
+
+/* feed 'seconds' worth of the tone of amplitude 'a' through the agc, returns
+ * the output peak within the last 'tail' seconds */
+static float TestAGC_Feed(double a, double seconds, double tail)
+{
+    /* block of data */
+    float x[BLOCK_SIZE];
+    /* phase is kept between the calls */
+    static long n;
+    /* output peak */
+    float peak = 0;
+    /* number of blocks */
+    long blocks = seconds * BB_SAMPLING_RATE / BLOCK_SIZE;
+
+    /* generate and process */
+    for (long b = 0; b < blocks; b++) {
+        for (int k = 0; k < BLOCK_SIZE; k++, n++)
+            x[k] = a * sin(2 * M_PI * TONE_FREQ * n / BB_SAMPLING_RATE);
+        AGC_Process(x, BLOCK_SIZE, 1.0f, x);
+        /* look for the peak at the end */
+        if (b >= blocks - tail * BB_SAMPLING_RATE / BLOCK_SIZE)
+            for (int k = 0; k < BLOCK_SIZE; k++)
+                peak = fmaxf(peak, fabsf(x[k]));
+    }
+
+    /* report the peak */
+    return peak;
+}
+
+/* run the whole receiver on the station of given amplitude (re-tuning to it
+ * first if requested), returns the peak of the dac samples (relative to the
+ * full scale) within the last 100ms and the overall one */
+static int TestAGC_Receiver(float amp, int tune, float *peak, float *all,
+    float *gain, float *rssi)
+{
+    /* station, the phase is kept between the calls */
+    static test_am_t station = { .fc = 225000, .fm = 1000, .depth = 0.5 };
+    /* number of samples per rf event */
+    const int rf_num = HostRFIn_GetHalfSize();
+    const int bb_num = rf_num / DEC_DECIMATION_RATE;
+    /* data buffers */
+    int16_t rf[rf_num]; int32_t out[bb_num * 2];
+
+    /* tuning to the station resets the agc */
+    if (tune)
+        test_check(TestHost_StartRadio(station.fc) == EOK, "tune");
+    /* 1s of data */
+    station.amp = amp, *peak = *all = 0;
+    for (int f = 0; f < 500; f++) {
+        TestHost_GenAM(&station, rf, rf_num);
+        test_check(HostRFIn_Feed(rf, rf_num) == EOK, "feed");
+        HostUSBAudioSrc_GetSamples(out, bb_num);
+        HostSAI1A_Drain(out, bb_num);
+        /* dac samples use 24 bits */
+        for (int k = 0; k < bb_num; k++) {
+            float x = abs(out[k]) / 8388608.0f;
+            *all = fmaxf(*all, x);
+            *peak = f >= 450 ? fmaxf(*peak, x) : 0;
+        }
+    }
+    /* agc state */
+    Radio_GetAGCStatus(gain, rssi);
+
+    /* report status */
+    return EOK;
+}
+
+/* run the test */
+int TestAGC_Run(void)
+{
+    /* fast attack, short hang, slow decay */
+    agc_cfg_t cfg = { .attack = 0.5e-3f, .hang = 0.1f, .decay = 0.2f,
+        .max_gain = 80 };
+    /* output peaks, agc state */
+    float strong, weak, rise, held, all, gain, rssi, gain0, rssi0;
+
+    /* invalid settings */
+    agc_cfg_t bad = cfg; bad.max_gain = AGC_MAX_GAIN + 1;
+    test_check(AGC_Init(&bad) == EFATAL, "max gain");
+    bad = cfg; bad.decay = -1;
+    test_check(AGC_SetConfig(&bad) == EFATAL, "decay");
+
+    /* strong tone, then 60dB weaker one */
+    test_check(AGC_Init(&cfg) == EOK, "init");
+    strong = TestAGC_Feed(0.5, 1, 0.1);
+    weak = TestAGC_Feed(0.0005, 3, 0.1);
+    AGC_GetStatus(&gain, 0);
+    /* back to the strong one: the rise must be caught by the look-ahead */
+    rise = TestAGC_Feed(0.5, 0.1, 0.1);
+    /* show the results */
+    printf("  strong: %.1f dB, weak: %.1f dB, gain = %.1f dB, rise: "
+        "%.1f dB (target = %.1f dB)\n", 20 * log10(strong),
+        20 * log10(weak), 20 * log10(gain), 20 * log10(rise),
+        20 * log10(AGC_TARGET));
+    test_check(fabs(20 * log10(strong / AGC_TARGET)) < 0.5, "strong");
+    test_check(fabs(20 * log10(weak / AGC_TARGET)) < 0.5, "weak");
+    test_check(fabs(20 * log10(gain) - 20 * log10(AGC_TARGET / 0.0005)) < 1,
+        "gain");
+    test_check(rise < AGC_TARGET * 1.05f, "overshoot");
+
+    /* signal drop within the hang time keeps the gain, so the weak tone
+     * stays weak */
+    held = TestAGC_Feed(0.05, 0.05, 0.02);
+    printf("  20dB drop within the hang time: %.1f dB\n", 20 * log10(held));
+    test_check(fabs(20 * log10(held / AGC_TARGET) + 20) < 1, "hang");
+
+    /* the gain does not go beyond the maximum */
+    cfg.max_gain = 20;
+    test_check(AGC_SetConfig(&cfg) == EOK, "config");
+    weak = TestAGC_Feed(0.0005, 3, 0.1);
+    printf("  max gain of 20dB: %.1f dB\n", 20 * log10(weak));
+    test_check(fabs(20 * log10(weak / 0.005)) < 0.5, "max gain");
+
+    /* whole receiver: strong station and the one 60dB weaker. the agc
+     * settings of the am mode are re-applied as the ones above were put
+     * directly into the agc */
+    test_check(TestHost_StartRadio(225000) == EOK, "start");
+    test_check(Radio_GetAGC(RADIO_MODE_AM, &cfg) == EOK, "get");
+    test_check(Radio_SetAGC(RADIO_MODE_AM, &cfg) == EOK, "set");
+    test_check(TestAGC_Receiver(2000, 1, &strong, &all, &gain0, &rssi0) ==
+        EOK, "rx");
+    test_check(TestAGC_Receiver(2, 1, &weak, &all, &gain, &rssi) == EOK,
+        "rx");
+    printf("  receiver: strong: %.1f dB (gain = %.1f dB, rssi = %.1f dB), "
+        "weak: %.1f dB (gain = %.1f dB, rssi = %.1f dB)\n",
+        20 * log10(strong), gain0, rssi0, 20 * log10(weak), gain, rssi);
+    test_check(fabs(20 * log10(strong / AGC_TARGET)) < 1, "strong");
+    test_check(fabs(20 * log10(weak / AGC_TARGET)) < 3, "weak");
+    test_check(fabs(rssi0 - rssi - 60) < 2, "rssi");
+    /* the weak station suddenly gets 60dB stronger: no clipping */
+    test_check(TestAGC_Receiver(2000, 0, &strong, &all, &gain, &rssi) ==
+        EOK, "rx");
+    printf("  60dB rise: peak = %.1f dB\n", 20 * log10(all));
+    test_check(all < AGC_TARGET * 1.1f, "peak = %f", all);
+
+    /* report status */
+    return EOK;
+}
@@ -0,0 +1,280 @@
+/**
+ * @file asrc.c
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Host test: asynchronous sample rate converter. Tones resampled with
+ * the fixed ratios must stay clean (thd+n measured against the fitted sine). The
+ * sink that runs off its own clock (ppm offset) is simulated: the servo must
+ * find the ratio without any buffer under- or overflows, the tone must stay
+ * clean while it is being tracked and the latency (measured with a step) must
+ * follow the fill level target. Whole receiver with the dac drained at the
+ * offset rate must find the offset as well.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "config.h"
+#include "err.h"
+#include "dsp/asrc.h"
+#include "host/host.h"
+#include "host/test/asrc.h"
+#include "host/test/test.h"
+#include "radio/radio.h"
+#include "util/elems.h"
+
+/* input samples per block */
+#define BLOCK_SIZE                      96
+/* tone amplitude */
+#define TONE_AMP                        0.5
+/* sink buffer size and the fill level that the servo keeps */
+#define SINK_SIZE                       4096
+#define SINK_TARGET                     1536
+/* length of the sink simulation in seconds, the step is applied that many
+ * seconds before the end */
+#define SINK_TIME                       10
+#define SINK_STEP                       0.5
+
+/* thd+n of the tone at around frequency 'f' (cycles per sample) in dB: the
+ * sine (with the dc) is fitted with the least squares, the frequency is
+ * refined along the way (the converter that tracks the sink clock is never
+ * exactly at the nominal ratio), the power of what is left is compared to the
+ * power of the fit */
+static double TestASRC_THDN(const float *x, int num, double f)
+{
+    /* fitted parameters: cos and sin amplitudes, dc, frequency correction */
+    double p[4] = { 0 }, w = 2 * M_PI * f;
+    /* residual power */
+    double rest = 0;
+
+    /* few rounds of the gauss-newton: first one fits the amplitudes only */
+    for (int it = 0, dim = 3; it < 6; it++, dim = 4) {
+        /* normal equations */
+        double m[4][5] = { { 0 } };
+        for (int n = 0; n < num; n++) {
+            /* time relative to the middle of the block */
+            double t = n - num / 2, c = cos(w * t), s = sin(w * t);
+            /* derivatives of the model */
+            double d[4] = { c, s, 1, t * (p[1] * c - p[0] * s) };
+            for (int i = 0; i < dim; i++) {
+                for (int j = 0; j < dim; j++)
+                    m[i][j] += d[i] * d[j];
+                m[i][dim] += d[i] * x[n];
+            }
+        }
+        /* gauss-jordan elimination */
+        for (int i = 0; i < dim; i++)
+            for (int j = 0; j < dim; j++)
+                if (j != i)
+                    for (int k = dim; k >= i; k--)
+                        m[j][k] -= m[j][i] / m[i][i] * m[i][k];
+        /* new amplitudes, refined frequency */
+        for (int i = 0; i < 3; i++)
+            p[i] = m[i][dim] / m[i][i];
+        if (dim == 4)
+            w += m[3][dim] / m[3][3];
+    }
+
+    /* residual */
+    for (int n = 0; n < num; n++) {
+        double t = n - num / 2;
+        double e = x[n] - p[0] * cos(w * t) - p[1] * sin(w * t) - p[2];
+        rest += e * e;
+    }
+    /* report the ratio to the tone power */
+    return 10 * log10(rest / num / ((p[0] * p[0] + p[1] * p[1]) / 2));
+}
+
+/* resample the tone of frequency 'f' (Hz at the input rate of
+ * BB_SAMPLING_RATE) with the fixed ratio, returns the thd+n */
+static int TestASRC_Fixed(double ratio, double f, double *thdn)
+{
+    /* one second of the output (with the margin for the ratios below 1) */
+    static float out[BB_SAMPLING_RATE * 2];
+    /* input block */
+    float in[BLOCK_SIZE];
+    /* converter */
+    asrc_t a; int num = 0;
+
+    /* servo is not used */
+    test_check(ASRC_Init(&a, ratio, 0, 1) == EOK, "init");
+    /* one second of the tone */
+    for (int n = 0; n < BB_SAMPLING_RATE; n += BLOCK_SIZE) {
+        for (int k = 0; k < BLOCK_SIZE; k++)
+            in[k] = TONE_AMP * sin(2 * M_PI * f * (n + k) / BB_SAMPLING_RATE);
+        num += ASRC_Process(&a, in, BLOCK_SIZE, out + num);
+    }
+    /* number of the output samples must follow the ratio */
+    test_check(abs(num - (int)lrint(BB_SAMPLING_RATE / ratio)) <= 1,
+        "num = %d", num);
+    /* skip the filter start-up */
+    *thdn = TestASRC_THDN(out + ASRC_TAPS, num - ASRC_TAPS,
+        f * (float)ratio / BB_SAMPLING_RATE);
+
+    /* report status */
+    return EOK;
+}
+
+/* simulate the sink that consumes the samples at the rate that differs by
+ * 'ppm' from the input rate. Reports the thd+n of the tone while the ratio
+ * is tracked, the latency of the step, the final ratio correction and the
+ * fill level error */
+static int TestASRC_Sink(double ppm, double *thdn, double *latency,
+    float *corr, float *err)
+{
+    /* sink buffer and all the samples that the sink has consumed */
+    static float buf[SINK_SIZE], sink[BB_SAMPLING_RATE * (SINK_TIME + 1)];
+    /* buffer pointers, number of the consumed samples */
+    long head = 0, tail = 0, consumed = 0;
+    /* input block, resampled block */
+    float in[BLOCK_SIZE], out[BLOCK_SIZE + 2];
+    /* sink rate, consumption accumulator */
+    const double rate = BB_SAMPLING_RATE * (1 + ppm * 1e-6);
+    double acc = 0;
+    /* block at which the sink was started, index of the step sample */
+    long start = -1, step = (long)((SINK_TIME - SINK_STEP) *
+        BB_SAMPLING_RATE);
+    /* converter */
+    asrc_t a;
+
+    /* nominal ratio is 1, the servo needs to find the actual one */
+    test_check(ASRC_Init(&a, 1, SINK_TARGET, ASRC_SERVO_TIME *
+        BB_SAMPLING_RATE / 1000.0f) == EOK, "init");
+    /* go block by block */
+    for (long n = 0, b = 0; n < SINK_TIME * BB_SAMPLING_RATE;
+        n += BLOCK_SIZE, b++) {
+        /* fill level goes to the servo once the sink is running */
+        if (start >= 0)
+            ASRC_Servo(&a, head - tail, BLOCK_SIZE);
+        /* tone, silence before the step, step */
+        for (int k = 0; k < BLOCK_SIZE; k++)
+            in[k] = n + k >= step ? TONE_AMP : n + k < step -
+                BB_SAMPLING_RATE / 10 ? TONE_AMP * sin(2 * M_PI * 1000 *
+                (n + k) / BB_SAMPLING_RATE) : 0;
+        /* resample and store */
+        int num = ASRC_Process(&a, in, BLOCK_SIZE, out);
+        test_check(head + num - tail <= SINK_SIZE, "overflow at %ld", n);
+        for (int k = 0; k < num; k++, head++)
+            buf[head % SINK_SIZE] = out[k];
+
+        /* sink starts once the buffer is filled up to the target (which is
+         * sampled before the block is stored) */
+        if (start < 0 && head - tail >= SINK_TARGET + BLOCK_SIZE)
+            start = b;
+        /* sink consumes the samples at its own rate during the next block */
+        if (start >= 0) {
+            acc += BLOCK_SIZE * rate / BB_SAMPLING_RATE;
+            for (; acc >= 1; acc -= 1, tail++) {
+                test_check(tail < head, "underflow at %ld", n);
+                sink[consumed++] = buf[tail % SINK_SIZE];
+            }
+        }
+    }
+
+    /* tone during the last second before the silence */
+    long from = (long)((SINK_TIME - SINK_STEP - 1.1) * rate);
+    *thdn = TestASRC_THDN(sink + from, (long)rate, 1000 / rate);
+    /* look for the step, sink sample 0 was consumed right after the start
+     * block was stored */
+    long j = (long)((SINK_TIME - SINK_STEP - 0.05) * rate);
+    for (; j < consumed && sink[j] < TONE_AMP / 2; j++);
+    test_check(j < consumed, "no step");
+    *latency = (start + 1) * (double)BLOCK_SIZE / BB_SAMPLING_RATE +
+        j / rate - (double)step / BB_SAMPLING_RATE;
+    /* servo state */
+    ASRC_GetStatus(&a, corr, err);
+    *err -= SINK_TARGET;
+
+    /* report status */
+    return EOK;
+}
+
+/* run the whole receiver with the dac that runs 'ppm' off the nominal rate,
+ * returns the ratio correction and the fill level after 2 and 4 seconds */
+static int TestASRC_Receiver(double ppm, float *corr, float *fill2,
+    float *fill4)
+{
+    /* station */
+    test_am_t am = { .fc = 225000, .fm = 1000, .amp = 1000, .depth = 0.5 };
+    /* number of samples per rf event */
+    const int rf_num = HostRFIn_GetHalfSize();
+    const int bb_num = rf_num / DEC_DECIMATION_RATE;
+    /* data buffers */
+    int16_t rf[rf_num]; int32_t out[bb_num * 2];
+    /* consumption accumulator */
+    double acc = 0;
+
+    /* 4s of data */
+    for (int f = 0; f < 2000; f++) {
+        TestHost_GenAM(&am, rf, rf_num);
+        test_check(HostRFIn_Feed(rf, rf_num) == EOK, "feed");
+        HostUSBAudioSrc_GetSamples(out, bb_num);
+        /* dac runs at its own rate */
+        acc += bb_num * (1 + ppm * 1e-6);
+        HostSAI1A_Drain(out, (int)acc), acc -= (int)acc;
+        /* fill levels */
+        if (f == 999)
+            Radio_GetAudioSync(0, fill2);
+    }
+    Radio_GetAudioSync(corr, fill4);
+
+    /* report status */
+    return EOK;
+}
+
+/* run the test */
+int TestASRC_Run(void)
+{
+    /* fixed ratios: none, the nominal one of the dac, the extremes of the
+     * servo range and the 48k -> 44.1k conversion */
+    const double ratios[] = { 1.0, BB_SAMPLING_RATE /
+        SAI1_ACTUAL_SAMPLING_RATE, 1 + ASRC_MAX_PPM * 1e-6,
+        1 - ASRC_MAX_PPM * 1e-6, 48000.0 / 44100.0 };
+    /* sink clock offsets */
+    const double ppms[] = { 0, 250, -250, 500 };
+    /* measurements */
+    double thdn, latency; float corr, err, fill2, fill4;
+
+    /* fixed ratios */
+    for (int i = 0; i < (int)elems(ratios); i++) {
+        for (double f = 1000; f <= 3000; f += 2000) {
+            test_check(TestASRC_Fixed(ratios[i], f, &thdn) == EOK, "fixed");
+            printf("  ratio = %.6f, %4.0f Hz: thd+n = %.1f dB\n", ratios[i],
+                f, thdn);
+            test_check(thdn < -80, "thd+n");
+        }
+    }
+
+    /* sinks off the nominal rate */
+    for (int i = 0; i < (int)elems(ppms); i++) {
+        test_check(TestASRC_Sink(ppms[i], &thdn, &latency, &corr, &err) ==
+            EOK, "sink");
+        printf("  sink at %+4.0f ppm: correction = %+7.1f ppm, fill error = "
+            "%+.0f, thd+n = %.1f dB, latency = %.2f ms\n", ppms[i], corr,
+            err, thdn, latency * 1000);
+        test_check(fabs(corr + ppms[i]) < 2, "correction");
+        test_check(fabs(err) < 4, "fill level");
+        test_check(thdn < -70, "thd+n");
+        /* fill level plus up to two blocks and the filter delay */
+        test_check(latency > (double)SINK_TARGET / BB_SAMPLING_RATE &&
+            latency < (double)(SINK_TARGET + 2 * BLOCK_SIZE + ASRC_TAPS) /
+            BB_SAMPLING_RATE, "latency");
+    }
+
+    /* whole receiver with the dac running 300ppm fast */
+    test_check(TestHost_StartRadio(225000) == EOK, "start");
+    test_check(TestASRC_Receiver(300, &corr, &fill2, &fill4) == EOK, "rx");
+    /* dac rate that the converter expects vs the one that it gets */
+    double expected = (SAI1_ACTUAL_SAMPLING_RATE / (BB_SAMPLING_RATE *
+        (1 + 300e-6)) - 1) * 1e6;
+    printf("  receiver, dac at +300 ppm: correction = %+.1f ppm "
+        "(%+.1f ppm), fill = %.0f (%.0f)\n", corr, expected, fill4, fill2);
+    test_check(fabs(corr - expected) < 10, "correction");
+    test_check(fabs(fill4 - fill2) < 10, "fill level");
+
+    /* report status */
+    return EOK;
+}
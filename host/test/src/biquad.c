@@ -0,0 +1,263 @@
+/**
+ * @file biquad.c
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Host test: biquadratic filters. The cascaded I/Q filter must give
+ * bit-exact results when compared to the consecutive BiQuad_Filter() calls
+ * (section after section, channel after channel), also when the data is
+ * split into blocks. Execution times of both approaches are reported.
+ * Fixed point (Q31/Q15) variants are compared against the double precision
+ * model in terms of the noise floor and the execution time.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "err.h"
+#include "arch/arch_fpu.h"
+#include "dev/cyccnt.h"
+#include "dsp/biquad.h"
+#include "host/test/biquad.h"
+#include "host/test/test.h"
+#include "util/elems.h"
+
+/* number of samples */
+#define DATA_SIZE                       4800
+/* block size (baseband samples per rf frame) */
+#define BLOCK_SIZE                      96
+
+/* filter sections: the demodulator low pass filter followed by the dc
+ * removal filter and a resonant one */
+static const biquad_taps_t taps[BIQUAD_MAX_SECTIONS] = {
+    { .b0 = +4.834173e-04, .b1 = +9.668347e-04, .b2 = +4.834173e-04,
+      .a1 = -1.460218e+00, .a2 = +5.420541e-01 },
+    { .b0 = +1.000000e+00, .b1 = +2.000000e+00, .b2 = +1.000000e+00,
+      .a1 = -1.686415e+00, .a2 = +7.809287e-01 },
+    { .b0 = +9.972270e-01, .b1 = -1.994454e+00, .b2 = +9.972270e-01,
+      .a1 = -1.994446e+00, .a2 = +9.944618e-01 },
+    { .b0 = +2.000000e-02, .b1 = +0.000000e+00, .b2 = -2.000000e-02,
+      .a1 = -1.900000e+00, .a2 = +9.600000e-01 },
+};
+
+/* decimation low pass filter (the one used by the dec4 module) */
+static const biquad_taps_t dec4_taps[] = {
+    { .b0 = +4.824343e-03, .b1 = +9.648687e-03, .b2 = +4.824343e-03,
+      .a1 = -1.048600e+00, .a2 = +2.961404e-01 },
+    { .b0 = +1.000000e+00, .b1 = +2.000000e+00, .b2 = +1.000000e+00,
+      .a1 = -1.320913e+00, .a2 = +6.327388e-01 },
+};
+
+/* set up the filters */
+static void TestBiQuad_Setup(biquad_t *bq, int sections)
+{
+    /* set the taps, reset the delay lines */
+    for (int s = 0; s < sections; s++)
+        BiQuad_SetTaps(&bq[s], &taps[s]);
+}
+
+/* filter with the consecutive calls to BiQuad_Filter */
+static void TestBiQuad_Separate(const float *i, const float *q, int len,
+    biquad_t *bq_i, biquad_t *bq_q, int sections, float *i_out, float *q_out)
+{
+    /* in-phase channel: first section reads the input, all others work
+     * in-situ */
+    for (int s = 0; s < sections; s++)
+        BiQuad_Filter(s ? i_out : i, len, &bq_i[s], i_out);
+    /* quadrature channel */
+    for (int s = 0; s < sections; s++)
+        BiQuad_Filter(s ? q_out : q, len, &bq_q[s], q_out);
+}
+
+/* double precision model of the filter cascade (direct form I) */
+static void TestBiQuad_Model(const float *src, int len,
+    const biquad_taps_t *t, int sections, double *dst)
+{
+    /* delay lines */
+    double dl[BIQUAD_MAX_SECTIONS][4] = { { 0 } };
+
+    /* process all the samples */
+    for (int n = 0; n < len; n++) {
+        /* input sample */
+        double x = src[n], y;
+        /* go through all the sections */
+        for (int s = 0; s < sections; s++, x = y) {
+            double *d = dl[s];
+            y = t[s].b0 * x + t[s].b1 * d[0] + t[s].b2 * d[1] -
+                t[s].a1 * d[2] - t[s].a2 * d[3];
+            d[1] = d[0], d[0] = x, d[3] = d[2], d[2] = y;
+        }
+        /* store */
+        dst[n] = x;
+    }
+}
+
+/* noise floor in dBFS: power of the difference between the output and the
+ * model */
+static float TestBiQuad_NoiseFloor(const double *model, const float *out,
+    int len)
+{
+    /* error power */
+    double pwr = 0;
+    /* sum up */
+    for (int n = 0; n < len; n++)
+        pwr += (out[n] - model[n]) * (out[n] - model[n]);
+    /* convert to decibels */
+    return 10 * log10(pwr / len + 1e-30);
+}
+
+/* compare the fixed point variants against the floating point one */
+static int TestBiQuad_Fixp(const float *x)
+{
+    /* results */
+    static double model[DATA_SIZE];
+    static float y[DATA_SIZE];
+    static int32_t x31[DATA_SIZE], y31[DATA_SIZE];
+    static int16_t x15[DATA_SIZE], y15[DATA_SIZE];
+    /* number of sections */
+    const int sections = elems(dec4_taps);
+    /* filters and taps */
+    biquad_t bq[BIQUAD_MAX_SECTIONS];
+    biquad_q31_t bq31[BIQUAD_MAX_SECTIONS];
+    biquad_q15_t bq15[BIQUAD_MAX_SECTIONS];
+    biquad_q31_taps_t taps31[BIQUAD_MAX_SECTIONS];
+    biquad_q15_taps_t taps15[BIQUAD_MAX_SECTIONS];
+    /* timing */
+    uint32_t ts, t_flt = 0, t_q31 = 0, t_q15 = 0;
+
+    /* quantize the taps, set up the filters */
+    for (int s = 0; s < sections; s++) {
+        test_check(BiQuad_QuantizeQ31(&dec4_taps[s], &taps31[s]) == EOK,
+            "section %d", s);
+        test_check(BiQuad_QuantizeQ15(&dec4_taps[s], &taps15[s]) == EOK,
+            "section %d", s);
+        BiQuad_SetTaps(&bq[s], &dec4_taps[s]);
+        BiQuad_SetTapsQ31(&bq31[s], &taps31[s]);
+        BiQuad_SetTapsQ15(&bq15[s], &taps15[s]);
+    }
+    /* coefficients of the 2nd section reach 2.0, so two integer bits are
+     * needed */
+    test_check(taps31[1].shift == 2 && taps15[1].shift == 2, "shift = %d, %d",
+        taps31[1].shift, taps15[1].shift);
+
+    /* coefficients that cannot be represented at all */
+    const biquad_taps_t huge = { .b0 = 1e5, .a1 = -1.0 };
+    test_check(BiQuad_QuantizeQ15(&huge, &taps15[2]) == EFATAL, "q15");
+
+    /* input data in fixed point notations */
+    for (int n = 0; n < DATA_SIZE; n++) {
+        x31[n] = Arch_VCVT_S32_F32(x[n], 31);
+        x15[n] = Arch_VCVT_S16_F32(x[n], 15);
+    }
+
+    /* run all the variants section by section in blocks */
+    for (int n = 0; n < DATA_SIZE; n += BLOCK_SIZE) {
+        ts = CycCnt_GetValue();
+        for (int s = 0; s < sections; s++)
+            BiQuad_Filter(s ? y + n : x + n, BLOCK_SIZE, &bq[s], y + n);
+        t_flt += CycCnt_GetValue() - ts, ts = CycCnt_GetValue();
+        for (int s = 0; s < sections; s++)
+            BiQuad_FilterQ31(s ? y31 + n : x31 + n, BLOCK_SIZE, &bq31[s],
+                y31 + n);
+        t_q31 += CycCnt_GetValue() - ts, ts = CycCnt_GetValue();
+        for (int s = 0; s < sections; s++)
+            BiQuad_FilterQ15(s ? y15 + n : x15 + n, BLOCK_SIZE, &bq15[s],
+                y15 + n);
+        t_q15 += CycCnt_GetValue() - ts;
+    }
+
+    /* reference */
+    TestBiQuad_Model(x, DATA_SIZE, dec4_taps, sections, model);
+    /* compute the noise floors */
+    float nf_flt = TestBiQuad_NoiseFloor(model, y, DATA_SIZE);
+    for (int n = 0; n < DATA_SIZE; n++)
+        y[n] = Arch_VCVT_F32_S32(y31[n], 31);
+    float nf_q31 = TestBiQuad_NoiseFloor(model, y, DATA_SIZE);
+    for (int n = 0; n < DATA_SIZE; n++)
+        y[n] = Arch_VCVT_F32_S16(y15[n], 15);
+    float nf_q15 = TestBiQuad_NoiseFloor(model, y, DATA_SIZE);
+
+    /* show the results */
+    printf("  noise floor: float: %.1f dBFS, q31: %.1f dBFS, q15: %.1f "
+        "dBFS\n", nf_flt, nf_q31, nf_q15);
+    printf("  %d section(s): float: %u cycles/frame, q31: %u cycles/frame, "
+        "q15: %u cycles/frame\n", sections, t_flt / (DATA_SIZE / BLOCK_SIZE),
+        t_q31 / (DATA_SIZE / BLOCK_SIZE), t_q15 / (DATA_SIZE / BLOCK_SIZE));
+    /* 64-bit accumulation keeps the q31 variant below the float one, q15 is
+     * limited by the data word width */
+    test_check(nf_q31 < nf_flt && nf_q15 < -60, "noise floor");
+
+    /* report status */
+    return EOK;
+}
+
+/* run the test */
+int TestBiQuad_Run(void)
+{
+    /* input data */
+    static float i[DATA_SIZE], q[DATA_SIZE];
+    /* results */
+    static float i_ref[DATA_SIZE], q_ref[DATA_SIZE];
+    static float i_out[DATA_SIZE], q_out[DATA_SIZE];
+    /* filters */
+    biquad_t bq_i[BIQUAD_MAX_SECTIONS], bq_q[BIQUAD_MAX_SECTIONS];
+    biquad_t ref_i[BIQUAD_MAX_SECTIONS], ref_q[BIQUAD_MAX_SECTIONS];
+
+    /* random data */
+    for (int n = 0; n < DATA_SIZE; n++) {
+        i[n] = rand() / (float)RAND_MAX - 0.5f;
+        q[n] = rand() / (float)RAND_MAX - 0.5f;
+    }
+
+    /* check all the cascade lengths */
+    for (int sections = 1; sections <= BIQUAD_MAX_SECTIONS; sections++) {
+        /* reset the filters */
+        TestBiQuad_Setup(bq_i, sections), TestBiQuad_Setup(bq_q, sections);
+        TestBiQuad_Setup(ref_i, sections), TestBiQuad_Setup(ref_q, sections);
+
+        /* process in blocks to verify the state keeping */
+        for (int n = 0; n < DATA_SIZE; n += BLOCK_SIZE) {
+            TestBiQuad_Separate(i + n, q + n, BLOCK_SIZE, ref_i, ref_q,
+                sections, i_ref + n, q_ref + n);
+            BiQuad_FilterCascadeIQ(i + n, q + n, BLOCK_SIZE, bq_i, bq_q,
+                sections, i_out + n, q_out + n);
+        }
+        /* results must be the same bit by bit */
+        for (int n = 0; n < DATA_SIZE; n++)
+            test_check(!memcmp(&i_out[n], &i_ref[n], sizeof(float)) &&
+                !memcmp(&q_out[n], &q_ref[n], sizeof(float)),
+                "sections = %d, n = %d: i = %e (%e), q = %e (%e)", sections,
+                n, i_out[n], i_ref[n], q_out[n], q_ref[n]);
+
+        /* in-situ operation */
+        TestBiQuad_Setup(bq_i, sections), TestBiQuad_Setup(bq_q, sections);
+        memcpy(i_out, i, sizeof(i)), memcpy(q_out, q, sizeof(q));
+        for (int n = 0; n < DATA_SIZE; n += BLOCK_SIZE)
+            BiQuad_FilterCascadeIQ(i_out + n, q_out + n, BLOCK_SIZE, bq_i,
+                bq_q, sections, i_out + n, q_out + n);
+        test_check(!memcmp(i_out, i_ref, sizeof(i_out)) &&
+            !memcmp(q_out, q_ref, sizeof(q_out)), "sections = %d: in-situ "
+            "results differ", sections);
+
+        /* compare the execution times of both approaches */
+        uint32_t ts, t_sep = 0, t_cas = 0;
+        for (int n = 0; n < DATA_SIZE; n += BLOCK_SIZE) {
+            ts = CycCnt_GetValue();
+            TestBiQuad_Separate(i + n, q + n, BLOCK_SIZE, ref_i, ref_q,
+                sections, i_ref + n, q_ref + n);
+            t_sep += CycCnt_GetValue() - ts, ts = CycCnt_GetValue();
+            BiQuad_FilterCascadeIQ(i + n, q + n, BLOCK_SIZE, bq_i, bq_q,
+                sections, i_out + n, q_out + n);
+            t_cas += CycCnt_GetValue() - ts;
+        }
+        printf("  %d section(s): separate: %u cycles/frame, cascade: %u "
+            "cycles/frame\n", sections, t_sep / (DATA_SIZE / BLOCK_SIZE),
+            t_cas / (DATA_SIZE / BLOCK_SIZE));
+    }
+
+    /* fixed point variants */
+    return TestBiQuad_Fixp(i);
+}
@@ -0,0 +1,166 @@
+/**
+ * @file chan.c
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Host test: polyphase channelizer. Tone placed in the channel must
+ * come out of that channel only (with the unity gain and the offset from
+ * the channel center preserved), for both the complex and the real input.
+ * Throughput is reported against the number of channels for the real input
+ * at the rf sampling rate (whole 0 - RF_SAMPLING_FREQ / 2 span).
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "config.h"
+#include "err.h"
+#include "host/test/chan.h"
+#include "host/test/test.h"
+#include "radio/chan.h"
+
+/* number of input samples (one frame of rf data) */
+#define DATA_SIZE                       4800
+/* number of frames for the throughput measurement (1s of data) */
+#define FRAMES                          (RF_SAMPLING_FREQ / DATA_SIZE)
+
+/* tone amplitude (in adc lsbs, int16 full scale is 1.0 at the output) */
+#define AMP                             1000.0
+
+/* get the monotonic time in seconds */
+static double TestChan_GetTime(void)
+{
+    /* time specification */
+    struct timespec ts;
+    /* read the clock */
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    /* convert */
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* generate the tone at frequency f (normalized to the sampling rate), real
+ * one when q is NULL */
+static void TestChan_Gen(double f, int16_t *i, int16_t *q, int num)
+{
+    /* generate all samples */
+    for (int n = 0; n < num; n++) {
+        i[n] = lrint(AMP * cos(2 * M_PI * f * n));
+        if (q) q[n] = lrint(AMP * sin(2 * M_PI * f * n));
+    }
+}
+
+/* check where the tone ends up: channel 'ch' must have the amplitude 'amp'
+ * and rotate with the 'f' cycles per output sample, all channels further than
+ * one channel away (apart from the mirror image of the real input) must be
+ * suppressed */
+static int TestChan_Check(int channels, int ch, int real, double amp,
+    double f, const float *re, const float *im, int num)
+{
+    /* power per channel */
+    double pwr[CHAN_MAX_CHANNELS] = { 0 };
+    /* phase progression of the tested channel */
+    double rot_re = 0, rot_im = 0;
+
+    /* skip the filter settling time */
+    for (int m = CHAN_TAPS_PER_BRANCH; m < num; m++) {
+        /* output vector */
+        const float *v_re = re + m * channels, *v_im = im + m * channels;
+        /* accumulate the power */
+        for (int k = 0; k < channels; k++)
+            pwr[k] += v_re[k] * v_re[k] + v_im[k] * v_im[k];
+        /* product with the conjugate of the previous sample */
+        rot_re += v_re[ch] * v_re[ch - channels] +
+            v_im[ch] * v_im[ch - channels];
+        rot_im += v_im[ch] * v_re[ch - channels] -
+            v_re[ch] * v_im[ch - channels];
+    }
+
+    /* amplitude of the tested channel */
+    double a = sqrt(pwr[ch] / (num - CHAN_TAPS_PER_BRANCH));
+    /* strongest of the other channels (relative) */
+    double other = 0;
+    for (int k = 0; k < channels; k++) {
+        int d = (k - ch + channels) % channels;
+        if (d > 1 && d < channels - 1 && pwr[k] > other &&
+            !(real && k == channels - ch))
+            other = pwr[k];
+    }
+    other = 10 * log10(other / pwr[ch] + 1e-30);
+    /* frequency within the channel */
+    double f_meas = atan2(rot_im, rot_re) / (2 * M_PI);
+
+    /* show the results */
+    printf("  %3d channels: channel %3d: gain = %+.2f dB, offset = %+.4f "
+        "(%+.4f), other channels: %.1f dB\n", channels, ch,
+        20 * log10(a / amp), f_meas, f, other);
+    /* check */
+    test_check(fabs(20 * log10(a / amp)) < 0.5, "gain");
+    test_check(fabs(f_meas - f) < 1e-3, "offset");
+    test_check(other < -60, "other channels");
+
+    /* report status */
+    return EOK;
+}
+
+/* run the test */
+int TestChan_Run(void)
+{
+    /* input data */
+    static int16_t i[DATA_SIZE], q[DATA_SIZE];
+    /* output data */
+    static float re[DATA_SIZE + CHAN_MAX_CHANNELS];
+    static float im[DATA_SIZE + CHAN_MAX_CHANNELS];
+
+    /* unsupported number of channels */
+    test_check(Chan_Init(48) == EFATAL && Chan_Init(CHAN_MAX_CHANNELS * 2) ==
+        EFATAL, "channels");
+
+    /* complex tone: 0.2 of the channel spacing above the center of channel
+     * 5, fed in uneven portions */
+    test_check(Chan_Init(64) == EOK, "init");
+    TestChan_Gen((5 + 0.2) / 64, i, q, DATA_SIZE);
+    int num = Chan_Process(i, q, 1000, re, im);
+    num += Chan_Process(i + 1000, q + 1000, DATA_SIZE - 1000, re + num * 64,
+        im + num * 64);
+    test_check(num == DATA_SIZE / 64, "num = %d", num);
+    if (TestChan_Check(64, 5, 0, AMP / 32768, 0.2, re, im, num) != EOK)
+        return EFATAL;
+
+    /* negative frequency ends up in the upper half */
+    test_check(Chan_Init(64) == EOK, "init");
+    TestChan_Gen(-(3 - 0.1) / 64, i, q, DATA_SIZE);
+    num = Chan_Process(i, q, DATA_SIZE, re, im);
+    if (TestChan_Check(64, 64 - 3, 0, AMP / 32768, 0.1, re, im, num) != EOK)
+        return EFATAL;
+
+    /* real input: 225kHz station, half of the amplitude goes to the
+     * positive frequency */
+    test_check(Chan_Init(256) == EOK, "init");
+    TestChan_Gen(225000.0 / RF_SAMPLING_FREQ, i, 0, DATA_SIZE);
+    num = Chan_Process(i, 0, DATA_SIZE, re, im);
+    if (TestChan_Check(256, 24, 1, AMP / 2 / 32768, 0, re, im, num) != EOK)
+        return EFATAL;
+
+    /* throughput against the number of channels (real rf input) */
+    TestChan_Gen(225000.0 / RF_SAMPLING_FREQ, i, 0, DATA_SIZE);
+    for (int channels = 16; channels <= CHAN_MAX_CHANNELS; channels *= 2) {
+        /* start from scratch */
+        Chan_Init(channels);
+        /* process 1s of data */
+        double start = TestChan_GetTime();
+        for (int f = 0; f < FRAMES; f++)
+            Chan_Process(i, 0, DATA_SIZE, re, im);
+        double elapsed = TestChan_GetTime() - start;
+        /* show the results */
+        printf("  %3d channels (%7.1f Hz spacing): %7.1f Msps (%5.1fx "
+            "real-time), %.2f ns/sample\n", channels,
+            (double)RF_SAMPLING_FREQ / channels,
+            RF_SAMPLING_FREQ / elapsed * 1e-6, 1 / elapsed,
+            elapsed / RF_SAMPLING_FREQ * 1e9);
+    }
+
+    /* report status */
+    return EOK;
+}
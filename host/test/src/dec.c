@@ -0,0 +1,99 @@
+/**
+ * @file dec.c
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Host test: decimator completion logic. Channel transfers complete
+ * independently, the callback must be called exactly once, after both of
+ * them are done, regardless of the order in which they complete.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "config.h"
+#include "err.h"
+#include "dev/dec.h"
+#include "host/host.h"
+#include "host/test/dec.h"
+#include "host/test/test.h"
+#include "sys/cb.h"
+#include "util/elems.h"
+
+/* number of input samples */
+#define INPUT_SIZE                      (DEC_DECIMATION_RATE * 8)
+
+/* number of callback calls and the last callback argument */
+static int cb_calls;
+static dec_cbarg_t cb_arg;
+
+/* decimation callback */
+static int TestDec_Callback(void *ptr)
+{
+    /* count the calls, store the argument */
+    cb_calls++, cb_arg = *(dec_cbarg_t *)ptr;
+    /* report status */
+    return EOK;
+}
+
+/* run the test */
+int TestDec_Run(void)
+{
+    /* input data: the same for both channels */
+    static int16_t in[INPUT_SIZE];
+    /* output data */
+    static int32_t i_out[INPUT_SIZE / DEC_DECIMATION_RATE];
+    static int32_t q_out[INPUT_SIZE / DEC_DECIMATION_RATE];
+    /* channel completion routines: I, Q */
+    void (* const isr[2])(void) = { Dec_DMA1C4Isr, Dec_DMA1C5Isr };
+
+    /* some data */
+    for (int k = 0; k < INPUT_SIZE; k++)
+        in[k] = rand() % 8192 - 4096;
+
+    /* completions are raised here */
+    HostDec_SetManualCompletion(1);
+
+    /* both orders: I then Q and Q then I */
+    for (int first = 0; first < 2; first++) {
+        /* start the decimation */
+        cb_calls = 0;
+        test_check(Dec_Decimate(in, in, INPUT_SIZE, i_out, q_out,
+            TestDec_Callback) == 0, "async call returned the argument");
+        /* first channel is done */
+        isr[first]();
+        test_check(cb_calls == 0, "callback after one channel (%d)", first);
+        /* second one is done */
+        isr[!first]();
+        test_check(cb_calls == 1, "calls = %d (%d)", cb_calls, first);
+        /* check the argument */
+        test_check(cb_arg.num == (int)elems(i_out) && cb_arg.i == i_out &&
+            cb_arg.q == q_out, "callback argument");
+        /* both channels got the same data once the previous contents of the
+         * sinc^3 filters is flushed (lowest byte holds the channel number) */
+        for (int k = 3; k < (int)elems(i_out); k++)
+            test_check(i_out[k] >> 8 == q_out[k] >> 8 &&
+                (i_out[k] & 0xff) == 0 && (q_out[k] & 0xff) == 1,
+                "k = %d: %08x, %08x", k, i_out[k], q_out[k]);
+    }
+
+    /* starting the new transfer drops the completion that was counted for the
+     * previous one */
+    cb_calls = 0;
+    Dec_Decimate(in, in, INPUT_SIZE, i_out, q_out, TestDec_Callback);
+    isr[0]();
+    Dec_Decimate(in, in, INPUT_SIZE, i_out, q_out, TestDec_Callback);
+    isr[1]();
+    test_check(cb_calls == 0, "stale completion was counted");
+    isr[0]();
+    test_check(cb_calls == 1, "calls = %d", cb_calls);
+
+    /* back to the automatic completions, sync call */
+    HostDec_SetManualCompletion(0);
+    dec_cbarg_t *ca = Dec_Decimate(in, in, INPUT_SIZE, i_out, q_out, CB_SYNC);
+    test_check(ca && ca->num == (int)elems(i_out), "sync call");
+
+    /* report status */
+    return EOK;
+}
@@ -0,0 +1,158 @@
+/**
+ * @file demod_cw.c
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Host test: cw demodulator. The keyed carrier within the channel must
+ * come out at the bfo pitch (plus its offset) and produce the keying
+ * envelope, signals outside of the channel and the ones that would alias
+ * onto it after the decimation must be suppressed. Cost of the cw and am
+ * demodulation is reported for comparison.
+ */
+
+#include <math.h>
+#include <stdio.h>
+
+#include "config.h"
+#include "err.h"
+#include "dev/cyccnt.h"
+#include "host/test/demod_cw.h"
+#include "host/test/test.h"
+#include "radio/demod_am.h"
+#include "radio/demod_cw.h"
+#include "util/elems.h"
+
+/* number of samples (1s) */
+#define DATA_SIZE                       48000
+/* block size (baseband samples per rf frame) */
+#define BLOCK_SIZE                      96
+/* number of samples that are skipped before the measurement starts (filter
+ * settling) */
+#define SETTLE_SIZE                     4800
+
+/* bfo pitch */
+#define PITCH                           700.0
+/* keyed carrier offset from the channel center and its amplitude */
+#define F_CW                            50.0
+#define A_CW                            0.25
+/* keying period in samples (60ms on, 60ms off) */
+#define KEY_PERIOD                      5760
+
+/* generate the tone at the baseband, keyed if requested */
+static void TestDemodCW_Gen(double f, double a, int keyed, float *i, float *q)
+{
+    /* generate all samples */
+    for (int n = 0; n < DATA_SIZE; n++) {
+        /* keying */
+        double k = !keyed || (n % KEY_PERIOD) < KEY_PERIOD / 2;
+        /* tone */
+        double p = 2 * M_PI * f * n / BB_SAMPLING_RATE;
+        i[n] = k * a * cos(p), q[n] = k * a * sin(p);
+    }
+}
+
+/* measure the amplitude of the tone at given frequency */
+static double TestDemodCW_Amplitude(const float *x, int num, double f)
+{
+    /* correlation with the cosine and sine */
+    double c = 0, s = 0, w = 2 * M_PI * f / BB_SAMPLING_RATE;
+    /* sum up */
+    for (int n = 0; n < num; n++)
+        c += x[n] * cos(w * n), s += x[n] * sin(w * n);
+    /* amplitude */
+    return 2 * sqrt(c * c + s * s) / num;
+}
+
+/* demodulate the test signal */
+static void TestDemodCW_Demodulate(const float *i, const float *q,
+    float *out, uint32_t *t)
+{
+    /* filtered data */
+    float i_flt[BLOCK_SIZE], q_flt[BLOCK_SIZE];
+    /* timestamp */
+    uint32_t ts;
+
+    /* start from scratch */
+    DemodCW_Reset(); DemodCW_SetPitch(PITCH);
+    /* process in blocks the way the radio does */
+    for (int n = 0, num; n < DATA_SIZE; n += BLOCK_SIZE) {
+        ts = CycCnt_GetValue();
+        num = DemodCW_Filter(i + n, q + n, BLOCK_SIZE, i_flt, q_flt);
+        DemodCW_Demodulate(i_flt, q_flt, num, out + n);
+        *t += CycCnt_GetValue() - ts;
+    }
+}
+
+/* run the test */
+int TestDemodCW_Run(void)
+{
+    /* input data and the output */
+    static float i[DATA_SIZE], q[DATA_SIZE], out[DATA_SIZE];
+    /* filtered data for the am demodulator */
+    float i_flt[BLOCK_SIZE], q_flt[BLOCK_SIZE];
+    /* envelope */
+    float env[64];
+    /* timing */
+    uint32_t ts, t_cw = 0, t_am = 0;
+
+    /* unsupported pitch */
+    test_check(DemodCW_SetPitch(DEMODCW_MAX_PITCH + 1) == EFATAL, "pitch");
+
+    /* steady carrier within the channel comes out at pitch + offset */
+    TestDemodCW_Gen(F_CW, A_CW, 0, i, q);
+    TestDemodCW_Demodulate(i, q, out, &t_cw);
+    double a = 20 * log10(TestDemodCW_Amplitude(out + SETTLE_SIZE,
+        DATA_SIZE - SETTLE_SIZE, PITCH + F_CW) / A_CW);
+    printf("  in-channel tone: %+.2f dB\n", a);
+    test_check(fabs(a) < 1.0, "%.2f", a);
+
+    /* signal outside of the channel and the ones that would alias onto the
+     * channel after the decimation */
+    const double f_rej[] = { 600, -600, DEMODCW_SAMPLING_RATE + F_CW,
+        -DEMODCW_SAMPLING_RATE + F_CW, 2 * DEMODCW_SAMPLING_RATE + F_CW };
+    for (int k = 0; k < (int)elems(f_rej); k++) {
+        /* generate and demodulate */
+        TestDemodCW_Gen(f_rej[k], A_CW, 0, i, q);
+        TestDemodCW_Demodulate(i, q, out, &t_cw);
+        /* output power relative to the input */
+        double p = 0;
+        for (int n = SETTLE_SIZE; n < DATA_SIZE; n++)
+            p += out[n] * out[n];
+        p = 10 * log10(p / (DATA_SIZE - SETTLE_SIZE) / (A_CW * A_CW / 2));
+        printf("  tone @ %+6.0f Hz: %.1f dB\n", f_rej[k], p);
+        test_check(p < -40, "%.0f Hz: %.1f dB", f_rej[k], p);
+    }
+
+    /* keyed carrier */
+    TestDemodCW_Gen(F_CW, A_CW, 1, i, q);
+    DemodCW_ReadEnvelope(env, elems(env));
+    t_cw = 0, TestDemodCW_Demodulate(i, q, out, &t_cw);
+    /* last envelope samples: goertzel blocks are 8ms long, key period is
+     * 120ms, so there are blocks that are entirely on or off */
+    int env_num = DemodCW_ReadEnvelope(env, elems(env));
+    float env_min = 1, env_max = 0;
+    for (int k = 0; k < env_num; k++)
+        env_min = fminf(env_min, env[k]), env_max = fmaxf(env_max, env[k]);
+    printf("  envelope: %d samples, min = %.4f, max = %.4f\n", env_num,
+        env_min, env_max);
+#if DEMODCW_GOERTZEL
+    test_check(env_num > 0, "no envelope");
+    test_check(fabs(20 * log10(env_max / A_CW)) < 1.0, "max = %f", env_max);
+    test_check(env_min < A_CW / 100, "min = %f", env_min);
+#endif
+
+    /* am demodulator for the comparison */
+    for (int n = 0; n < DATA_SIZE; n += BLOCK_SIZE) {
+        ts = CycCnt_GetValue();
+        DemodAM_Filter(i + n, q + n, BLOCK_SIZE, i_flt, q_flt);
+        DemodAM_Demodulate(i_flt, q_flt, BLOCK_SIZE, out + n);
+        t_am += CycCnt_GetValue() - ts;
+    }
+    /* show the cost */
+    printf("  cw: %u cycles/frame, am: %u cycles/frame\n",
+        t_cw / (DATA_SIZE / BLOCK_SIZE), t_am / (DATA_SIZE / BLOCK_SIZE));
+
+    /* report status */
+    return EOK;
+}
@@ -0,0 +1,161 @@
+/**
+ * @file demod_sam.c
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Host test: synchronous am demodulator. The pll must lock to the
+ * carrier that is off by some offset and report it. With the carrier faded
+ * below the sidebands (selective fading) the coherent detector must stay
+ * clean where the envelope detector distorts. The whole receiver must lock
+ * and move the carrier to dc with the 2nd stage mixer. Cost of both
+ * demodulators is reported.
+ */
+
+#include <math.h>
+#include <stdio.h>
+
+#include "config.h"
+#include "err.h"
+#include "dev/cyccnt.h"
+#include "host/test/demod_sam.h"
+#include "host/test/test.h"
+#include "radio/demod_am.h"
+#include "radio/demod_sam.h"
+#include "radio/radio.h"
+
+/* number of samples (1s) */
+#define DATA_SIZE                       48000
+/* block size (baseband samples per rf frame) */
+#define BLOCK_SIZE                      96
+/* number of samples that are skipped before the measurement starts (pll
+ * acquisition) */
+#define SETTLE_SIZE                     24000
+
+/* modulating tone frequency */
+#define F_MOD                           1000.0
+
+/* generate the am signal at the baseband: carrier amplitude (relative to the
+ * sidebands) of 'car', modulation depth 'depth' and the carrier offset 'f' */
+static void TestDemodSAM_Gen(double car, double depth, double f, float *i,
+    float *q)
+{
+    /* generate all samples */
+    for (int n = 0; n < DATA_SIZE; n++) {
+        /* modulating signal and the carrier phase */
+        double m = 0.25 * (car + depth * cos(2 * M_PI * F_MOD * n /
+            BB_SAMPLING_RATE));
+        double p = 2 * M_PI * f * n / BB_SAMPLING_RATE + 1.0;
+        /* modulated carrier */
+        i[n] = m * cos(p), q[n] = m * sin(p);
+    }
+}
+
+/* measure the amplitude of the tone at given frequency */
+static double TestDemodSAM_Amplitude(const float *x, int num, double f)
+{
+    /* correlation with the cosine and sine */
+    double c = 0, s = 0, w = 2 * M_PI * f / BB_SAMPLING_RATE;
+    /* sum up */
+    for (int n = 0; n < num; n++)
+        c += x[n] * cos(w * n), s += x[n] * sin(w * n);
+    /* amplitude */
+    return 2 * sqrt(c * c + s * s) / num;
+}
+
+/* second harmonic level relative to the fundamental in decibels */
+static double TestDemodSAM_Distortion(const float *x)
+{
+    /* measure both */
+    double a1 = TestDemodSAM_Amplitude(x + SETTLE_SIZE,
+        DATA_SIZE - SETTLE_SIZE, F_MOD);
+    double a2 = TestDemodSAM_Amplitude(x + SETTLE_SIZE,
+        DATA_SIZE - SETTLE_SIZE, 2 * F_MOD);
+    /* convert to decibels */
+    return 20 * log10(a2 / a1);
+}
+
+/* demodulate with both demodulators */
+static void TestDemodSAM_Demodulate(const float *i, const float *q,
+    float *am, float *sam, uint32_t *t_am, uint32_t *t_sam)
+{
+    /* filtered data */
+    static float i_flt[DATA_SIZE], q_flt[DATA_SIZE];
+    /* timestamp */
+    uint32_t ts;
+
+    /* reset the pll */
+    DemodSAM_Reset();
+    /* process in blocks the way the radio does */
+    *t_am = *t_sam = 0;
+    for (int n = 0; n < DATA_SIZE; n += BLOCK_SIZE) {
+        DemodAM_Filter(i + n, q + n, BLOCK_SIZE, i_flt + n, q_flt + n);
+        ts = CycCnt_GetValue();
+        DemodAM_Demodulate(i_flt + n, q_flt + n, BLOCK_SIZE, am + n);
+        *t_am += CycCnt_GetValue() - ts, ts = CycCnt_GetValue();
+        DemodSAM_Demodulate(i_flt + n, q_flt + n, BLOCK_SIZE, sam + n);
+        *t_sam += CycCnt_GetValue() - ts;
+    }
+}
+
+/* run the test */
+int TestDemodSAM_Run(void)
+{
+    /* input data and the outputs */
+    static float i[DATA_SIZE], q[DATA_SIZE], am[DATA_SIZE], sam[DATA_SIZE];
+    /* timing */
+    uint32_t t_am, t_sam;
+    /* carrier status */
+    int locked; float offset;
+
+    /* carrier that is 150Hz off */
+    TestDemodSAM_Gen(1.0, 0.5, 150, i, q);
+    TestDemodSAM_Demodulate(i, q, am, sam, &t_am, &t_sam);
+    /* show the results */
+    double a = TestDemodSAM_Amplitude(sam + SETTLE_SIZE,
+        DATA_SIZE - SETTLE_SIZE, F_MOD);
+    printf("  offset: locked = %d, frequency = %.3f Hz, tone = %.4f\n",
+        DemodSAM_IsLocked(), DemodSAM_GetFrequency(), a);
+    test_check(DemodSAM_IsLocked(), "not locked");
+    test_check(fabs(DemodSAM_GetFrequency() - 150) < 0.1, "%f",
+        DemodSAM_GetFrequency());
+    /* modulating tone amplitude is 0.25 * 0.5 */
+    test_check(fabs(20 * log10(a / 0.125)) < 0.5, "tone = %f", a);
+
+    /* noise only: no lock */
+    for (int n = 0; n < DATA_SIZE; n++)
+        i[n] = 0.01 * ((n * 7919 % 1013) / 506.5 - 1),
+        q[n] = 0.01 * ((n * 6007 % 1021) / 510.5 - 1);
+    TestDemodSAM_Demodulate(i, q, am, sam, &t_am, &t_sam);
+    test_check(!DemodSAM_IsLocked(), "locked to noise");
+
+    /* selective fading: carrier at half of the sideband level, the envelope
+     * is overmodulated */
+    TestDemodSAM_Gen(0.5, 1.0, 0, i, q);
+    TestDemodSAM_Demodulate(i, q, am, sam, &t_am, &t_sam);
+    double d_am = TestDemodSAM_Distortion(am);
+    double d_sam = TestDemodSAM_Distortion(sam);
+    printf("  faded carrier: 2nd harmonic: envelope: %.1f dB, "
+        "synchronous: %.1f dB\n", d_am, d_sam);
+    test_check(DemodSAM_IsLocked(), "not locked");
+    test_check(d_sam < -40 && d_am > -20, "%.1f, %.1f", d_am, d_sam);
+
+    /* show the cost */
+    printf("  envelope: %.1f cycles/sample, synchronous: %.1f "
+        "cycles/sample\n", (double)t_am / DATA_SIZE, (double)t_sam /
+        DATA_SIZE);
+
+    /* whole receiver: carrier 200Hz above the tuned frequency */
+    test_am_t gen = { .fc = 225200, .fm = 1000, .amp = 600, .depth = 0.5 };
+    test_check(TestHost_StartRadio(225000) == EOK, "start");
+    test_check(Radio_SetMode(RADIO_MODE_SAM) == EOK, "mode");
+    test_check(TestHost_RunAM(&gen, 500) == EOK, "run");
+    Radio_GetCarrier(&locked, &offset);
+    printf("  receiver: locked = %d, offset = %.3f Hz\n", locked, offset);
+    /* restore the default mode */
+    Radio_SetMode(RADIO_MODE_AM); TestHost_RunAM(&gen, 1);
+    test_check(locked && fabs(offset - 200) < 0.5, "%d, %f", locked, offset);
+
+    /* report status */
+    return EOK;
+}
@@ -0,0 +1,138 @@
+/**
+ * @file demod_ssb.c
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Host test: single sideband demodulator. The baseband signal carries
+ * one tone in the upper and one in the lower sideband. The selected one must
+ * come out with the unity gain while the other one must be suppressed. Cost
+ * of the ssb and am demodulation is reported for comparison.
+ */
+
+#include <math.h>
+#include <stdio.h>
+
+#include "config.h"
+#include "err.h"
+#include "dev/cyccnt.h"
+#include "host/test/demod_ssb.h"
+#include "host/test/test.h"
+#include "radio/demod_am.h"
+#include "radio/demod_ssb.h"
+
+/* number of samples */
+#define DATA_SIZE                       9600
+/* block size (baseband samples per rf frame) */
+#define BLOCK_SIZE                      96
+/* number of samples that are skipped before the measurement starts (filter
+ * settling) */
+#define SETTLE_SIZE                     4800
+
+/* upper and lower sideband tone frequencies */
+#define F_USB                           1000.0
+#define F_LSB                           700.0
+/* amplitudes of the tones */
+#define A_USB                           0.5
+#define A_LSB                           0.25
+
+/* measure the amplitude of the tone at given frequency */
+static double TestDemodSSB_Amplitude(const float *x, int num, double f)
+{
+    /* correlation with the cosine and sine */
+    double c = 0, s = 0, w = 2 * M_PI * f / BB_SAMPLING_RATE;
+    /* sum up */
+    for (int n = 0; n < num; n++)
+        c += x[n] * cos(w * n), s += x[n] * sin(w * n);
+    /* amplitude */
+    return 2 * sqrt(c * c + s * s) / num;
+}
+
+/* demodulate the test signal with given sideband, returns the amplitudes of
+ * the usb and lsb tones in decibels relative to their input amplitudes */
+static int TestDemodSSB_Sideband(int sideband, const float *i, const float *q,
+    double *usb, double *lsb, uint32_t *t_flt, uint32_t *t_dem)
+{
+    /* intermediate data and the output */
+    static float i_flt[DATA_SIZE], q_flt[DATA_SIZE], out[DATA_SIZE];
+    /* timestamp */
+    uint32_t ts;
+
+    /* select the sideband */
+    if (DemodSSB_SetSideband(sideband) != EOK)
+        return EFATAL;
+
+    /* process in blocks the way the radio does */
+    *t_flt = *t_dem = 0;
+    for (int n = 0; n < DATA_SIZE; n += BLOCK_SIZE) {
+        ts = CycCnt_GetValue();
+        DemodSSB_Filter(i + n, q + n, BLOCK_SIZE, i_flt + n, q_flt + n);
+        *t_flt += CycCnt_GetValue() - ts, ts = CycCnt_GetValue();
+        DemodSSB_Demodulate(i_flt + n, q_flt + n, BLOCK_SIZE, out + n);
+        *t_dem += CycCnt_GetValue() - ts;
+    }
+
+    /* measure the tones */
+    *usb = 20 * log10(TestDemodSSB_Amplitude(out + SETTLE_SIZE,
+        DATA_SIZE - SETTLE_SIZE, F_USB) / A_USB);
+    *lsb = 20 * log10(TestDemodSSB_Amplitude(out + SETTLE_SIZE,
+        DATA_SIZE - SETTLE_SIZE, F_LSB) / A_LSB);
+    /* report status */
+    return EOK;
+}
+
+/* run the test */
+int TestDemodSSB_Run(void)
+{
+    /* input data and the am demodulator buffers */
+    static float i[DATA_SIZE], q[DATA_SIZE], i_flt[DATA_SIZE],
+        q_flt[DATA_SIZE], out[DATA_SIZE];
+    /* tone levels */
+    double usb, lsb;
+    /* timing */
+    uint32_t ts, t_flt, t_dem, t_am_flt = 0, t_am_dem = 0;
+
+    /* upper sideband tone at positive and the lower sideband one at the
+     * negative frequency */
+    for (int n = 0; n < DATA_SIZE; n++) {
+        double wu = 2 * M_PI * F_USB / BB_SAMPLING_RATE * n;
+        double wl = 2 * M_PI * F_LSB / BB_SAMPLING_RATE * n;
+        i[n] = A_USB * cos(wu) + A_LSB * cos(wl);
+        q[n] = A_USB * sin(wu) - A_LSB * sin(wl);
+    }
+
+    /* invalid sideband */
+    test_check(DemodSSB_SetSideband(2) == EFATAL, "sideband");
+
+    /* upper sideband */
+    test_check(TestDemodSSB_Sideband(DEMODSSB_USB, i, q, &usb, &lsb, &t_flt,
+        &t_dem) == EOK, "usb");
+    printf("  usb: usb tone: %+.2f dB, lsb tone: %+.1f dB\n", usb, lsb);
+    test_check(fabs(usb) < 1.0 && lsb < -50, "usb: %.2f, %.1f", usb, lsb);
+
+    /* lower sideband */
+    test_check(TestDemodSSB_Sideband(DEMODSSB_LSB, i, q, &usb, &lsb, &t_flt,
+        &t_dem) == EOK, "lsb");
+    printf("  lsb: usb tone: %+.1f dB, lsb tone: %+.2f dB\n", usb, lsb);
+    test_check(fabs(lsb) < 1.0 && usb < -50, "lsb: %.1f, %.2f", usb, lsb);
+
+    /* am demodulator for the comparison */
+    for (int n = 0; n < DATA_SIZE; n += BLOCK_SIZE) {
+        ts = CycCnt_GetValue();
+        DemodAM_Filter(i + n, q + n, BLOCK_SIZE, i_flt + n, q_flt + n);
+        t_am_flt += CycCnt_GetValue() - ts, ts = CycCnt_GetValue();
+        DemodAM_Demodulate(i_flt + n, q_flt + n, BLOCK_SIZE, out + n);
+        t_am_dem += CycCnt_GetValue() - ts;
+    }
+
+    /* show the cost */
+    printf("  ssb: filter: %.1f cycles/sample, demodulate: %.1f "
+        "cycles/sample\n", (double)t_flt / DATA_SIZE, (double)t_dem /
+        DATA_SIZE);
+    printf("  am:  filter: %.1f cycles/sample, demodulate: %.1f "
+        "cycles/sample\n", (double)t_am_flt / DATA_SIZE, (double)t_am_dem /
+        DATA_SIZE);
+
+    /* report status */
+    return EOK;
+}
@@ -0,0 +1,137 @@
+/**
+ * @file fft.c
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Host test: fast fourier transform. All the variants are compared
+ * against the double precision dft for every supported size (both the pure
+ * radix-4 ones and the ones that need the radix-2 stage) and the resulting
+ * signal to noise ratios are reported together with the execution times.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "config.h"
+#include "err.h"
+#include "dev/cyccnt.h"
+#include "dsp/fft.h"
+#include "host/test/fft.h"
+#include "host/test/test.h"
+
+/* number of transforms per timing measurement */
+#define REPEAT                          64
+
+/* reference dft */
+static void TestFFT_DFT(const double *x_re, const double *x_im, int size,
+    double *y_re, double *y_im)
+{
+    /* all bins */
+    for (int k = 0; k < size; k++) {
+        double re = 0, im = 0;
+        for (int n = 0; n < size; n++) {
+            /* exp(-j * 2 * pi * k * n / size), index is reduced first so that
+             * the angle stays accurate */
+            double a = -2 * M_PI * ((long)k * n % size) / size;
+            re += x_re[n] * cos(a) - x_im[n] * sin(a);
+            im += x_re[n] * sin(a) + x_im[n] * cos(a);
+        }
+        y_re[k] = re, y_im[k] = im;
+    }
+}
+
+/* signal to noise ratio of the result (scaled by 'scale') against the
+ * reference */
+static double TestFFT_SNR(const double *ref_re, const double *ref_im,
+    const double *re, const double *im, double scale, int size)
+{
+    /* signal and error power */
+    double s = 0, e = 0;
+    for (int k = 0; k < size; k++) {
+        s += ref_re[k] * ref_re[k] + ref_im[k] * ref_im[k];
+        e += pow(re[k] * scale - ref_re[k], 2) +
+            pow(im[k] * scale - ref_im[k], 2);
+    }
+    /* report the ratio */
+    return 10 * log10(s / (e + 1e-300));
+}
+
+/* run the test */
+int TestFFT_Run(void)
+{
+    /* input data and the reference */
+    static double x_re[FFT_MAX_SIZE], x_im[FFT_MAX_SIZE];
+    static double ref_re[FFT_MAX_SIZE], ref_im[FFT_MAX_SIZE];
+    /* results converted to doubles */
+    static double y_re[FFT_MAX_SIZE], y_im[FFT_MAX_SIZE];
+    /* transform buffers */
+    static float f_re[FFT_MAX_SIZE], f_im[FFT_MAX_SIZE];
+    static int32_t q31_re[FFT_MAX_SIZE], q31_im[FFT_MAX_SIZE];
+    static int16_t q15_re[FFT_MAX_SIZE], q15_im[FFT_MAX_SIZE];
+
+    /* unsupported sizes */
+    test_check(FFT_Float(f_re, f_im, 48) == EFATAL &&
+        FFT_Q31(q31_re, q31_im, FFT_MAX_SIZE * 2) == EFATAL &&
+        FFT_Q15(q15_re, q15_im, 1) == EFATAL, "size");
+
+    /* same data every time */
+    srand(1);
+    for (int size = 2; size <= FFT_MAX_SIZE; size *= 2) {
+        /* random input with the magnitude below 1.0 */
+        for (int n = 0; n < size; n++) {
+            x_re[n] = (rand() / (double)RAND_MAX - 0.5) * 1.4;
+            x_im[n] = (rand() / (double)RAND_MAX - 0.5) * 1.4;
+        }
+        /* reference */
+        TestFFT_DFT(x_re, x_im, size, ref_re, ref_im);
+
+        /* execution times */
+        uint32_t t_flt = 0, t_q31 = 0, t_q15 = 0, ts;
+        for (int r = 0; r < REPEAT; r++) {
+            /* prepare the inputs */
+            for (int n = 0; n < size; n++) {
+                f_re[n] = x_re[n], f_im[n] = x_im[n];
+                q31_re[n] = lrint(x_re[n] * 2147483648.0);
+                q31_im[n] = lrint(x_im[n] * 2147483648.0);
+                q15_re[n] = lrint(x_re[n] * 32768.0);
+                q15_im[n] = lrint(x_im[n] * 32768.0);
+            }
+            /* run all the variants */
+            ts = CycCnt_GetValue();
+            FFT_Float(f_re, f_im, size);
+            t_flt += CycCnt_GetValue() - ts, ts = CycCnt_GetValue();
+            FFT_Q31(q31_re, q31_im, size);
+            t_q31 += CycCnt_GetValue() - ts, ts = CycCnt_GetValue();
+            FFT_Q15(q15_re, q15_im, size);
+            t_q15 += CycCnt_GetValue() - ts;
+        }
+
+        /* fixed point results are scaled by 1/size */
+        for (int k = 0; k < size; k++)
+            y_re[k] = f_re[k], y_im[k] = f_im[k];
+        double snr_flt = TestFFT_SNR(ref_re, ref_im, y_re, y_im, 1, size);
+        for (int k = 0; k < size; k++)
+            y_re[k] = q31_re[k], y_im[k] = q31_im[k];
+        double snr_q31 = TestFFT_SNR(ref_re, ref_im, y_re, y_im,
+            size / 2147483648.0, size);
+        for (int k = 0; k < size; k++)
+            y_re[k] = q15_re[k], y_im[k] = q15_im[k];
+        double snr_q15 = TestFFT_SNR(ref_re, ref_im, y_re, y_im,
+            size / 32768.0, size);
+
+        /* show the results */
+        printf("  size %4d: snr: float = %5.1f dB, q31 = %5.1f dB, "
+            "q15 = %5.1f dB, cycles: float = %6u, q31 = %6u, q15 = %6u\n",
+            size, snr_flt, snr_q31, snr_q15, t_flt / REPEAT, t_q31 / REPEAT,
+            t_q15 / REPEAT);
+        /* check */
+        test_check(snr_flt > 120, "float snr = %.1f", snr_flt);
+        test_check(snr_q31 > 120, "q31 snr = %.1f", snr_q31);
+        test_check(snr_q15 > 40, "q15 snr = %.1f", snr_q15);
+    }
+
+    /* report status */
+    return EOK;
+}
@@ -0,0 +1,316 @@
+/**
+ * @file iqframe.c
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Host test: binary framed iq notifications. COBS must bring back
+ * whatever went in (zeros anywhere, runs of the maximal length) without ever
+ * putting zeros out and within its overhead bound, and must refuse what it
+ * did not produce. The frames must carry the receiver's own iq samples (the
+ * ones from the event, which must match the usb stream) within half of the
+ * mantissa's lsb, whatever the level, the crc must be CRC-16/CCITT-FALSE and
+ * catch every single bit error. With the AT response line budget the 8-bit
+ * frames must carry several times more iq pairs over the serial link than
+ * the base64 text lines do.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "config.h"
+#include "err.h"
+#include "cobs/cobs.h"
+#include "host/host.h"
+#include "host/test/iqframe.h"
+#include "host/test/test.h"
+#include "radio/iqframe.h"
+#include "radio/radio.h"
+#include "sys/ev.h"
+#include "util/elems.h"
+#include "util/minmax.h"
+
+/* station frequency, frames to let the receiver settle, frames to capture */
+#define STATION_FREQ                    225000
+#define SETTLE_FRAMES                   20
+#define CAPTURE_FRAMES                  10
+/* iq pairs per rf frame of the widest iq stream */
+#define FRAME_PAIRS                     \
+    (RF_SAMPLING_FREQ * 2 / 1000 / DEC_MIN_DECIMATION_RATE)
+/* serial link throughput [bytes/s] (start bit, 8 data bits, stop bit) */
+#define LINK_THROUGHPUT                 (USART2_BAUD_RATE / 10)
+
+/* iq samples delivered by the event (interleaved) */
+static float ev_iq[2 * CAPTURE_FRAMES * FRAME_PAIRS];
+static int ev_num;
+
+/* iq samples are ready */
+static int TestIQFrame_Callback(void *arg)
+{
+    /* event argument */
+    radio_iqdata_evarg_t *ea = arg;
+    /* store what fits */
+    for (int k = 0; k < ea->num && ev_num < (int)elems(ev_iq) / 2; k++) {
+        ev_iq[2 * ev_num + 0] = ea->i[k];
+        ev_iq[2 * ev_num + 1] = ea->q[k];
+        ev_num++;
+    }
+    /* report status */
+    return EOK;
+}
+
+/* reference crc: CRC-16/CCITT-FALSE computed bit by bit */
+static uint16_t TestIQFrame_CRC(const uint8_t *ptr, size_t size)
+{
+    /* initial value */
+    uint16_t crc = 0xffff;
+    /* process all the bits, msb first */
+    for (size_t k = 0; k < size; k++) {
+        crc ^= ptr[k] << 8;
+        for (int b = 0; b < 8; b++)
+            crc = crc & 0x8000 ? crc << 1 ^ 0x1021 : crc << 1;
+    }
+    /* return the crc */
+    return crc;
+}
+
+/* encode and decode the data with cobs */
+static int TestIQFrame_COBS(const uint8_t *in, int size)
+{
+    /* encoded and decoded data */
+    static uint8_t enc[1024], dec[1024];
+
+    /* encode, the output never exceeds the bound */
+    int len = COBS_Encode(in, size, enc, COBS_ENCODED_SIZE(size));
+    test_check(len > 0 && len <= (int)COBS_ENCODED_SIZE(size), "size = %d: "
+        "len = %d", size, len);
+    /* there are no zeros within the encoded data */
+    test_check(!memchr(enc, 0, len), "size = %d: zero", size);
+    /* one byte less does not fit when the bound is reached */
+    test_check(len < (int)COBS_ENCODED_SIZE(size) ||
+        COBS_Encode(in, size, enc, len - 1) == EFATAL, "size = %d", size);
+    /* decode */
+    int dec_len = COBS_Decode(enc, len, dec, sizeof(dec));
+    test_check(dec_len == size && !memcmp(in, dec, size), "size = %d: "
+        "decoded %d", size, dec_len);
+    /* in-situ decoding */
+    dec_len = COBS_Decode(enc, len, enc, len);
+    test_check(dec_len == size && !memcmp(in, enc, size), "size = %d: "
+        "in-situ %d", size, dec_len);
+    /* report status */
+    return EOK;
+}
+
+/* encode and decode the frame, returns the largest error in the lsbs of the
+ * block scale, checks the header fields and the crc */
+static int TestIQFrame_RoundTrip(int format, const float *iq, int num,
+    double *err)
+{
+    /* encoded frame, raw frame, decoded samples */
+    uint8_t frame[IQFRAME_MAX_SIZE], raw[IQFRAME_MAX_SIZE];
+    float out[IQFRAME_MAX_SIZE];
+    /* frame header */
+    iqframe_hdr_t hdr;
+    /* sequence number and the drop counter */
+    uint16_t seq = rand(); uint32_t dropped = rand();
+
+    /* encode */
+    int len = IQFrame_Encode(format, seq, dropped, iq, num, frame,
+        sizeof(frame));
+    test_check(len > 2 && len <= IQFRAME_MAX_SIZE, "len = %d", len);
+    /* delimiters only at the ends */
+    test_check(frame[0] == IQFRAME_DELIM && frame[len - 1] == IQFRAME_DELIM &&
+        !memchr(frame + 1, IQFRAME_DELIM, len - 2), "delimiters");
+
+    /* crc (of everything that precedes it) must be the CCITT-FALSE one */
+    int raw_len = COBS_Decode(frame + 1, len - 2, raw, sizeof(raw));
+    test_check(raw_len > IQFRAME_CRC_SIZE, "raw_len = %d", raw_len);
+    test_check(TestIQFrame_CRC(raw, raw_len - IQFRAME_CRC_SIZE) ==
+        (raw[raw_len - 2] | raw[raw_len - 1] << 8), "crc");
+
+    /* decode (in-situ) */
+    int dec_num = IQFrame_Decode(frame + 1, len - 2, &hdr, out);
+    test_check(dec_num == num, "num = %d (%d)", dec_num, num);
+    test_check(hdr.format == format && hdr.seq == seq && hdr.num == num &&
+        hdr.dropped == dropped, "header");
+
+    /* largest error (the mantissas that saturated when rounded get the other
+     * half of the lsb) */
+    double lsb = ldexp(1, hdr.exp), sat = format == IQFRAME_FMT_S16 ?
+        INT16_MAX : INT8_MAX;
+    *err = 0;
+    for (int k = 0; k < 2 * num; k++)
+        *err = fmax(*err, fabs(out[k] - iq[k]) / lsb -
+            (fabs(iq[k]) / lsb > sat ? 0.5 : 0));
+    /* report status */
+    return EOK;
+}
+
+/* every single bit error must be caught */
+static int TestIQFrame_BitErrors(int format, const float *iq, int num)
+{
+    /* encoded frame, its copy */
+    uint8_t frame[IQFRAME_MAX_SIZE], copy[IQFRAME_MAX_SIZE];
+    /* decoded samples and the header */
+    float out[IQFRAME_MAX_SIZE]; iqframe_hdr_t hdr;
+
+    /* encode */
+    int len = IQFrame_Encode(format, 1, 0, iq, num, frame, sizeof(frame));
+    test_check(len > 0, "len = %d", len);
+    /* flip every bit between the delimiters */
+    for (int k = 8; k < (len - 1) * 8; k++) {
+        memcpy(copy, frame, len), copy[k / 8] ^= 1 << k % 8;
+        test_check(IQFrame_Decode(copy + 1, len - 2, &hdr, out) == EFATAL,
+            "bit %d", k);
+    }
+    /* report status */
+    return EOK;
+}
+
+/* number of the iq pairs per second that the serial link carries with the
+ * notifications of the size 'size' that hold 'num' pairs each */
+static double TestIQFrame_LinkRate(int size, int num)
+{
+    return (double)LINK_THROUGHPUT / size * num;
+}
+
+/* run the test */
+int TestIQFrame_Run(void)
+{
+    /* test data */
+    static uint8_t data[1024];
+    /* samples */
+    static float iq[2 * IQFRAME_MAX_SIZE];
+    /* errors */
+    double err;
+
+    /* cobs: empty data, zeros only, trailing zero, runs of the maximal
+     * length and around it, random data with the zeros of varying density */
+    test_check(TestIQFrame_COBS(data, 0) == EOK, "empty");
+    test_check(TestIQFrame_COBS(data, 300) == EOK, "zeros");
+    memset(data, 0x5a, sizeof(data));
+    for (int size = 1; size < 800; size += size < 520 ? 1 : 37) {
+        test_check(TestIQFrame_COBS(data, size) == EOK, "run");
+        data[size - 1] = 0;
+        test_check(TestIQFrame_COBS(data, size) == EOK, "trailing zero");
+        data[size - 1] = 0x5a;
+    }
+    for (int density = 2; density <= 512; density *= 2) {
+        for (int k = 0; k < (int)elems(data); k++)
+            data[k] = rand() % density ? rand() % 255 + 1 : 0;
+        for (int size = 0; size <= (int)elems(data) - 300; size += 97)
+            test_check(TestIQFrame_COBS(data, size) == EOK, "random");
+    }
+    /* what cobs did not produce gets refused: zeros, runs that end past the
+     * data */
+    uint8_t bad_zero[] = { 3, 1, 0 }, bad_run[] = { 2, 1, 5, 1, 2 };
+    test_check(COBS_Decode(bad_zero, sizeof(bad_zero), data, sizeof(data)) ==
+        EFATAL, "zero");
+    test_check(COBS_Decode(bad_run, sizeof(bad_run), data, sizeof(data)) ==
+        EFATAL, "run");
+    /* reference crc check value */
+    test_check(TestIQFrame_CRC((const uint8_t *)"123456789", 9) == 0x29b1,
+        "check value");
+
+    /* frame capacity with the response line budget */
+    int max_s16 = IQFrame_GetMaxSamples(IQFRAME_FMT_S16, AT_RES_MAX_LINE_LEN);
+    int max_s8 = IQFrame_GetMaxSamples(IQFRAME_FMT_S8, AT_RES_MAX_LINE_LEN);
+    test_check(IQFrame_GetMaxSamples(0, AT_RES_MAX_LINE_LEN) == EFATAL &&
+        IQFrame_GetMaxSamples(3, AT_RES_MAX_LINE_LEN) == EFATAL, "format");
+    test_check(max_s16 > 0 && max_s8 > 0, "max = %d, %d", max_s16, max_s8);
+
+    /* capture the receiver's iq samples from the event along with the usb
+     * stream: they must be the same */
+    test_check(TestHost_StartRadio(STATION_FREQ) == EOK, "start");
+    Ev_RegisterCallback(&radio_iqdata_ev, TestIQFrame_Callback);
+    test_am_t am = { .fc = STATION_FREQ + 1000, .fm = 400, .amp = 200,
+        .depth = 0.5 };
+    test_check(TestHost_RunAM(&am, SETTLE_FRAMES) == EOK, "settle");
+    /* drop the usb samples that are already there */
+    int32_t usb[2 * FRAME_PAIRS];
+    while (HostUSBAudioSrc_GetSamples(usb, elems(usb) / 2) > 0);
+    /* capture */
+    const int rf_num = HostRFIn_GetHalfSize();
+    int16_t rf[rf_num]; int32_t out[rf_num / DEC_DECIMATION_RATE * 2];
+    int usb_num = 0, rate; ev_num = 0;
+    Radio_GetIQRate(&rate);
+    for (int f = 0; f < CAPTURE_FRAMES; f++) {
+        TestHost_GenAM(&am, rf, rf_num);
+        test_check(HostRFIn_Feed(rf, rf_num) == EOK, "feed");
+        HostSAI1A_Drain(out, elems(out) / 2);
+        /* compare with the event */
+        for (int n; (n = HostUSBAudioSrc_GetSamples(usb,
+            elems(usb) / 2)) > 0; usb_num += n) {
+            for (int k = 0; k < 2 * n && 2 * usb_num + k < 2 * ev_num; k++)
+                test_check(fabs(ldexp(usb[k], -31) -
+                    ev_iq[2 * usb_num + k]) < 1e-6, "sample %d",
+                    usb_num + k / 2);
+        }
+    }
+    Ev_UnregisterCallback(&radio_iqdata_ev, TestIQFrame_Callback);
+    test_check(ev_num == CAPTURE_FRAMES * rate / 500 && usb_num == ev_num,
+        "event = %d, usb = %d (%d)", ev_num, usb_num,
+        CAPTURE_FRAMES * rate / 500);
+
+    /* receiver's samples at their own level and scaled way down and up, the
+     * block scale follows: error within half of the lsb */
+    static const float gains[] = { 1, 1e-6f, 1e-3f, 1e3f };
+    for (int g = 0; g < (int)elems(gains); g++) {
+        for (int format = IQFRAME_FMT_S16; format <= IQFRAME_FMT_S8;
+            format++) {
+            int max = format == IQFRAME_FMT_S16 ? max_s16 : max_s8;
+            double max_err = 0;
+            /* go through the captured samples frame by frame */
+            for (int offs = 0; offs + max <= ev_num; offs += max) {
+                for (int k = 0; k < 2 * max; k++)
+                    iq[k] = ev_iq[2 * offs + k] * gains[g];
+                test_check(TestIQFrame_RoundTrip(format, iq, max, &err) ==
+                    EOK, "round trip");
+                max_err = fmax(max_err, err);
+            }
+            test_check(max_err <= 0.501, "gain %g, format %d: error = %.3f "
+                "lsb", gains[g], format, max_err);
+        }
+    }
+
+    /* silence, a single pair, frame that does not fit */
+    memset(iq, 0, sizeof(iq));
+    test_check(TestIQFrame_RoundTrip(IQFRAME_FMT_S8, iq, max_s8, &err) ==
+        EOK && err == 0, "silence");
+    test_check(TestIQFrame_RoundTrip(IQFRAME_FMT_S16, ev_iq, 1, &err) ==
+        EOK && err <= 0.5, "single");
+    uint8_t frame[IQFRAME_MAX_SIZE];
+    test_check(IQFrame_Encode(IQFRAME_FMT_S16, 0, 0, ev_iq, max_s16 + 1,
+        frame, sizeof(frame)) == EFATAL, "too long");
+
+    /* every single bit error is caught */
+    test_check(TestIQFrame_BitErrors(IQFRAME_FMT_S16, ev_iq, max_s16) == EOK,
+        "s16 bit errors");
+    test_check(TestIQFrame_BitErrors(IQFRAME_FMT_S8, ev_iq, max_s8) == EOK,
+        "s8 bit errors");
+
+    /* serial link: base64 text lines (the way the notifications are rendered)
+     * against the frames that fill the same response line budget */
+    int txt_num = (AT_RES_MAX_LINE_LEN - (sizeof("+RADIO_IQ: ") - 1) -
+        sizeof(AT_LINE_END)) / 4 * 3 / (2 * sizeof(float));
+    int txt_len = (sizeof("+RADIO_IQ: ") - 1) + (txt_num * 8 + 2) / 3 * 4 +
+        (sizeof(AT_LINE_END) - 1);
+    double txt = TestIQFrame_LinkRate(txt_len, txt_num);
+    double s16 = TestIQFrame_LinkRate(IQFrame_Encode(IQFRAME_FMT_S16, 0, 0,
+        ev_iq, max_s16, frame, sizeof(frame)), max_s16);
+    double s8 = TestIQFrame_LinkRate(IQFrame_Encode(IQFRAME_FMT_S8, 0, 0,
+        ev_iq, max_s8, frame, sizeof(frame)), max_s8);
+    printf("  text: %d pairs per %d bytes, %.0f pairs/s\n", txt_num, txt_len,
+        txt);
+    printf("  s16: %d pairs per frame, %.0f pairs/s (x%.2f)\n", max_s16, s16,
+        s16 / txt);
+    printf("  s8: %d pairs per frame, %.0f pairs/s (x%.2f)\n", max_s8, s8,
+        s8 / txt);
+    test_check(s16 >= 2 * txt && s16 >= 24000, "s16 = %.0f", s16);
+    test_check(s8 >= 4 * txt && s8 >= 48000, "s8 = %.0f", s8);
+
+    /* report status */
+    return EOK;
+}
@@ -0,0 +1,218 @@
+/**
+ * @file iqrate.c
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Host test: runtime selectable iq stream sampling rate. The half-band
+ * decimator must be flat in the passband and reject whatever aliases onto it.
+ * Whole receiver is switched through all the rates (from the radio api and
+ * from the usb host side): every change must be announced once, usb stream
+ * must carry exactly the number of samples that the rate implies, the carrier
+ * level must not depend on the rate, the station next door must only show up
+ * when it fits within the stream and the channel path must stay unaffected.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "config.h"
+#include "err.h"
+#include "dsp/hband.h"
+#include "host/host.h"
+#include "host/test/iqrate.h"
+#include "host/test/test.h"
+#include "radio/meter.h"
+#include "radio/radio.h"
+#include "sys/ev.h"
+#include "util/elems.h"
+
+/* station frequency, offset of the adjacent one */
+#define STATION_FREQ                    225000
+#define ADJ_OFFSET                      9000
+/* frames to let the filters settle, frames to measure over */
+#define SETTLE_FRAMES                   20
+#define MEASURE_FRAMES                  50
+
+/* number of the iq rate events, rate from the last one */
+static int ev_cnt, ev_rate;
+
+/* iq rate has changed */
+static int TestIQRate_Callback(void *arg)
+{
+    /* event argument */
+    radio_iq_evarg_t *ea = arg;
+    /* note the rate */
+    ev_cnt++, ev_rate = ea->rate;
+    /* report status */
+    return EOK;
+}
+
+/* gain of the half-band decimator for the tone at 'f' (relative to the input
+ * sampling rate) [dB] */
+static double TestIQRate_HBandGain(double f)
+{
+    /* decimator, data block */
+    hband_t hb; float x[256];
+    /* output power, number of output samples */
+    double p = 0; int n = 0;
+
+    /* feed the tone in blocks */
+    HBand_Init(&hb, HBAND_TAPS);
+    for (int blk = 0, k = 0; blk < 32; blk++) {
+        for (int j = 0; j < (int)elems(x); j++, k++)
+            x[j] = cos(2 * M_PI * f * k);
+        /* in-situ */
+        int num = HBand_Decimate(&hb, x, elems(x), x);
+        /* skip the transient */
+        for (int j = 0; blk >= 2 && j < num; j++, n++)
+            p += x[j] * x[j];
+    }
+
+    /* input tone has the power of 1/2 */
+    return 10 * log10(p / n * 2);
+}
+
+/* run the receiver for 'frames' with the station (and the adjacent one when
+ * 'adj' is set), checks that every frame brings 'per_frame' iq samples,
+ * returns the power of the carrier (which sits at dc) and the power of what
+ * is left of the iq stream when the carrier is taken away */
+static double TestIQRate_Feed(int adj, int frames, int per_frame,
+    double *rest)
+{
+    /* stations */
+    static test_am_t station = { .fc = STATION_FREQ, .amp = 200 };
+    static test_am_t adjacent = { .fc = STATION_FREQ + ADJ_OFFSET,
+        .amp = 200 };
+    /* number of samples per rf event */
+    const int rf_num = HostRFIn_GetHalfSize();
+    /* data buffers (room for the widest stream) */
+    int16_t rf[rf_num], rf_adj[rf_num];
+    int32_t iq[rf_num / DEC_MIN_DECIMATION_RATE * 2 * 2];
+    int32_t out[rf_num / DEC_DECIMATION_RATE * 2];
+    /* mean values, overall power, number of the samples */
+    double mi = 0, mq = 0, p = 0; long n = 0;
+
+    /* process the frames */
+    for (int f = 0; f < frames; f++) {
+        TestHost_GenAM(&station, rf, rf_num);
+        TestHost_GenAM(&adjacent, rf_adj, rf_num);
+        for (int k = 0; adj && k < rf_num; k++)
+            rf[k] += rf_adj[k];
+        test_check(HostRFIn_Feed(rf, rf_num) == EOK, "feed");
+        HostSAI1A_Drain(out, elems(out) / 2);
+        /* take all the iq samples there are */
+        int num = HostUSBAudioSrc_GetSamples(iq, elems(iq) / 2);
+        test_check(per_frame < 0 || num == per_frame, "num = %d (%d)", num,
+            per_frame);
+        /* accumulate */
+        for (int k = 0; k < num; k++, n++) {
+            double i = ldexp(iq[2 * k], -31), q = ldexp(iq[2 * k + 1], -31);
+            mi += i, mq += q, p += i * i + q * q;
+        }
+    }
+
+    /* no samples */
+    if (!n)
+        return -INFINITY;
+    /* carrier power, the rest */
+    mi /= n, mq /= n;
+    if (rest)
+        *rest = 10 * log10(p / n - mi * mi - mq * mq);
+    return 10 * log10(mi * mi + mq * mq);
+}
+
+/* switch the rate, returns the number of events caught */
+static int TestIQRate_Switch(int rate, int from_usb)
+{
+    /* event counter before the switch */
+    int cnt = ev_cnt;
+
+    /* request the rate the same way the host would or by using the api */
+    if (from_usb) {
+        test_check(HostUSBAudioSrc_SelectRate(rate) == EOK, "select");
+    } else {
+        test_check(Radio_SetIQRate(rate) == EOK, "set");
+    }
+    /* rate is applied with the next frame, takes effect with the one after */
+    TestIQRate_Feed(0, 2, -1, 0);
+    /* check the effect */
+    int r; Radio_GetIQRate(&r);
+    test_check(r == rate && ev_rate == rate &&
+        HostUSBAudioSrc_GetRate() == (uint32_t)rate, "rate = %d, ev = %d, "
+        "usb = %u", r, ev_rate, HostUSBAudioSrc_GetRate());
+    /* return the number of events */
+    return ev_cnt - cnt;
+}
+
+/* run the test */
+int TestIQRate_Run(void)
+{
+    /* rates to go through */
+    static const int rates[] = { 96000, 24000, 12000, 48000 };
+    /* reference carrier power, rssi */
+    double ref; float ref_rssi, rssi, floor;
+
+    /* half-band decimator: flat up to 0.2 of the input rate, rejects from
+     * 0.3 on (that is what aliases onto the useful band) */
+    double pass = TestIQRate_HBandGain(0.2);
+    double stop = fmax(TestIQRate_HBandGain(0.3),
+        TestIQRate_HBandGain(0.45));
+    printf("  half-band: %.3f dB @ 0.2, %.1f dB @ 0.3..0.45\n", pass, stop);
+    test_check(fabs(TestIQRate_HBandGain(0.01)) < 0.01, "dc");
+    test_check(fabs(pass) < 0.01, "pass = %.3f", pass);
+    test_check(stop < -70, "stop = %.1f", stop);
+
+    /* bring up the receiver, the rates that do not come from the decimation
+     * by 25 * 2^k are refused */
+    test_check(TestHost_StartRadio(STATION_FREQ) == EOK, "start");
+    test_check(Radio_SetIQRate(44100) == EFATAL &&
+        Radio_SetIQRate(192000) == EFATAL && Radio_SetIQRate(6000) == EFATAL &&
+        Radio_SetIQRate(0) == EFATAL && Radio_SetIQRate(-48000) == EFATAL,
+        "invalid rates");
+    test_check(HostUSBAudioSrc_SelectRate(44100) == EFATAL, "invalid rate");
+    Ev_RegisterCallback(&radio_iq_ev, TestIQRate_Callback);
+
+    /* reference at the default rate */
+    TestIQRate_Feed(0, SETTLE_FRAMES, -1, 0);
+    ref = TestIQRate_Feed(0, MEASURE_FRAMES, BB_SAMPLING_RATE / 500, 0);
+    Meter_GetLevels(&ref_rssi, &floor);
+
+    /* go through the rates */
+    for (int k = 0; k < (int)elems(rates); k++) {
+        /* iq samples per 2ms frame */
+        int rate = rates[k], per_frame = rate / 500;
+        /* every other switch is initiated by the usb host */
+        int events = TestIQRate_Switch(rate, k % 2);
+        test_check(events == 1, "events = %d", events);
+        /* carrier alone, then with the adjacent station */
+        TestIQRate_Feed(0, SETTLE_FRAMES, per_frame, 0);
+        double p = TestIQRate_Feed(0, MEASURE_FRAMES, per_frame, 0);
+        Meter_GetLevels(&rssi, &floor);
+        TestIQRate_Feed(1, SETTLE_FRAMES, per_frame, 0);
+        /* power the adjacent station brings to the stream (relative to the
+         * carrier) */
+        double adj; TestIQRate_Feed(1, MEASURE_FRAMES, per_frame, &adj);
+        adj -= p;
+        printf("  %5d Hz: %3d samples per frame, carrier %.2f dB "
+            "(%.2f dB), adjacent %.1f dBc, rssi %.2f dB\n", rate, per_frame,
+            p, ref, adj, rssi);
+        /* level does not depend on the rate */
+        test_check(fabs(p - ref) < 0.5, "p = %.2f", p);
+        /* the channel path runs at the same rate all the time */
+        test_check(fabs(rssi - ref_rssi) < 0.5, "rssi = %.2f", rssi);
+        /* adjacent station only gets through when it fits */
+        if (ADJ_OFFSET < rate / 2) {
+            test_check(adj > -3, "adj = %.1f", adj);
+        } else {
+            test_check(adj < -50, "adj = %.1f", adj);
+        }
+    }
+
+    /* no event when the rate stays the same */
+    test_check(TestIQRate_Switch(BB_SAMPLING_RATE, 0) == 0, "events");
+    Ev_UnregisterCallback(&radio_iq_ev, TestIQRate_Callback);
+    /* report status */
+    return EOK;
+}
@@ -0,0 +1,203 @@
+/**
+ * @file meter.c
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Host test: signal meter and squelch. Am carrier in the white noise
+ * must be measured with the right level, noise floor and snr, a strong
+ * adjacent station must not lift the noise floor. Squelch must open on the
+ * signal, stay open for the hang time and close afterwards. Whole receiver
+ * with the squelch closed must send silence to the dac and skip the audio
+ * processing stages.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "config.h"
+#include "err.h"
+#include "host/host.h"
+#include "host/test/meter.h"
+#include "host/test/test.h"
+#include "radio/meter.h"
+#include "radio/radio.h"
+
+/* baseband samples per rf frame */
+#define BLOCK_SIZE                      96
+/* noise level (power of the complex noise) [dB] */
+#define NOISE_DB                        -60.0
+
+/* gaussian noise sample of given rms */
+static double TestMeter_Noise(double rms)
+{
+    /* box-muller */
+    double u1 = (rand() + 1.0) / ((double)RAND_MAX + 2);
+    double u2 = rand() / (double)RAND_MAX;
+    return rms * sqrt(-2 * log(u1)) * cos(2 * M_PI * u2);
+}
+
+/* feed 'seconds' worth of the am carrier (level 'car' in dB, -INFINITY for
+ * none), the adjacent carrier at 'adj_f' and the noise, returns the squelch
+ * state after every block */
+static int TestMeter_Feed(double car, double adj, double adj_f,
+    double seconds, int *opened, int *closed)
+{
+    /* block of data */
+    float i[BLOCK_SIZE], q[BLOCK_SIZE];
+    /* phase is kept between the calls */
+    static long n;
+    /* amplitudes, noise rms per component */
+    double a = pow(10, car / 20), b = pow(10, adj / 20);
+    double rms = sqrt(pow(10, NOISE_DB / 10) / 2);
+    /* squelch state */
+    int state = -1;
+
+    /* generate and feed */
+    *opened = *closed = -1;
+    for (long blk = 0; blk < seconds * BB_SAMPLING_RATE / BLOCK_SIZE; blk++) {
+        for (int k = 0; k < BLOCK_SIZE; k++, n++) {
+            /* carrier modulated with 1kHz tone, 50% */
+            double m = a * (1 + 0.5 * cos(2 * M_PI * 1000 * n /
+                BB_SAMPLING_RATE));
+            double w = 2 * M_PI * adj_f * n / BB_SAMPLING_RATE;
+            i[k] = m + b * cos(w) + TestMeter_Noise(rms);
+            q[k] = b * sin(w) + TestMeter_Noise(rms);
+        }
+        /* note the block numbers at which the squelch changes it's state */
+        int s = Meter_Process(i, q, BLOCK_SIZE);
+        if (s != state && state != -1)
+            *(s ? opened : closed) = blk;
+        state = s;
+    }
+
+    /* report the final state */
+    return state;
+}
+
+/* run the whole receiver without any station, returns the peak of the dac
+ * samples */
+static int TestMeter_Receiver(float amp, int frames, int32_t *peak)
+{
+    /* station */
+    static test_am_t station = { .fc = 225000, .fm = 1000, .depth = 0.5 };
+    /* number of samples per rf event */
+    const int rf_num = HostRFIn_GetHalfSize();
+    const int bb_num = rf_num / DEC_DECIMATION_RATE;
+    /* data buffers */
+    int16_t rf[rf_num]; int32_t out[bb_num * 2];
+
+    /* process the frames */
+    station.amp = amp, *peak = 0;
+    for (int f = 0; f < frames; f++) {
+        TestHost_GenAM(&station, rf, rf_num);
+        test_check(HostRFIn_Feed(rf, rf_num) == EOK, "feed");
+        HostUSBAudioSrc_GetSamples(out, bb_num);
+        /* the dac buffer is half of it's size behind, check the last frames
+         * only */
+        HostSAI1A_Drain(out, bb_num);
+        for (int k = 0; f >= frames / 2 && k < bb_num; k++)
+            *peak = abs(out[k]) > *peak ? abs(out[k]) : *peak;
+    }
+
+    /* report status */
+    return EOK;
+}
+
+/* run the test */
+int TestMeter_Run(void)
+{
+    /* measurements, squelch state */
+    float rssi, floor, snr; int open, opened, closed;
+    /* profiler statistics */
+    prof_stats_t demod0, demod1, meter0, meter1;
+    /* dac peak */
+    int32_t peak;
+
+    /* initialize */
+    test_check(Meter_Init() == EOK, "init");
+    test_check(Meter_SetSquelch(-1) == EFATAL &&
+        Meter_SetSquelch(METER_MAX_SQUELCH + 1) == EFATAL, "squelch");
+
+    /* carrier at -30dB in the noise, expected floor: noise power in the
+     * equivalent noise bandwidth of the hann window (1.5 bins) */
+    double floor_db = NOISE_DB + 10 * log10(1.5 / METER_SIZE);
+    /* carrier and the sidebands */
+    double rssi_db = -30 + 10 * log10(1 + 0.5 * 0.5 / 2);
+    TestMeter_Feed(-30, -INFINITY, 0, 1, &opened, &closed);
+    Meter_GetLevels(&rssi, &floor);
+    printf("  carrier: rssi = %.1f dB (%.1f dB), floor = %.1f dB (%.1f dB)\n",
+        rssi, rssi_db, floor, floor_db);
+    test_check(fabs(rssi - rssi_db) < 0.5, "rssi = %.1f", rssi);
+    test_check(fabs(floor - floor_db) < 1, "floor = %.1f", floor);
+
+    /* strong station 12kHz away must not lift the floor */
+    TestMeter_Feed(-30, -10, 12000, 1, &opened, &closed);
+    Meter_GetLevels(&rssi, &floor);
+    printf("  adjacent station: rssi = %.1f dB, floor = %.1f dB\n", rssi,
+        floor);
+    test_check(fabs(rssi - rssi_db) < 0.5, "rssi = %.1f", rssi);
+    test_check(fabs(floor - floor_db) < 1, "floor = %.1f", floor);
+
+    /* squelch at 10dB snr: open with the carrier */
+    test_check(Meter_SetSquelch(10) == EOK, "squelch");
+    /* weak carrier 15dB above the floor */
+    open = TestMeter_Feed(floor_db + 15, -INFINITY, 0, 0.5, &opened,
+        &closed);
+    test_check(open && closed == -1, "open = %d, closed = %d", open, closed);
+    /* carrier is gone: stays open for the hang time, then closes (the channel
+     * power needs a while to drop below the threshold as well) */
+    open = TestMeter_Feed(-INFINITY, -INFINITY, 0, 0.5, &opened, &closed);
+    double t_close = (closed + 1) * 1000.0 * BLOCK_SIZE / BB_SAMPLING_RATE;
+    printf("  squelch closed %.0f ms after the carrier was gone\n", t_close);
+    test_check(!open && opened == -1, "open = %d", open);
+    test_check(t_close >= SQUELCH_HANG && t_close < SQUELCH_HANG +
+        3 * METER_TIME,
+        "t = %.0f", t_close);
+    /* noise only, squelch stays closed */
+    open = TestMeter_Feed(-INFINITY, -INFINITY, 0, 1, &opened, &closed);
+    test_check(!open && opened == -1, "opened = %d", opened);
+    /* carrier: opens right away */
+    open = TestMeter_Feed(floor_db + 15, -INFINITY, 0, 0.5, &opened,
+        &closed);
+    double t_open = (opened + 1) * 1000.0 * BLOCK_SIZE / BB_SAMPLING_RATE;
+    printf("  squelch opened %.0f ms after the carrier appeared\n", t_open);
+    test_check(open && t_open < METER_TIME * 2, "t = %.0f", t_open);
+    /* squelch disabled */
+    test_check(Meter_SetSquelch(0) == EOK, "squelch");
+    test_check(TestMeter_Feed(-INFINITY, -INFINITY, 0, 0.1, &opened,
+        &closed), "open");
+
+    /* whole receiver: flush whatever the previous tests left within the
+     * pipeline, then re-initialize the meter as it was fed directly */
+    test_check(TestHost_StartRadio(225000) == EOK, "start");
+    test_check(TestMeter_Receiver(0, 20, &peak) == EOK, "rx");
+    test_check(Meter_Init() == EOK && Meter_SetSquelch(10) == EOK, "init");
+    test_check(TestMeter_Receiver(0, 200, &peak) == EOK, "rx");
+    Radio_GetProfile(RADIO_PROF_DEMOD, 0, &demod0);
+    Radio_GetProfile(RADIO_PROF_METER, 0, &meter0);
+    /* no station: squelch stays closed, the dac gets the silence */
+    test_check(TestMeter_Receiver(0, 200, &peak) == EOK, "rx");
+    Meter_GetLevels(&rssi, &floor); Meter_GetSquelch(&snr, &open);
+    Radio_GetProfile(RADIO_PROF_DEMOD, 0, &demod1);
+    Radio_GetProfile(RADIO_PROF_METER, 0, &meter1);
+    printf("  receiver, no station: rssi = %.1f dB, floor = %.1f dB, "
+        "open = %d, demodulated frames = %u of %u\n", rssi, floor, open,
+        demod1.cnt - demod0.cnt, meter1.cnt - meter0.cnt);
+    test_check(!open && peak == 0, "open = %d, peak = %d", open, peak);
+    test_check(demod1.cnt == demod0.cnt && meter1.cnt - meter0.cnt == 200,
+        "demod = %u, meter = %u", demod1.cnt - demod0.cnt,
+        meter1.cnt - meter0.cnt);
+    /* station: audio comes back */
+    test_check(TestMeter_Receiver(200, 200, &peak) == EOK, "rx");
+    Meter_GetLevels(&rssi, &floor); Meter_GetSquelch(&snr, &open);
+    printf("  receiver, station: rssi = %.1f dB, floor = %.1f dB, open = %d\n",
+        rssi, floor, open);
+    test_check(open && peak > 0, "open = %d, peak = %d", open, peak);
+
+    /* restore the default */
+    Meter_SetSquelch(0);
+    /* report status */
+    return EOK;
+}
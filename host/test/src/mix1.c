@@ -0,0 +1,137 @@
+/**
+ * @file mix1.c
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Host test: 1st stage mixer. Checks the mixer output against the
+ * floating point model for all the bands, verifies that the re-tuning
+ * switches the local oscillator tables between the frames and that the
+ * kernel selected with MIX1_PACKED matches the reference (scalar) one bit by
+ * bit.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "config.h"
+#include "err.h"
+#include "dev/cyccnt.h"
+#include "host/test/mix1.h"
+#include "host/test/test.h"
+#include "radio/mix1.h"
+#include "util/elems.h"
+
+/* number of samples in the frame */
+#define FRAME_SIZE                      (RF_SAMPLING_FREQ * 2 / 1000)
+/* number of bands offered by the mixer */
+#define BANDS_NUM                       100
+/* band spacing */
+#define BAND_SPACING                    (RF_SAMPLING_FREQ / (BANDS_NUM * 2))
+
+/* check the frame against the model of the mixer tuned to given band */
+static int TestMix1_Check(const int16_t *rf, const int16_t *i,
+    const int16_t *q, int num, int band)
+{
+    /* lut gain: Q30 cosine, shifted by RF_SAMPLING_BITS and then by the
+     * mixer normalization shift */
+    const double gain = ldexp(1, 30 - RF_SAMPLING_BITS -
+        (31 - DEC_MAX_INPUT_BITS - 1));
+
+    /* check all samples */
+    for (int n = 0; n < num; n++) {
+        /* local oscillator phase */
+        double ph = 2 * M_PI * ((n * band) % (BANDS_NUM * 2)) /
+            (BANDS_NUM * 2);
+        /* expected values */
+        double ei = rf[n] * gain * cos(ph), eq = -rf[n] * gain * sin(ph);
+        /* allow for the rounding errors */
+        test_check(fabs(i[n] - ei) <= 1 && fabs(q[n] - eq) <= 1,
+            "band = %d, n = %d: i = %d (%f), q = %d (%f)", band, n, i[n], ei,
+            q[n], eq);
+    }
+
+    /* report status */
+    return EOK;
+}
+
+/* compare the selected kernel against the reference one */
+static int TestMix1_Equivalence(const int16_t *rf, int16_t *i, int16_t *q,
+    int band)
+{
+    /* reference results */
+    static int16_t ALIGNED(4) i_ref[FRAME_SIZE], q_ref[FRAME_SIZE];
+
+    /* mix using both kernels */
+    Mix1_Mix(rf, FRAME_SIZE, i, q);
+    Mix1_MixRef(rf, FRAME_SIZE, i_ref, q_ref);
+    /* results must match exactly */
+    for (int n = 0; n < FRAME_SIZE; n++)
+        test_check(i[n] == i_ref[n] && q[n] == q_ref[n],
+            "band = %d, n = %d: i = %d (%d), q = %d (%d)", band, n, i[n],
+            i_ref[n], q[n], q_ref[n]);
+
+    /* report status */
+    return EOK;
+}
+
+/* run the test */
+int TestMix1_Run(void)
+{
+    /* data buffers */
+    static int16_t ALIGNED(4) rf[FRAME_SIZE], i[FRAME_SIZE], q[FRAME_SIZE];
+    /* extreme values of the rf samples */
+    const int16_t rf_min = -(1 << (RF_SAMPLING_BITS - 1));
+    const int16_t rf_max = (1 << (RF_SAMPLING_BITS - 1)) - 1;
+
+    /* full scale random data */
+    for (int n = 0; n < FRAME_SIZE; n++)
+        rf[n] = (rand() % (1 << RF_SAMPLING_BITS)) -
+            (1 << (RF_SAMPLING_BITS - 1));
+
+    /* go through all the bands in both directions so that both tables get
+     * used for every band */
+    for (int k = 0; k <= 2 * BANDS_NUM; k++) {
+        /* band to be checked */
+        int band = k <= BANDS_NUM ? k : 2 * BANDS_NUM - k;
+        /* tune */
+        float f = Mix1_SetLOFrequency(band * BAND_SPACING);
+        test_check(f == band * BAND_SPACING, "f = %f", f);
+        /* mix and check */
+        Mix1_Mix(rf, FRAME_SIZE, i, q);
+        if (TestMix1_Check(rf, i, q, FRAME_SIZE, band) != EOK ||
+            TestMix1_Equivalence(rf, i, q, band) != EOK)
+            return EFATAL;
+    }
+
+    /* kernels must also agree on the extreme values */
+    for (int n = 0; n < FRAME_SIZE; n++)
+        rf[n] = n % 3 == 0 ? rf_min : n % 3 == 1 ? rf_max : 0;
+    for (int band = 0; band <= BANDS_NUM; band++) {
+        Mix1_SetLOFrequency(band * BAND_SPACING);
+        if (TestMix1_Equivalence(rf, i, q, band) != EOK)
+            return EFATAL;
+    }
+
+    /* compare the execution times */
+    uint32_t ts, t_sel = 0, t_ref = 0;
+    for (int k = 0; k < 1000; k++) {
+        ts = CycCnt_GetValue(); Mix1_Mix(rf, FRAME_SIZE, i, q);
+        t_sel += CycCnt_GetValue() - ts;
+        ts = CycCnt_GetValue(); Mix1_MixRef(rf, FRAME_SIZE, i, q);
+        t_ref += CycCnt_GetValue() - ts;
+    }
+    printf("  %s kernel: %u cycles/frame, reference: %u cycles/frame\n",
+        MIX1_PACKED ? "packed" : "scalar", t_sel / 1000, t_ref / 1000);
+
+    /* re-tuning to the same band must not disturb the output */
+    Mix1_SetLOFrequency(25 * BAND_SPACING);
+    Mix1_SetLOFrequency(25 * BAND_SPACING);
+    Mix1_Mix(rf, FRAME_SIZE, i, q);
+    if (TestMix1_Check(rf, i, q, FRAME_SIZE, 25) != EOK)
+        return EFATAL;
+
+    /* report status */
+    return EOK;
+}
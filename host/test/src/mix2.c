@@ -0,0 +1,287 @@
+/**
+ * @file mix2.c
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Host test: 2nd stage mixer fused with the usb data preparation.
+ * Compares the fused kernel (mixing + Q31 conversion + writing to the usb
+ * buffer) against the separate passes that were used before, both in terms of
+ * the results (which must be identical, also when the usb buffer wraps or
+ * overflows) and the execution time. Checks the nco tuning resolution, the
+ * purity of the generated oscillation and that the nco does not cost more
+ * than the band-stepped oscillator it replaced.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "config.h"
+#include "err.h"
+#include "dev/cyccnt.h"
+#include "dev/usb_audiosrc.h"
+#include "dsp/float_fixp.h"
+#include "host/host.h"
+#include "host/test/mix2.h"
+#include "host/test/test.h"
+#include "radio/mix2.h"
+#include "util/elems.h"
+#include "util/minmax.h"
+
+/* number of samples processed in every pass of the comparison: the mixer
+ * phase returns to the starting point after that many samples for the
+ * frequencies that are multiples of BB_SAMPLING_RATE / 1024, so both methods
+ * get to see the same oscillator phases */
+#define TOTAL_SIZE                      3072
+/* block size: does not divide the usb buffer size so that the buffer wraps in
+ * the middle of the block */
+#define BLOCK_SIZE                      1024
+/* number of blocks after which the usb buffer gets drained */
+#define DRAIN_EVERY                     2
+/* size of the lut of the band-stepped oscillator that the nco replaced */
+#define BAND_LUT_SIZE                   1024
+/* number of frames per timing measurement and the number of measurements
+ * (the fastest one is reported) */
+#define BENCH_FRAMES                    10
+#define BENCH_RUNS                      200
+
+/* method of processing the data: usb data preparation (separate passes or
+ * the fused kernel) or the mixing alone (band-stepped oscillator or the
+ * nco) */
+typedef enum { SEPARATE, FUSED, BAND, NCO } method_t;
+
+/* cosine lut of the band-stepped oscillator, oscillator band */
+static float band_lut[BAND_LUT_SIZE];
+static int band;
+
+/* mixer that was used before the nco: the phase is expressed in the lut
+ * entries and advances by the band number every sample */
+static void NOINLINE OPTIMIZE("O3") TestMix2_MixBand(const float *i,
+    const float *q, int num, float *i_out, float *q_out)
+{
+    /* phase accumulator */
+    static unsigned int phase;
+    /* temporary storage */
+    float _i, _q, i_lut, q_lut;
+
+    /* do the complex multiplication */
+    for (int cnt = 0; cnt < num; cnt++,
+        phase = (phase + band) % elems(band_lut)) {
+        /* lut entries */
+        i_lut = band_lut[phase];
+        q_lut = band_lut[(phase + elems(band_lut) / 4) % elems(band_lut)];
+        /* (a + bi) * (c + di) = (ac - bd) + i(ad + bc) */
+        _i = i[cnt] * i_lut - q[cnt] * q_lut;
+        _q = i[cnt] * q_lut + q[cnt] * i_lut;
+        /* using temporary registers allows for in-situ operation */
+        i_out[cnt] = _i, q_out[cnt] = _q;
+    }
+}
+
+/* process single block with given method */
+static void TestMix2_Block(method_t method, float *i, float *q, int num)
+{
+    /* separate passes: mixing, conversion, storing */
+    if (method == SEPARATE) {
+        /* conversion buffers */
+        int32_t i32[num], q32[num];
+        /* mixing */
+        Mix2_Mix(i, q, num, i, q);
+        /* conversion to the fixed point notation */
+        FloatFixp_FloatToFixp32(i, num, 31, i32);
+        FloatFixp_FloatToFixp32(q, num, 31, q32);
+        /* put into usb buffers */
+        USBAudioSrc_PutSamples(i32, q32, num);
+    /* single pass */
+    } else if (method == FUSED) {
+        /* space within the usb buffer */
+        usb_audio_span_t span;
+        /* get the space */
+        int usb_num = USBAudioSrc_AcquireSpace(num, &span);
+        /* mix directly to the buffer */
+        for (int k = 0, n = 0; k < (int)elems(span.num); n += span.num[k++])
+            Mix2_MixFixp32(i + n, q + n, span.num[k], i + n, q + n,
+                span.ptr[k]);
+        /* mix the rest */
+        Mix2_Mix(i + usb_num, q + usb_num, num - usb_num, i + usb_num,
+            q + usb_num);
+        /* commit */
+        USBAudioSrc_CommitSamples(usb_num);
+    /* mixing with the band-stepped oscillator */
+    } else if (method == BAND) {
+        TestMix2_MixBand(i, q, num, i, q);
+    /* mixing with the nco */
+    } else {
+        Mix2_Mix(i, q, num, i, q);
+    }
+}
+
+/* measure the cost of processing the block with given method, returns the
+ * number of cycles per block */
+static float TestMix2_Bench(method_t method, float *i, float *q, int num)
+{
+    /* usb stream (discarded) */
+    static int32_t usb[TOTAL_SIZE * 2];
+    /* fastest measurement */
+    uint32_t ts, t_min = UINT32_MAX;
+
+    /* measure a couple of times */
+    for (int r = 0; r < BENCH_RUNS; r++) {
+        /* flush the usb buffer so that it does not overflow */
+        while (HostUSBAudioSrc_GetSamples(usb, TOTAL_SIZE));
+        /* process a few blocks */
+        ts = CycCnt_GetValue();
+        for (int k = 0; k < BENCH_FRAMES; k++)
+            TestMix2_Block(method, i, q, num);
+        t_min = min(t_min, CycCnt_GetValue() - ts);
+    }
+
+    /* return the cost of a single block */
+    return (float)t_min / BENCH_FRAMES;
+}
+
+/* process all data with given method, store the float results and the
+ * contents of the usb stream */
+static int TestMix2_Process(method_t method, const float *i, const float *q,
+    float *i_out, float *q_out, int32_t *usb)
+{
+    /* number of samples fetched from the usb buffer */
+    int usb_num = 0;
+
+    /* flush the usb buffer */
+    while (HostUSBAudioSrc_GetSamples(usb, TOTAL_SIZE));
+
+    /* copy the input data, mixing is done in-situ */
+    for (int n = 0; n < TOTAL_SIZE; n++)
+        i_out[n] = i[n], q_out[n] = q[n];
+    /* process block by block */
+    for (int n = 0; n < TOTAL_SIZE; n += BLOCK_SIZE) {
+        /* process */
+        TestMix2_Block(method, i_out + n, q_out + n, BLOCK_SIZE);
+        /* drain the usb buffer every once in a while, so that it overflows
+         * from time to time */
+        if ((n / BLOCK_SIZE) % DRAIN_EVERY == DRAIN_EVERY - 1)
+            usb_num += HostUSBAudioSrc_GetSamples(usb + 2 * usb_num,
+                TOTAL_SIZE - usb_num);
+    }
+    /* fetch the rest */
+    usb_num += HostUSBAudioSrc_GetSamples(usb + 2 * usb_num,
+        TOTAL_SIZE - usb_num);
+
+    /* return the number of pairs of samples in the usb stream */
+    return usb_num;
+}
+
+/* check the nco: tuning accuracy and the oscillation purity */
+static int TestMix2_NCO(float f)
+{
+    /* one second worth of samples */
+    static float i[BB_SAMPLING_RATE], q[BB_SAMPLING_RATE];
+    /* accumulated deviation of the phase step from the expected one */
+    double dph = 0;
+
+    /* tune */
+    float actual = Mix2_SetLOFrequency(f);
+    /* sub-Hz resolution is expected */
+    test_check(fabs(actual - f) < 0.01, "f = %f, actual = %f", f, actual);
+    /* expected phase step (oscillator brings the positive frequencies down,
+     * hence the minus sign) */
+    double w = -2 * M_PI * actual / BB_SAMPLING_RATE, wc = cos(w), ws = sin(w);
+
+    /* mixing the constant gives the oscillator output */
+    for (int n = 0; n < BB_SAMPLING_RATE; n++)
+        i[n] = 1, q[n] = 0;
+    Mix2_Mix(i, q, BB_SAMPLING_RATE, i, q);
+
+    /* go through all the samples */
+    for (int n = 0; n < BB_SAMPLING_RATE; n++) {
+        /* magnitude must be constant */
+        double mag = hypot(i[n], q[n]);
+        test_check(fabs(mag - 1) < 2e-5, "f = %f, n = %d, mag = %f", f, n,
+            mag);
+        /* phase step between the consecutive samples less the expected one
+         * (stays small, so it does not wrap around even close to fs/2 where
+         * the lut quantization makes the step itself exceed pi) */
+        if (n) {
+            double re = i[n] * i[n - 1] + q[n] * q[n - 1];
+            double im = q[n] * i[n - 1] - i[n] * q[n - 1];
+            dph += atan2(im * wc - re * ws, re * wc + im * ws);
+        }
+    }
+
+    /* measured frequency */
+    double measured = actual - dph / (2 * M_PI) * BB_SAMPLING_RATE /
+        (BB_SAMPLING_RATE - 1);
+    test_check(fabs(measured - actual) < 1e-3, "f = %f, actual = %f, "
+        "measured = %f", f, actual, measured);
+
+    /* report status */
+    return EOK;
+}
+
+/* run the test */
+int TestMix2_Run(void)
+{
+    /* input data and the results */
+    static float i[TOTAL_SIZE], q[TOTAL_SIZE];
+    static float i_ref[TOTAL_SIZE], q_ref[TOTAL_SIZE];
+    static float i_out[TOTAL_SIZE], q_out[TOTAL_SIZE];
+    static int32_t usb_ref[TOTAL_SIZE * 2], usb[TOTAL_SIZE * 2];
+
+    /* random data that exceeds the Q31 range once in a while so that the
+     * saturation is verified as well */
+    for (int n = 0; n < TOTAL_SIZE; n++) {
+        i[n] = (rand() / (float)RAND_MAX - 0.5f) * 2.2f;
+        q[n] = (rand() / (float)RAND_MAX - 0.5f) * 2.2f;
+    }
+
+    /* tune somewhere (see TOTAL_SIZE) */
+    Mix2_SetLOFrequency(-263.0f * BB_SAMPLING_RATE / 1024);
+    /* process with both methods */
+    int num_ref = TestMix2_Process(SEPARATE, i, q, i_ref, q_ref, usb_ref);
+    int num = TestMix2_Process(FUSED, i, q, i_out, q_out, usb);
+
+    /* compare the floating point results */
+    for (int n = 0; n < TOTAL_SIZE; n++)
+        test_check(i_out[n] == i_ref[n] && q_out[n] == q_ref[n],
+            "n = %d: i = %e (%e), q = %e (%e)", n, i_out[n], i_ref[n],
+            q_out[n], q_ref[n]);
+    /* compare the usb streams */
+    test_check(num == num_ref, "num = %d (%d)", num, num_ref);
+    /* make sure that the overflow was exercised */
+    test_check(num < TOTAL_SIZE, "num = %d", num);
+    for (int n = 0; n < num * 2; n++)
+        test_check(usb[n] == usb_ref[n], "n = %d: %d (%d)", n, usb[n],
+            usb_ref[n]);
+
+    /* nco tuning */
+    const float freqs[] = { 0, 0.5f, 1000.37f, -1000.37f, 5999.99f, -11987.3f,
+        BB_SAMPLING_RATE / 2 - 0.1f };
+    for (int k = 0; k < (int)elems(freqs); k++)
+        if (TestMix2_NCO(freqs[k]) != EOK)
+            return EFATAL;
+
+    /* compare the execution times of all methods using the radio block
+     * size */
+    const int bb_num = RF_SAMPLING_FREQ * 2 / 1000 / DEC_DECIMATION_RATE;
+    float t[NCO + 1];
+    /* band-stepped oscillator is tuned to the same frequency as the nco */
+    for (int n = 0; n < BAND_LUT_SIZE; n++)
+        band_lut[n] = cosf(2 * M_PI * n / BAND_LUT_SIZE);
+    band = -263, Mix2_SetLOFrequency(-263.0f * BB_SAMPLING_RATE / 1024);
+    for (method_t m = SEPARATE; m <= NCO; m++)
+        t[m] = TestMix2_Bench(m, i_out, q_out, bb_num);
+    printf("  separate passes: %.1f cycles/frame, fused: %.1f cycles/frame\n",
+        t[SEPARATE], t[FUSED]);
+    printf("  band-stepped mixer: %.1f cycles/frame, nco: %.1f cycles/frame\n",
+        t[BAND], t[NCO]);
+    /* fused kernel must not cost more than the passes it replaced */
+    test_check(t[FUSED] <= t[SEPARATE], "separate = %.1f, fused = %.1f",
+        t[SEPARATE], t[FUSED]);
+    /* nco must not cost more than the modulo arithmetic it replaced */
+    test_check(t[NCO] <= t[BAND], "band = %.1f, nco = %.1f", t[BAND], t[NCO]);
+
+    /* report status */
+    return EOK;
+}
@@ -0,0 +1,300 @@
+/**
+ * @file nb.c
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Host test: noise blanker. Synthetic captures (am station in the noise
+ * with the impulses added on top) are fed through the mixer: the output must
+ * be zeroed exactly around the impulses (also when the blanking crosses the
+ * block and the frame boundaries), left untouched elsewhere and the selected
+ * kernel must match the reference one. Impulse-free signal must not trigger
+ * the blanker nor make the mixer noticeably slower. Whole receiver must recover the audio quality that the
+ * impulses destroy.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "compiler.h"
+#include "config.h"
+#include "dev/cyccnt.h"
+#include "err.h"
+#include "host/host.h"
+#include "host/test/nb.h"
+#include "host/test/test.h"
+#include "radio/mix1.h"
+#include "radio/radio.h"
+#include "util/elems.h"
+#include "util/minmax.h"
+
+/* number of samples in the frame */
+#define FRAME_SIZE                      (RF_SAMPLING_FREQ * 2 / 1000)
+/* lut length (mixer block size) */
+#define BLOCK_SIZE                      (RF_SAMPLING_FREQ / MIX1_BAND_SPACING)
+/* impulse period in samples (100 impulses per second) */
+#define IMPULSE_PERIOD                  (RF_SAMPLING_FREQ / 100)
+/* number of frames in a single benchmark measurement */
+#define BENCH_FRAMES                    10
+/* number of benchmark measurements (the fastest one is taken) */
+#define BENCH_RUNS                      200
+
+/* impulse shape for the mixer checks: short spike with the ringing that the
+ * front end adds to it (the ringing alone stays below the threshold) */
+static const int16_t impulse[] = { 2000, -300, 150, -50 };
+/* impulse shape for the receiver: broadband burst that saturates the adc */
+static const int16_t burst[] = { 1500, 2047, 1500, 800, 300, -100, -200 };
+
+/* synthetic capture: am station in the noise, bursts every IMPULSE_PERIOD
+ * samples starting at 'phase' (none if negative) */
+static void TestNB_Gen(test_am_t *am, int16_t *rf, int num, long *n,
+    long phase)
+{
+    /* generate the station */
+    TestHost_GenAM(am, rf, num);
+    /* add the impulses */
+    for (int k = 0; phase >= 0 && k < num; k++, (*n)++) {
+        long p = (*n - phase) % IMPULSE_PERIOD;
+        if (*n >= phase && p < (long)elems(burst)) {
+            int x = rf[k] + burst[p];
+            rf[k] = x > 2047 ? 2047 : x < -2048 ? -2048 : x;
+        }
+    }
+}
+
+/* measure the cost of mixing the frame with given blanker threshold, returns 
+ * the number of cycles per frame */
+static float TestNB_Bench(float threshold, const int16_t *rf, int16_t *i, 
+    int16_t *q)
+{
+    /* fastest measurement */
+    uint32_t ts, t_min = UINT32_MAX;
+
+    /* apply the threshold */
+    Mix1_SetBlanker(threshold);
+    /* measure a couple of times */
+    for (int r = 0; r < BENCH_RUNS; r++) {
+        /* process a few frames */
+        ts = CycCnt_GetValue();
+        for (int k = 0; k < BENCH_FRAMES; k++)
+            Mix1_Mix(rf, FRAME_SIZE, i, q);
+        t_min = min(t_min, CycCnt_GetValue() - ts);
+    }
+
+    /* return the cost of a single frame */
+    return (float)t_min / BENCH_FRAMES;
+}
+
+/* check a single frame with an impulse at the sample 'at' (none if
+ * negative), 'carry' is the number of samples that are blanked at the
+ * beginning of the frame because of the impulse in the previous one, it gets
+ * updated for the next frame */
+static int TestNB_Frame(test_am_t *am, int at, int *carry)
+{
+    /* data buffers */
+    static int16_t ALIGNED(4) rf[FRAME_SIZE], i[FRAME_SIZE], q[FRAME_SIZE];
+    static int16_t ALIGNED(4) i_raw[FRAME_SIZE], q_raw[FRAME_SIZE];
+    /* blanked samples counters */
+    uint32_t b0, b1;
+    /* blanking window: starts at the pair that holds the spike */
+    int pair = at & ~1, from = pair - MIX1_NB_PRE;
+    int to = pair + 2 + MIX1_NB_POST;
+    /* expected number of blanked samples */
+    int expected = *carry;
+
+    /* station with the impulse */
+    TestHost_GenAM(am, rf, FRAME_SIZE);
+    for (int k = 0; at >= 0 && k < (int)elems(impulse); k++)
+        rf[at + k] += impulse[k];
+
+    /* unblanked output (the reference kernel state does not matter as the
+     * blanker is disabled) */
+    Mix1_SetBlanker(0);
+    Mix1_MixRef(rf, FRAME_SIZE, i_raw, q_raw);
+    /* blanked output of both kernels */
+    Mix1_SetBlanker(MIX1_NB_THRESHOLD);
+    Mix1_GetBlanker(0, &b0);
+    Mix1_Mix(rf, FRAME_SIZE, i, q);
+    Mix1_GetBlanker(0, &b1);
+
+    /* compare */
+    for (int n = 0; n < FRAME_SIZE; n++) {
+        /* sample is within the blanking window */
+        int blank = n < *carry || (at >= 0 && n >= from && n < to);
+        test_check(blank ? i[n] == 0 && q[n] == 0 :
+            i[n] == i_raw[n] && q[n] == q_raw[n], "at = %d, n = %d: "
+            "i = %d (%d), q = %d (%d)", at, n, i[n], i_raw[n], q[n],
+            q_raw[n]);
+        expected += blank && n >= *carry;
+    }
+    /* number of blanked samples */
+    test_check(b1 - b0 == expected, "at = %d, blanked = %u (%d)", at,
+        b1 - b0, expected);
+
+    /* blanking that goes past the frame end */
+    *carry = at >= 0 && to > FRAME_SIZE ? to - FRAME_SIZE : 0;
+
+    /* report status */
+    return EOK;
+}
+
+/* sinad of the 1kHz tone within the dac samples. The tone is fitted within
+ * 10ms long windows so that the slow changes of the agc gain do not count as
+ * the distortion */
+static double TestNB_SINAD(const int32_t *x, int num)
+{
+    /* window length */
+    const int len = BB_SAMPLING_RATE / 100;
+    /* tone power and the total power */
+    double tone = 0, total = 0;
+
+    /* process all windows */
+    for (int b = 0; b + len <= num; b += len) {
+        /* mean, correlations with the tone and the power */
+        double mean = 0, c = 0, s = 0, p = 0;
+        /* remove the dc */
+        for (int n = b; n < b + len; n++)
+            mean += x[n];
+        mean /= len;
+        /* correlate */
+        for (int n = b; n < b + len; n++) {
+            double w = 2 * M_PI * 1000 * n / BB_SAMPLING_RATE;
+            c += (x[n] - mean) * cos(w), s += (x[n] - mean) * sin(w);
+            p += (x[n] - mean) * (x[n] - mean);
+        }
+        /* accumulate */
+        tone += 2 * (c * c + s * s) / len, total += p;
+    }
+
+    /* tone power vs the rest */
+    return 10 * log10(tone / (total - tone));
+}
+
+/* run the receiver on the station with (or without) the impulses, returns
+ * the sinad of the audio */
+static int TestNB_Receiver(int impulses, float threshold, double *sinad)
+{
+    /* station */
+    static test_am_t station = { .fc = 225000, .fm = 1000, .depth = 0.5,
+        .amp = 10 };
+    /* number of samples per rf event */
+    const int rf_num = HostRFIn_GetHalfSize();
+    const int bb_num = rf_num / DEC_DECIMATION_RATE;
+    /* number of frames: a second, the last quarter of it gets analyzed (agc
+     * needs to settle) */
+    const int frames = RF_SAMPLING_FREQ / rf_num;
+    /* data buffers */
+    int16_t rf[rf_num]; int32_t out[bb_num * 2];
+    static int32_t audio[BB_SAMPLING_RATE / 4];
+    /* sample counter for the impulse generator */
+    long n = 0;
+    int audio_num = 0;
+
+    /* apply the threshold */
+    test_check(Mix1_SetBlanker(threshold) == EOK, "threshold");
+    /* process the frames */
+    for (int f = 0; f < frames; f++) {
+        TestNB_Gen(&station, rf, rf_num, &n, impulses ? 12345 : -1);
+        test_check(HostRFIn_Feed(rf, rf_num) == EOK, "feed");
+        HostUSBAudioSrc_GetSamples(out, bb_num);
+        int num = HostSAI1A_Drain(out, bb_num);
+        /* collect the last quarter */
+        for (int k = 0; f >= frames * 3 / 4 && k < num; k++)
+            audio[audio_num++] = out[k];
+    }
+
+    /* compute the sinad */
+    *sinad = TestNB_SINAD(audio, audio_num);
+    /* report status */
+    return EOK;
+}
+
+/* run the test */
+int TestNB_Run(void)
+{
+    /* station in the noise for the unit part */
+    test_am_t station = { .fc = 225000, .fm = 1000, .depth = 0.5,
+        .amp = 200 };
+    /* data buffers */
+    static int16_t ALIGNED(4) rf[FRAME_SIZE], i[FRAME_SIZE], q[FRAME_SIZE];
+    static int16_t ALIGNED(4) i_ref[FRAME_SIZE], q_ref[FRAME_SIZE];
+    /* blanked samples counters */
+    uint32_t b0, b1;
+    /* sinad values */
+    double clean, noisy, blanked;
+    /* blanker off and on execution times */
+    float t_off, t_on;
+    /* sample counter for the impulse generator */
+    long n = 0;
+
+    /* threshold limits */
+    test_check(Mix1_SetBlanker(-1) == EFATAL &&
+        Mix1_SetBlanker(MIX1_NB_MAX_THRESHOLD + 1) == EFATAL, "threshold");
+    Mix1_SetLOFrequency(225000);
+
+    /* let the average settle, no impulses: nothing gets blanked */
+    test_check(Mix1_SetBlanker(MIX1_NB_THRESHOLD) == EOK, "threshold");
+    Mix1_GetBlanker(0, &b0);
+    for (int f = 0; f < 500; f++) {
+        TestNB_Gen(&station, rf, FRAME_SIZE, &n, -1);
+        Mix1_Mix(rf, FRAME_SIZE, i, q);
+        Mix1_MixRef(rf, FRAME_SIZE, i_ref, q_ref);
+    }
+    Mix1_GetBlanker(0, &b1);
+    test_check(b1 == b0, "blanked = %u", b1 - b0);
+
+    /* cost of the blanker on the impulse-free signal (the last frame is 
+     * mixed over and over, the average stays where it has settled) */
+    t_off = TestNB_Bench(0, rf, i, q);
+    t_on = TestNB_Bench(MIX1_NB_THRESHOLD, rf, i, q);
+    printf("  blanker off: %.1f cycles/frame, on: %.1f cycles/frame\n",
+        t_off, t_on);
+    /* blanker only compares the block peak with the threshold */
+    test_check(t_on <= t_off * 1.25f, "off = %.1f, on = %.1f", t_off, t_on);
+    /* still nothing gets blanked */
+    Mix1_GetBlanker(0, &b0);
+    test_check(b0 == b1, "blanked = %u", b0 - b1);
+
+    /* kernels must agree on the data with the impulses */
+    Mix1_GetBlanker(0, &b0);
+    for (int f = 0; f < 100; f++) {
+        TestNB_Gen(&station, rf, FRAME_SIZE, &n, 777);
+        Mix1_Mix(rf, FRAME_SIZE, i, q);
+        Mix1_MixRef(rf, FRAME_SIZE, i_ref, q_ref);
+        for (int k = 0; k < FRAME_SIZE; k++)
+            test_check(i[k] == i_ref[k] && q[k] == q_ref[k], "f = %d, k = %d",
+                f, k);
+    }
+    Mix1_GetBlanker(0, &b1);
+    test_check(b1 > b0, "blanked = %u", b1 - b0);
+
+    /* impulses (the reference kernel is used without the blanker from now
+     * on): in the middle of the block, at the block start (blanking
+     * reaches the previous block), at the block end (blanking continues in
+     * the next one), at the frame end (blanking continues in the next frame)
+     * and at the frame start (blanking cannot reach the previous frame) */
+    const int ats[] = { 1001, BLOCK_SIZE * 5, BLOCK_SIZE * 3 - 1,
+        FRAME_SIZE - elems(impulse), -1, 0, 2, -1 };
+    for (int k = 0, carry = 0; k < (int)elems(ats); k++)
+        if (TestNB_Frame(&station, ats[k], &carry) != EOK)
+            return EFATAL;
+
+    /* whole receiver */
+    test_check(TestHost_StartRadio(225000) == EOK, "start");
+    Radio_SetMode(RADIO_MODE_AM);
+    test_check(TestNB_Receiver(0, MIX1_NB_THRESHOLD, &clean) == EOK, "rx");
+    test_check(TestNB_Receiver(1, 0, &noisy) == EOK, "rx");
+    test_check(TestNB_Receiver(1, MIX1_NB_THRESHOLD, &blanked) == EOK, "rx");
+    printf("  sinad: clean = %.1f dB, impulses = %.1f dB, blanked = %.1f dB\n",
+        clean, noisy, blanked);
+    /* impulses must hurt and the blanker must bring the quality back */
+    test_check(noisy < clean - 10, "sinad = %.1f", noisy);
+    test_check(blanked > clean - 5, "sinad = %.1f", blanked);
+
+    /* restore the default */
+    Mix1_SetBlanker(MIX1_NB_THRESHOLD);
+    /* report status */
+    return EOK;
+}
@@ -0,0 +1,199 @@
+/**
+ * @file notch.c
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Host test: adaptive notch. Whistle on top of the noise-like audio
+ * must be removed while the audio itself passes (delayed) almost untouched,
+ * the whistle that changes its pitch must be found again quickly. Whole
+ * receiver with the heterodyne of the adjacent station must lose the whistle
+ * once the notch gets enabled.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "config.h"
+#include "err.h"
+#include "host/host.h"
+#include "host/test/notch.h"
+#include "host/test/test.h"
+#include "radio/notch.h"
+#include "radio/radio.h"
+
+/* baseband samples per rf frame */
+#define BLOCK_SIZE                      96
+
+/* audio generator: lowpass filtered noise and the whistle */
+typedef struct test_audio {
+    /* whistle frequency [Hz] and amplitude, noise rms */
+    double f, amp, rms;
+    /* whistle phase, noise filter state */
+    double ph, lp;
+} test_audio_t;
+
+/* measurements */
+typedef struct test_res {
+    /* whistle amplitude at the output (correlation), power of the audio and
+     * of the difference between the output and the delayed audio */
+    double wi, wq, audio, diff;
+    /* number of samples */
+    long n;
+} test_res_t;
+
+/* feed 'seconds' worth of the audio through the notch, measure the last
+ * 'tail' seconds */
+static void TestNotch_Feed(test_audio_t *a, double seconds, double tail,
+    test_res_t *res)
+{
+    /* audio without the whistle (delayed the same way the notch does it) */
+    static float clean[NOTCH_DELAY + BLOCK_SIZE];
+    /* block of data */
+    float x[BLOCK_SIZE];
+    /* number of blocks */
+    long blocks = seconds * BB_SAMPLING_RATE / BLOCK_SIZE;
+
+    /* nothing measured yet */
+    *res = (test_res_t) { 0 };
+    /* generate and process */
+    for (long b = 0; b < blocks; b++) {
+        for (int k = 0; k < BLOCK_SIZE; k++) {
+            /* white noise of the unit power through the one pole lowpass
+             * (about 2.5kHz wide) */
+            double w = (rand() / (double)RAND_MAX - 0.5) * sqrt(12);
+            a->lp += 0.3 * (w - a->lp);
+            /* phase of the whistle */
+            a->ph += 2 * M_PI * a->f / BB_SAMPLING_RATE;
+            /* store both */
+            clean[NOTCH_DELAY + k] = a->lp * a->rms / sqrt(0.3 / 1.7);
+            x[k] = clean[NOTCH_DELAY + k] + a->amp * cos(a->ph);
+        }
+        Notch_Process(x, BLOCK_SIZE, x);
+        /* measure at the end */
+        if (b >= blocks - tail * BB_SAMPLING_RATE / BLOCK_SIZE) {
+            for (int k = 0; k < BLOCK_SIZE; k++, res->n++) {
+                /* phase of the whistle at the output */
+                double ph = a->ph - 2 * M_PI * a->f *
+                    (BLOCK_SIZE + NOTCH_DELAY - k) / BB_SAMPLING_RATE;
+                res->wi += x[k] * cos(ph), res->wq += x[k] * sin(ph);
+                res->audio += clean[k] * clean[k];
+                res->diff += (x[k] - clean[k]) * (x[k] - clean[k]);
+            }
+        }
+        /* keep the samples that are still within the delay */
+        for (int k = 0; k < NOTCH_DELAY; k++)
+            clean[k] = clean[BLOCK_SIZE + k];
+    }
+
+    /* whistle amplitude */
+    res->wi *= 2.0 / res->n, res->wq *= 2.0 / res->n;
+}
+
+/* whistle suppression in dB */
+static double TestNotch_Suppression(const test_audio_t *a,
+    const test_res_t *res)
+{
+    return 20 * log10(a->amp / hypot(res->wi, res->wq));
+}
+
+/* audio distortion (power of the difference between the output and the
+ * delayed audio without the whistle) relative to the audio in dB */
+static double TestNotch_Distortion(const test_res_t *res)
+{
+    return 10 * log10(res->diff / res->audio);
+}
+
+/* run the whole receiver on the station and its neighbour that is 1.7kHz
+ * away, returns the amplitude of the whistle (relative to the full scale) in
+ * the dac samples of the last 100ms */
+static int TestNotch_Receiver(float *whistle)
+{
+    /* station and its neighbour */
+    static test_am_t station = { .fc = 225000, .fm = 400, .amp = 1000,
+        .depth = 0.5 };
+    static test_am_t neighbour = { .fc = 226700, .fm = 400, .amp = 300 };
+    /* number of samples per rf event */
+    const int rf_num = HostRFIn_GetHalfSize();
+    const int bb_num = rf_num / DEC_DECIMATION_RATE;
+    /* data buffers */
+    int16_t rf[rf_num], nb[rf_num]; int32_t out[bb_num * 2];
+    /* whistle correlation */
+    double wi = 0, wq = 0; long n = 0;
+
+    /* 1s of data */
+    for (int f = 0; f < 500; f++) {
+        TestHost_GenAM(&station, rf, rf_num);
+        TestHost_GenAM(&neighbour, nb, rf_num);
+        for (int k = 0; k < rf_num; k++)
+            rf[k] += nb[k];
+        test_check(HostRFIn_Feed(rf, rf_num) == EOK, "feed");
+        HostUSBAudioSrc_GetSamples(out, bb_num);
+        HostSAI1A_Drain(out, bb_num);
+        /* dac samples use 24 bits */
+        for (int k = 0; f >= 450 && k < bb_num; k++, n++) {
+            double ph = 2 * M_PI * 1700.0 * n / BB_SAMPLING_RATE;
+            wi += out[k] / 8388608.0 * cos(ph);
+            wq += out[k] / 8388608.0 * sin(ph);
+        }
+    }
+    /* whistle amplitude */
+    *whistle = hypot(wi, wq) * 2 / n;
+
+    /* report status */
+    return EOK;
+}
+
+/* run the test */
+int TestNotch_Run(void)
+{
+    /* audio with the whistle 10dB above it */
+    test_audio_t a = { .f = 1700, .amp = sqrt(2) * 0.1 * sqrt(10),
+        .rms = 0.1 };
+    /* measurements */
+    test_res_t res;
+    /* whistle levels at the receiver output */
+    float off, on;
+
+    /* audio alone passes untouched */
+    Notch_Reset();
+    a.amp = 0, TestNotch_Feed(&a, 2, 1, &res);
+    printf("  audio alone: distortion = %.1f dB\n",
+        TestNotch_Distortion(&res));
+    test_check(TestNotch_Distortion(&res) < -25, "distortion");
+
+    /* whistle gets removed, the audio stays except for the part that falls
+     * within the notch (about NOTCH_SAMPLING_RATE / NOTCH_TAPS wide) */
+    a.amp = sqrt(2) * 0.1 * sqrt(10), TestNotch_Feed(&a, 2, 1, &res);
+    printf("  %.0f Hz whistle: suppression = %.1f dB, distortion = "
+        "%.1f dB\n", a.f, TestNotch_Suppression(&a, &res),
+        TestNotch_Distortion(&res));
+    test_check(TestNotch_Suppression(&a, &res) > 30, "suppression");
+    test_check(TestNotch_Distortion(&res) < -12, "distortion");
+
+    /* whistle changes the pitch: found again within 200ms */
+    a.f = 900, TestNotch_Feed(&a, 0.2, 0.05, &res);
+    printf("  %.0f Hz whistle after 200 ms: suppression = %.1f dB\n", a.f,
+        TestNotch_Suppression(&a, &res));
+    test_check(TestNotch_Suppression(&a, &res) > 20, "tracking");
+    /* high pitch, where the droop equalizer matters the most */
+    a.f = 2500, TestNotch_Feed(&a, 2, 1, &res);
+    printf("  %.0f Hz whistle: suppression = %.1f dB\n", a.f,
+        TestNotch_Suppression(&a, &res));
+    test_check(TestNotch_Suppression(&a, &res) > 25, "suppression");
+
+    /* whole receiver: heterodyne with the notch disabled and enabled */
+    test_check(TestHost_StartRadio(225000) == EOK, "start");
+    test_check(Radio_SetNotch(0) == EOK, "notch");
+    test_check(TestNotch_Receiver(&off) == EOK, "rx");
+    test_check(Radio_SetNotch(1) == EOK, "notch");
+    test_check(TestNotch_Receiver(&on) == EOK, "rx");
+    test_check(Radio_SetNotch(0) == EOK, "notch");
+    printf("  receiver: whistle off = %.1f dB, on = %.1f dB\n",
+        20 * log10(off), 20 * log10(on));
+    test_check(20 * log10(off / on) > 20, "receiver");
+
+    /* report status */
+    return EOK;
+}
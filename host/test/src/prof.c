@@ -0,0 +1,211 @@
+/**
+ * @file prof.c
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Host test: execution time profiler and the stage cycle budgets of
+ * the radio receiver. Cycles are emulated with the monotonic clock (see
+ * host/dev/cyccnt.h) so the budgets are the upper limits for the host and
+ * catch regressions (e.g. a stage that suddenly takes a multiple of its usual
+ * time) rather than tell how the target behaves. The machine may get busy
+ * with something else in the middle of the measurement, so the one that does
+ * not fit the budgets gets repeated. The headroom accounting is checked with
+ * the fake clock, where every frame takes exactly the same number of cycles.
+ */
+
+#include <stdio.h>
+
+#include "config.h"
+#include "err.h"
+#include "host/host.h"
+#include "host/test/prof.h"
+#include "host/test/test.h"
+#include "radio/radio.h"
+#include "radio/rfcap.h"
+#include "sys/prof.h"
+#include "util/elems.h"
+
+/* average cycle budgets for the stages. these are host 'cycles' (see above)
+ * with a generous margin so that the machine to machine differences do not
+ * matter */
+static const struct {
+    int stage; uint32_t cycles;
+} budgets[] = {
+    { RADIO_PROF_MIX1, 2000 }, { RADIO_PROF_DEC, 8000 },
+    { RADIO_PROF_MIX2, 1000 }, { RADIO_PROF_FILTER, 1000 },
+    { RADIO_PROF_DEMOD, 500 }, { RADIO_PROF_AGC, 500 },
+    { RADIO_PROF_DAC_FIXP, 500 }, { RADIO_PROF_SAT, 500 },
+    { RADIO_PROF_METER, 500 }, { RADIO_PROF_NOTCH, 500 },
+    { RADIO_PROF_ASRC, 1000 }, { RADIO_PROF_RFCAP, 4000 },
+    { RADIO_PROF_IQNTF, 500 },
+    { RADIO_PROF_TOTAL, 15000 },
+};
+
+/* number of attempts to fit the budgets */
+#define BUDGET_ATTEMPTS                 3
+/* fake clock steps: frame fits, every frame overruns */
+#define FAKE_STEP                       100
+#define FAKE_STEP_OVERRUN               UINT16_MAX
+
+/* check the statistics on the known data set */
+static int TestProf_Stats(void)
+{
+    /* profiler */
+    prof_t p; prof_stats_t s;
+
+    /* nothing gathered yet */
+    Prof_Reset(&p); Prof_GetStats(&p, &s);
+    test_check(s.cnt == 0 && s.max == 0, "cnt = %u", s.cnt);
+
+    /* uniform distribution */
+    for (int i = 1; i <= 1000; i++)
+        Prof_Update(&p, i);
+    Prof_GetStats(&p, &s);
+    /* exact values */
+    test_check(s.min == 1 && s.max == 1000 && s.avg == 500 && s.cnt == 1000,
+        "min = %u, max = %u, avg = %u", s.min, s.max, s.avg);
+    /* p99 is given with the bin resolution (never underestimated) */
+    test_check(s.p99 >= 990 && s.p99 <= 1000, "p99 = %u", s.p99);
+
+    /* small values have exact bins, outliers must not affect p99 */
+    Prof_Reset(&p);
+    for (int i = 0; i < 1000; i++)
+        Prof_Update(&p, i % 100 == 0 ? 100000 : 5);
+    Prof_GetStats(&p, &s);
+    test_check(s.p99 == 5 && s.max == 100000, "p99 = %u", s.p99);
+
+    /* histogram saturation must preserve the proportions */
+    Prof_Reset(&p);
+    for (int i = 0; i < 200000; i++)
+        Prof_Update(&p, i % 10 == 0 ? 2000 : 100);
+    Prof_GetStats(&p, &s);
+    test_check(s.p99 >= 2000 && s.p99 < 2000 * 9 / 8, "p99 = %u", s.p99);
+    /* values beyond the histogram range */
+    Prof_Update(&p, UINT32_MAX); Prof_GetStats(&p, &s);
+    test_check(s.max == UINT32_MAX, "max = %u", s.max);
+
+    /* report status */
+    return EOK;
+}
+
+/* measure the processing stages, tells whether all fit their budgets */
+static int TestProf_Measure(test_am_t *am, int *fits)
+{
+    /* statistics */
+    prof_stats_t s; const char *name;
+
+    /* gather the statistics */
+    Radio_ResetProfile();
+    test_check(TestHost_RunAM(am, 1000) == EOK, "processing error");
+
+    /* check all stages */
+    *fits = 1;
+    for (int i = 0; i < (int)elems(budgets); i++) {
+        /* get the stage statistics */
+        Radio_GetProfile(budgets[i].stage, &name, &s);
+        /* show the results */
+        printf("  %-10s min = %7u, avg = %7u, max = %7u, p99 = %7u\n", name,
+            s.min, s.avg, s.max, s.p99);
+        /* all frames must be accounted for */
+        test_check(s.cnt == 1000, "%s: cnt = %u", name, s.cnt);
+        /* check against the budget */
+        if (s.avg > budgets[i].cycles) {
+            printf("  %s: avg = %u exceeds the budget of %u\n", name, s.avg,
+                budgets[i].cycles);
+            *fits = 0;
+        }
+    }
+
+    /* report status */
+    return EOK;
+}
+
+/* check the headroom accounting with the fake clock that advances by 'step'
+ * cycles with every read, 'overrun' tells whether the frames are expected
+ * to overrun */
+static int TestProf_Headroom(test_am_t *am, uint32_t step, uint32_t frame,
+    int overrun)
+{
+    /* statistics */
+    prof_stats_t s, total; const char *name;
+
+    /* gather the statistics */
+    HostCycCnt_SetStep(step);
+    Radio_ResetProfile();
+    int rc = TestHost_RunAM(am, 100);
+    HostCycCnt_SetStep(0);
+    test_check(rc == EOK, "processing error");
+
+    /* headroom is what is left from the frame */
+    Radio_GetProfile(RADIO_PROF_TOTAL, &name, &total);
+    Radio_GetProfile(RADIO_PROF_HEADROOM, &name, &s);
+    printf("  %-10s min = %7u, avg = %7u, max = %7u (total = %u..%u, "
+        "step = %u)\n", name, s.min, s.avg, s.max, total.min, total.max, step);
+    test_check(s.cnt == 100 && total.cnt == 100, "cnt = %u, %u", s.cnt,
+        total.cnt);
+    test_check(overrun ? total.min >= frame : total.max < frame,
+        "total = %u..%u", total.min, total.max);
+    /* overruns are reported as no headroom at all */
+    if (overrun) {
+        test_check(s.max == 0, "%s: max = %u, total min = %u", name, s.max,
+            total.min);
+    /* every frame: headroom and the processing add up to the frame */
+    } else {
+        test_check(s.min + total.max == frame &&
+            s.max + total.min == frame && s.avg + total.avg == frame,
+            "%s: %u..%u, total %u..%u", name, s.min, s.max, total.min,
+            total.max);
+    }
+
+    /* report status */
+    return EOK;
+}
+
+/* check the receiver processing stages against the budgets */
+static int TestProf_Budgets(void)
+{
+    /* am broadcast at 225kHz */
+    test_am_t am = { .fc = 225000, .fm = 1000, .amp = 1000, .depth = 0.5f };
+    /* all stages fit their budgets */
+    int fits = 0;
+
+    /* start the receiver with all the optional stages enabled */
+    test_check(TestHost_StartRadio(am.fc) == EOK, "unable to tune");
+    test_check(Radio_SetNotch(1) == EOK, "unable to enable the notch");
+    test_check(RFCap_SetFormat(RFCAP_FMT_U8, 4) == EOK, 
+        "unable to enable the rf capture");
+    /* cycle budget of a single frame */
+    const uint32_t frame = CPUCLOCK_FREQ / RF_SAMPLING_FREQ *
+        HostRFIn_GetHalfSize();
+    /* let the filters settle */
+    test_check(TestHost_RunAM(&am, 100) == EOK, "processing error");
+
+    /* measure until everything fits (or the attempts run out) */
+    for (int k = 0; k < BUDGET_ATTEMPTS && !fits; k++)
+        test_check(TestProf_Measure(&am, &fits) == EOK, "measurement");
+    test_check(fits, "budgets exceeded in all %d attempts", BUDGET_ATTEMPTS);
+
+    /* headroom accounting: frames that fit, frames that overrun */
+    test_check(TestProf_Headroom(&am, FAKE_STEP, frame, 0) == EOK, "headroom");
+    test_check(TestProf_Headroom(&am, FAKE_STEP_OVERRUN, frame, 1) == EOK,
+        "overrun");
+
+    /* back to the defaults */
+    test_check(Radio_SetNotch(0) == EOK, "unable to disable the notch");
+    test_check(RFCap_SetFormat(RFCAP_FMT_OFF, 1) == EOK, 
+        "unable to disable the rf capture");
+
+    /* report status */
+    return EOK;
+}
+
+/* run the test */
+int TestProf_Run(void)
+{
+    /* run the sub-tests */
+    if (TestProf_Stats() != EOK || TestProf_Budgets() != EOK)
+        return EFATAL;
+    /* report status */
+    return EOK;
+}
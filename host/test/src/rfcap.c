@@ -0,0 +1,309 @@
+/**
+ * @file rfcap.c
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Host test: raw rf capture over the usb bulk endpoint. With the bus
+ * that keeps up the samples must make it through as they were (16-bit) or
+ * within the mu-law quantization step (8-bit), the half-band decimators must
+ * be flat in the passband and reject what aliases onto it. With the bus that
+ * moves what full speed bulk transfers do, the 8-bit stream decimated by 4
+ * must go through with no losses while the undecimated 16-bit one must lose
+ * blocks in the way the headers tell about: every gap in the sequence numbers
+ * is covered by the dropped block counter. Throughput reported by the device
+ * must match what the bus has carried.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "config.h"
+#include "err.h"
+#include "host/host.h"
+#include "host/test/rfcap.h"
+#include "host/test/test.h"
+#include "radio/rfcap.h"
+#include "util/elems.h"
+#include "util/minmax.h"
+
+/* bus budget that never runs out, full speed bulk throughput [bytes/s] */
+#define BUS_UNLIMITED                   1000000000
+#define BUS_FS                          1000000
+/* frames for the sample checks, frames for the throughput checks (the
+ * throughput gets measured over RFCAP_RATE_BLOCKS blocks) */
+#define SAMPLE_FRAMES                   20
+#define RATE_FRAMES                     (RFCAP_RATE_BLOCKS + 20)
+
+/* stream reader: stream buffer (at least one largest block) and the amount
+ * of data within it */
+static uint8_t buf[2 * (sizeof(rfcap_hdr_t) + 2 * RFCAP_BLOCK_SIZE)];
+static int buf_num;
+/* previous header, number of blocks, blocks missing, torn blocks */
+static rfcap_hdr_t prev;
+static long blocks, missing, torn;
+/* bytes read */
+static long bytes;
+/* samples fed, samples unpacked */
+static int16_t fed[SAMPLE_FRAMES * RFCAP_BLOCK_SIZE];
+static int16_t got[SAMPLE_FRAMES * RFCAP_BLOCK_SIZE];
+static long fed_num, got_num;
+
+/* parse the blocks gathered so far */
+static int TestRFCap_Parse(void)
+{
+    /* offset within the buffer */
+    int offs = 0;
+
+    /* process all complete blocks */
+    while (buf_num - offs >= (int)sizeof(rfcap_hdr_t)) {
+        /* validate the header */
+        rfcap_hdr_t hdr; memcpy(&hdr, buf + offs, sizeof(hdr));
+        int size = RFCap_GetPayloadSize(&hdr);
+        test_check(size >= 0, "header at %ld", bytes - buf_num + offs);
+        /* payload is not complete */
+        if (buf_num - offs < (int)sizeof(hdr) + size)
+            break;
+
+        /* unpack the samples (as long as there is room for them) */
+        int16_t samples[RFCAP_BLOCK_SIZE];
+        int num = RFCap_Unpack(&hdr, buf + offs + sizeof(hdr), samples);
+        test_check(num == RFCAP_BLOCK_SIZE / hdr.dec, "num = %d", num);
+        memcpy(got + got_num, samples, min(num, (int)elems(got) - 
+            (int)got_num) * sizeof(*got));
+        got_num = min(got_num + num, (long)elems(got));
+        offs += sizeof(hdr) + size;
+
+        /* the capture starts with the first block */
+        if (!blocks) {
+            test_check(hdr.seq == 0 && hdr.dropped == 0 && hdr.torn == 0,
+                "seq = %u, dropped = %u", hdr.seq, hdr.dropped);
+        /* gaps must be covered by the dropped block counter */
+        } else {
+            long gap = hdr.seq - prev.seq - 1;
+            test_check(gap >= 0 && (long)(hdr.dropped - prev.dropped) == gap,
+                "seq %u after %u, dropped %u after %u", hdr.seq, prev.seq,
+                hdr.dropped, prev.dropped);
+            missing += gap, torn += (uint16_t)(hdr.torn - prev.torn);
+        }
+        /* update the statistics */
+        blocks++, prev = hdr;
+    }
+
+    /* move the leftover to the beginning of the buffer */
+    memmove(buf, buf + offs, buf_num - offs), buf_num -= offs;
+    /* report status */
+    return EOK;
+}
+
+/* read the stream as the usb host would do with given budget */
+static int TestRFCap_Read(int budget)
+{
+    /* read until the budget runs out or there is nothing more to read */
+    for (int n = 1; budget > 0 && n; budget -= n) {
+        n = HostUSBRFCap_Read(buf + buf_num, min(budget, (int)sizeof(buf) -
+            buf_num));
+        buf_num += n, bytes += n;
+        test_check(TestRFCap_Parse() == EOK, "parse");
+    }
+    /* report status */
+    return EOK;
+}
+
+/* start the capture with the clean reader state */
+static int TestRFCap_Start(int format, int dec)
+{
+    /* stop the capture, let it take effect and take whatever was left */
+    test_check(RFCap_SetFormat(RFCAP_FMT_OFF, 1) == EOK, "off");
+    int16_t rf[RFCAP_BLOCK_SIZE] = { 0 };
+    test_check(HostRFIn_Feed(rf, elems(rf)) == EOK, "feed");
+    while (HostUSBRFCap_Read(buf, sizeof(buf)));
+
+    /* reset the reader */
+    buf_num = 0, blocks = missing = torn = bytes = 0;
+    fed_num = got_num = 0;
+    /* start over */
+    test_check(RFCap_SetFormat(format, dec) == EOK, "format");
+    /* report status */
+    return EOK;
+}
+
+/* feed the frames, read the stream with given bus throughput after every 
+ * one, tone (if 'amp' is non-zero) or random samples spanning the adc range 
+ * are fed */
+static int TestRFCap_Feed(int frames, int bus_rate, float fc, float amp)
+{
+    /* tone generator */
+    test_am_t tone = { .fc = fc, .amp = amp };
+    /* number of samples per rf event */
+    const int rf_num = HostRFIn_GetHalfSize();
+    /* data buffer */
+    int16_t rf[rf_num];
+    /* bus budget of a single frame */
+    const int budget = (long long)bus_rate * rf_num / RF_SAMPLING_FREQ;
+
+    /* process the frames */
+    for (int f = 0; f < frames; f++) {
+        /* generate the data */
+        if (amp) {
+            TestHost_GenAM(&tone, rf, rf_num);
+        } else {
+            for (int k = 0; k < rf_num; k++)
+                rf[k] = rand() % 4096 - 3070;
+        }
+        /* store what was fed */
+        memcpy(fed + fed_num, rf, min(rf_num, (int)elems(fed) - 
+            (int)fed_num) * sizeof(*fed));
+        fed_num = min(fed_num + rf_num, (long)elems(fed));
+        /* let the receiver do it's job, read the stream */
+        test_check(HostRFIn_Feed(rf, rf_num) == EOK, "feed");
+        test_check(TestRFCap_Read(budget) == EOK, "read");
+    }
+
+    /* report status */
+    return EOK;
+}
+
+/* gain of the decimator for the tone at 'fc' [dB] */
+static double TestRFCap_Gain(int dec, float fc)
+{
+    /* tone amplitude */
+    const float amp = 1000;
+    /* output power */
+    double p = 0;
+
+    /* capture the tone */
+    if (TestRFCap_Start(RFCAP_FMT_S16, dec) != EOK ||
+        TestRFCap_Feed(SAMPLE_FRAMES, BUS_UNLIMITED, fc, amp) != EOK)
+        return NAN;
+    /* skip the first block (transient) */
+    for (long k = RFCAP_BLOCK_SIZE / dec; k < got_num; k++)
+        p += (double)got[k] * got[k];
+    /* relative to the power of the input tone */
+    return 10 * log10(p / (got_num - RFCAP_BLOCK_SIZE / dec) / 
+        (amp * amp / 2));
+}
+
+/* check the throughput limited capture */
+static int TestRFCap_Throughput(int format, int dec, int *lossless)
+{
+    /* statistics */
+    rfcap_stats_t s;
+
+    /* capture */
+    test_check(TestRFCap_Start(format, dec) == EOK, "start");
+    test_check(TestRFCap_Feed(RATE_FRAMES, BUS_FS, 0, 0) == EOK, "feed");
+    test_check(RFCap_GetStats(&s) == EOK, "stats");
+    printf("  %s/%d: blocks = %u, sent = %u, dropped = %u, torn = %u, "
+        "rate = %u B/s, read %ld blocks\n", format == RFCAP_FMT_S16 ? 
+        "s16" : "u8", dec, s.blocks, s.sent, s.dropped, s.torn, s.rate, 
+        blocks);
+
+    /* all blocks are accounted for: the ones read, the ones in flight or
+     * waiting and the dropped ones */
+    test_check(s.blocks == RATE_FRAMES && s.blocks - s.dropped - blocks <= 2,
+        "blocks = %u, dropped = %u", s.blocks, s.dropped);
+    /* reader sees what the device reports: blocks dropped before the last 
+     * one read are the ones missing, the ones after it were dropped or are 
+     * still on their way */
+    test_check(prev.dropped == missing && s.dropped - prev.dropped <= 
+        s.blocks - prev.seq - 1 && torn <= s.torn, "missing = %ld, "
+        "torn = %ld", missing, torn);
+    /* throughput matches the data read (over the whole capture) and does 
+     * not exceed what the bus can do */
+    double rate = (double)bytes * RF_SAMPLING_FREQ / 
+        (RATE_FRAMES * RFCAP_BLOCK_SIZE);
+    test_check(s.rate <= BUS_FS && fabs(s.rate - rate) < 0.05 * rate, 
+        "rate = %u vs %.0f", s.rate, rate);
+    /* no losses */
+    *lossless = s.dropped == 0 && s.torn == 0;
+
+    /* report status */
+    return EOK;
+}
+
+/* run the test */
+int TestRFCap_Run(void)
+{
+    /* statistics */
+    rfcap_stats_t s;
+    /* format, decimation rate */
+    int format, dec, lossless;
+
+    /* bring up the receiver, unsupported settings are refused */
+    test_check(TestHost_StartRadio(225000) == EOK, "start");
+    test_check(RFCap_SetFormat(3, 1) == EFATAL && 
+        RFCap_SetFormat(RFCAP_FMT_S16, 3) == EFATAL &&
+        RFCap_SetFormat(RFCAP_FMT_U8, 8) == EFATAL &&
+        RFCap_SetFormat(-1, 1) == EFATAL, "invalid formats");
+
+    /* mu-law codes: symmetrical and monotonic */
+    for (int c = 0; c < 256; c++) {
+        int16_t x = RFCap_MuLawDecode(c), y = RFCap_MuLawDecode(c ^ 0x80);
+        test_check(x == -y || x == -y - 1, "code 0x%02x: %d, %d", c, x, y);
+        test_check((c & 0x7f) == 0x7f || abs(x) > 
+            abs(RFCap_MuLawDecode(c + 1)), "code 0x%02x", c);
+    }
+
+    /* undecimated 16-bit samples go as they are */
+    test_check(TestRFCap_Start(RFCAP_FMT_S16, 1) == EOK, "start");
+    test_check(TestRFCap_Feed(SAMPLE_FRAMES, BUS_UNLIMITED, 0, 0) == EOK, 
+        "feed");
+    test_check(RFCap_GetFormat(&format, &dec) == EOK && 
+        format == RFCAP_FMT_S16 && dec == 1, "format");
+    test_check(blocks == SAMPLE_FRAMES && missing == 0 && torn == 0, 
+        "blocks = %ld, missing = %ld, torn = %ld", blocks, missing, torn);
+    test_check(got_num == fed_num && !memcmp(got, fed, sizeof(*got) * 
+        got_num), "s16 samples differ");
+
+    /* 8-bit codes: lossless for the small samples, within the half of the 
+     * quantization step for the others */
+    test_check(TestRFCap_Start(RFCAP_FMT_U8, 1) == EOK, "start");
+    test_check(TestRFCap_Feed(SAMPLE_FRAMES, BUS_UNLIMITED, 0, 0) == EOK, 
+        "feed");
+    test_check(blocks == SAMPLE_FRAMES && got_num == fed_num, "blocks");
+    int max_err = 0;
+    for (long k = 0; k < got_num; k++) {
+        int x = fed[k], err = abs(got[k] - x);
+        test_check(abs(x) >= 16 ? err <= abs(x) / 32 + 2 : err == 0, 
+            "sample %d: %d", x, got[k]);
+        max_err = max(max_err, err);
+    }
+    printf("  u8: max error = %d lsb\n", max_err);
+
+    /* decimators: flat passband, rejection of what aliases */
+    double pass2 = TestRFCap_Gain(2, 400000);
+    double stop2 = fmax(TestRFCap_Gain(2, 750000), 
+        TestRFCap_Gain(2, 1000000));
+    double pass4 = TestRFCap_Gain(4, 200000);
+    double stop4 = fmax(TestRFCap_Gain(4, 375000), 
+        TestRFCap_Gain(4, 750000));
+    printf("  dec 2: %.3f dB @ 400 kHz, %.1f dB @ 750 kHz..1 MHz\n", 
+        pass2, stop2);
+    printf("  dec 4: %.3f dB @ 200 kHz, %.1f dB @ 375 kHz, 750 kHz\n", 
+        pass4, stop4);
+    test_check(fabs(pass2) < 0.1 && fabs(pass4) < 0.1, "pass = %.3f, %.3f", 
+        pass2, pass4);
+    test_check(stop2 < -40 && stop4 < -40, "stop = %.1f, %.1f", stop2, 
+        stop4);
+
+    /* full speed bus: the 8-bit stream decimated by 4 fits, the undecimated 
+     * 16-bit one does not (blocks are dropped, the ones that were sent take 
+     * longer than the block period so they get torn) */
+    test_check(TestRFCap_Throughput(RFCAP_FMT_U8, 4, &lossless) == EOK, 
+        "u8/4");
+    test_check(lossless, "u8/4 losses");
+    test_check(TestRFCap_Throughput(RFCAP_FMT_S16, 1, &lossless) == EOK, 
+        "s16/1");
+    test_check(!lossless && torn > 0, "s16/1 without losses");
+
+    /* turn the capture off, no blocks come after it */
+    test_check(TestRFCap_Start(RFCAP_FMT_OFF, 1) == EOK, "off");
+    test_check(TestRFCap_Feed(2, BUS_UNLIMITED, 0, 0) == EOK, "feed");
+    test_check(RFCap_GetStats(&s) == EOK && bytes == 0, "bytes = %ld", 
+        bytes);
+    /* report status */
+    return EOK;
+}
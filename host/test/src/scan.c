@@ -0,0 +1,145 @@
+/**
+ * @file scan.c
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Host test: wideband scan. Handful of am stations with levels
+ * spanning 30dB is put through the whole receiver while the scan runs: every
+ * station must be found in the right channel with the right level, nothing
+ * else apart from the channels adjacent to the stations (and the ones where
+ * the decimator aliases the strongest stations to, BB_SAMPLING_RATE away, 70dB
+ * down) may be reported as occupied, the scan must finish within seconds and the receiver must get
+ * back to the frequency it was tuned to.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "config.h"
+#include "err.h"
+#include "host/host.h"
+#include "host/test/scan.h"
+#include "host/test/test.h"
+#include "radio/radio.h"
+#include "radio/scan.h"
+#include "radio/spectrum.h"
+#include "util/elems.h"
+
+/* frames per band */
+#define DWELL                           4
+/* time limit for the whole scan [s] */
+#define MAX_TIME                        5
+
+/* run the test */
+int TestScan_Run(void)
+{
+    /* stations: carrier frequency, modulating tone, amplitude, depth */
+    static test_am_t stations[] = {
+        { 153000, 1000, 2000, 0.5 }, { 225000, 700, 1000, 0.5 },
+        { 531000, 1500, 200, 0.3 }, { 999000, 400, 63, 0.5 },
+    };
+    /* spectrum line */
+    uint8_t bins[SPECTRUM_SIZE]; uint32_t seq;
+    /* scan status */
+    int running, bands, frames = 0;
+    /* channel parameters */
+    float frequency, level, snr, f;
+
+    /* bring up the radio */
+    test_check(TestHost_StartRadio(225000) == EOK, "start");
+    /* number of samples per rf event and the corresponding number of the
+     * baseband samples */
+    const int rf_num = HostRFIn_GetHalfSize();
+    const int bb_num = rf_num / DEC_DECIMATION_RATE;
+    /* data buffers */
+    int16_t rf[rf_num], st[rf_num]; int32_t out[bb_num * 2];
+    /* unsupported dwell */
+    test_check(Radio_Scan(SCAN_MAX_DWELL + 1) == EFATAL, "dwell");
+    /* start the scan */
+    test_check(Radio_Scan(DWELL) == EOK, "scan");
+
+    /* push the frames until the scan is done */
+    do {
+        /* sum of all stations */
+        for (int k = 0; k < rf_num; k++)
+            rf[k] = 0;
+        for (int s = 0; s < (int)elems(stations); s++) {
+            TestHost_GenAM(&stations[s], st, rf_num);
+            for (int k = 0; k < rf_num; k++)
+                rf[k] += st[k];
+        }
+        /* let the receiver do it's job */
+        test_check(HostRFIn_Feed(rf, rf_num) == EOK, "feed");
+        /* consume the outputs */
+        HostUSBAudioSrc_GetSamples(out, bb_num);
+        HostSAI1A_Drain(out, bb_num);
+        /* check the progress */
+        Scan_GetProgress(&running, &bands);
+    } while (running && ++frames < MAX_TIME * RF_SAMPLING_FREQ / rf_num);
+
+    /* show the results */
+    printf("  %d bands scanned in %.3f s\n", bands,
+        (double)frames * rf_num / RF_SAMPLING_FREQ);
+    test_check(!running && bands == SCAN_BANDS, "bands = %d", bands);
+
+    /* level of the first station (all levels are compared against it) */
+    float level0 = 0;
+    /* go through the table */
+    for (int c = 0; c < SCAN_CHANNELS; c++) {
+        test_check(Scan_GetChannel(c, &frequency, &level, &snr) == EOK,
+            "channel %d", c);
+        /* look for the station within the channel, next to it or at the
+         * decimator alias frequency */
+        int s, adjacent = 0;
+        for (s = 0; s < (int)elems(stations); s++) {
+            float d = fabsf(stations[s].fc - frequency);
+            if (d < SCAN_CHANNEL_WIDTH / 2)
+                break;
+            adjacent |= d < SCAN_CHANNEL_WIDTH * 3 / 2 ||
+                fabsf(d - BB_SAMPLING_RATE) < SCAN_CHANNEL_WIDTH / 2;
+        }
+
+        /* channel with the station */
+        if (s < (int)elems(stations)) {
+            /* carrier level, sidebands add to that */
+            double expected = 20 * log10(stations[s].amp / stations[0].amp) +
+                10 * log10((1 + stations[s].depth * stations[s].depth / 2) /
+                (1 + stations[0].depth * stations[0].depth / 2));
+            /* reference */
+            if (s == 0)
+                level0 = level;
+            printf("  %7.0f Hz: level = %6.1f dB, relative = %6.1f dB "
+                "(%6.1f dB), snr = %5.1f dB\n", frequency, level,
+                level - level0, expected, snr);
+            test_check(fabs(level - level0 - expected) < 1, "level");
+            test_check(snr >= SCAN_THRESHOLD, "snr");
+        /* free channels */
+        } else if (!adjacent) {
+            test_check(snr < SCAN_THRESHOLD, "%.0f Hz: snr = %.1f",
+                frequency, snr);
+        }
+    }
+    /* measurements outside of the table */
+    test_check(Scan_GetChannel(SCAN_CHANNELS, &frequency, &level, &snr) ==
+        EFATAL, "channel");
+
+    /* receiver is back at the frequency that was set: the station shows up
+     * at the center of the spectrum */
+    Radio_GetFrequency(&f);
+    test_check(f == 225000, "frequency = %.3f", f);
+    test_check(TestHost_RunAM(&stations[1], 100) == EOK, "run");
+    Spectrum_GetLine(&seq, bins);
+    level = SPECTRUM_DB_MIN + bins[SPECTRUM_SIZE / 2] * SPECTRUM_DB_STEP;
+    test_check(level > -40, "carrier level = %.1f", level);
+
+    /* re-tuning stops the scan */
+    test_check(Radio_Scan(DWELL) == EOK, "scan");
+    test_check(TestHost_StartRadio(225000) == EOK, "tune");
+    Scan_GetProgress(&running, &bands);
+    test_check(!running, "running");
+
+    /* report status */
+    return EOK;
+}
@@ -0,0 +1,147 @@
+/**
+ * @file sdec.c
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Host test: software decimators. For every supported rate checks the
+ * passband gain (with the cic droop compensated), the rejection of the
+ * signal that would alias onto the passband tone and the async api. The
+ * execution time is compared against the model of the DFSDM path.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "config.h"
+#include "err.h"
+#include "dev/cyccnt.h"
+#include "dev/dec.h"
+#include "host/test/sdec.h"
+#include "host/test/test.h"
+#include "radio/sdec.h"
+#include "sys/cb.h"
+#include "util/elems.h"
+
+/* number of input samples per frame (as in the receiver) */
+#define FRAME_SIZE                      4800
+/* number of frames to process, first ones are skipped as the filters settle */
+#define FRAMES                          20
+#define FRAMES_SKIPPED                  4
+/* input tone amplitude (half of the full scale) */
+#define AMPLITUDE                       0.5f
+
+/* number of callback calls and the number of samples reported */
+static int cb_calls, cb_num;
+
+/* decimation callback */
+static int TestSDec_Callback(void *ptr)
+{
+    /* callback argument */
+    sdec_cbarg_t *ca = ptr;
+    /* count the calls */
+    cb_calls++, cb_num = ca->num;
+    /* report status */
+    return EOK;
+}
+
+/* decimate complex tone of frequency 'f' (relative to the output sampling
+ * rate) and return the amplitude of the output tone at frequency 'f_out' */
+static int TestSDec_Tone(int rate, float f, float f_out, float *amp)
+{
+    /* input and output buffers */
+    static int16_t i[FRAME_SIZE], q[FRAME_SIZE];
+    static float i_out[FRAME_SIZE], q_out[FRAME_SIZE];
+    /* full scale */
+    const float fs = 1 << (DEC_MAX_INPUT_BITS - 1);
+    /* correlation sums */
+    double re = 0, im = 0; long n_in = 0, n_out = 0, cnt = 0;
+
+    /* set up the decimator */
+    test_check(SDec_Init(rate) == EOK, "rate = %d", rate);
+    /* process frames */
+    for (int frame = 0; frame < FRAMES; frame++) {
+        /* generate the tone */
+        for (int k = 0; k < FRAME_SIZE; k++, n_in++) {
+            double ph = 2 * M_PI * f * n_in / rate;
+            i[k] = lrint(AMPLITUDE * fs * cos(ph));
+            q[k] = lrint(AMPLITUDE * fs * sin(ph));
+        }
+        /* decimate using the async call */
+        cb_calls = 0;
+        SDec_Decimate(i, q, FRAME_SIZE, i_out, q_out, TestSDec_Callback);
+        test_check(cb_calls == 1 && cb_num == FRAME_SIZE / rate,
+            "calls = %d, num = %d", cb_calls, cb_num);
+        /* correlate with the expected output tone */
+        for (int k = 0; k < cb_num; k++, n_out++) {
+            /* skip the settling period */
+            if (frame < FRAMES_SKIPPED)
+                continue;
+            double ph = 2 * M_PI * f_out * n_out;
+            re += i_out[k] * cos(ph) + q_out[k] * sin(ph);
+            im += q_out[k] * cos(ph) - i_out[k] * sin(ph);
+            cnt++;
+        }
+    }
+
+    /* amplitude */
+    *amp = sqrt(re * re + im * im) / cnt;
+    /* report status */
+    return EOK;
+}
+
+/* run the test */
+int TestSDec_Run(void)
+{
+    /* supported rates */
+    static const int rates[] = { 25, 50, 100, 200 };
+
+    /* unsupported rates: cic rate too low, cic gain too high */
+    test_check(SDec_Init(3) == EFATAL, "rate = 3");
+    test_check(SDec_Init(4 * 65) == EFATAL, "rate = 260");
+
+    /* check all supported rates */
+    for (int k = 0; k < (int)elems(rates); k++) {
+        /* passband tone, tone that aliases onto it after decimation */
+        float amp_pass, amp_alias, amp_edge;
+        /* passband */
+        if (TestSDec_Tone(rates[k], 0.05f, 0.05f, &amp_pass) != EOK ||
+            TestSDec_Tone(rates[k], 0.2f, 0.2f, &amp_edge) != EOK ||
+            TestSDec_Tone(rates[k], 1.05f, 0.05f, &amp_alias) != EOK)
+            return EFATAL;
+
+        /* convert to decibels relative to the input */
+        float pass = 20 * log10f(amp_pass / AMPLITUDE);
+        float edge = 20 * log10f(amp_edge / AMPLITUDE);
+        float alias = 20 * log10f(amp_alias / AMPLITUDE);
+        printf("  rate %3d: gain @ 0.05 fs: %+.2f dB, @ 0.2 fs: %+.2f dB, "
+            "alias rejection: %.1f dB\n", rates[k], pass, edge, alias);
+        /* droop must be compensated, aliases must be suppressed */
+        test_check(fabsf(pass) < 0.1f && fabsf(edge) < 0.5f && alias < -60,
+            "rate = %d", rates[k]);
+    }
+
+    /* compare the execution time against the DFSDM model */
+    static int16_t i[FRAME_SIZE], q[FRAME_SIZE];
+    static float i_out[FRAME_SIZE], q_out[FRAME_SIZE];
+    static int32_t i_q31[FRAME_SIZE], q_q31[FRAME_SIZE];
+    uint32_t ts, t_sw = 0, t_hw = 0;
+    /* random input */
+    for (int k = 0; k < FRAME_SIZE; k++)
+        i[k] = rand() % 8192 - 4096, q[k] = rand() % 8192 - 4096;
+    /* same rate as the receiver */
+    test_check(SDec_Init(DEC_DECIMATION_RATE) == EOK, "rate");
+    for (int frame = 0; frame < FRAMES; frame++) {
+        ts = CycCnt_GetValue();
+        SDec_Decimate(i, q, FRAME_SIZE, i_out, q_out, CB_SYNC);
+        t_sw += CycCnt_GetValue() - ts, ts = CycCnt_GetValue();
+        Dec_Decimate(i, q, FRAME_SIZE, i_q31, q_q31, CB_SYNC);
+        t_hw += CycCnt_GetValue() - ts;
+    }
+    printf("  rate %3d: software: %u cycles/frame, dfsdm model: %u "
+        "cycles/frame\n", DEC_DECIMATION_RATE, t_sw / FRAMES, t_hw / FRAMES);
+
+    /* report status */
+    return EOK;
+}
@@ -0,0 +1,116 @@
+/**
+ * @file spectrum.c
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Host test: spectrum engine. Complex tone fed in the rf callback
+ * sized portions must show up at the right bin with the right level, the
+ * mirror image and the distant bins must stay at the floor, the lines must be
+ * produced at the configured rate.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "config.h"
+#include "err.h"
+#include "host/test/spectrum.h"
+#include "host/test/test.h"
+#include "radio/spectrum.h"
+
+/* baseband samples per rf frame */
+#define BLOCK_SIZE                      96
+/* tone frequency (at the bin center, bin 0 being the tuned frequency) and
+ * the level */
+#define TONE_BIN                        16
+#define TONE_FREQ                       \
+    ((double)BB_SAMPLING_RATE * TONE_BIN / SPECTRUM_SIZE)
+#define TONE_DB                         -20.0
+
+/* feed 'seconds' worth of the tone at frequency 'f' */
+static void TestSpectrum_Feed(double f, double seconds)
+{
+    /* block of data */
+    float i[BLOCK_SIZE], q[BLOCK_SIZE];
+    /* phase is kept between the calls */
+    static long n;
+    /* amplitude */
+    double a = pow(10, TONE_DB / 20);
+
+    /* generate and feed */
+    for (long b = 0; b < seconds * BB_SAMPLING_RATE / BLOCK_SIZE; b++) {
+        for (int k = 0; k < BLOCK_SIZE; k++, n++) {
+            i[k] = a * cos(2 * M_PI * f * n / BB_SAMPLING_RATE);
+            q[k] = a * sin(2 * M_PI * f * n / BB_SAMPLING_RATE);
+        }
+        Spectrum_PutSamples(i, q, BLOCK_SIZE);
+    }
+}
+
+/* run the test */
+int TestSpectrum_Run(void)
+{
+    /* spectrum line */
+    uint8_t bins[SPECTRUM_SIZE];
+    /* line sequence numbers */
+    uint32_t seq0, seq1;
+    /* settings */
+    int rate, average;
+
+    /* initialize */
+    test_check(Spectrum_Init() == EOK, "init");
+    test_check(Spectrum_GetRate(&rate, &average) == EOK &&
+        rate == SPECTRUM_RATE && average == SPECTRUM_AVERAGE, "rate");
+    /* captures that would not fit within the stream */
+    test_check(Spectrum_SetRate(100, 4) == EFATAL &&
+        Spectrum_SetRate(10, 0) == EFATAL, "rate");
+
+    /* one second worth of the tone above the tuned frequency */
+    Spectrum_GetLine(&seq0, 0);
+    TestSpectrum_Feed(TONE_FREQ, 1);
+    Spectrum_GetLine(&seq1, bins);
+    /* number of lines must match the rate */
+    test_check(abs((int)(seq1 - seq0) - SPECTRUM_RATE) <= 1,
+        "lines = %d", (int)(seq1 - seq0));
+
+    /* expected bin (negative frequencies go first) */
+    int k = SPECTRUM_SIZE / 2 + TONE_BIN;
+    /* level of the tone, its mirror image and the strongest of the distant
+     * bins */
+    float tone = SPECTRUM_DB_MIN + bins[k] * SPECTRUM_DB_STEP;
+    float image = SPECTRUM_DB_MIN + bins[SPECTRUM_SIZE - k] * SPECTRUM_DB_STEP;
+    float other = SPECTRUM_DB_MIN;
+    for (int m = 0; m < SPECTRUM_SIZE; m++)
+        if (abs(m - k) > 8)
+            other = fmaxf(other, SPECTRUM_DB_MIN + bins[m] * SPECTRUM_DB_STEP);
+    /* show the results */
+    printf("  lines = %d, tone @ bin %d: %.1f dB, image: %.1f dB, "
+        "other bins: %.1f dB\n", (int)(seq1 - seq0), k, tone, image, other);
+    /* check */
+    test_check(fabs(tone - TONE_DB) < 0.5, "tone = %.1f", tone);
+    test_check(image < TONE_DB - 80, "image = %.1f", image);
+    test_check(other < TONE_DB - 60, "other = %.1f", other);
+
+    /* disabled engine does not produce lines */
+    test_check(Spectrum_SetRate(0, 1) == EOK, "rate");
+    Spectrum_GetLine(&seq0, 0);
+    TestSpectrum_Feed(TONE_FREQ, 0.5);
+    Spectrum_GetLine(&seq1, 0);
+    test_check(seq0 == seq1, "lines = %d", (int)(seq1 - seq0));
+
+    /* highest possible rate: back to back captures, no averaging */
+    rate = BB_SAMPLING_RATE / SPECTRUM_SIZE;
+    test_check(Spectrum_SetRate(rate, 1) == EOK, "rate");
+    Spectrum_GetLine(&seq0, 0);
+    TestSpectrum_Feed(TONE_FREQ, 1);
+    Spectrum_GetLine(&seq1, 0);
+    test_check(abs((int)(seq1 - seq0) - rate) <= 1, "lines = %d",
+        (int)(seq1 - seq0));
+
+    /* restore the defaults */
+    Spectrum_SetRate(SPECTRUM_RATE, SPECTRUM_AVERAGE);
+    /* report status */
+    return EOK;
+}
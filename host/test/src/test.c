@@ -0,0 +1,86 @@
+/**
+ * @file test.c
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Host (Linux) regression tests: common helpers
+ */
+
+#include <math.h>
+#include <stdlib.h>
+
+#include "config.h"
+#include "err.h"
+#include "dev/cs43l22.h"
+#include "dev/dec.h"
+#include "dev/display.h"
+#include "dev/rfin.h"
+#include "dev/sai1a.h"
+#include "dev/usb_audiosrc.h"
+#include "host/host.h"
+#include "host/test/test.h"
+#include "radio/radio.h"
+
+/* generate the am signal */
+void TestHost_GenAM(test_am_t *am, int16_t *out, int num)
+{
+    /* angular frequencies per sample */
+    double wc = 2 * M_PI * am->fc / RF_SAMPLING_FREQ;
+    double wm = 2 * M_PI * am->fm / RF_SAMPLING_FREQ;
+
+    /* generate the samples */
+    for (int k = 0; k < num; k++, am->n++) {
+        /* modulating signal */
+        double m = 1 + am->depth * cos(wm * am->n);
+        /* pseudo-random dither, so that the adc lsb gets exercised */
+        double d = (rand() / (double)RAND_MAX - 0.5) * 4;
+        /* modulated carrier */
+        out[k] = lrint(am->amp * m * cos(wc * am->n) + d);
+    }
+}
+
+/* bring up the radio */
+int TestHost_StartRadio(float f)
+{
+    /* initialization flag */
+    static int initialized;
+
+    /* bring up the 'drivers' in the same order as the target does */
+    if (!initialized) {
+        RFIn_Init(); Dec_Init(); SAI1A_Init(); USBAudioSrc_Init();
+        Display_Init(); CS43L22_Init();
+        /* initialize the radio receiver logic */
+        Radio_Init(); initialized = 1;
+    }
+
+    /* tune */
+    return Radio_SetFrequency(f);
+}
+
+/* push the frames through the receiver */
+int TestHost_RunAM(test_am_t *am, int frames)
+{
+    /* number of samples per rf event */
+    const int rf_num = HostRFIn_GetHalfSize();
+    const int bb_num = rf_num / DEC_DECIMATION_RATE;
+    /* data buffers */
+    int16_t rf[rf_num]; int32_t out[bb_num * 2]; uint8_t cap[4 * rf_num];
+    /* status */
+    int rc = EOK;
+
+    /* process the frames */
+    for (int i = 0; i < frames && rc == EOK; i++) {
+        /* generate the data */
+        TestHost_GenAM(am, rf, rf_num);
+        /* let the receiver do it's job */
+        rc = HostRFIn_Feed(rf, rf_num);
+        /* consume the outputs */
+        HostUSBAudioSrc_GetSamples(out, bb_num);
+        HostSAI1A_Drain(out, bb_num);
+        while (HostUSBRFCap_Read(cap, sizeof(cap)));
+    }
+
+    /* report status */
+    return rc;
+}
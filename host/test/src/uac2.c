@@ -0,0 +1,275 @@
+/**
+ * @file uac2.c
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Host test: usb audio class 2.0 streaming. The configuration 
+ * descriptor is walked and checked for consistency (lengths, entity links, 
+ * packet sizes of all the formats, fifo memory budget). The pacing is driven 
+ * by the simulated producer that delivers the samples in 2ms blocks from the 
+ * adc clock which is off the usb frame clock: packets must keep the nominal 
+ * size (+-1 sample), carry the true rate on average and the fill level 
+ * (latency) must stay put. Packing of the samples and the clock source 
+ * range response are checked byte by byte.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "config.h"
+#include "err.h"
+#include "dev/usb_audiosrc.h"
+#include "dev/usb_audiostream.h"
+#include "dev/usbdesc.h"
+#include "host/test/test.h"
+#include "host/test/uac2.h"
+#include "util/elems.h"
+#include "util/minmax.h"
+
+/* usb full speed: max isochronous packet size, fifo memory size in words */
+#define FS_MAX_ISO_SIZE                 1023
+#define FS_FIFO_WORDS                   320
+/* length of the pacing simulation in frames */
+#define PACE_FRAMES                     20000
+
+/* fifo size in words as it is set up by the drivers */
+static int TestUAC2_FifoWords(int bytes)
+{
+    /* fifo sizes have the lower limit */
+    return max(16, bytes / 4);
+}
+
+/* walk the configuration descriptor */
+static int TestUAC2_Descriptor(void)
+{
+    /* descriptor and its size */
+    const uint8_t *d = usb_config_descriptors[0];
+    int total = d[2] | d[3] << 8;
+    /* current interface, alternate setting and the sample size */
+    int iface = -1, alt = 0, subslot = 0;
+    /* interface presence mask, class specific ac descriptors size */
+    int ifaces = 0, ac_total = 0, ac_len = 0;
+    /* entity links, number of streaming formats */
+    int clock_id = -1, it_clock = -1, ot_clock = -1, formats = 0;
+
+    /* go through all the descriptors */
+    for (int offs = 0; offs < total; offs += d[offs]) {
+        /* current descriptor */
+        const uint8_t *p = d + offs;
+        test_check(p[0] >= 2 && offs + p[0] <= total, "length at %d", offs);
+
+        /* standard interface descriptor */
+        if (p[1] == 0x04) {
+            iface = p[2], alt = p[3], ifaces |= 1 << iface;
+        /* audio control: header, clock source, terminals */
+        } else if (p[1] == 0x24 && iface == 0) {
+            /* header gives the size of all of them */
+            if (p[2] == 0x01)
+                ac_total = p[6] | p[7] << 8;
+            if (p[2] == 0x0A)
+                clock_id = p[3];
+            if (p[2] == 0x02)
+                it_clock = p[7];
+            if (p[2] == 0x03)
+                ot_clock = p[8];
+            ac_len += p[0];
+        /* audio streaming: format type */
+        } else if (p[1] == 0x24 && iface == 1 && p[2] == 0x02) {
+            subslot = p[4];
+            test_check(p[5] == 8 * subslot, "resolution of alt %d", alt);
+            /* alternate settings follow the mode numbers */
+            test_check(subslot == alt + 1, "subslot of alt %d", alt);
+        /* audio streaming endpoint */
+        } else if (p[1] == 0x05 && iface == 1) {
+            /* packet size and the one needed for the highest rate */
+            int size = p[4] | p[5] << 8;
+            int rate = subslot == 2 ? USB_AUDIO_SRC_MAX_RATE_16 : 
+                USB_AUDIO_SRC_MAX_RATE_32;
+            /* isochronous asynchronous */
+            test_check(p[3] == 0x05, "attributes of alt %d", alt);
+            test_check(size >= (rate / 1000 + 1) * 2 * subslot && 
+                size <= USB_AUDIO_SRC_MAX_TFER_SIZE && 
+                size <= FS_MAX_ISO_SIZE, "packet size of alt %d", alt);
+            printf("  alt %d: %2d-bit, up to %6d Hz, %3d bytes per packet\n",
+                alt, 8 * subslot, rate, size);
+            formats++;
+        }
+    }
+
+    /* all the interfaces are there */
+    test_check(ifaces == (1 << usb_interfaces_num) - 1 && 
+        d[4] == usb_interfaces_num, "interfaces 0x%x", ifaces);
+    /* audio control size */
+    test_check(ac_total == ac_len, "ac size %d vs %d", ac_total, ac_len);
+    /* terminals are clocked from the clock source */
+    test_check(clock_id == USB_AUDIO_SRC_CLOCK_ID && it_clock == clock_id && 
+        ot_clock == clock_id, "clock links");
+    /* 16, 24 and 32 bit formats */
+    test_check(formats == USB_AUDIO_SRC_MODE_S32, "formats %d", formats);
+
+    /* fifo memory: reception, control, audio, vcp interrupt and bulk, rf 
+     * capture bulk */
+    int words = USB_RX_FIFO_SIZE / 4 + TestUAC2_FifoWords(USB_CTRLEP_SIZE) + 
+        TestUAC2_FifoWords(USB_AUDIO_SRC_MAX_TFER_SIZE) + 
+        TestUAC2_FifoWords(USB_VCP_INT_SIZE) + 
+        TestUAC2_FifoWords(USB_VCP_TX_SIZE) + 
+        TestUAC2_FifoWords(USB_RFCAP_TX_SIZE);
+    printf("  descriptor: %d bytes, fifo memory: %d of %d words\n", total, 
+        words, FS_FIFO_WORDS);
+    test_check(words <= FS_FIFO_WORDS, "fifo memory");
+
+    /* report status */
+    return EOK;
+}
+
+/* drive the pacing with the producer that runs 'ppm' off the usb frame 
+ * clock, report the average rate and the fill level range (in frames) */
+static int TestUAC2_Pacing(uint32_t rate, int bytes, double ppm, 
+    double *avg, double *fill_min, double *fill_max)
+{
+    /* pacing */
+    usb_audio_pace_t pace;
+    /* samples produced and sent, producer clock in usb frames */
+    long produced = 0, sent = 0, sent_half = 0;
+    double t = 0, acc = 0;
+    /* max samples per packet (as in the descriptor), fill level to be kept */
+    int max_num = USB_AUDIO_SRC_PACKET_SIZE(bytes == 2 ? 
+        USB_AUDIO_SRC_MAX_RATE_16 : USB_AUDIO_SRC_MAX_RATE_32, bytes) / 
+        (2 * bytes);
+    int target = rate * USB_AUDIO_SRC_LATENCY / USB_AUDIO_SRC_FRAME_RATE;
+
+    test_check(USBAudioStream_PaceInit(&pace, rate, target, max_num) == EOK,
+        "init");
+    *fill_min = 1e9, *fill_max = -1e9;
+
+    /* go frame by frame */
+    for (int f = 0; f < PACE_FRAMES; f++) {
+        /* producer delivers every 2ms of its own time */
+        for (; t <= f; t += 2 / (1 + ppm * 1e-6)) {
+            acc += rate * 2.0 / USB_AUDIO_SRC_FRAME_RATE;
+            produced += (long)acc, acc -= (long)acc;
+        }
+        /* average is taken over the second half */
+        if (f == PACE_FRAMES / 2)
+            sent_half = sent;
+        /* packet size */
+        int fill = produced - sent;
+        int num = USBAudioStream_Pace(&pace, fill);
+        sent += num;
+        test_check(num <= max_num, "packet size");
+        /* once settled */
+        if (f >= PACE_FRAMES / 4) {
+            /* packets differ from the nominal size by a sample at most */
+            test_check(fabs(num - rate / 1000.0) < 1 + 1e-9, 
+                "packet of %d samples in frame %d", num, f);
+            /* fill level that the packet was taken from */
+            *fill_min = min(*fill_min, (double)fill);
+            *fill_max = max(*fill_max, (double)fill);
+        }
+    }
+
+    /* no gaps in the stream */
+    test_check(pace.underruns == 0, "%u underruns", pace.underruns);
+    /* results */
+    *avg = (sent - sent_half) * 1000.0 / (PACE_FRAMES / 2);
+    *fill_min *= 1000.0 / rate, *fill_max *= 1000.0 / rate;
+
+    /* report status */
+    return EOK;
+}
+
+/* check the packing */
+static int TestUAC2_Pack(void)
+{
+    /* one pair of samples */
+    const int32_t lr[2] = { 0x12345678, -2 };
+    /* expected results for 16, 24 and 32 bits */
+    const uint8_t ref[3][8] = {
+        { 0x34, 0x12, 0xff, 0xff },
+        { 0x56, 0x34, 0x12, 0xff, 0xff, 0xff },
+        { 0x78, 0x56, 0x34, 0x12, 0xfe, 0xff, 0xff, 0xff },
+    };
+    /* output */
+    uint8_t out[8];
+
+    /* all the widths */
+    for (int bytes = 2; bytes <= 4; bytes++) {
+        test_check(USBAudioStream_Pack(lr, 1, bytes, out) == 2 * bytes, 
+            "size");
+        for (int k = 0; k < 2 * bytes; k++)
+            test_check(out[k] == ref[bytes - 2][k], "%d bytes, byte %d", 
+                bytes, k);
+    }
+
+    /* report status */
+    return EOK;
+}
+
+/* check the sampling frequency range response */
+static int TestUAC2_Range(void)
+{
+    /* rates */
+    const uint32_t rates[] = { 96000, 48000 };
+    /* expected response */
+    const uint8_t ref[26] = { 
+        0x02, 0x00,
+        0x00, 0x77, 0x01, 0x00, 0x00, 0x77, 0x01, 0x00, 0, 0, 0, 0,
+        0x80, 0xbb, 0x00, 0x00, 0x80, 0xbb, 0x00, 0x00, 0, 0, 0, 0,
+    };
+    /* output */
+    uint8_t out[32];
+
+    /* whole response */
+    test_check(USBAudioStream_FreqRange(rates, 2, out, sizeof(out)) == 26, 
+        "size");
+    for (int k = 0; k < 26; k++)
+        test_check(out[k] == ref[k], "byte %d", k);
+    /* host asks for the number of subranges first */
+    test_check(USBAudioStream_FreqRange(rates, 2, out, 2) == 2 && 
+        out[0] == 2, "truncated");
+
+    /* report status */
+    return EOK;
+}
+
+/* run the test */
+int TestUAC2_Run(void)
+{
+    /* sampling rates (44.1k has a fractional number of samples per frame) 
+     * with the sample sizes and the clock offsets */
+    const struct { uint32_t rate; int bytes; } cfgs[] = {
+        { 48000, 4 }, { 96000, 3 }, { 96000, 4 }, { 192000, 2 }, 
+        { 44100, 2 },
+    };
+    const double ppms[] = { 0, 300, -300 };
+    /* results */
+    double avg, fill_min, fill_max;
+
+    /* descriptors */
+    test_check(TestUAC2_Descriptor() == EOK, "descriptor");
+    /* pacing */
+    for (int i = 0; i < (int)elems(cfgs); i++) {
+        for (int j = 0; j < (int)elems(ppms); j++) {
+            test_check(TestUAC2_Pacing(cfgs[i].rate, cfgs[i].bytes, ppms[j],
+                &avg, &fill_min, &fill_max) == EOK, "pacing");
+            printf("  %6u Hz, %d bytes, adc at %+4.0f ppm: %.2f Hz, "
+                "latency %.2f - %.2f ms\n", cfgs[i].rate, cfgs[i].bytes, 
+                ppms[j], avg, fill_min, fill_max);
+            /* true rate is carried */
+            test_check(fabs(avg / (cfgs[i].rate * (1 + ppms[j] * 1e-6)) - 1) 
+                < 20e-6, "average rate");
+            /* latency stays around the target, the producer delivers 2ms 
+             * blocks */
+            test_check(fill_min > USB_AUDIO_SRC_LATENCY - 2 && 
+                fill_max < USB_AUDIO_SRC_LATENCY + 2, "latency");
+        }
+    }
+    /* packing and control requests */
+    test_check(TestUAC2_Pack() == EOK, "pack");
+    test_check(TestUAC2_Range() == EOK, "range");
+
+    /* report status */
+    return EOK;
+}
@@ -0,0 +1,71 @@
+/**
+ * @file test.h
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Host (Linux) regression tests: common helpers
+ */
+
+#ifndef HOST_TEST_TEST_H
+#define HOST_TEST_TEST_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include "err.h"
+
+/** @brief check the condition, print the message and fail the test if it is
+ * not met */
+#define test_check(cond, ...)                                               \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            fprintf(stderr, "%s:%d: check failed: %s: ", __FILE__,         \
+                __LINE__, #cond);                                           \
+            fprintf(stderr, __VA_ARGS__); fprintf(stderr, "\n");            \
+            return EFATAL;                                                  \
+        }                                                                   \
+    } while (0)
+
+/** @brief synthetic am signal generator */
+typedef struct test_am {
+    /* carrier and modulating tone frequencies [Hz] */
+    float fc, fm;
+    /* carrier amplitude [adc lsb] and modulation depth [0..1] */
+    float amp, depth;
+    /* sample counter */
+    uint32_t n;
+} test_am_t;
+
+/**
+ * @brief Generate the am modulated signal the way the adc would see it
+ * (already offset-compensated)
+ *
+ * @param am generator state
+ * @param out output buffer
+ * @param num number of samples to generate
+ */
+void TestHost_GenAM(test_am_t *am, int16_t *out, int num);
+
+/**
+ * @brief Bring up the radio (just once per process, consecutive calls only
+ * re-tune the receiver)
+ *
+ * @param f frequency to tune to
+ *
+ * @return int status
+ */
+int TestHost_StartRadio(float f);
+
+/**
+ * @brief Push given number of rf frames from the generator through the
+ * receiver, discarding the outputs
+ *
+ * @param am signal generator
+ * @param frames number of rf frames (rf callbacks)
+ *
+ * @return int status
+ */
+int TestHost_RunAM(test_am_t *am, int frames);
+
+#endif /* HOST_TEST_TEST_H */
@@ -0,0 +1,20 @@
+/**
+ * @file uac2.h
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Host test: usb audio class 2.0 descriptors and pacing
+ */
+
+#ifndef HOST_TEST_UAC2_H
+#define HOST_TEST_UAC2_H
+
+/**
+ * @brief Run the test
+ *
+ * @return int status (EOK if passed)
+ */
+int TestUAC2_Run(void);
+
+#endif /* HOST_TEST_UAC2_H */
@@ -12,6 +12,7 @@
 #include "dev/await.h"
 #include "dev/cpuclock.h"
 #include "dev/cs43l22.h"
+#include "dev/cyccnt.h"
 #include "dev/dec.h"
 #include "dev/display.h"
 #include "dev/extimux.h"
@@ -30,6 +31,7 @@
 #include "dev/usbcore.h"
 #include "dev/usbdesc.h"
 #include "dev/usb_audiosrc.h"
+#include "dev/usb_rfcap.h"
 #include "dev/usb_vcp.h"
 #include "dev/watchdog.h"
 #include "radio/radio.h"
@@ -87,6 +89,8 @@ void Main(void)
     Invoke_Init();
     /* time measurement */
     TimeMeas_Init();
+    /* cpu cycle counter */
+    CycCnt_Init();
     /* exti mux */
     ExtiMux_Init();
     /* async awaiter */
@@ -109,6 +113,8 @@ void Main(void)
     USBAudioSrc_Init();
 	/* initialize vcp */
 	USBVCP_Init();
+    /* initialize raw rf capture */
+    USBRFCap_Init();
 
     /* externals */
     /* led */
@@ -143,6 +149,8 @@ void Main(void)
 
 	/* execution loop */
     while (1) {
+        /* poll the at protocol */
+        AT_Poll();
         /* poll idle modes */
         Idle_Poll();
 	}
@@ -0,0 +1,94 @@
+/**
+ * @file agc.h
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Automatic gain control of the demodulated audio: peak detector with
+ * the hang and decay times, gain smoothed with the attack time and the
+ * look-ahead delay line so that the gain is already reduced when the peak
+ * reaches the output.
+ */
+
+#ifndef RADIO_AGC_H
+#define RADIO_AGC_H
+
+#include "config.h"
+
+/** @brief maximal attack, hang and decay time in seconds */
+#define AGC_MAX_TIME                                    10
+/** @brief maximal gain in dB */
+#define AGC_MAX_GAIN                                    120
+
+/** @brief agc settings */
+typedef struct agc_cfg {
+    /* attack time: time constant of the gain reduction [s], no overshoot
+     * when it is below 1/4 of the look-ahead */
+    float attack;
+    /* hang time: detected peak is held for that long [s] */
+    float hang;
+    /* decay time: time constant of the peak detector decay [s] */
+    float decay;
+    /* maximal gain (the one used for the silence) [dB] */
+    float max_gain;
+} agc_cfg_t;
+
+/**
+ * @brief Initialize the agc, the gain starts at the maximum
+ *
+ * @param cfg initial settings
+ *
+ * @return int status (EFATAL for invalid settings)
+ */
+int AGC_Init(const agc_cfg_t *cfg);
+
+/**
+ * @brief Check the settings without applying them
+ *
+ * @param cfg settings (times: 0 - AGC_MAX_TIME, max gain: 0 - AGC_MAX_GAIN)
+ *
+ * @return int status (EFATAL for invalid settings)
+ */
+int AGC_CheckConfig(const agc_cfg_t *cfg);
+
+/**
+ * @brief Change the settings, the detector state is kept. May be called from
+ * within the rf callback and from outside of it.
+ *
+ * @param cfg settings (see AGC_CheckConfig())
+ *
+ * @return int status (EFATAL for invalid settings)
+ */
+int AGC_SetConfig(const agc_cfg_t *cfg);
+
+/**
+ * @brief Reset the detector (e.g. after re-tuning), the gain goes back to
+ * the maximum and is brought down by the first peak that enters the
+ * look-ahead. To be called from within the rf callback.
+ */
+void AGC_Reset(void);
+
+/**
+ * @brief Process the audio: delay it by AGC_LOOKAHEAD samples, apply the agc
+ * gain and the volume. Peaks are brought to AGC_TARGET * volume. May be done
+ * in situ.
+ *
+ * @param in input samples
+ * @param num number of samples
+ * @param volume output scaling applied on top of the agc gain
+ * @param out output samples
+ */
+void AGC_Process(const float *in, int num, float volume, float *out);
+
+/**
+ * @brief Get the agc state as of the end of the last processed block
+ *
+ * @param gain place to put the gain to (linear, may be NULL)
+ * @param level place to put the detected peak level of the input (relative
+ * to the full scale, linear, may be NULL)
+ *
+ * @return int status
+ */
+int AGC_GetStatus(float *gain, float *level);
+
+#endif /* RADIO_AGC_H */
@@ -0,0 +1,50 @@
+/**
+ * @file chan.h
+ * 
+ * @date 2026-10-17
+ * @author twatorowski 
+ * 
+ * @brief Polyphase FFT filter-bank channelizer: splits the complex (1st 
+ * stage mixer output) or real (raw rf) data into equally spaced channels, 
+ * all of them decimated by the number of channels.
+ */
+
+#ifndef RADIO_CHAN_H
+#define RADIO_CHAN_H
+
+#include <stdint.h>
+
+/**
+ * @brief Initialize the channelizer: design the prototype filter and reset 
+ * the delay lines.
+ * 
+ * @param channels number of channels (power of 2, no more than 
+ * CHAN_MAX_CHANNELS)
+ * 
+ * @return int status (EFATAL for unsupported number of channels)
+ */
+int Chan_Init(int channels);
+
+/**
+ * @brief Push the samples through the channelizer. Every 'channels' input 
+ * samples produce one output sample for every channel. Channel k is 
+ * centered at k * fs / channels (channels above the half of the number 
+ * of channels are the negative frequencies). Outputs are stored as 
+ * consecutive vectors (one per output sample time) of 'channels' complex 
+ * numbers, int16 full scale corresponds to 1.0.
+ * 
+ * @param i in-phase (or real) input data
+ * @param q quadrature input data, NULL for the real input
+ * @param num number of input samples (any, the incomplete vector is 
+ * carried over to the next call)
+ * @param re real parts of the output, room for at least 
+ * (num / channels + 1) * channels values
+ * @param im imaginary parts of the output, room for at least 
+ * (num / channels + 1) * channels values
+ * 
+ * @return int number of the output vectors produced
+ */
+int Chan_Process(const int16_t *i, const int16_t *q, int num, float *re, 
+    float *im);
+
+#endif /* RADIO_CHAN_H */
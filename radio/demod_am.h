@@ -10,6 +10,12 @@
 #ifndef RADIO_DEMOD_AM_H
 #define RADIO_DEMOD_AM_H
 
+/**
+ * @brief Reset the input filters and the dc removal filter (so that the dc 
+ * offset of the previous station does not show up as the transient after the 
+ * re-tuning)
+ */
+void DemodAM_Reset(void);
 
 /**
  * @brief Apply filtration before AM demodulation
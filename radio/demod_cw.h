@@ -0,0 +1,89 @@
+/**
+ * @file demod_cw.h
+ * 
+ * @date 2026-10-17
+ * @author twatorowski 
+ * 
+ * @brief CW Demodulation: narrow channel filter at the reduced sampling rate, 
+ * beat frequency oscillator and the bank of goertzel detectors that produce 
+ * the keying envelope.
+ */
+
+#ifndef RADIO_DEMOD_CW_H
+#define RADIO_DEMOD_CW_H
+
+#include "config.h"
+
+/** @brief decimation rate of the internal processing */
+#define DEMODCW_DECIMATION_RATE                         8
+/** @brief internal sampling rate */
+#define DEMODCW_SAMPLING_RATE                           \
+    (BB_SAMPLING_RATE / DEMODCW_DECIMATION_RATE)
+/** @brief minimal bfo pitch in Hz */
+#define DEMODCW_MIN_PITCH                               200
+/** @brief maximal bfo pitch in Hz */
+#define DEMODCW_MAX_PITCH                               1500
+/** @brief number of goertzel detectors */
+#define DEMODCW_GOERTZEL_BINS                           9
+/** @brief spacing of the goertzel detectors in Hz */
+#define DEMODCW_GOERTZEL_SPACING                        50
+/** @brief goertzel block length (in samples at the internal rate) */
+#define DEMODCW_GOERTZEL_SIZE                           48
+
+/**
+ * @brief Reset the filters, the oscillator and the envelope detector
+ */
+void DemodCW_Reset(void);
+
+/**
+ * @brief Set the pitch of the beat frequency oscillator, i.e. the audio 
+ * frequency that the signal at the center of the channel is converted to.
+ * 
+ * @param hz pitch in Hz (DEMODCW_MIN_PITCH - DEMODCW_MAX_PITCH)
+ * 
+ * @return int status (EFATAL for unsupported pitch)
+ */
+int DemodCW_SetPitch(float hz);
+
+/**
+ * @brief Decimate to the internal sampling rate and apply the channel filter
+ * 
+ * @param i input in-phase channel
+ * @param q input quadrature channel
+ * @param num number of samples to filter (multiple of the 
+ * DEMODCW_DECIMATION_RATE)
+ * @param i_out filtered in-phase channel (num / DEMODCW_DECIMATION_RATE 
+ * samples)
+ * @param q_out filtered quadrature channel (num / DEMODCW_DECIMATION_RATE 
+ * samples)
+ * 
+ * @return int number of the output samples
+ */
+int DemodCW_Filter(const float *i, const float *q, int num, float *i_out, 
+    float *q_out);
+
+/**
+ * @brief Demodulate the data produced by the DemodCW_Filter(): mix with the 
+ * bfo, run the goertzel detectors and interpolate back to the baseband 
+ * sampling rate.
+ * 
+ * @param i In-phase data
+ * @param q Quadrature data
+ * @param num number of samples (at the internal rate)
+ * @param out output data (num * DEMODCW_DECIMATION_RATE samples)
+ */
+void DemodCW_Demodulate(const float *i, const float *q, int num, float *out);
+
+/**
+ * @brief Read the keying envelope samples (one per goertzel block, amplitude 
+ * of the strongest detector). Envelope samples that are not read on time are 
+ * lost.
+ * 
+ * @param env place to put the envelope samples to
+ * @param num maximal number of samples to read
+ * 
+ * @return int number of samples read
+ */
+int DemodCW_ReadEnvelope(float *env, int num);
+
+#endif /* RADIO_DEMOD_CW_H */
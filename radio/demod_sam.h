@@ -0,0 +1,55 @@
+/**
+ * @file demod_sam.h
+ * 
+ * @date 2026-10-17
+ * @author twatorowski 
+ * 
+ * @brief Synchronous AM Demodulation: the pll locks to the carrier and the 
+ * signal is demodulated coherently.
+ */
+
+#ifndef RADIO_DEMOD_SAM_H
+#define RADIO_DEMOD_SAM_H
+
+/**
+ * @brief Reset the carrier pll (the oscillator frequency is set to 0Hz) and 
+ * the output filter.
+ */
+void DemodSAM_Reset(void);
+
+/**
+ * @brief Demodulate AM signal contained in the baseband I/Q data (filtered 
+ * with DemodAM_Filter()) using the pll that tracks the carrier.
+ * 
+ * @param i In-phase data
+ * @param q Quadrature data
+ * @param num number of samples
+ * @param out output data
+ */
+void DemodSAM_Demodulate(const float *i, const float *q, int num, float *out);
+
+/**
+ * @brief Returns the carrier lock status
+ * 
+ * @return int 1 if the pll is locked to the carrier, 0 otherwise
+ */
+int DemodSAM_IsLocked(void);
+
+/**
+ * @brief Returns the frequency of the pll oscillator, i.e. the offset of the 
+ * carrier from 0Hz.
+ * 
+ * @return float frequency in Hz
+ */
+float DemodSAM_GetFrequency(void);
+
+/**
+ * @brief Shift the pll oscillator frequency. Used when the part of the 
+ * carrier offset is compensated elsewhere (by the mixer), so that the loop 
+ * does not need to re-acquire it.
+ * 
+ * @param hz frequency shift in Hz
+ */
+void DemodSAM_ShiftFrequency(float hz);
+
+#endif /* RADIO_DEMOD_SAM_H */
@@ -0,0 +1,56 @@
+/**
+ * @file demod_ssb.h
+ * 
+ * @date 2026-10-17
+ * @author twatorowski 
+ * 
+ * @brief SSB Demodulation (Weaver method)
+ */
+
+#ifndef RADIO_DEMOD_SSB_H
+#define RADIO_DEMOD_SSB_H
+
+/** @name Sidebands */
+/** @{ */
+/** @brief upper sideband */
+#define DEMODSSB_USB                                    0
+/** @brief lower sideband */
+#define DEMODSSB_LSB                                    1
+/** @} */
+
+/**
+ * @brief Select the sideband and reset the filters.
+ * 
+ * @param sideband sideband (DEMODSSB_USB or DEMODSSB_LSB)
+ * 
+ * @return int status (EFATAL for unknown sideband)
+ */
+int DemodSSB_SetSideband(int sideband);
+
+/**
+ * @brief Apply the sideband selection filter: the center of the audio band 
+ * of the selected sideband is brought to dc and then the data is low-pass 
+ * filtered. Can be performed in-situ. Needs to be followed by the 
+ * DemodSSB_Demodulate() for the same block of data.
+ * 
+ * @param i input in-phase channel
+ * @param q input quadrature channel
+ * @param num number of samples to filter
+ * @param i_out filtered in-phase channel
+ * @param q_out filtered quadrature channel
+ */
+void DemodSSB_Filter(const float *i, const float *q, int num, float *i_out, 
+    float *q_out);
+
+/**
+ * @brief Demodulate the SSB signal filtered with DemodSSB_Filter(): the data 
+ * is brought back to the audio band and the real part is taken.
+ * 
+ * @param i In-phase data
+ * @param q Quadrature data
+ * @param num number of samples
+ * @param out output data
+ */
+void DemodSSB_Demodulate(const float *i, const float *q, int num, float *out);
+
+#endif /* RADIO_DEMOD_SSB_H */
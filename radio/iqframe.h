@@ -0,0 +1,104 @@
+/**
+ * @file iqframe.h
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Binary framing of the iq samples for the serial links: the header, 
+ * the block floating point samples (16 or 8-bit mantissas that share the 
+ * exponent) and the crc, all COBS encoded and put between two zero bytes. 
+ * Zeros never show up within the text lines nor within the encoded frames, 
+ * so the frames can be mixed with the AT responses and notifications on the 
+ * same link.
+ */
+
+#ifndef RADIO_IQFRAME_H
+#define RADIO_IQFRAME_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "compiler.h"
+#include "config.h"
+#include "cobs/cobs.h"
+
+/** @name Sample formats */
+/** @{ */
+/** @brief 16-bit mantissas */
+#define IQFRAME_FMT_S16                                 1
+/** @brief 8-bit mantissas */
+#define IQFRAME_FMT_S8                                  2
+/** @} */
+
+/** @brief frame delimiter (goes before and after the encoded frame) */
+#define IQFRAME_DELIM                                   0x00
+/** @brief size of the crc (CRC-16/CCITT-FALSE, little endian, follows the 
+ * samples) */
+#define IQFRAME_CRC_SIZE                                2
+
+/** @brief frame header (little endian), samples follow right after it as the 
+ * interleaved I/Q mantissas */
+typedef struct iqframe_hdr {
+    /**< sample format */
+    uint8_t format;
+    /**< block exponent: sample = mantissa * 2^exp (full scale is 1.0) */
+    int8_t exp;
+    /**< frame sequence number */
+    uint16_t seq;
+    /**< number of the iq pairs within the frame */
+    uint16_t num;
+    /**< number of the iq pairs that the device has dropped so far (buffer 
+     * overflows) */
+    uint32_t dropped;
+} PACKED iqframe_hdr_t;
+
+/** @brief size of the encoded frame (with the delimiters) for given number of 
+ * the payload bytes */
+#define IQFRAME_ENCODED_SIZE(payload)                   \
+    (COBS_ENCODED_SIZE(sizeof(iqframe_hdr_t) + (payload) +  \
+        IQFRAME_CRC_SIZE) + 2)
+
+/**
+ * @brief Get the maximal number of the iq pairs that fit within the encoded 
+ * frame of given size
+ *
+ * @param format sample format (IQFRAME_FMT_...)
+ * @param size encoded frame size (with the delimiters)
+ *
+ * @return int number of the iq pairs, EFATAL for unsupported format
+ */
+int IQFrame_GetMaxSamples(int format, size_t size);
+
+/**
+ * @brief Encode the iq samples into the frame (with the delimiters)
+ *
+ * @param format sample format (IQFRAME_FMT_...)
+ * @param seq frame sequence number
+ * @param dropped number of the iq pairs dropped so far
+ * @param iq interleaved I/Q samples
+ * @param num number of the iq pairs
+ * @param out output buffer
+ * @param size size of the output buffer (frames longer than 
+ * IQFRAME_MAX_SIZE are not supported)
+ *
+ * @return int size of the encoded frame, EFATAL if it does not fit
+ */
+int IQFrame_Encode(int format, uint16_t seq, uint32_t dropped, 
+    const float *iq, int num, void *out, size_t size);
+
+/**
+ * @brief Decode the frame: the data between the delimiters, can work in-situ 
+ * (the input gets destroyed then)
+ *
+ * @param in encoded frame (without the delimiters)
+ * @param in_size size of the encoded frame
+ * @param hdr frame header
+ * @param iq interleaved I/Q samples (room for in_size / 2 pairs is always 
+ * enough)
+ *
+ * @return int number of the iq pairs, EFATAL if the frame is malformed or 
+ * the crc does not match
+ */
+int IQFrame_Decode(void *in, size_t in_size, iqframe_hdr_t *hdr, float *iq);
+
+#endif /* RADIO_IQFRAME_H */
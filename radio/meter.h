@@ -0,0 +1,79 @@
+/**
+ * @file meter.h
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Signal meter and squelch: channel power and the noise floor
+ * measured on the decimated I/Q data (before the demodulation) with the
+ * windowed METER_SIZE point dft, squelch that tells whether the audio path
+ * needs to run at all.
+ */
+
+#ifndef RADIO_METER_H
+#define RADIO_METER_H
+
+#include "config.h"
+
+/** @brief maximal squelch threshold in dB */
+#define METER_MAX_SQUELCH                               60
+
+/**
+ * @brief Initialize the meter, squelch is disabled
+ *
+ * @return int status
+ */
+int Meter_Init(void);
+
+/**
+ * @brief Start the averaging anew (e.g. after re-tuning), the squelch
+ * settings and state are kept. To be called from within the rf callback.
+ */
+void Meter_Reset(void);
+
+/**
+ * @brief Measure the baseband samples (2nd stage mixer output, channel at
+ * dc) and update the squelch, to be called from within the rf callback.
+ *
+ * @param i in-phase samples
+ * @param q quadrature samples
+ * @param num number of samples (multiple of METER_SIZE)
+ *
+ * @return int 1 if the squelch is open (audio needs to be processed), 0
+ * otherwise
+ */
+int Meter_Process(const float *i, const float *q, int num);
+
+/**
+ * @brief Set the squelch threshold
+ *
+ * @param snr signal to noise ratio in dB at which the squelch opens (0 -
+ * squelch disabled, up to METER_MAX_SQUELCH)
+ *
+ * @return int status (EFATAL for unsupported threshold)
+ */
+int Meter_SetSquelch(float snr);
+
+/**
+ * @brief Get the squelch settings and state
+ *
+ * @param snr place to put the threshold to (in dB, may be NULL)
+ * @param open place to put the squelch state to (1 - open, may be NULL)
+ *
+ * @return int status
+ */
+int Meter_GetSquelch(float *snr, int *open);
+
+/**
+ * @brief Get the measurements
+ *
+ * @param rssi place to put the channel power to (in dB relative to the full
+ * scale complex tone)
+ * @param floor place to put the noise floor to (power of the noise in the
+ * channel-wide band, same reference as for the rssi)
+ *
+ * @return int status
+ */
+int Meter_GetLevels(float *rssi, float *floor);
+
+#endif /* RADIO_METER_H */
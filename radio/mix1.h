@@ -6,7 +6,9 @@
  * 
  * @brief 1st mixer that converts the RF signal to near-zero IF. Local 
  * Oscillator is implemented using NCO and allows for selecting 64 even spaced 
- * frequencies from 0 to f_sample / 2
+ * frequencies from 0 to f_sample / 2. Noise blanker is built into the mixing 
+ * kernels: impulses in the RF signal are detected against its average power 
+ * and the mixer output around them is blanked.
  */
 
 #ifndef RADIO_MIX1_H
@@ -14,6 +16,14 @@
 
 #include <stdint.h>
 
+#include "config.h"
+
+/** @brief maximal noise blanker threshold in dB */
+#define MIX1_NB_MAX_THRESHOLD                           40
+
+/** @brief spacing of the bands offered by the local oscillator (sampling 
+ * frequency over the length of the oscillator lut) */
+#define MIX1_BAND_SPACING                               (RF_SAMPLING_FREQ / 200)
 
 /**
  * @brief mix the incoming RF signal using the internally generated 
@@ -24,8 +34,23 @@
  * @param i resulting in-phase component
  * @param q resulting quadrature component
  * 
+ * @note with the packed kernel (MIX1_PACKED) all of the buffers must be word 
+ * aligned
+ */
+void Mix1_Mix(const int16_t *rf, int num, int16_t *i, int16_t *q);
+
+/**
+ * @brief Reference (scalar) implementation of the mixer. Produces exactly the 
+ * same results as Mix1_Mix() regardless of the kernel selected with 
+ * MIX1_PACKED (the noise blanker keeps separate state for it, so it needs to 
+ * be fed with the same data). Meant for verification.
+ * 
+ * @param rf fr signal input data
+ * @param num number of samples to be downconverted
+ * @param i resulting in-phase component
+ * @param q resulting quadrature component
  */
-int Mix1_Mix(const int16_t *rf, int num, int16_t *i, int16_t *q);
+void Mix1_MixRef(const int16_t *rf, int num, int16_t *i, int16_t *q);
 
 /**
  * @brief Sets the frequency for the numerically controlled oscillator that is 
@@ -38,4 +63,28 @@ int Mix1_Mix(const int16_t *rf, int num, int16_t *i, int16_t *q);
  */
 float Mix1_SetLOFrequency(float f);
 
+/**
+ * @brief Set the noise blanker threshold: sample pairs with the energy that 
+ * exceeds the average by the threshold are treated as impulses and the mixer 
+ * output from MIX1_NB_PRE samples before to MIX1_NB_POST samples after them 
+ * is zeroed.
+ * 
+ * @param threshold threshold in dB (0 - blanker disabled, up to 
+ * MIX1_NB_MAX_THRESHOLD)
+ * 
+ * @return int status (EFATAL for unsupported threshold)
+ */
+int Mix1_SetBlanker(float threshold);
+
+/**
+ * @brief Get the noise blanker settings and statistics
+ * 
+ * @param threshold place to put the threshold to (in dB, may be NULL)
+ * @param blanked place to put the number of samples blanked by Mix1_Mix() so 
+ * far to (may be NULL)
+ * 
+ * @return int status
+ */
+int Mix1_GetBlanker(float *threshold, uint32_t *blanked);
+
 #endif /* RADIO_MIX1_H */
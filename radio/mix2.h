@@ -5,8 +5,9 @@
  * @author twatorowski 
  * 
  * @brief 2nd stage mixer, that brings the decimated signal to DC. This one has 
- * a lot finer tunning capabilities as it uses NCO with bigger look-up table and 
- * operates as low-data rate.
+ * a lot finer tunning capabilities as it uses the NCO with 32-bit phase 
+ * accumulator (BB_SAMPLING_RATE / 2^32 resolution), the top bits of which 
+ * address the look-up table, and operates as low-data rate.
  */
 
 #ifndef RADIO_MIX2_H
@@ -26,13 +27,39 @@
 void Mix2_Mix(const float *i, const float *q, int num, float *i_out, 
     float *q_out);
 
+/**
+ * @brief Mix the complex input signal with the local oscillator and store the 
+ * result both in floating point and in the Q31 format (as the interleaved I/Q 
+ * pairs). Saves the separate conversion and copying passes when the data is 
+ * to be sent over the usb.
+ * 
+ * @param i In-phase channel data
+ * @param q Quadrature channel data
+ * @param num number of samples to be mixed
+ * @param i_out pointer to the output I channel data
+ * @param q_out pointer to the output Q channel data
+ * @param iq_out pointer to the output interleaved Q31 I/Q pairs
+ */
+void Mix2_MixFixp32(const float *i, const float *q, int num, float *i_out, 
+    float *q_out, int32_t *iq_out);
+
 /**
  * @brief Sets the local oscillator frequency for the 2nd stage mixer
  * 
- * @param hz desired frequency
+ * @param hz desired frequency (-fs/2 to fs/2, fs being the sampling rate set 
+ * with Mix2_SetSamplingRate(), BB_SAMPLING_RATE by default)
  * 
- * @return int actual frequency
+ * @return float actual frequency
  */
 float Mix2_SetLOFrequency(float hz);
 
+/**
+ * @brief Sets the sampling rate of the data that gets mixed. Takes effect with 
+ * the next call to Mix2_SetLOFrequency() as the phase increment depends on 
+ * both.
+ * 
+ * @param hz sampling rate
+ */
+void Mix2_SetSamplingRate(float hz);
+
 #endif /* RADIO_MIX2_H */
@@ -0,0 +1,43 @@
+/**
+ * @file notch.h
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Adaptive notch: lms line enhancer that runs on the demodulated audio
+ * at the reduced sampling rate, finds the steady tones (heterodyne whistles,
+ * carriers of the adjacent stations) and subtracts them from the audio.
+ */
+
+#ifndef RADIO_NOTCH_H
+#define RADIO_NOTCH_H
+
+#include "config.h"
+
+/** @brief decimation rate of the internal processing */
+#define NOTCH_DECIMATION_RATE                           4
+/** @brief internal sampling rate */
+#define NOTCH_SAMPLING_RATE                             \
+    (BB_SAMPLING_RATE / NOTCH_DECIMATION_RATE)
+/** @brief audio delay introduced by the notch in samples (at the baseband
+ * rate) */
+#define NOTCH_DELAY                                     \
+    (2 * NOTCH_DECIMATION_RATE - 1)
+
+/**
+ * @brief Reset the notch: the predictor forgets all the tones it has found,
+ * the delay lines are emptied. To be called from within the rf callback.
+ */
+void Notch_Reset(void);
+
+/**
+ * @brief Process the audio: remove the steady tones, the output is delayed by
+ * NOTCH_DELAY samples. May be done in situ.
+ *
+ * @param in input samples
+ * @param num number of samples (multiple of the NOTCH_DECIMATION_RATE)
+ * @param out output samples
+ */
+void Notch_Process(const float *in, int num, float *out);
+
+#endif /* RADIO_NOTCH_H */
@@ -10,6 +10,98 @@
 #ifndef RADIO_RADIO_H
 #define RADIO_RADIO_H
 
+#include "radio/agc.h"
+#include "sys/ev.h"
+#include "sys/prof.h"
+
+/** @defgroup RADIO_PROF_STAGES Profiled processing stages */
+/** @{ */
+/** @name Processing stages of the rf callback */
+/** @{ */
+/** @brief 1st stage mixing */
+#define RADIO_PROF_MIX1                                 0
+/** @brief decimation (startup only as it runs in the background) */
+#define RADIO_PROF_DEC                                  1
+/** @brief 2nd stage mixing fused with the conversion of the iq data to the 
+ * fixed point and storing it in the usb buffers */
+#define RADIO_PROF_MIX2                                 2
+/** @brief filtering before the demodulation */
+#define RADIO_PROF_FILTER                               3
+/** @brief demodulation */
+#define RADIO_PROF_DEMOD                                4
+/** @brief automatic gain control and the volume */
+#define RADIO_PROF_AGC                                  5
+/** @brief conversion of the audio to the fixed point for the dac */
+#define RADIO_PROF_DAC_FIXP                             6
+/** @brief audio saturation */
+#define RADIO_PROF_SAT                                  7
+/** @brief whole callback */
+#define RADIO_PROF_TOTAL                                8
+/** @brief cycles left in the frame after the processing was done */
+#define RADIO_PROF_HEADROOM                             9
+/** @brief 1st local oscillator re-tuning (done outside of the rf callback, 
+ * once per frequency change, the tables were rebuilt on every frame before) */
+#define RADIO_PROF_LO1                                  10
+/** @brief channel power and noise floor measurement (the audio path stages 
+ * that follow it are skipped when the squelch is closed) */
+#define RADIO_PROF_METER                                11
+/** @brief adaptive notch (only when enabled) */
+#define RADIO_PROF_NOTCH                                12
+/** @brief sample rate conversion of the audio to the dac clock */
+#define RADIO_PROF_ASRC                                 13
+/** @brief half-band decimation between the iq stream rate and the baseband 
+ * rate (only when they differ) */
+#define RADIO_PROF_HBAND                                14
+/** @brief raw rf capture (only when enabled) */
+#define RADIO_PROF_RFCAP                                15
+/** @brief iq data notification (binary iq stream over the at interfaces) */
+#define RADIO_PROF_IQNTF                                16
+/** @brief number of the profiled stages */
+#define RADIO_PROF_NUM                                  17
+/** @} */
+/** @} */
+
+/** @defgroup RADIO_MODES Demodulation modes */
+/** @{ */
+/** @name Demodulation modes */
+/** @{ */
+/** @brief amplitude modulation */
+#define RADIO_MODE_AM                                   0
+/** @brief single sideband, upper sideband */
+#define RADIO_MODE_USB                                  1
+/** @brief single sideband, lower sideband */
+#define RADIO_MODE_LSB                                  2
+/** @brief synchronous amplitude modulation */
+#define RADIO_MODE_SAM                                  3
+/** @brief continuous wave (morse) */
+#define RADIO_MODE_CW                                   4
+/** @brief number of the modes */
+#define RADIO_MODE_NUM                                  5
+/** @} */
+/** @} */
+
+/** @brief iq stream sampling rate change event argument */
+typedef struct radio_iq_evarg {
+    /**< sampling rate of the iq stream (in Hz) */
+    int rate;
+} radio_iq_evarg_t;
+
+/** @brief iq stream sampling rate has changed, notified from within the rf 
+ * callback when the first frame at the new rate gets processed */
+extern ev_t radio_iq_ev;
+
+/** @brief iq samples event argument */
+typedef struct radio_iqdata_evarg {
+    /**< in-phase and quadrature samples (full scale is 1.0) */
+    const float *i, *q;
+    /**< number of the samples */
+    int num;
+} radio_iqdata_evarg_t;
+
+/** @brief iq samples are ready (the same ones that go to the usb host), 
+ * notified from within the rf callback once per frame */
+extern ev_t radio_iqdata_ev;
+
 /**
  * @brief Initialize radio receiver logic
  * 
@@ -35,5 +127,180 @@ int Radio_SetFrequency(float f);
  */
 int Radio_GetFrequency(float *f);
 
+/**
+ * @brief set the demodulation mode. The change takes place at the beginning 
+ * of the next frame.
+ * 
+ * @param mode demodulation mode (@ref RADIO_MODES)
+ * 
+ * @return int status
+ */
+int Radio_SetMode(int mode);
+
+/**
+ * @brief get the demodulation mode 
+ * 
+ * @param mode place to put the mode to (@ref RADIO_MODES)
+ * 
+ * @return int status
+ */
+int Radio_GetMode(int *mode);
+
+/**
+ * @brief get the name of the demodulation mode
+ * 
+ * @param mode demodulation mode (@ref RADIO_MODES)
+ * 
+ * @return const char * name of the mode or NULL for unknown modes
+ */
+const char * Radio_GetModeName(int mode);
+
+/**
+ * @brief set the pitch of the beat frequency oscillator (cw mode)
+ * 
+ * @param hz pitch in Hz
+ * 
+ * @return int status (EFATAL for unsupported pitch)
+ */
+int Radio_SetBFO(float hz);
+
+/**
+ * @brief get the pitch of the beat frequency oscillator
+ * 
+ * @param hz place to put the pitch to (in Hz)
+ * 
+ * @return int status
+ */
+int Radio_GetBFO(float *hz);
+
+/**
+ * @brief enable or disable the adaptive notch that removes the steady tones 
+ * (heterodyne whistles) from the audio. Not applied in the cw mode as the 
+ * tone is the signal there. Takes effect at the beginning of the next frame.
+ * 
+ * @param enable 1 - enable, 0 - disable
+ * 
+ * @return int status
+ */
+int Radio_SetNotch(int enable);
+
+/**
+ * @brief get the adaptive notch setting
+ * 
+ * @param enable place to put the setting to (1 - enabled)
+ * 
+ * @return int status
+ */
+int Radio_GetNotch(int *enable);
+
+/**
+ * @brief set the sampling rate of the iq stream (the one sent over the usb). 
+ * Rates are the ones that the decimation of RF_SAMPLING_FREQ by 
+ * DEC_MIN_DECIMATION_RATE times the power of 2 (up to IQ_MAX_DECIMATION_RATE) 
+ * gives: 96, 48, 24 or 12 kHz. The demodulation always takes place at 
+ * BB_SAMPLING_RATE. Takes effect at the beginning of the next frame, 
+ * radio_iq_ev is notified once the iq samples at the new rate are produced.
+ * 
+ * @param rate sampling rate in Hz
+ * 
+ * @return int status (EFATAL for unsupported rate)
+ */
+int Radio_SetIQRate(int rate);
+
+/**
+ * @brief get the sampling rate of the iq stream
+ * 
+ * @param rate place to put the rate to (in Hz)
+ * 
+ * @return int status
+ */
+int Radio_GetIQRate(int *rate);
+
+/**
+ * @brief set the automatic gain control settings for given mode. Settings of 
+ * the mode in use take effect at the beginning of the next frame.
+ * 
+ * @param mode demodulation mode (@ref RADIO_MODES)
+ * @param cfg agc settings
+ * 
+ * @return int status (EFATAL for unknown mode or invalid settings)
+ */
+int Radio_SetAGC(int mode, const agc_cfg_t *cfg);
+
+/**
+ * @brief get the automatic gain control settings for given mode
+ * 
+ * @param mode demodulation mode (@ref RADIO_MODES)
+ * @param cfg place to put the settings to
+ * 
+ * @return int status (EFATAL for unknown mode)
+ */
+int Radio_GetAGC(int mode, agc_cfg_t *cfg);
+
+/**
+ * @brief get the state of the automatic gain control
+ * 
+ * @param gain place to put the current agc gain to (in dB, without the 
+ * volume)
+ * @param rssi place to put the signal level seen by the agc to (peak of 
+ * the demodulated signal in dB relative to the full scale)
+ * 
+ * @return int status
+ */
+int Radio_GetAGCStatus(float *gain, float *rssi);
+
+/**
+ * @brief get the state of the carrier tracking (synchronous am mode only)
+ * 
+ * @param locked place to put the lock status to (1 - locked)
+ * @param offset place to put the carrier offset (in Hz) from the frequency 
+ * that the receiver is tuned to
+ * 
+ * @return int status
+ */
+int Radio_GetCarrier(int *locked, float *offset);
+
+/**
+ * @brief get the state of the sample rate converter that matches the audio to
+ * the dac clock
+ * 
+ * @param ppm place to put the correction of the conversion ratio to (in ppm,
+ * relative to the nominal ratio given by the dac pll settings)
+ * @param fill place to put the number of samples that wait in the dac buffer
+ * to (smoothed over the recent frames)
+ * 
+ * @return int status
+ */
+int Radio_GetAudioSync(float *ppm, float *fill);
+
+/**
+ * @brief start or stop the wideband scan (see radio/scan.h for the occupancy 
+ * table). The receiver goes back to the frequency that was set once the scan 
+ * is done, re-tuning stops the scan.
+ * 
+ * @param dwell number of frames averaged per band (0 - stop the scan)
+ * 
+ * @return int status (EFATAL for unsupported dwell)
+ */
+int Radio_Scan(int dwell);
+
+/**
+ * @brief get the cpu cycle statistics for given processing stage 
+ * 
+ * @param stage processing stage (@ref RADIO_PROF_STAGES)
+ * @param name place to store the pointer to the stage name to (may be NULL)
+ * @param stats place to put the statistics to
+ * 
+ * @return int status
+ */
+int Radio_GetProfile(int stage, const char **name, prof_stats_t *stats);
+
+/**
+ * @brief reset the cpu cycle statistics for all processing stages
+ * 
+ * @return int status
+ */
+int Radio_ResetProfile(void);
+
 
 #endif /* RADIO_RADIO_H */
@@ -0,0 +1,147 @@
+/**
+ * @file rfcap.h
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Raw rf capture: every half of the rf buffer (a block) is sent over 
+ * the usb bulk endpoint as is or decimated by 2 or 4 (half-band filters) as 
+ * 16-bit samples or 8-bit mu-law codes. Every block goes with the header that 
+ * carries the block sequence number and the counters of the blocks that were 
+ * lost, so that the reader can tell where the gaps are.
+ */
+
+#ifndef RADIO_RFCAP_H
+#define RADIO_RFCAP_H
+
+#include <stdint.h>
+
+#include "compiler.h"
+#include "config.h"
+
+/** @name Sample formats */
+/** @{ */
+/** @brief capture disabled */
+#define RFCAP_FMT_OFF                                   0
+/** @brief signed 16-bit samples (adc lsb) */
+#define RFCAP_FMT_S16                                   1
+/** @brief 8-bit mu-law codes (G.711) of the samples scaled by 
+ * 2^RFCAP_MULAW_SHIFT */
+#define RFCAP_FMT_U8                                    2
+/** @} */
+
+/** @brief highest decimation rate */
+#define RFCAP_MAX_DEC                                   4
+/** @brief number of the rf samples in a block (half of the rf buffer) */
+#define RFCAP_BLOCK_SIZE                                \
+    (RF_SAMPLING_FREQ * 2 / 1000)
+/** @brief scaling of the samples before the mu-law encoding: the adc range 
+ * (with the offset applied) fits within the 16-bit codec range and the 
+ * samples below 16 lsb are coded with no loss */
+#define RFCAP_MULAW_SHIFT                               3
+/** @brief header magic value ('R', 'C' in the little endian byte order) */
+#define RFCAP_MAGIC                                     0x4352
+
+/** @brief block header (little endian), payload follows right after it */
+typedef struct rfcap_hdr {
+    /**< magic value */
+    uint16_t magic;
+    /**< sample format and the decimation rate */
+    uint8_t format, dec;
+    /**< number of the samples within the block */
+    uint16_t num;
+    /**< number of the blocks that were overwritten by the adc while being 
+     * sent (modulo 2^16) */
+    uint16_t torn;
+    /**< block sequence number (counts all the blocks, sent or not) */
+    uint32_t seq;
+    /**< number of the blocks that were dropped since the capture started */
+    uint32_t dropped;
+} PACKED rfcap_hdr_t;
+
+/** @brief capture statistics */
+typedef struct rfcap_stats {
+    /**< number of the blocks captured, sent, dropped (the endpoint was busy) 
+     * and torn (overwritten while sent) */
+    uint32_t blocks, sent, dropped, torn;
+    /**< sustained throughput [bytes per second] */
+    uint32_t rate;
+} rfcap_stats_t;
+
+/**
+ * @brief Initialize the capture (disabled)
+ *
+ * @return int status
+ */
+int RFCap_Init(void);
+
+/**
+ * @brief Set the capture format, takes effect with the next block. Counters 
+ * start over when the capture gets enabled.
+ *
+ * @param format sample format (RFCAP_FMT_...)
+ * @param dec decimation rate (1, 2 or 4)
+ *
+ * @return int status (EFATAL for unsupported settings)
+ */
+int RFCap_SetFormat(int format, int dec);
+
+/**
+ * @brief Get the capture format
+ *
+ * @param format sample format (RFCAP_FMT_...)
+ * @param dec decimation rate
+ *
+ * @return int status
+ */
+int RFCap_GetFormat(int *format, int *dec);
+
+/**
+ * @brief Get the capture statistics
+ *
+ * @param stats statistics
+ *
+ * @return int status
+ */
+int RFCap_GetStats(rfcap_stats_t *stats);
+
+/**
+ * @brief Feed the block of the rf samples, to be called from within the rf 
+ * callback. The 16-bit undecimated blocks are sent straight from the rf 
+ * buffer, so the data must stay where it is until the next block arrives.
+ *
+ * @param samples rf samples
+ * @param num number of the samples (up to RFCAP_BLOCK_SIZE)
+ */
+void RFCap_PutSamples(const int16_t *samples, int num);
+
+/**
+ * @brief Decode the mu-law code
+ *
+ * @param code mu-law code
+ *
+ * @return int16_t sample (adc lsb)
+ */
+int16_t RFCap_MuLawDecode(uint8_t code);
+
+/**
+ * @brief Unpack the block payload into the 16-bit samples
+ *
+ * @param hdr block header
+ * @param payload block payload
+ * @param out output samples (room for hdr->num samples is needed)
+ *
+ * @return int number of the samples, EFATAL if the header is not valid
+ */
+int RFCap_Unpack(const rfcap_hdr_t *hdr, const void *payload, int16_t *out);
+
+/**
+ * @brief Get the size of the block payload
+ *
+ * @param hdr block header
+ *
+ * @return int payload size in bytes, EFATAL if the header is not valid
+ */
+int RFCap_GetPayloadSize(const rfcap_hdr_t *hdr);
+
+#endif /* RADIO_RFCAP_H */
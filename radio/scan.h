@@ -0,0 +1,100 @@
+/**
+ * @file scan.h
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Wideband scan: sweeps the 1st local oscillator across all of its
+ * bands (0 - RF_SAMPLING_FREQ / 2), measures the power of the channels that
+ * fall within the band and builds the occupancy table.
+ */
+
+#ifndef RADIO_SCAN_H
+#define RADIO_SCAN_H
+
+#include "config.h"
+#include "radio/mix1.h"
+#include "sys/cb.h"
+
+/** @brief number of the channels within a single band */
+#define SCAN_CHANNELS_PER_BAND                                              \
+    (MIX1_BAND_SPACING / SCAN_CHANNEL_WIDTH)
+/** @brief number of the bands that the scan goes through */
+#define SCAN_BANDS                                                          \
+    (RF_SAMPLING_FREQ / 2 / MIX1_BAND_SPACING + 1)
+/** @brief number of the channels within the table, channel n is centered at
+ * n * SCAN_CHANNEL_WIDTH (0 - RF_SAMPLING_FREQ / 2) */
+#define SCAN_CHANNELS                                                       \
+    (RF_SAMPLING_FREQ / 2 / SCAN_CHANNEL_WIDTH + 1)
+
+/** @brief callback argument: the band to tune the 1st local oscillator to */
+typedef struct scan_cbarg {
+    /* band center frequency */
+    float frequency;
+    /* scan has finished, frequency is not valid */
+    int done;
+} scan_cbarg_t;
+
+/**
+ * @brief Initialize the scanner
+ *
+ * @return int status
+ */
+int Scan_Init(void);
+
+/**
+ * @brief Start the scan. The callback is called (from the invoked context)
+ * every time the 1st local oscillator needs to be re-tuned and once the scan
+ * is done, measurements for the band start after the callback returns.
+ *
+ * @param dwell number of SCAN_SIZE long frames that get averaged per band
+ * (1 to SCAN_MAX_DWELL)
+ * @param cb re-tuning callback, called with the scan_cbarg_t
+ *
+ * @return int status (EFATAL for unsupported dwell)
+ */
+int Scan_Start(int dwell, cb_t cb);
+
+/**
+ * @brief Stop the scan, the callback is not called anymore.
+ *
+ * @return int status
+ */
+int Scan_Stop(void);
+
+/**
+ * @brief Feed the baseband I/Q samples of the 1st stage mixer (before the 2nd
+ * stage mixing), to be called from within the rf callback.
+ *
+ * @param i in-phase samples
+ * @param q quadrature samples
+ * @param num number of samples
+ */
+void Scan_PutSamples(const float *i, const float *q, int num);
+
+/**
+ * @brief Get the scan progress
+ *
+ * @param running scan is in progress
+ * @param bands number of the bands that were measured
+ *
+ * @return int status
+ */
+int Scan_GetProgress(int *running, int *bands);
+
+/**
+ * @brief Get the channel from the occupancy table
+ *
+ * @param ch channel number (0 to SCAN_CHANNELS - 1)
+ * @param frequency channel center frequency [Hz]
+ * @param level channel power relative to the full scale complex tone at the
+ * decimator output [dB]
+ * @param snr channel power relative to the noise floor (median of all
+ * the measured channels) [dB]
+ *
+ * @return int status (EFATAL for invalid channel, ENOINIT if the channel was
+ * not measured yet)
+ */
+int Scan_GetChannel(int ch, float *frequency, float *level, float *snr);
+
+#endif /* RADIO_SCAN_H */
@@ -0,0 +1,59 @@
+/**
+ * @file sdec.h
+ * 
+ * @date 2026-10-17
+ * @author twatorowski 
+ * 
+ * @brief Software decimators for the I/Q channels: portable alternative for 
+ * the DFSDM based ones (dev/dec). Each channel goes through the sinc^3 (CIC) 
+ * filter, the droop compensation filter and up to SDEC_MAX_HB_STAGES 
+ * half-band filters, each of which decimates by 2.
+ */
+
+#ifndef RADIO_SDEC_H
+#define RADIO_SDEC_H
+
+#include <stdint.h>
+
+#include "sys/cb.h"
+
+/** @brief decimation callback argument type */
+typedef struct sdec_cbarg {
+    /**< number of samples */
+    int num;
+    /**< downsampled data for the I channel */
+    float *i;
+    /**< downsampled data for the Q channel */
+    float *q; 
+} sdec_cbarg_t;
+
+/**
+ * @brief Initialize the decimators for given decimation rate and reset 
+ * the filters. Rate is split between the cic filter and the half-band stages
+ * so that as many of the half-band stages are used as possible.
+ * 
+ * @param rate decimation rate
+ * 
+ * @return int status code (EFATAL for unsupported rates)
+ */
+int SDec_Init(int rate);
+
+/**
+ * @brief Perform data filtration & decimation. Computation is done within 
+ * the call, so the callback (if any) is called before this function returns. 
+ * 
+ * @param i input I data (signed numbers DEC_MAX_INPUT_BITS bits wide)
+ * @param q input Q data (signed numbers DEC_MAX_INPUT_BITS bits wide)
+ * @param num number of input samples (must be divisible by the rate)
+ * @param i_out normalized (full scale is from -1  to +1) and decimated I 
+ *        channel data
+ * @param q_out normalized/decimated Q channel data
+ * @param cb callback to be called when the decimation is over
+ * 
+ * @return sdec_cbarg_t * callback argument for sync calls, null for async 
+ * calls
+ */
+sdec_cbarg_t * SDec_Decimate(const int16_t *i, const int16_t *q, int num, 
+    float *i_out,  float *q_out, cb_t cb);
+
+#endif /* RADIO_SDEC_H */
@@ -0,0 +1,84 @@
+/**
+ * @file spectrum.h
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Spectrum (waterfall) engine: captures the baseband I/Q frames at the
+ * configured rate, windows them, transforms them with the Q31 fft, averages
+ * the power and log-compresses it into the byte per bin lines.
+ */
+
+#ifndef RADIO_SPECTRUM_H
+#define RADIO_SPECTRUM_H
+
+#include <stdint.h>
+
+#include "config.h"
+
+/** @defgroup SPECTRUM_SCALE Log-compressed bin scale */
+/** @{ */
+/** @name Bin value b corresponds to SPECTRUM_DB_MIN + b * SPECTRUM_DB_STEP dB
+ * relative to the full scale complex tone */
+/** @{ */
+/** @brief level represented by the bin value of 0 */
+#define SPECTRUM_DB_MIN                                 -127.5f
+/** @brief bin value step */
+#define SPECTRUM_DB_STEP                                0.5f
+/** @} */
+/** @} */
+
+/**
+ * @brief Initialize the spectrum engine, starts with SPECTRUM_RATE and
+ * SPECTRUM_AVERAGE.
+ *
+ * @return int status
+ */
+int Spectrum_Init(void);
+
+/**
+ * @brief Set the rate at which the spectrum lines are produced and the number
+ * of frames that get averaged within each line. Captures need to fit within
+ * the baseband stream: rate * average * SPECTRUM_SIZE <= BB_SAMPLING_RATE.
+ *
+ * @param rate lines per second (0 disables the engine)
+ * @param average number of frames per line (1 to SPECTRUM_MAX_AVERAGE)
+ *
+ * @return int status (EFATAL for unsupported settings)
+ */
+int Spectrum_SetRate(int rate, int average);
+
+/**
+ * @brief Get the current rate settings
+ *
+ * @param rate lines per second
+ * @param average number of frames per line
+ *
+ * @return int status
+ */
+int Spectrum_GetRate(int *rate, int *average);
+
+/**
+ * @brief Feed the baseband I/Q samples, to be called from within the rf
+ * callback. Processing of the captured frames is invoked elsewhere.
+ *
+ * @param i in-phase samples
+ * @param q quadrature samples
+ * @param num number of samples
+ */
+void Spectrum_PutSamples(const float *i, const float *q, int num);
+
+/**
+ * @brief Get the latest spectrum line. Bins go from -BB_SAMPLING_RATE / 2 up
+ * to BB_SAMPLING_RATE / 2 - BB_SAMPLING_RATE / SPECTRUM_SIZE (0 Hz being the
+ * tuned frequency) in the @ref SPECTRUM_SCALE.
+ *
+ * @param seq line sequence number (0 - no line was produced yet)
+ * @param bins SPECTRUM_SIZE bins (may be NULL when only the sequence number
+ * is needed)
+ *
+ * @return int status
+ */
+int Spectrum_GetLine(uint32_t *seq, uint8_t *bins);
+
+#endif /* RADIO_SPECTRUM_H */
@@ -0,0 +1,156 @@
+/**
+ * @file agc.c
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Automatic gain control. Peak detector runs on the samples as they
+ * enter the look-ahead delay line: rises instantly, is held for the hang time
+ * and then decays with the decay time constant. The gain is derived from the
+ * detected peak smoothed with the attack time constant and is applied to the
+ * samples that leave the delay line, so that with the attack time well below
+ * the look-ahead the gain is already reduced when the peak gets out.
+ */
+
+#include "compiler.h"
+#include "config.h"
+#include "err.h"
+#include "radio/agc.h"
+#include "sys/critical.h"
+#include "util/fp.h"
+#include "util/minmax.h"
+
+/* settings converted to the per-sample coefficients: attack and decay filter
+ * coefficients, hang time in samples and the lowest level that the gain is
+ * computed for (max gain) */
+static float k_attack, k_decay, min_level;
+static int hang_num;
+
+/* look-ahead delay line and the current position within it */
+static float delay[AGC_LOOKAHEAD];
+static int delay_idx;
+/* detected peak, samples left till the decay starts and the smoothed level
+ * that the gain is computed from */
+static float peak, level;
+static int hang_left;
+
+/* published state */
+static volatile float status_gain, status_level;
+
+/* initialize the agc */
+int AGC_Init(const agc_cfg_t *cfg)
+{
+    /* apply the settings */
+    if (AGC_SetConfig(cfg) != EOK)
+        return EFATAL;
+
+    /* empty delay line */
+    for (int n = 0; n < AGC_LOOKAHEAD; n++)
+        delay[n] = 0;
+    delay_idx = 0;
+    /* start at the maximal gain */
+    AGC_Reset();
+
+    /* report status */
+    return EOK;
+}
+
+/* reset the detector */
+void AGC_Reset(void)
+{
+    /* no peak, maximal gain */
+    peak = 0, hang_left = 0, level = min_level;
+    status_gain = AGC_TARGET / level, status_level = 0;
+}
+
+/* check the settings */
+int AGC_CheckConfig(const agc_cfg_t *cfg)
+{
+    /* all times and the gain need to be within the limits */
+    if (cfg->attack < 0 || cfg->attack > AGC_MAX_TIME || cfg->hang < 0 ||
+        cfg->hang > AGC_MAX_TIME || cfg->decay < 0 ||
+        cfg->decay > AGC_MAX_TIME || cfg->max_gain < 0 ||
+        cfg->max_gain > AGC_MAX_GAIN)
+        return EFATAL;
+    /* report status */
+    return EOK;
+}
+
+/* change the settings */
+int AGC_SetConfig(const agc_cfg_t *cfg)
+{
+    /* sanity check */
+    if (AGC_CheckConfig(cfg) != EOK)
+        return EFATAL;
+
+    /* one pole filter coefficients: 1 - exp(-1 / (t * fs)), zero time means
+     * no filtering at all */
+    float att = cfg->attack ? 1 - fp_exp(-1.0f /
+        (cfg->attack * BB_SAMPLING_RATE)) : 1;
+    float dec = cfg->decay ? 1 - fp_exp(-1.0f /
+        (cfg->decay * BB_SAMPLING_RATE)) : 1;
+    /* level at which the max gain is reached */
+    float lvl = AGC_TARGET / fp_pow(10.0f, cfg->max_gain / 20);
+
+    /* the rf callback uses all of these */
+    Critical_Enter();
+    k_attack = att, k_decay = dec, min_level = lvl;
+    hang_num = (int)(cfg->hang * BB_SAMPLING_RATE);
+    Critical_Exit();
+
+    /* report status */
+    return EOK;
+}
+
+/* process the audio */
+void OPTIMIZE("O3") AGC_Process(const float *in, int num, float volume,
+    float *out)
+{
+    /* local copies of the state */
+    float p = peak, l = level;
+    int idx = delay_idx, hang = hang_left;
+    /* output level */
+    const float target = AGC_TARGET * volume;
+
+    /* process all samples */
+    for (int n = 0; n < num; n++) {
+        /* incoming sample goes to the detector */
+        float x = in[n], a = fp_fabs(x);
+        /* peak: instant rise, held for the hang time, then decays */
+        if (a >= p) {
+            p = a, hang = hang_num;
+        } else if (hang) {
+            hang--;
+        } else {
+            p += k_decay * (a - p);
+        }
+        /* gain follows the peak with the attack time constant, limited by
+         * the maximal gain */
+        l += k_attack * (max(p, min_level) - l);
+
+        /* delayed sample gets the gain that was derived from the samples
+         * that are ahead of it */
+        out[n] = delay[idx] * target / l;
+        delay[idx] = x;
+        /* advance within the delay line */
+        if (++idx == AGC_LOOKAHEAD)
+            idx = 0;
+    }
+
+    /* store the state */
+    peak = p, level = l, delay_idx = idx, hang_left = hang;
+    /* publish */
+    status_gain = AGC_TARGET / l, status_level = p;
+}
+
+/* get the agc state */
+int AGC_GetStatus(float *gain, float *_level)
+{
+    /* report the published values */
+    if (gain)
+        *gain = status_gain;
+    if (_level)
+        *_level = status_level;
+    /* report status */
+    return EOK;
+}
@@ -0,0 +1,142 @@
+/**
+ * @file chan.c
+ * 
+ * @date 2026-10-17
+ * @author twatorowski 
+ * 
+ * @brief Polyphase FFT filter-bank channelizer (critically sampled). With N 
+ * channels the output of channel k is: 
+ * y_k[m] = sum(h[n] * x[m * N - n] * exp(j * 2 * pi * k * n / N)), 
+ * splitting n into n = l * N + p gives N polyphase branches: 
+ * v_p[m] = sum(h[l * N + p] * x[(m - l) * N - p]) that are then combined by 
+ * the N-point transform, so the cost per input sample is 
+ * CHAN_TAPS_PER_BRANCH multiplications plus the share of the fft.
+ */
+
+#include <stdint.h>
+
+#include "compiler.h"
+#include "config.h"
+#include "err.h"
+#include "dsp/fft.h"
+#include "radio/chan.h"
+#include "util/fp.h"
+
+/* number of channels */
+static int channels;
+/* prototype filter: h[l * channels + p] belongs to the branch p */
+static float taps[CHAN_MAX_CHANNELS * CHAN_TAPS_PER_BRANCH];
+/* delay line: ring of CHAN_TAPS_PER_BRANCH blocks of 'channels' samples, 
+ * every block is stored in the reversed order so that the newest sample is 
+ * at index 0 */
+static float dl_re[CHAN_MAX_CHANNELS * CHAN_TAPS_PER_BRANCH];
+static float dl_im[CHAN_MAX_CHANNELS * CHAN_TAPS_PER_BRANCH];
+/* block that is being filled and the number of samples in it */
+static int head, fill;
+/* transform buffers */
+static float fft_re[CHAN_MAX_CHANNELS], fft_im[CHAN_MAX_CHANNELS];
+
+/* initialize the channelizer */
+int Chan_Init(int channels_num)
+{
+    /* number of channels must be a power of two */
+    if (channels_num < 2 || channels_num > CHAN_MAX_CHANNELS || 
+        (channels_num & (channels_num - 1)))
+        return EFATAL;
+
+    /* prototype filter length, center and the cut-off (half of the channel 
+     * spacing, normalized to the sampling rate) */
+    int len = channels_num * CHAN_TAPS_PER_BRANCH;
+    float center = (len - 1) / 2.0f, fc = 0.5f / channels_num, sum = 0;
+    /* design the prototype filter: windowed (blackman) sinc */
+    for (int n = 0; n < len; n++) {
+        /* distance from the center */
+        float x = n - center;
+        /* window value */
+        float w = 0.42f - 0.5f * fp_cos(2 * fp_PI * n / (len - 1)) + 
+            0.08f * fp_cos(4 * fp_PI * n / (len - 1));
+        /* sinc (the filter has an even length, so x is never 0) */
+        taps[n] = w * fp_sin(2 * fp_PI * fc * x) / (fp_PI * x);
+        sum += taps[n];
+    }
+    /* unity gain at dc, int16 full scale is represented as 1.0 */
+    for (int n = 0; n < len; n++)
+        taps[n] *= 1.0f / (sum * 32768.0f);
+
+    /* reset the delay line */
+    for (int n = 0; n < len; n++)
+        dl_re[n] = dl_im[n] = 0;
+    /* store the configuration */
+    channels = channels_num, head = 0, fill = 0;
+
+    /* report status */
+    return EOK;
+}
+
+/* compute the channel outputs for the complete block */
+static void OPTIMIZE("O3") LOOP_UNROLL Chan_Block(float *re, float *im)
+{
+    /* shorthand */
+    const int n_ch = channels;
+
+    /* polyphase branches, newest block first */
+    for (int p = 0; p < n_ch; p++)
+        fft_re[p] = fft_im[p] = 0;
+    for (int l = 0, b = head; l < CHAN_TAPS_PER_BRANCH; l++) {
+        /* taps and the data of given block */
+        const float *h = &taps[l * n_ch];
+        const float *x_re = &dl_re[b * n_ch], *x_im = &dl_im[b * n_ch];
+        /* accumulate */
+        for (int p = 0; p < n_ch; p++)
+            fft_re[p] += h[p] * x_re[p], fft_im[p] += h[p] * x_im[p];
+        /* previous block */
+        b = b ? b - 1 : CHAN_TAPS_PER_BRANCH - 1;
+    }
+
+    /* combine the branches */
+    FFT_Float(fft_re, fft_im, n_ch);
+    /* the forward transform produces exp(-j...) so the channel k is found 
+     * in the bin -k */
+    for (int k = 0; k < n_ch; k++) {
+        re[k] = fft_re[(n_ch - k) & (n_ch - 1)];
+        im[k] = fft_im[(n_ch - k) & (n_ch - 1)];
+    }
+}
+
+/* push the samples through the channelizer */
+int Chan_Process(const int16_t *i, const int16_t *q, int num, float *re, 
+    float *im)
+{
+    /* shorthand */
+    const int n_ch = channels;
+    /* number of output vectors */
+    int out_num = 0;
+
+    /* process all samples */
+    while (num) {
+        /* samples that fit into the current block */
+        int n = n_ch - fill < num ? n_ch - fill : num;
+        /* current block, filled from the end */
+        float *x_re = &dl_re[head * n_ch + n_ch - 1 - fill];
+        float *x_im = &dl_im[head * n_ch + n_ch - 1 - fill];
+
+        /* store the samples */
+        for (int k = 0; k < n; k++)
+            x_re[-k] = i[k], x_im[-k] = q ? q[k] : 0;
+        /* update the pointers */
+        i += n, q = q ? q + n : 0, num -= n, fill += n;
+
+        /* block is complete */
+        if (fill == n_ch) {
+            /* produce the outputs */
+            Chan_Block(re, im);
+            re += n_ch, im += n_ch, out_num++;
+            /* next block */
+            head = head == CHAN_TAPS_PER_BRANCH - 1 ? 0 : head + 1;
+            fill = 0;
+        }
+    }
+
+    /* report the number of output vectors */
+    return out_num;
+}
@@ -34,13 +34,9 @@ static biquad_t dec4_q[] = {
 void OPTIMIZE("O3") LOOP_UNROLL Dec4_Filter(const float *i, 
     const float *q, int num, float *i_out, float *q_out)
 {
-    /* filter incoming data for the in-phase channel */
-    for (int cnt = 0; cnt < elems(dec4_i); cnt++)
-        BiQuad_Filter(i, num, &dec4_i[cnt], i_out);
-
-    /* filter incoming data for the quadrature channel */
-    for (int cnt = 0; cnt < elems(dec4_q); cnt++)
-        BiQuad_Filter(q, num, &dec4_q[cnt], q_out);
+    /* filter both channels with all the sections in one pass */
+    BiQuad_FilterCascadeIQ(i, q, num, dec4_i, dec4_q, elems(dec4_i), 
+        i_out, q_out);
 }
 
 /* do the actual decimation (drop unused samples  */
@@ -40,17 +40,24 @@ static biquad_t lpf_q[] = {
 /* output high pass filter */
 static biquad_t hpf[] = { { .taps = &hpf_taps[0] } };
 
+/* reset the filters */
+void DemodAM_Reset(void)
+{
+    /* input filters */
+    for (int k = 0; k < (int)elems(lpf_i); k++)
+        BiQuad_SetTaps(&lpf_i[k], 0), BiQuad_SetTaps(&lpf_q[k], 0);
+    /* output filter */
+    for (int k = 0; k < (int)elems(hpf); k++)
+        BiQuad_SetTaps(&hpf[k], 0);
+}
+
 /* filtration before demodulation */
 void OPTIMIZE("O3") LOOP_UNROLL DemodAM_Filter(const float *i, 
     const float *q, int num, float *i_out, float *q_out)
 {
-    /* filter incoming data for the in-phase channel */
-    for (int cnt = 0; cnt < elems(lpf_i); cnt++)
-        BiQuad_Filter(i, num, &lpf_i[cnt], i_out);
-
-    /* filter incoming data for the quadrature channel */
-    for (int cnt = 0; cnt < elems(lpf_q); cnt++)
-        BiQuad_Filter(q, num, &lpf_q[cnt], q_out);
+    /* filter both channels with all the sections in one pass */
+    BiQuad_FilterCascadeIQ(i, q, num, lpf_i, lpf_q, elems(lpf_i), i_out, 
+        q_out);
 }
 
 /* simple demodulation routine */
@@ -0,0 +1,222 @@
+/**
+ * @file demod_cw.c
+ * 
+ * @date 2026-10-17
+ * @author twatorowski 
+ * 
+ * @brief Demodulate CW signal. The baseband data is decimated by 8 with the 
+ * triangular (sinc^2) filter which puts its zeros at the multiples of the 
+ * internal sampling rate where the aliases would come from. Narrow channel 
+ * filter, bfo and the goertzel detectors run at the internal rate, the audio 
+ * is brought back to the baseband rate with linear interpolation.
+ */
+
+#include <stdint.h>
+
+#include "compiler.h"
+#include "config.h"
+#include "err.h"
+#include "dsp/biquad.h"
+#include "dsp/tridec.h"
+#include "radio/demod_cw.h"
+#include "util/elems.h"
+#include "util/fp.h"
+
+/* size of the envelope buffer (power of two) */
+#define DEMODCW_ENV_SIZE                                32
+
+/* channel filter (elliptic, 4th order, 0.5dB ripple, 50dB attenuation, 
+ * f_c = 200Hz @ 6ksps) */
+static const biquad_taps_t lpf_taps[] = {
+    { .b0 = +3.753097e-03, .b1 = -4.140058e-03, .b2 = +3.753097e-03,
+      .a1 = -1.814696e+00, .a2 = +8.310506e-01 },
+    { .b0 = +1.000000e+00, .b1 = -1.793649e+00, .b2 = +1.000000e+00,
+      .a1 = -1.893644e+00, .a2 = +9.386328e-01 },
+};
+
+/* channel filters */
+static biquad_t lpf_i[] = { 
+    { .taps = &lpf_taps[0] }, { .taps = &lpf_taps[1] } 
+};
+static biquad_t lpf_q[] = { 
+    { .taps = &lpf_taps[0] }, { .taps = &lpf_taps[1] } 
+};
+
+/* decimators */
+static tridec_t dec_i, dec_q;
+
+/* bfo phasor and the rotation per sample */
+static float bfo_c = 1.0f, bfo_s, rot_c = 1.0f, rot_s;
+/* previous audio sample (for the interpolation) */
+static float audio_prev;
+
+#if DEMODCW_GOERTZEL
+/* goertzel detector coefficients and states */
+static float gz_coef[DEMODCW_GOERTZEL_BINS];
+static float gz_s1[DEMODCW_GOERTZEL_BINS], gz_s2[DEMODCW_GOERTZEL_BINS];
+/* sample counter within the goertzel block */
+static int gz_cnt;
+/* envelope buffer */
+static float env_buf[DEMODCW_ENV_SIZE];
+/* envelope buffer head (written by the demodulator) and tail (by the 
+ * reader) */
+static volatile uint32_t env_head, env_tail;
+#endif
+
+/* reset the demodulator */
+void DemodCW_Reset(void)
+{
+    /* filters */
+    for (int k = 0; k < (int)elems(lpf_i); k++)
+        BiQuad_SetTaps(&lpf_i[k], 0), BiQuad_SetTaps(&lpf_q[k], 0);
+    /* decimator */
+    TriDec_Init(&dec_i, DEMODCW_DECIMATION_RATE);
+    TriDec_Init(&dec_q, DEMODCW_DECIMATION_RATE);
+    /* oscillator and the interpolator */
+    bfo_c = 1.0f, bfo_s = 0, audio_prev = 0;
+
+#if DEMODCW_GOERTZEL
+    /* goertzel detectors */
+    for (int k = 0; k < DEMODCW_GOERTZEL_BINS; k++)
+        gz_s1[k] = gz_s2[k] = 0;
+    gz_cnt = 0;
+#endif
+}
+
+/* set the bfo pitch */
+int DemodCW_SetPitch(float hz)
+{
+    /* sanity check */
+    if (hz < DEMODCW_MIN_PITCH || hz > DEMODCW_MAX_PITCH)
+        return EFATAL;
+
+    /* rotation per sample */
+    float w = 2 * fp_PI * hz / DEMODCW_SAMPLING_RATE;
+    rot_c = fp_cos(w), rot_s = fp_sin(w);
+
+#if DEMODCW_GOERTZEL
+    /* detectors are centered around the pitch */
+    for (int k = 0; k < DEMODCW_GOERTZEL_BINS; k++) {
+        /* detector frequency */
+        float f = hz + (k - DEMODCW_GOERTZEL_BINS / 2) * 
+            DEMODCW_GOERTZEL_SPACING;
+        /* goertzel coefficient */
+        gz_coef[k] = 2 * fp_cos(2 * fp_PI * f / DEMODCW_SAMPLING_RATE);
+    }
+#endif
+
+    /* report status */
+    return EOK;
+}
+
+/* decimation and channel filtration */
+int OPTIMIZE("O3") LOOP_UNROLL DemodCW_Filter(const float *i, 
+    const float *q, int num, float *i_out, float *q_out)
+{
+    /* decimate both channels */
+    int num_out = TriDec_Decimate(&dec_i, i, num, i_out);
+    TriDec_Decimate(&dec_q, q, num, q_out);
+
+    /* narrow channel filter */
+    BiQuad_FilterCascadeIQ(i_out, q_out, num_out, lpf_i, lpf_q, 
+        elems(lpf_i), i_out, q_out);
+
+    /* return the number of samples produced */
+    return num_out;
+}
+
+#if DEMODCW_GOERTZEL
+/* feed the sample to the goertzel detectors, produce the envelope sample at 
+ * the end of every block */
+static inline ALWAYS_INLINE void DemodCW_Goertzel(float x)
+{
+    /* update all detectors */
+    for (int k = 0; k < DEMODCW_GOERTZEL_BINS; k++) {
+        float s0 = x + gz_coef[k] * gz_s1[k] - gz_s2[k];
+        gz_s2[k] = gz_s1[k], gz_s1[k] = s0;
+    }
+    /* block is not complete */
+    if (++gz_cnt < DEMODCW_GOERTZEL_SIZE)
+        return;
+
+    /* look for the strongest detector */
+    float p_max = 0;
+    for (int k = 0; k < DEMODCW_GOERTZEL_BINS; k++) {
+        /* power at the detector frequency */
+        float p = gz_s1[k] * gz_s1[k] + gz_s2[k] * gz_s2[k] - 
+            gz_coef[k] * gz_s1[k] * gz_s2[k];
+        /* store the maximum */
+        if (p > p_max) 
+            p_max = p;
+        /* reset the detector */
+        gz_s1[k] = gz_s2[k] = 0;
+    }
+    /* start the new block */
+    gz_cnt = 0;
+
+    /* tone amplitude, one square root per block */
+    env_buf[env_head % DEMODCW_ENV_SIZE] = fp_sqrt(p_max) * 
+        (2.0f / DEMODCW_GOERTZEL_SIZE);
+    /* make it visible to the reader */
+    env_head = env_head + 1;
+}
+#endif
+
+/* demodulation routine */
+void OPTIMIZE("O3") LOOP_UNROLL DemodCW_Demodulate(const float *i, 
+    const float *q, int num, float *out)
+{
+    /* shorthand */
+    const int r = DEMODCW_DECIMATION_RATE;
+    /* local copies of the oscillator state */
+    float c = bfo_c, s = bfo_s, rc = rot_c, rs = rot_s, a_prev = audio_prev;
+
+    /* process all samples */
+    for (int m = 0; m < num; m++) {
+        /* audio: real part of the product with the bfo */
+        float a = i[m] * c - q[m] * s;
+        /* advance the oscillator */
+        float c1 = c * rc - s * rs; s = s * rc + c * rs; c = c1;
+
+#if DEMODCW_GOERTZEL
+        /* keying envelope */
+        DemodCW_Goertzel(a);
+#endif
+
+        /* back to the baseband rate */
+        float d = (a - a_prev) * (1.0f / r);
+        for (int k = 1; k <= r; k++)
+            *out++ = a_prev + d * k;
+        /* store the sample */
+        a_prev = a;
+    }
+
+    /* keep the oscillator magnitude at unity (one newton step for 1/sqrt 
+     * per block is enough) */
+    float g = 1.5f - 0.5f * (c * c + s * s);
+    /* store the state */
+    bfo_c = c * g, bfo_s = s * g, audio_prev = a_prev;
+}
+
+/* read the keying envelope */
+int DemodCW_ReadEnvelope(float *env, int num)
+{
+    /* number of samples read */
+    int n = 0;
+
+#if DEMODCW_GOERTZEL
+    /* current head */
+    uint32_t head = env_head, tail = env_tail;
+    /* samples that were overwritten are lost */
+    if (head - tail > DEMODCW_ENV_SIZE)
+        tail = head - DEMODCW_ENV_SIZE;
+    /* copy */
+    for (; n < num && tail != head; n++, tail++)
+        env[n] = env_buf[tail % DEMODCW_ENV_SIZE];
+    /* store the tail */
+    env_tail = tail;
+#endif
+
+    /* report the number of samples read */
+    return n;
+}
@@ -0,0 +1,154 @@
+/**
+ * @file demod_sam.c
+ * 
+ * @date 2026-10-17
+ * @author twatorowski 
+ * 
+ * @brief Synchronous AM demodulator. The 2nd order pll (proportional-integral 
+ * loop filter) tracks the carrier, the signal is rotated so that the carrier 
+ * lands on the real axis and the in-phase component is the audio. No 
+ * magnitude is computed per sample, so there is no square root in the loop 
+ * and the selective fading of the carrier does not distort the audio the way 
+ * it does with the envelope detector.
+ */
+
+#include "assert.h"
+#include "compiler.h"
+#include "config.h"
+#include "err.h"
+#include "dsp/biquad.h"
+#include "radio/demod_sam.h"
+#include "util/elems.h"
+#include "util/fp.h"
+#include "util/minmax.h"
+
+/* conversion factor between Hz and radians per sample */
+#define DEMODSAM_HZ_TO_RAD              (2 * fp_PI / BB_SAMPLING_RATE)
+/* loop damping factor */
+#define DEMODSAM_ZETA                   0.707f
+/* normalized loop natural frequency (radians per sample) */
+#define DEMODSAM_WN                     (DEMODSAM_PLL_FN * DEMODSAM_HZ_TO_RAD)
+/* smoothing factor of the lock detector (per block) */
+#define DEMODSAM_LOCK_ALPHA             0.25f
+/* coherent carrier level (relative to the rms of the signal) above which the 
+ * lock is declared and below which it is lost */
+#define DEMODSAM_LOCK_ON                0.5f
+#define DEMODSAM_LOCK_OFF               0.3f
+/* maximal ratio of the quadrature and in-phase carrier components for the 
+ * lock to be declared (tan of the phase error, ~20deg) */
+#define DEMODSAM_LOCK_PHASE             0.35f
+
+/* am demodulation output high pass filter (for removing the carrier) 
+ * (highpass, f_c = 30Hz @ 48ksps) */
+static const biquad_taps_t hpf_taps[] = {
+    { .b0 = +9.972270e-01, .b1 = -1.994454e+00, .b2 = +9.972270e-01, 
+      .a1 = -1.994446e+00, .a2 = +9.944618e-01 },
+};
+/* output high pass filter */
+static biquad_t hpf[] = { { .taps = &hpf_taps[0] } };
+
+/* loop filter gains: proportional and integral */
+static const float kp = 2 * DEMODSAM_ZETA * DEMODSAM_WN;
+static const float ki = DEMODSAM_WN * DEMODSAM_WN;
+/* frequency limit in radians per sample */
+static const float w_max = DEMODSAM_MAX_OFFSET * DEMODSAM_HZ_TO_RAD;
+
+/* oscillator phasor (cosine and sine of the phase) */
+static float osc_c = 1.0f, osc_s;
+/* oscillator frequency in radians per sample (loop filter integrator) */
+static float osc_w;
+/* inverse of the signal amplitude, normalizes the phase detector gain */
+static float inv_amp;
+/* coherent (carrier) components normalized to the signal amplitude */
+static float car_i, car_q;
+/* lock indicator */
+static int locked;
+
+/* reset the pll */
+void DemodSAM_Reset(void)
+{
+    /* oscillator */
+    osc_c = 1.0f, osc_s = 0, osc_w = 0;
+    /* detectors */
+    inv_amp = 0, car_i = 0, car_q = 0, locked = 0;
+    /* output filter */
+    for (int k = 0; k < (int)elems(hpf); k++)
+        BiQuad_SetTaps(&hpf[k], 0);
+}
+
+/* demodulation routine */
+void OPTIMIZE("O3") LOOP_UNROLL DemodSAM_Demodulate(const float *i, 
+    const float *q, int num, float *out)
+{
+    /* local copies of the loop state */
+    float c = osc_c, s = osc_s, w = osc_w, ia = inv_amp;
+    /* sums of the coherent components and of the signal power */
+    float sum_i = 0, sum_q = 0, pwr = 0;
+
+    /* process all samples */
+    for (int n = 0; n < num; n++) {
+        /* input values */
+        float x_i = i[n], x_q = q[n];
+        /* bring the carrier to dc: multiply by the conjugate of the 
+         * oscillator */
+        float y_i = x_i * c + x_q * s, y_q = x_q * c - x_i * s;
+        /* phase error (sine of it, normalized) */
+        float e = y_q * ia;
+        /* loop filter */
+        w += ki * e; float d = w + kp * e;
+        /* advance the oscillator: multiply by exp(j * d) approximated with 
+         * (1 - d^2 / 2) + j * d, the loop takes care of the residual phase 
+         * error, magnitude grows by d^4 / 8 per sample at most */
+        float r = 1.0f - 0.5f * d * d, c1 = c * r - s * d;
+        s = s * r + c * d, c = c1;
+        /* coherent detection: in-phase component is the audio */
+        out[n] = y_i;
+        /* accumulate the statistics */
+        sum_i += y_i, sum_q += y_q, pwr += x_i * x_i + x_q * x_q;
+    }
+
+    /* keep the oscillator magnitude at unity (one newton step for 1/sqrt 
+     * per block is enough) */
+    float g = 1.5f - 0.5f * (c * c + s * s);
+    c *= g, s *= g;
+    /* limit the tracking range */
+    w = min(max(w, -w_max), w_max);
+    /* amplitude estimate for the next block: one square root per block */
+    float amp = fp_sqrt(pwr / num);
+    ia = amp > fp_EPSILON ? 1.0f / amp : 0;
+    /* smoothed coherent carrier components */
+    car_i += DEMODSAM_LOCK_ALPHA * (sum_i * ia / num - car_i);
+    car_q += DEMODSAM_LOCK_ALPHA * (sum_q * ia / num - car_q);
+    /* lock detection with hysteresis */
+    locked = locked ? car_i > DEMODSAM_LOCK_OFF : 
+        car_i > DEMODSAM_LOCK_ON && fp_fabs(car_q) < 
+        DEMODSAM_LOCK_PHASE * car_i;
+
+    /* store the state */
+    osc_c = c, osc_s = s, osc_w = w, inv_amp = ia;
+
+    /* remove the carrier */
+    for (int k = 0; k < (int)elems(hpf); k++)
+        BiQuad_Filter(out, num, &hpf[k], out);
+}
+
+/* get the lock status */
+int DemodSAM_IsLocked(void)
+{
+    /* report the status */
+    return locked;
+}
+
+/* get the oscillator frequency */
+float DemodSAM_GetFrequency(void)
+{
+    /* convert to Hz */
+    return osc_w / (float)DEMODSAM_HZ_TO_RAD;
+}
+
+/* shift the oscillator frequency */
+void DemodSAM_ShiftFrequency(float hz)
+{
+    /* convert to radians per sample */
+    osc_w += hz * (float)DEMODSAM_HZ_TO_RAD;
+}
@@ -0,0 +1,126 @@
+/**
+ * @file demod_ssb.c
+ * 
+ * @date 2026-10-17
+ * @author twatorowski 
+ * 
+ * @brief Demodulate SSB signal using the Weaver method: the center of the 
+ * audio band (1500Hz) of the selected sideband is shifted to dc, low pass 
+ * filter (f_c = 1350Hz) removes the other sideband and the data is shifted 
+ * back to produce the audio in the 150Hz - 2850Hz range.
+ */
+
+#include "assert.h"
+#include "compiler.h"
+#include "config.h"
+#include "err.h"
+#include "dsp/biquad.h"
+#include "radio/demod_ssb.h"
+#include "util/elems.h"
+
+/* weaver oscillator period in samples (1500Hz @ 48ksps) */
+#define DEMODSSB_LO_PERIOD                              32
+
+/* cosine look up table for the weaver oscillator, one full period */
+static const float cos_lut[DEMODSSB_LO_PERIOD] = {
+    +1.000000e+00, +9.807853e-01, +9.238795e-01, +8.314696e-01,
+    +7.071068e-01, +5.555702e-01, +3.826834e-01, +1.950903e-01,
+    +0.000000e+00, -1.950903e-01, -3.826834e-01, -5.555702e-01,
+    -7.071068e-01, -8.314696e-01, -9.238795e-01, -9.807853e-01,
+    -1.000000e+00, -9.807853e-01, -9.238795e-01, -8.314696e-01,
+    -7.071068e-01, -5.555702e-01, -3.826834e-01, -1.950903e-01,
+    +0.000000e+00, +1.950903e-01, +3.826834e-01, +5.555702e-01,
+    +7.071068e-01, +8.314696e-01, +9.238795e-01, +9.807853e-01,
+};
+
+/* sideband selection low pass filter (elliptic, 7th order, 0.5dB ripple, 
+ * 60dB attenuation, f_c = 1350Hz @ 48ksps) */
+static const biquad_taps_t lpf_taps[] = {
+    { .b0 = +5.560708e-04, .b1 = +5.560708e-04, .b2 = +0.000000e+00,
+      .a1 = -9.417278e-01, .a2 = +0.000000e+00 },
+    { .b0 = +1.000000e+00, .b1 = -1.841668e+00, .b2 = +1.000000e+00,
+      .a1 = -1.902929e+00, .a2 = +9.146003e-01 },
+    { .b0 = +1.000000e+00, .b1 = -1.937418e+00, .b2 = +1.000000e+00,
+      .a1 = -1.934897e+00, .a2 = +9.594662e-01 },
+    { .b0 = +1.000000e+00, .b1 = -1.952514e+00, .b2 = +1.000000e+00,
+      .a1 = -1.957826e+00, .a2 = +9.891405e-01 },
+};
+
+/* low-pass filters */
+static biquad_t lpf_i[] = { 
+    { .taps = &lpf_taps[0] }, { .taps = &lpf_taps[1] }, 
+    { .taps = &lpf_taps[2] }, { .taps = &lpf_taps[3] } 
+};
+static biquad_t lpf_q[] = { 
+    { .taps = &lpf_taps[0] }, { .taps = &lpf_taps[1] }, 
+    { .taps = &lpf_taps[2] }, { .taps = &lpf_taps[3] } 
+};
+
+/* sign of the oscillator's sine: +1 for usb, -1 for lsb */
+static float lo_sign = 1.0f;
+/* oscillator phase (index within the look up table) */
+static int lo_phase;
+
+/* select the sideband */
+int DemodSSB_SetSideband(int sideband)
+{
+    /* the oscillator table was prepared for this sampling rate */
+    assert(BB_SAMPLING_RATE == 48000, "unsupported sampling rate", 
+        BB_SAMPLING_RATE);
+    /* sanity check */
+    if (sideband != DEMODSSB_USB && sideband != DEMODSSB_LSB)
+        return EFATAL;
+
+    /* lower sideband is obtained by mirroring the spectrum */
+    lo_sign = sideband == DEMODSSB_USB ? 1.0f : -1.0f;
+    /* reset the filters */
+    for (int k = 0; k < (int)elems(lpf_i); k++)
+        BiQuad_SetTaps(&lpf_i[k], 0), BiQuad_SetTaps(&lpf_q[k], 0);
+
+    /* report status */
+    return EOK;
+}
+
+/* sideband selection filter */
+void OPTIMIZE("O3") LOOP_UNROLL DemodSSB_Filter(const float *i, 
+    const float *q, int num, float *i_out, float *q_out)
+{
+    /* oscillator phase and the sign */
+    int ph = lo_phase; float sg = lo_sign;
+
+    /* shift down: multiply by exp(-j * sg * w * n) */
+    for (int n = 0; n < num; n++, ph = (ph + 1) % DEMODSSB_LO_PERIOD) {
+        /* oscillator values, sine is the cosine delayed by quarter period */
+        float c = cos_lut[ph], s = sg * cos_lut[(ph - DEMODSSB_LO_PERIOD / 4) & 
+            (DEMODSSB_LO_PERIOD - 1)];
+        /* input values */
+        float x_i = i[n], x_q = q[n];
+        /* complex multiplication */
+        i_out[n] = x_i * c + x_q * s;
+        q_out[n] = x_q * c - x_i * s;
+    }
+
+    /* remove the unwanted sideband */
+    BiQuad_FilterCascadeIQ(i_out, q_out, num, lpf_i, lpf_q, elems(lpf_i), 
+        i_out, q_out);
+}
+
+/* demodulation routine */
+void OPTIMIZE("O3") LOOP_UNROLL DemodSSB_Demodulate(const float *i, 
+    const float *q, int num, float *out)
+{
+    /* oscillator phase and the sign */
+    int ph = lo_phase; float sg = lo_sign;
+
+    /* shift up: real part of the product with exp(j * sg * w * n) */
+    for (int n = 0; n < num; n++, ph = (ph + 1) % DEMODSSB_LO_PERIOD) {
+        /* oscillator values */
+        float c = cos_lut[ph], s = sg * cos_lut[(ph - DEMODSSB_LO_PERIOD / 4) & 
+            (DEMODSSB_LO_PERIOD - 1)];
+        /* real part of the complex multiplication */
+        out[n] = i[n] * c - q[n] * s;
+    }
+
+    /* store the phase for the next block */
+    lo_phase = ph;
+}
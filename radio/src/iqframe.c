@@ -0,0 +1,166 @@
+/**
+ * @file iqframe.c
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Binary framing of the iq samples. The block exponent is chosen so 
+ * that the largest sample of the frame uses the whole mantissa range, so 
+ * the 8-bit mantissas keep about 42dB of the dynamic range below the 
+ * strongest sample of the frame and the 16-bit ones about 90dB, whatever the 
+ * signal level is.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "compiler.h"
+#include "config.h"
+#include "err.h"
+#include "arch/arch.h"
+#include "cobs/cobs.h"
+#include "radio/iqframe.h"
+#include "util/fp.h"
+#include "util/minmax.h"
+
+/* lowest block exponent (quieter frames are coded with the mantissas that 
+ * do not use the full range) */
+#define IQFRAME_MIN_EXP                     -100
+
+/* crc-16/ccitt-false lookup table (for every nibble) */
+static const uint16_t crc_tab[16] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50a5, 0x60c6, 0x70e7,
+    0x8108, 0x9129, 0xa14a, 0xb16b, 0xc18c, 0xd1ad, 0xe1ce, 0xf1ef,
+};
+
+/* compute the crc over the data */
+static uint16_t IQFrame_CRC(const uint8_t *ptr, size_t size)
+{
+    /* initial value */
+    uint16_t crc = 0xffff;
+
+    /* process the data nibble by nibble, msb first */
+    for (size_t k = 0; k < size; k++) {
+        crc = (crc << 4) ^ crc_tab[(crc >> 12) ^ (ptr[k] >> 4)];
+        crc = (crc << 4) ^ crc_tab[(crc >> 12) ^ (ptr[k] & 0xf)];
+    }
+
+    /* return the crc */
+    return crc;
+}
+
+/* number of bytes per mantissa */
+static int IQFrame_GetSampleSize(int format)
+{
+    /* sample format */
+    switch (format) {
+    case IQFRAME_FMT_S16 : return 2;
+    case IQFRAME_FMT_S8 : return 1;
+    }
+    /* unsupported format */
+    return EFATAL;
+}
+
+/* get the maximal number of the iq pairs that fit within the frame */
+int IQFrame_GetMaxSamples(int format, size_t size)
+{
+    /* bytes per mantissa */
+    int bytes = IQFrame_GetSampleSize(format);
+    /* sanity check */
+    if (bytes < 0)
+        return EFATAL;
+
+    /* largest frame that is supported */
+    size = min(size, (size_t)IQFRAME_MAX_SIZE);
+    /* largest number of the pairs */
+    int num = size / (2 * bytes);
+    /* go down until the encoded frame fits */
+    for (; num > 0 && IQFRAME_ENCODED_SIZE(num * 2 * bytes) > size; num--);
+    /* return the number of pairs */
+    return num;
+}
+
+/* encode the iq samples into the frame */
+int IQFrame_Encode(int format, uint16_t seq, uint32_t dropped, 
+    const float *iq, int num, void *out, size_t size)
+{
+    /* frame before the encoding */
+    uint8_t raw[IQFRAME_MAX_SIZE];
+    /* bytes per mantissa */
+    int bytes = IQFrame_GetSampleSize(format);
+    /* size of the frame before the encoding */
+    size_t raw_size = sizeof(iqframe_hdr_t) + num * 2 * bytes + 
+        IQFRAME_CRC_SIZE;
+    /* output pointer */
+    uint8_t *outp = out;
+
+    /* sanity check */
+    if (bytes < 0 || num < 0 || raw_size > sizeof(raw) || size < 2)
+        return EFATAL;
+
+    /* largest magnitude within the block */
+    float m = 0;
+    for (int k = 0; k < 2 * num; k++)
+        m = max(m, fp_fabs(iq[k]));
+    /* block exponent: the largest magnitude is below 2^e */
+    int e; frexpf(m, &e);
+    int exp = max(e - (8 * bytes - 1), IQFRAME_MIN_EXP);
+    /* scaling of the samples */
+    float scale = ldexpf(1, -exp);
+
+    /* header */
+    iqframe_hdr_t hdr = { .format = format, .exp = exp, .seq = seq, 
+        .num = num, .dropped = dropped };
+    memcpy(raw, &hdr, sizeof(hdr));
+    /* mantissas (little endian, rounded and saturated) */
+    uint8_t *p = raw + sizeof(hdr);
+    for (int k = 0; k < 2 * num; k++) {
+        int32_t v = Arch_SSAT((int32_t)fp_round(iq[k] * scale), 8 * bytes);
+        *p++ = v;
+        if (bytes == 2)
+            *p++ = v >> 8;
+    }
+    /* crc */
+    uint16_t crc = IQFrame_CRC(raw, p - raw);
+    *p++ = crc, *p++ = crc >> 8;
+
+    /* encode between the delimiters */
+    int len = COBS_Encode(raw, raw_size, outp + 1, size - 2);
+    if (len < 0)
+        return EFATAL;
+    outp[0] = outp[len + 1] = IQFRAME_DELIM;
+    /* return the size of the frame */
+    return len + 2;
+}
+
+/* decode the frame */
+int IQFrame_Decode(void *in, size_t in_size, iqframe_hdr_t *hdr, float *iq)
+{
+    /* decode in-situ */
+    int size = COBS_Decode(in, in_size, in, in_size);
+    /* frame must hold the header and the crc */
+    if (size < (int)(sizeof(*hdr) + IQFRAME_CRC_SIZE))
+        return EFATAL;
+
+    /* check the crc */
+    uint8_t *raw = in; size -= IQFRAME_CRC_SIZE;
+    if (IQFrame_CRC(raw, size) != (raw[size] | raw[size + 1] << 8))
+        return EFATAL;
+    /* validate the header */
+    memcpy(hdr, raw, sizeof(*hdr));
+    int bytes = IQFrame_GetSampleSize(hdr->format);
+    if (bytes < 0 || size != (int)sizeof(*hdr) + hdr->num * 2 * bytes)
+        return EFATAL;
+
+    /* scaling of the mantissas */
+    float scale = ldexpf(1, hdr->exp);
+    /* unpack the samples */
+    const uint8_t *p = raw + sizeof(*hdr);
+    for (int k = 0; k < 2 * hdr->num; k++, p += bytes)
+        iq[k] = (bytes == 2 ? (int16_t)(p[0] | p[1] << 8) : (int8_t)p[0]) * 
+            scale;
+
+    /* return the number of pairs */
+    return hdr->num;
+}
@@ -0,0 +1,174 @@
+/**
+ * @file meter.c
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Signal meter and squelch. The baseband data is cut into METER_SIZE
+ * samples long blocks, every block is hann-windowed and transformed. The
+ * center bin (BB_SAMPLING_RATE / METER_SIZE wide) holds the channel, the
+ * bins a quarter of the band away from it on both sides are far enough for
+ * the modulation not to leak into them (hann side lobes) and close enough
+ * to the center for the decimator droop not to matter much (about 1dB with
+ * the default settings), these measure the noise. Powers are averaged over
+ * time, the noise floor is the quieter of the noise bins so that the
+ * adjacent station on one side does not lift it up. All the bins have the
+ * same bandwidth, so their ratio is the snr.
+ */
+
+#include "compiler.h"
+#include "config.h"
+#include "err.h"
+#include "dsp/fft.h"
+#include "radio/meter.h"
+#include "util/elems.h"
+#include "util/fp.h"
+#include "util/minmax.h"
+
+/* bins that measure the noise */
+static const int noise_bins[] = { METER_SIZE / 4, METER_SIZE * 3 / 4 };
+
+/* dft window */
+static float window[METER_SIZE];
+/* per-block averaging coefficients for the channel and the noise */
+static float k_chan, k_noise;
+/* averaged powers, number of blocks processed */
+static float chan_pwr, noise_pwr[elems(noise_bins)];
+static int blocks;
+
+/* squelch thresholds (power ratios for opening and closing, 0 - disabled) */
+static volatile float sq_open, sq_close, sq_snr;
+/* squelch state, samples left till it closes */
+static volatile int sq_state;
+static int sq_hang;
+
+/* published measurements (linear) */
+static volatile float status_chan, status_noise;
+
+/* initialize the meter */
+int Meter_Init(void)
+{
+    /* channel needs to be made of whole samples */
+    if (METER_SIZE > FFT_MAX_SIZE || METER_SIZE < 8)
+        return EFATAL;
+
+    /* prepare the window */
+    for (int n = 0; n < METER_SIZE; n++)
+        window[n] = 0.5f - 0.5f * fp_cos(2 * fp_PI * n / METER_SIZE);
+    /* averaging coefficients: 1 - exp(-block / (t * fs)) */
+    k_chan = 1 - fp_exp(-METER_SIZE * 1000.0f /
+        (METER_TIME * BB_SAMPLING_RATE));
+    k_noise = 1 - fp_exp(-METER_SIZE * 1000.0f /
+        (METER_FLOOR_TIME * BB_SAMPLING_RATE));
+    /* start over */
+    Meter_Reset(); sq_state = 1, sq_hang = 0;
+
+    /* squelch is disabled */
+    return Meter_SetSquelch(0);
+}
+
+/* start the averaging anew */
+void Meter_Reset(void)
+{
+    /* first block initializes the averages */
+    blocks = 0, chan_pwr = 0;
+    for (int m = 0; m < (int)elems(noise_bins); m++)
+        noise_pwr[m] = 0;
+}
+
+/* measure the samples */
+int OPTIMIZE("O3") Meter_Process(const float *i, const float *q, int num)
+{
+    /* transform buffers */
+    float re[METER_SIZE], im[METER_SIZE];
+    /* local copies of the state */
+    float chan = chan_pwr;
+    /* averaging coefficients */
+    float kc, kn;
+
+    /* process all blocks */
+    for (int b = 0; b + METER_SIZE <= num; b += METER_SIZE, blocks++) {
+        /* apply the window */
+        for (int n = 0; n < METER_SIZE; n++)
+            re[n] = i[b + n] * window[n], im[n] = q[b + n] * window[n];
+        /* do the transform */
+        FFT_Float(re, im, METER_SIZE);
+
+        /* plain mean of all the blocks until there is enough of them for 
+         * the exponential averaging */
+        kc = blocks < 1 / k_chan ? 1.0f / (blocks + 1) : k_chan;
+        kn = blocks < 1 / k_noise ? 1.0f / (blocks + 1) : k_noise;
+        /* channel power */
+        float p = fp_sq(re[0]) + fp_sq(im[0]);
+        chan += kc * (p - chan);
+        /* noise */
+        for (int m = 0; m < (int)elems(noise_bins); m++) {
+            int k = noise_bins[m];
+            p = fp_sq(re[k]) + fp_sq(im[k]);
+            noise_pwr[m] += kn * (p - noise_pwr[m]);
+        }
+    }
+
+    /* noise floor is the quietest of the noise bins */
+    float noise = noise_pwr[0];
+    for (int m = 1; m < (int)elems(noise_bins); m++)
+        noise = min(noise, noise_pwr[m]);
+    /* store and publish */
+    chan_pwr = chan, status_chan = chan, status_noise = noise;
+
+    /* squelch is disabled */
+    if (sq_open == 0) {
+        sq_state = 1;
+    /* above the threshold (the lower one when already open) */
+    } else if (chan >= (sq_state ? sq_close : sq_open) * noise) {
+        sq_state = 1, sq_hang = SQUELCH_HANG * BB_SAMPLING_RATE / 1000;
+    /* below it: close after the hang time */
+    } else if ((sq_hang -= num) <= 0) {
+        sq_state = 0, sq_hang = 0;
+    }
+
+    /* report the squelch state */
+    return sq_state;
+}
+
+/* set the squelch threshold */
+int Meter_SetSquelch(float snr)
+{
+    /* sanity check */
+    if (snr < 0 || snr > METER_MAX_SQUELCH)
+        return EFATAL;
+
+    /* power ratios: 10 ^ (snr / 10) */
+    sq_close = snr ? fp_pow(10.0f, (snr - SQUELCH_HYSTERESIS) / 10) : 0;
+    sq_open = snr ? fp_pow(10.0f, snr / 10) : 0;
+    sq_snr = snr;
+
+    /* report status */
+    return EOK;
+}
+
+/* get the squelch settings and state */
+int Meter_GetSquelch(float *snr, int *open)
+{
+    /* report the values */
+    if (snr)
+        *snr = sq_snr;
+    if (open)
+        *open = sq_state;
+    /* report status */
+    return EOK;
+}
+
+/* get the measurements */
+int Meter_GetLevels(float *rssi, float *floor)
+{
+    /* full scale complex tone at dc ends up in the center bin multiplied by
+     * the window sum (METER_SIZE / 2) */
+    const float ref = fp_sq(METER_SIZE / 2.0f);
+    /* 10 * log10(x) with the natural logarithm, avoid the log of zero */
+    *rssi = 10 / 2.302585093f * fp_log(max(status_chan / ref, 1e-20f));
+    *floor = 10 / 2.302585093f * fp_log(max(status_noise / ref, 1e-20f));
+
+    /* report status */
+    return EOK;
+}
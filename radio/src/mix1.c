@@ -4,7 +4,11 @@
  * @date 2020-01-13
  * @author twatorowski 
  * 
- * @brief 1st stage mixer
+ * @brief 1st stage mixer with the noise blanker. Mixing kernels compute the 
+ * energy of every pair of the rf samples along the way (single dual multiply 
+ * per pair in the packed kernel) and report the block sum and the peak. Only 
+ * when the peak goes above the threshold the block is scanned again for the 
+ * impulses, otherwise the sum just updates the average.
  */
 
 #include <stdint.h>
@@ -13,9 +17,12 @@
 #include "compiler.h"
 #include "config.h"
 #include "err.h"
+#include "arch/arch.h"
+#include "radio/mix1.h"
 #include "sys/critical.h"
 #include "util/elems.h"
 #include "util/fp.h"
+#include "util/minmax.h"
 
 #define DEBUG
 #include "debug.h"
@@ -67,18 +74,59 @@ static const int32_t cos_lut[] = {
     +0x3f364928, +0x3f7ecea9, +0x3fb74988, +0x3fdfab80, +0x3ff7ea5d,
 };
 
-/* 1st local oscillator look-up table (subsampled sine lut values) */
-static int32_t i_lut[elems(cos_lut)], q_lut[elems(cos_lut)];
-/* currently set band, currently used band */
-static int set_band, curr_band = 25;
+/* number of fractional bits in the local oscillator tables: Q14 makes the 
+ * +/-1.0 representable within the 16-bit word */
+#define MIX1_LUT_BITS                   14
+/* normalization shift that is applied to the products so that the mixer 
+ * output fills DEC_MAX_INPUT_BITS bits */
+#define MIX1_BSHIFT                     (MIX1_LUT_BITS - \
+    (DEC_MAX_INPUT_BITS - RF_SAMPLING_BITS))
 
-/* update mixing arrays according to current band selection */
-static void LOOP_UNROLL OPTIMIZE("O3") Mix1_UpdateArrays(int band)
+/* 1st local oscillator look-up tables (subsampled sine lut values). Tables 
+ * are 16-bit wide so that the packed kernel can fetch two entries at once */
+typedef struct mix1_lut {
+    /* in-phase and quadrature components */
+    int16_t i[elems(cos_lut)], q[elems(cos_lut)];
+} ALIGNED(4) mix1_lut_t;
+
+/* two 16-bit samples packed in a single word (bottom half holds the sample 
+ * with the lower index) */
+typedef uint32_t MAY_ALIAS mix1_pair_t;
+
+/* noise blanker state */
+typedef struct mix1_nb {
+    /* average energy of the sample pair (Q4), 0 - not known yet */
+    uint32_t avg;
+    /* number of samples that are yet to be blanked at the beginning of the 
+     * next block, index (within the frame) of the first sample past the 
+     * blanked ones */
+    int left, upto;
+    /* number of samples blanked so far */
+    uint32_t blanked;
+} mix1_nb_t;
+
+/* double buffered tables: one is used by the mixer while the other one gets 
+ * rebuilt during the re-tuning */
+static mix1_lut_t luts[2];
+/* tables that are currently used by the mixer */
+static const mix1_lut_t * volatile curr_lut = &luts[0];
+/* currently used band, -1 forces the rebuild during the first tuning */
+static int curr_band = -1;
+
+/* noise blanker threshold: energy ratio in Q8 (0 - disabled) and in dB */
+static volatile uint32_t nb_ratio;
+static float nb_threshold;
+/* blanker state for the selected kernel and for the reference one */
+static mix1_nb_t nb, nb_ref;
+
+/* update mixing arrays according to given band selection */
+static void LOOP_UNROLL OPTIMIZE("O3") Mix1_UpdateArrays(int band, 
+    mix1_lut_t *lut)
 {
     /* index counters */
     int i_cnt = 0, q_cnt = elems(cos_lut) / 4;
-    /* number of bits to be shifted */
-    const int bits = RF_SAMPLING_BITS;
+    /* number of bits to be shifted (cos_lut is in Q30) */
+    const int bits = 30 - MIX1_LUT_BITS;
     /* rounding factor to be added before truncation */
     const int32_t rounding_f = 1 << (bits - 1);
 
@@ -89,8 +137,8 @@ static void LOOP_UNROLL OPTIMIZE("O3") Mix1_UpdateArrays(int band)
      * the positive frequencies down to near DC. */
     for (int i = 0; i < elems(cos_lut); i++) {
         /* write another entry */
-        i_lut[i] = (cos_lut[i_cnt] + rounding_f) >> bits;  
-        q_lut[i] = (cos_lut[q_cnt] + rounding_f) >> bits;
+        lut->i[i] = (cos_lut[i_cnt] + rounding_f) >> bits;  
+        lut->q[i] = (cos_lut[q_cnt] + rounding_f) >> bits;
         /* increment the coutners and wrap around if needed */
         if ((i_cnt += band) >= elems(cos_lut)) i_cnt -= elems(cos_lut);
         if ((q_cnt += band) >= elems(cos_lut)) q_cnt -= elems(cos_lut);
@@ -98,25 +146,153 @@ static void LOOP_UNROLL OPTIMIZE("O3") Mix1_UpdateArrays(int band)
 }
 
 /* mix the rf signal with the local oscillator, rf is assumed to be of length 
- * equal to the length of the local oscillator lut */
-static void LOOP_UNROLL OPTIMIZE("O3") Mix1_Iter(const int16_t * restrict rf, 
-    int16_t * restrict i, int16_t * restrict q)
+ * equal to the length of the local oscillator lut. This is the reference 
+ * (scalar) implementation. Returns the peak energy of the sample pairs, the 
+ * sum of the energies is stored under 'sum' */
+static uint32_t LOOP_UNROLL OPTIMIZE("O3") Mix1_IterScalar(
+    const int16_t * restrict rf, const mix1_lut_t * restrict lut, 
+    int16_t * restrict i, int16_t * restrict q, uint32_t *sum)
 {
     /* mix the incoming signals with the complex local oscillator. the lo lut 
-     * entries are prepared in such a way that the multiplication results in 
-     * 31 bit word thus leaving some space for the rounding factor. See the 
-     * Mix1_SetLOFrequency function for the details. We need to add the rounding 
-     * term before the bit shift otherwise a DC shift will be introduced which 
-     * then will be convertoed to a tone by 2nd stage mixing. This is obviously 
-     * undesirable */
-    const int bshift = 31 - DEC_MAX_INPUT_BITS - 1;
+     * entries are Q14 numbers so the product of the 12-bit rf sample and the 
+     * lut entry easily fits within the 32-bit word together with the 
+     * rounding factor. We need to add the rounding term before the bit shift 
+     * otherwise a DC shift will be introduced which then will be convertoed 
+     * to a tone by 2nd stage mixing. This is obviously undesirable */
+    const int bshift = MIX1_BSHIFT;
     /* rounding factor */
-    const uint32_t rounding_f = 1 << (bshift - 1);
+    const int32_t rounding_f = 1 << (bshift - 1);
+
+    /* energy of the current pair, peak and the sum */
+    uint32_t e = 0, peak = 0, s = 0;
 
     /* do the actual mixing, normalize by rounding and shifting */
-    for (int cnt = 0; cnt < elems(i_lut); cnt++) {
-        i[cnt] = ((int32_t)rf[cnt] * i_lut[cnt] + rounding_f) >> bshift;
-        q[cnt] = ((int32_t)rf[cnt] * q_lut[cnt] + rounding_f) >> bshift;
+    for (int cnt = 0; cnt < elems(lut->i); cnt++) {
+        i[cnt] = ((int32_t)rf[cnt] * lut->i[cnt] + rounding_f) >> bshift;
+        q[cnt] = ((int32_t)rf[cnt] * lut->q[cnt] + rounding_f) >> bshift;
+        /* pair is complete: update the statistics */
+        e += (int32_t)rf[cnt] * rf[cnt];
+        if (cnt & 1)
+            s += e, peak = max(peak, e), e = 0;
+    }
+
+    /* report the statistics */
+    return *sum = s, peak;
+}
+
+/* packed version of the mixer: processes two samples at once using the dual 
+ * 16-bit multiply-accumulate instructions. Produces exactly the same results 
+ * as the scalar version. All pointers must be word aligned */
+static uint32_t LOOP_UNROLL OPTIMIZE("O3") Mix1_IterPacked(
+    const int16_t * restrict rf, const mix1_lut_t * restrict lut, 
+    int16_t * restrict i, int16_t * restrict q, uint32_t *sum)
+{
+    /* same normalization as in the scalar version */
+    const int bshift = MIX1_BSHIFT;
+    /* rounding factor */
+    const int32_t rounding_f = 1 << (bshift - 1);
+
+    /* packed views on the data */
+    const mix1_pair_t *rf2 = (const mix1_pair_t *)rf;
+    const mix1_pair_t *i_lut2 = (const mix1_pair_t *)lut->i;
+    const mix1_pair_t *q_lut2 = (const mix1_pair_t *)lut->q;
+    mix1_pair_t *i2 = (mix1_pair_t *)i, *q2 = (mix1_pair_t *)q;
+    /* peak energy of the sample pairs and the sum */
+    uint32_t peak = 0, s = 0;
+
+    /* two samples per iteration */
+    for (int cnt = 0; cnt < elems(lut->i) / 2; cnt++) {
+        /* fetch two samples and two entries of each lut with single loads */
+        uint32_t x = rf2[cnt], li = i_lut2[cnt], lq = q_lut2[cnt];
+        /* multiply both halves, the rounding factor goes in as the 
+         * accumulator */
+        int32_t i0 = Arch_SMLABB(x, li, rounding_f);
+        int32_t i1 = Arch_SMLATT(x, li, rounding_f);
+        int32_t q0 = Arch_SMLABB(x, lq, rounding_f);
+        int32_t q1 = Arch_SMLATT(x, lq, rounding_f);
+        /* normalize and pack the results back, store both with single 
+         * writes */
+        i2[cnt] = Arch_PKHBT(i0 >> bshift, i1 >> bshift, 16);
+        q2[cnt] = Arch_PKHBT(q0 >> bshift, q1 >> bshift, 16);
+        /* energy of the pair with a single dual multiply */
+        uint32_t e = Arch_SMUAD(x, x);
+        s += e, peak = max(peak, e);
+    }
+
+    /* report the statistics */
+    return *sum = s, peak;
+}
+
+/* noise blanker: 'rf', 'i' and 'q' point to the beginning of the frame, 
+ * 'offs' is the offset of the block that was just mixed, 'peak' and 'sum' are 
+ * the statistics reported by the kernel */
+static void Mix1_Blank(mix1_nb_t *nb, const int16_t *rf, int16_t *i, 
+    int16_t *q, int offs, uint32_t peak, uint32_t sum)
+{
+    /* number of sample pairs within the block */
+    const int pairs = elems(cos_lut) / 2;
+    /* block end */
+    const int end = offs + elems(cos_lut);
+    /* mean energy of the pair (Q4, the sum itself may use all 32 bits) */
+    uint32_t mean = (sum / pairs << 4) + (sum % pairs << 4) / pairs;
+    /* threshold as the energy ratio */
+    uint32_t ratio = nb_ratio;
+    /* impulse threshold (in the same units as the peak) */
+    uint64_t thr = ((uint64_t)nb->avg * ratio) >> 12;
+
+    /* previous block ended with an impulse */
+    if (nb->left) {
+        /* blank the beginning */
+        int to = offs + min(nb->left, (int)elems(cos_lut));
+        for (int n = offs; n < to; n++)
+            i[n] = q[n] = 0;
+        /* update the counters */
+        nb->left -= to - offs, nb->blanked += to - offs, nb->upto = to;
+    }
+
+    /* blanker disabled or the average is not known yet: follow the level */
+    if (!ratio || !nb->avg) {
+        nb->avg = mean;
+    /* no impulse: track the average */
+    } else if (peak <= thr) {
+        nb->avg += ((int32_t)(mean - nb->avg)) >> MIX1_NB_AVG_SHIFT;
+    /* some of the pairs are above the threshold */
+    } else {
+        /* energy and the number of the pairs that are below it */
+        uint32_t clean = 0; int clean_num = 0;
+        for (int n = offs; n < end; n += 2) {
+            uint32_t e = (int32_t)rf[n] * rf[n] + 
+                (int32_t)rf[n + 1] * rf[n + 1];
+            if (e <= thr)
+                clean += e, clean_num++;
+        }
+
+        /* most of the block is above: that is the level change, not an 
+         * impulse */
+        if (clean_num < pairs / 2) {
+            nb->avg = mean; return;
+        }
+        /* look for the impulses */
+        for (int n = offs; n < end; n += 2) {
+            /* regular pair */
+            if ((uint32_t)((int32_t)rf[n] * rf[n] + 
+                (int32_t)rf[n + 1] * rf[n + 1]) <= thr)
+                continue;
+            /* blank the pair and its surroundings (within the frame), skip 
+             * the samples that are blanked already */
+            int from = max(n - MIX1_NB_PRE, nb->upto);
+            int to = n + 2 + MIX1_NB_POST;
+            for (int k = from; k < min(to, end); k++)
+                i[k] = q[k] = 0;
+            /* update the counters, blanking may continue in the next 
+             * block */
+            nb->blanked += max(min(to, end) - from, 0);
+            nb->upto = max(nb->upto, min(to, end));
+            nb->left = max(to - end, 0);
+        }
+        /* update the average with the regular pairs only */
+        nb->avg += ((int32_t)(((uint64_t)clean << 4) / clean_num - 
+            nb->avg)) >> MIX1_NB_AVG_SHIFT;
     }
 }
 
@@ -127,12 +303,48 @@ void OPTIMIZE("O3") Mix1_Mix(const int16_t *rf, int num, int16_t *i, int16_t *q)
     assert(num % elems(cos_lut) == 0, 
         "number of samples not divisible by lut length", num);
     
-    /* update the arrays if the frequency setting has changed */
-    Mix1_UpdateArrays(set_band);
+    /* tables are fetched once per call so that the re-tuning cannot switch 
+     * them in the middle of the frame */
+    const mix1_lut_t *lut = curr_lut;
+
+    /* block statistics */
+    uint32_t peak, sum;
 
+    /* blanking cannot reach the previous frame */
+    nb.upto = 0;
     /* mix with local oscillator */
-    for (int cnt = 0; cnt < num; cnt += elems(cos_lut))
-        Mix1_Iter(rf + cnt, i + cnt, q + cnt);
+    for (int cnt = 0; cnt < num; cnt += elems(cos_lut)) {
+    #if MIX1_PACKED
+        peak = Mix1_IterPacked(rf + cnt, lut, i + cnt, q + cnt, &sum);
+    #else
+        peak = Mix1_IterScalar(rf + cnt, lut, i + cnt, q + cnt, &sum);
+    #endif
+        /* look for the impulses */
+        Mix1_Blank(&nb, rf, i, q, cnt, peak, sum);
+    }
+}
+
+/* mix using the reference implementation */
+void OPTIMIZE("O3") Mix1_MixRef(const int16_t *rf, int num, int16_t *i, 
+    int16_t *q)
+{
+    /* assert on the number of elements */
+    assert(num % elems(cos_lut) == 0, 
+        "number of samples not divisible by lut length", num);
+    
+    /* tables are fetched once per call */
+    const mix1_lut_t *lut = curr_lut;
+
+    /* block statistics */
+    uint32_t peak, sum;
+
+    /* blanking cannot reach the previous frame */
+    nb_ref.upto = 0;
+    /* mix with local oscillator */
+    for (int cnt = 0; cnt < num; cnt += elems(cos_lut)) {
+        peak = Mix1_IterScalar(rf + cnt, lut, i + cnt, q + cnt, &sum);
+        Mix1_Blank(&nb_ref, rf, i, q, cnt, peak, sum);
+    }
 }
 
 /* set the current lo frequency */
@@ -140,6 +352,9 @@ float Mix1_SetLOFrequency(float f)
 {
     /* determine band spacing that is offered by the local oscillator */
     const float band_spacing = (float)RF_SAMPLING_FREQ / elems(cos_lut);
+    /* published spacing must match the lut */
+    assert(elems(cos_lut) * MIX1_BAND_SPACING == RF_SAMPLING_FREQ, 
+        "band spacing mismatch", elems(cos_lut));
     /* get the actual band that we are about to select for the 1st lo */
     int band = fp_round(f / band_spacing);
     
@@ -147,8 +362,48 @@ float Mix1_SetLOFrequency(float f)
     assert(band >= 0 && band <= elems(cos_lut) / 2, 
         "unsupported band for mix1", band);
         
-    /* store current band */
-    set_band = band;
+    /* band has changed: rebuild the tables that are not in use (the mixer is 
+     * called from the interrupt that preempts this code, so it may only ever 
+     * observe the tables that were published) and then publish them with a 
+     * single pointer write */
+    if (band != curr_band) {
+        /* get the spare tables */
+        mix1_lut_t *lut = curr_lut == &luts[0] ? &luts[1] : &luts[0];
+        /* fill them */
+        Mix1_UpdateArrays(band, lut);
+        /* make sure that the contents are in place before the switch */
+        Arch_DSB();
+        /* swap the tables */
+        curr_lut = lut, curr_band = band;
+    }
+
     /* return the actual frequency */
     return band * band_spacing;
 }
+
+/* set the noise blanker threshold */
+int Mix1_SetBlanker(float threshold)
+{
+    /* sanity check */
+    if (threshold < 0 || threshold > MIX1_NB_MAX_THRESHOLD)
+        return EFATAL;
+
+    /* energy ratio: 10 ^ (threshold / 10) in Q8 */
+    nb_ratio = threshold ? fp_round(fp_pow(10.0f, threshold / 10) * 256) : 0;
+    nb_threshold = threshold;
+
+    /* report status */
+    return EOK;
+}
+
+/* get the noise blanker settings and statistics */
+int Mix1_GetBlanker(float *threshold, uint32_t *blanked)
+{
+    /* report the values */
+    if (threshold)
+        *threshold = nb_threshold;
+    if (blanked)
+        *blanked = nb.blanked;
+    /* report status */
+    return EOK;
+}
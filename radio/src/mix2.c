@@ -11,6 +11,7 @@
 #include "compiler.h"
 #include "config.h"
 #include "err.h"
+#include "arch/arch_fpu.h"
 #include "sys/critical.h"
 #include "util/elems.h"
 #include "util/fp.h"
@@ -278,47 +279,100 @@ static const float cos_lut[] = {
     +9.996988e-01, +9.998306e-01, +9.999247e-01, +9.999812e-01,
 };
 
-/* currently selected band */
-static int curr_band;
-/* phase accumulator */
-static unsigned int phase;
+/* number of bits of the phase accumulator that are used for addressing the 
+ * lut, lut length must be equal to 2^MIX2_LUT_BITS */
+#define MIX2_LUT_BITS                   10
+/* half of the lut step expressed in the phase accumulator units */
+#define MIX2_HALF_STEP                  (1UL << (31 - MIX2_LUT_BITS))
 
-/* mix the rf signal with the local oscillator, rf is assumed to be of length 
- * equal to the length of the local oscillator lut */
+/* phase increment per sample */
+static uint32_t phase_inc;
+/* phase accumulator: full period corresponds to 2^32. it is kept half of the
+ * lut step ahead so that truncating it to the lut index picks the nearest 
+ * entry */
+static uint32_t phase = MIX2_HALF_STEP;
+/* sampling rate of the data being mixed */
+static float rate = BB_SAMPLING_RATE;
+
+/* mix the signal with the local oscillator */
 void OPTIMIZE("O3") Mix2_Mix(const float *i, const float *q, 
     int num, float *i_out, float *q_out)
 {
     /* temporary storage */
     float _i, _q, i_lut, q_lut;
+    /* local copies of the oscillator state, lut index */
+    uint32_t ph = phase, inc = phase_inc, idx;
+
+    /* do the complex multiplication */
+    for (int cnt = 0; cnt < num; cnt++, ph += inc) {
+        /* lut index: top bits of the phase, which wraps around on its own */
+        idx = ph >> (32 - MIX2_LUT_BITS);
+        /* local oscillator: cos(ph) and cos(ph + pi/2) */
+        i_lut = cos_lut[idx];
+        q_lut = cos_lut[(idx + elems(cos_lut) / 4) & (elems(cos_lut) - 1)];
+        /* (a + bi) * (c + di) = (ac - bd) + i(ad + bc) */
+        _i = i[cnt] * i_lut - q[cnt] * q_lut;
+        _q = i[cnt] * q_lut + q[cnt] * i_lut;
+        /* using temporary registers allows for in-situ operation */
+        i_out[cnt] = _i, q_out[cnt] = _q;
+    }
+
+    /* store the phase */
+    phase = ph;
+}
+
+/* mix and store the results in Q31 format as well */
+void OPTIMIZE("O3") Mix2_MixFixp32(const float *i, const float *q, 
+    int num, float *i_out, float *q_out, int32_t *iq_out)
+{
+    /* temporary storage */
+    float _i, _q, i_lut, q_lut;
+    /* local copies of the oscillator state, lut index */
+    uint32_t ph = phase, inc = phase_inc, idx;
 
     /* do the complex multiplication */
-    for (int cnt = 0; cnt < num; cnt++, phase = (phase + curr_band) % elems(cos_lut)) {
-        /* lut entries */
-        i_lut = cos_lut[phase];
-        q_lut = cos_lut[(phase + elems(cos_lut) / 4) % elems(cos_lut)];
+    for (int cnt = 0; cnt < num; cnt++, ph += inc) {
+        /* lut index: top bits of the phase, which wraps around on its own */
+        idx = ph >> (32 - MIX2_LUT_BITS);
+        /* local oscillator: cos(ph) and cos(ph + pi/2) */
+        i_lut = cos_lut[idx];
+        q_lut = cos_lut[(idx + elems(cos_lut) / 4) & (elems(cos_lut) - 1)];
         /* (a + bi) * (c + di) = (ac - bd) + i(ad + bc) */
         _i = i[cnt] * i_lut - q[cnt] * q_lut;
         _q = i[cnt] * q_lut + q[cnt] * i_lut;
         /* using temporary registers allows for in-situ operation */
         i_out[cnt] = _i, q_out[cnt] = _q;
+        /* convert to fixed point (with saturation) and store interleaved */
+        iq_out[2 * cnt + 0] = Arch_VCVT_S32_F32(_i, 31);
+        iq_out[2 * cnt + 1] = Arch_VCVT_S32_F32(_q, 31);
     }
+
+    /* store the phase */
+    phase = ph;
 }
 
 /* set the current lo frequency */
 float Mix2_SetLOFrequency(float f)
 {
-    /* determine band spacing offered by the second lo */
-    const float band_spacing = (float)RF_SAMPLING_FREQ / DEC_DECIMATION_RATE / 
-        elems(cos_lut);
-    /* get the actual band */
-    int band = fp_round(f / band_spacing);
-
     /* sanity check */
-    assert(band > -(int)elems(cos_lut) / 2 && band <= (int)elems(cos_lut) / 2, 
-        "unsupported band for mix2", band);
+    assert(f >= -rate / 2 && f <= rate / 2, "unsupported frequency for mix2", 
+        f);
 
-    /* store current band */
-    curr_band = band;
+    /* phase increment: full period is 2^32. conversion goes through the 
+     * 64-bit integer as +fs/2 does not fit into the signed 32-bit word 
+     * (it becomes -fs/2 after the wrapping, which is the same thing for the 
+     * oscillator) */
+    uint32_t inc = (int64_t)fp_round(f / rate * 4294967296.0f);
+
+    /* store the increment */
+    phase_inc = inc;
     /* return the actual frequency */
-    return band * band_spacing;
-}
\ No newline at end of file
+    return (int32_t)inc * (rate / 4294967296.0f);
+}
+
+/* set the sampling rate */
+void Mix2_SetSamplingRate(float hz)
+{
+    /* the increment is computed from it by the next frequency setting */
+    rate = hz;
+}
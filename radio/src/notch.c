@@ -0,0 +1,130 @@
+/**
+ * @file notch.c
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Adaptive notch. The audio is decimated by 4 with the triangular
+ * (sinc^2) filter, the normalized lms predictor at the internal rate tries to
+ * guess every sample from the ones that are NOTCH_DECORRELATION samples older:
+ * only the steady tones can be predicted that way, so the prediction is the
+ * tone estimate. The estimate gets its droop (decimator and interpolator)
+ * corrected with the short equalizer, is interpolated back to the baseband
+ * rate and subtracted from the delayed audio. Doing all of that at the
+ * quarter of the rate is what makes the notch cheap enough to be left on.
+ */
+
+#include "assert.h"
+#include "compiler.h"
+#include "config.h"
+#include "dsp/tridec.h"
+#include "radio/notch.h"
+#include "util/elems.h"
+
+/* length of the predictor delay line */
+#define NOTCH_LEN                           (NOTCH_TAPS + NOTCH_DECORRELATION)
+/* droop equalizer coefficient: (1 + 2a) - 2a * cos(w) matches the inverse of
+ * the decimator and interpolator responses within 1% up to 2kHz */
+#define NOTCH_EQ                            0.19f
+/* power below which the audio is considered to be the silence */
+#define NOTCH_MIN_POWER                     1e-12f
+
+/* decimator */
+static tridec_t dec;
+/* decimated audio, every sample is stored twice so that the predictor always
+ * sees the contiguous window, newest sample first */
+static float line[2 * NOTCH_LEN];
+static int line_idx;
+/* predictor weights and the power of the decimated audio */
+static float weights[NOTCH_TAPS], power;
+/* last two tone estimates (for the equalizer) and the last equalized one
+ * (for the interpolation) */
+static float est1, est2, est_prev;
+/* audio delay line and the current position within it */
+static float delay[NOTCH_DELAY];
+static int delay_idx;
+
+/* reset the notch */
+void Notch_Reset(void)
+{
+    /* decimator */
+    TriDec_Init(&dec, NOTCH_DECIMATION_RATE);
+    /* predictor */
+    for (int k = 0; k < (int)elems(line); k++)
+        line[k] = 0;
+    for (int k = 0; k < NOTCH_TAPS; k++)
+        weights[k] = 0;
+    line_idx = 0, power = 0;
+    /* equalizer and the interpolator */
+    est1 = est2 = est_prev = 0;
+    /* audio delay */
+    for (int k = 0; k < NOTCH_DELAY; k++)
+        delay[k] = 0;
+    delay_idx = 0;
+}
+
+/* process the audio */
+void OPTIMIZE("O3") LOOP_UNROLL Notch_Process(const float *in, int num,
+    float *out)
+{
+    /* shorthand */
+    const int r = NOTCH_DECIMATION_RATE;
+    /* power estimate follows the predictor window */
+    const float k_pwr = 1.0f / NOTCH_TAPS;
+    /* local copies of the state */
+    float p = power, e1 = est1, e2 = est2, e_prev = est_prev;
+    int idx = line_idx, d_idx = delay_idx;
+
+    /* sanity check for the number of samples */
+    assert(num % r == 0, "number of samples is not divisible by the "
+        "decimation factor", num);
+
+    /* one internal sample per r samples of the audio */
+    for (int n = 0; n < num; n += r, in += r, out += r) {
+        /* decimated audio sample */
+        float x;
+        TriDec_Decimate(&dec, in, r, &x);
+
+        /* store in the delay line (twice) */
+        idx = idx ? idx - 1 : NOTCH_LEN - 1;
+        line[idx] = line[idx + NOTCH_LEN] = x;
+        /* window of the older samples that the prediction is made from */
+        const float *ref = line + idx + NOTCH_DECORRELATION;
+
+        /* tone estimate */
+        float y = 0;
+        for (int k = 0; k < NOTCH_TAPS; k++)
+            y += weights[k] * ref[k];
+        /* normalized lms update: what was not predicted drives the weights,
+         * step is scaled by the power of the predictor window */
+        p += k_pwr * (x * x - p);
+        float g = NOTCH_MU * (x - y) / (NOTCH_TAPS * p + NOTCH_MIN_POWER);
+        for (int k = 0; k < NOTCH_TAPS; k++)
+            weights[k] += g * ref[k];
+
+        /* equalized estimate (one internal sample late) */
+        float e = (1 + 2 * NOTCH_EQ) * e1 - NOTCH_EQ * (y + e2);
+        e2 = e1, e1 = y;
+
+        /* back to the baseband rate, subtract from the delayed audio */
+        float d = (e - e_prev) * (1.0f / r);
+        for (int k = 0; k < r; k++) {
+            /* sample leaving the delay line */
+            float a = delay[d_idx];
+            /* delay line is updated before the output overwrites the input
+             * (in situ processing) */
+            delay[d_idx] = in[k];
+            /* advance within the delay line */
+            if (++d_idx == NOTCH_DELAY)
+                d_idx = 0;
+            /* remove the tone */
+            out[k] = a - (e_prev + d * (k + 1));
+        }
+        /* store the estimate */
+        e_prev = e;
+    }
+
+    /* store the state */
+    power = p, est1 = e1, est2 = e2, est_prev = e_prev;
+    line_idx = idx, delay_idx = d_idx;
+}
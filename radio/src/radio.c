@@ -7,12 +7,15 @@
  * @brief Radio Receiver logic
  */
 
+#include <string.h>
+
 #include "assert.h"
 #include "err.h"
 #include "at/ntf/radio.h"
 #include "dev/await.h"
 #include "dev/cs43l22.h"
 #include "dev/dec.h"
+#include "dev/cyccnt.h"
 #include "dev/display.h"
 #include "dev/invoke.h"
 #include "dev/joystick.h"
@@ -21,13 +24,27 @@
 #include "dev/sai1a.h"
 #include "dev/usb.h"
 #include "dev/usb_audiosrc.h"
+#include "dsp/asrc.h"
 #include "dsp/fixp_sat.h"
 #include "dsp/float_fixp.h"
-#include "dsp/float_scale.h"
+#include "dsp/hband.h"
+#include "radio/agc.h"
 #include "radio/dec4.h"
 #include "radio/demod_am.h"
+#include "radio/demod_cw.h"
+#include "radio/demod_sam.h"
+#include "radio/demod_ssb.h"
 #include "radio/mix1.h"
+#include "radio/meter.h"
 #include "radio/mix2.h"
+#include "radio/notch.h"
+#include "radio/radio.h"
+#include "radio/rfcap.h"
+#include "radio/scan.h"
+#include "radio/sdec.h"
+#include "radio/spectrum.h"
+#include "sys/critical.h"
+#include "sys/prof.h"
 #include "sys/sem.h"
 #include "util/fp.h"
 #include "util/elems.h"
@@ -36,33 +53,152 @@
 #define DEBUG
 #include "debug.h"
 
-/* frequencies */
-static int set_frequency = 225000, actual_frequency;
+/* number of rf frames after the re-tuning that still carry the previous 
+ * station (decimator latency) */
+#define RADIO_RETUNE_SETTLE                         3
+/* number of the baseband samples per rf frame */
+#define RADIO_BB_NUM                                \
+    (RF_SAMPLING_FREQ * 2 / 1000 / DEC_DECIMATION_RATE)
+/* max number of the half-band stages between the baseband and the iq 
+ * stream */
+#define RADIO_IQ_HB_STAGES                          2
+
+/* iq stream sampling rate change event */
+ev_t radio_iq_ev;
+/* iq samples event */
+ev_t radio_iqdata_ev;
+
+/* frequencies: requested one and the one that the receiver is actually tuned 
+ * to (with the accuracy of the local oscillators) */
+static float set_frequency = 225000, actual_frequency;
 /* currently displayed frequency */
-static int displayed_frequency;
+static float displayed_frequency;
+
+/* demodulation mode: requested one and the one that is in use */
+static volatile int set_mode = RADIO_MODE_AM;
+static int mode = -1;
+/* names of the modes */
+static const char * const mode_names[RADIO_MODE_NUM] = {
+    [RADIO_MODE_AM] = "AM", [RADIO_MODE_USB] = "USB", [RADIO_MODE_LSB] = "LSB",
+    [RADIO_MODE_SAM] = "SAM", [RADIO_MODE_CW] = "CW",
+};
+/* bfo pitch: requested one and the one that is in use */
+static volatile float set_bfo_pitch = DEMODCW_PITCH;
+static float bfo_pitch;
+/* adaptive notch: requested setting and the one that is in use */
+static volatile int set_notch;
+static int notch;
+/* agc settings for all the modes, settings of the mode in use need to be 
+ * re-applied */
+static agc_cfg_t agc_cfgs[RADIO_MODE_NUM] = {
+    /* broadcast am: slow decay so that the gain does not follow the 
+     * modulation */
+    [RADIO_MODE_AM] = { .attack = 0.5e-3f, .hang = 0.1f, .decay = 0.5f, 
+        .max_gain = 70 },
+    [RADIO_MODE_SAM] = { .attack = 0.5e-3f, .hang = 0.1f, .decay = 0.5f, 
+        .max_gain = 70 },
+    /* speech: the gain is held between the syllables */
+    [RADIO_MODE_USB] = { .attack = 0.5e-3f, .hang = 0.5f, .decay = 0.2f, 
+        .max_gain = 70 },
+    [RADIO_MODE_LSB] = { .attack = 0.5e-3f, .hang = 0.5f, .decay = 0.2f, 
+        .max_gain = 70 },
+    /* keying: the gain is held between the elements */
+    [RADIO_MODE_CW] = { .attack = 0.5e-3f, .hang = 0.25f, .decay = 0.1f, 
+        .max_gain = 70 },
+};
+static volatile int agc_update;
 
 /* frequencies of the local oscillator */
 static float lo1_frequency, lo2_frequency;
+/* carrier offset that is compensated by the 2nd local oscillator */
+static float lo2_offset;
+/* carrier tracking status */
+static volatile int carrier_locked;
+static volatile float carrier_offset;
+/* rf frames left till the audio path reset that follows the re-tuning */
+static int retune_settle;
 
-/* rf signal buffer, 2ms long */
-static int16_t rf[RF_SAMPLING_FREQ * 2 * 2 / 1000];
+/* rf signal buffer, 2ms long (word aligned for the packed mixer) */
+static int16_t ALIGNED(4) rf[RF_SAMPLING_FREQ * 2 * 2 / 1000];
 /* complex data after 1st stage mixing */
-static int16_t i_mix1[elems(rf) / 2], q_mix1[elems(rf) / 2];
-/* decimation result holding array, set up as ping-pong buffer */
-static float i_dec[2][elems(i_mix1) / DEC_DECIMATION_RATE],
-             q_dec[2][elems(q_mix1) / DEC_DECIMATION_RATE];
+static int16_t ALIGNED(4) i_mix1[elems(rf) / 2], q_mix1[elems(rf) / 2];
+/* decimation result holding array, set up as ping-pong buffer. The dfsdm 
+ * delivers Q31 numbers that get converted to floats in-situ. Sized for the 
+ * widest iq stream */
+static union dec_buf {
+    int32_t i32[elems(i_mix1) / DEC_MIN_DECIMATION_RATE];
+    float fl[elems(i_mix1) / DEC_MIN_DECIMATION_RATE];
+} i_dec[2], q_dec[2];
 /* ping pong indicator */
 static int pp;
 
-/* audio gain */
-static float dac_gain = 10.0f;
+/* iq stream decimation rate: requested one, the one of the frame being 
+ * processed and the ones that the frames within the ping-pong buffer were 
+ * produced for */
+static volatile int set_iq_dec = DEC_DECIMATION_RATE;
+static int iq_dec = DEC_DECIMATION_RATE;
+static int pp_iq_dec[2] = { DEC_DECIMATION_RATE, DEC_DECIMATION_RATE };
+/* rate that the decimators run at */
+static int dec_rate = DEC_DECIMATION_RATE;
+/* half-band decimators (i and q): baseband from the widest iq stream, the 
+ * same for the scanner (it needs the data from before the 2nd stage mixing) 
+ * and the narrower iq streams from the baseband */
+static hband_t hb_bb[2], hb_scan[2], hb_iq[RADIO_IQ_HB_STAGES][2];
+
+/* audio volume (applied on top of the agc gain) */
+static float volume = 1.0f;
 /* dac samples buffer */
 static int32_t dac[elems(rf) * 16 / DEC_DECIMATION_RATE];
 /* dac pointers */
 static uint32_t dac_head;
+/* sample rate converter that matches the audio to the dac clock */
+static asrc_t dac_asrc;
+/* dac streaming has started */
+static int dac_streaming;
 /* states of the dac ic */
 static enum dac_states { LOCK, INIT, PLAY, VOLUME, ON, ERR } dac_state;
 
+/* processing stage profilers */
+static prof_t prof[RADIO_PROF_NUM];
+/* names of the processing stages */
+static const char * const prof_names[RADIO_PROF_NUM] = {
+    [RADIO_PROF_MIX1] = "mix1", [RADIO_PROF_DEC] = "dec", 
+    [RADIO_PROF_MIX2] = "mix2", [RADIO_PROF_FILTER] = "filter",
+    [RADIO_PROF_DEMOD] = "demod", [RADIO_PROF_AGC] = "agc",
+    [RADIO_PROF_DAC_FIXP] = "dac_fixp", [RADIO_PROF_SAT] = "sat",
+    [RADIO_PROF_TOTAL] = "total", [RADIO_PROF_HEADROOM] = "headroom",
+    [RADIO_PROF_LO1] = "lo1", [RADIO_PROF_METER] = "meter",
+    [RADIO_PROF_NOTCH] = "notch", [RADIO_PROF_ASRC] = "asrc",
+    [RADIO_PROF_HBAND] = "hband", [RADIO_PROF_RFCAP] = "rfcap",
+    [RADIO_PROF_IQNTF] = "iqntf",
+};
+
+/* account the cycles spent in given stage, returns the timestamp for the 
+ * next stage */
+static inline ALWAYS_INLINE uint32_t Radio_ProfStage(int stage, uint32_t start)
+{
+    /* current timestamp */
+    uint32_t now = CycCnt_GetValue();
+    /* store the difference */
+    Prof_Update(&prof[stage], now - start);
+    /* return the timestamp */
+    return now;
+}
+
+/* account the cycles spent on the half-band decimation (there may be more than 
+ * one such stage per frame, the total gets reported), returns the timestamp 
+ * for the next stage */
+static inline ALWAYS_INLINE uint32_t Radio_ProfHBand(uint32_t *cycles, 
+    uint32_t start)
+{
+    /* current timestamp */
+    uint32_t now = CycCnt_GetValue();
+    /* accumulate the difference */
+    *cycles += now - start;
+    /* return the timestamp */
+    return now;
+}
+
 
 /* update the display */
 static int OPTIMIZE("O0") Radio_UpdateDisplay(void *ptr)
@@ -78,7 +214,7 @@ static int OPTIMIZE("O0") Radio_UpdateDisplay(void *ptr)
 
     /* prepare the display content */
     int i, len = snprintf(display_buf, sizeof(display_buf), "%04dk", 
-        (actual_frequency + 500) / 1000);
+        (int)fp_round(actual_frequency / 1000));
     /* store the data in the display memory */
     for (i = 0 ; i < len; i++)
         Display_SetCharacter(i, display_buf[i]);
@@ -98,17 +234,35 @@ static int OPTIMIZE("O0") Radio_UpdateDisplay(void *ptr)
  * update the LCD display */
 static int Radio_UpdateFrequencyCallback(void *ptr)
 {
+    /* timestamp for the profiler */
+    uint32_t ts = CycCnt_GetValue();
+
+    /* re-tuning ends the scan */
+    Scan_Stop();
     /* set the frequencies for the local oscillators */
     lo1_frequency = Mix1_SetLOFrequency(set_frequency);
+    /* this may trigger the lut rebuild, let's see what it costs */
+    Radio_ProfStage(RADIO_PROF_LO1, ts);
+    /* the rf callback alters the 2nd oscillator as well (carrier 
+     * tracking) */
+    Critical_Enter();
+    /* carrier offset compensation is dropped on re-tuning */
     lo2_frequency = Mix2_SetLOFrequency(set_frequency - lo1_frequency);
+    lo2_offset = 0;
+    /* carrier needs to be re-acquired */
+    DemodSAM_Reset();
+    /* audio path gets reset once the previous station leaves the pipeline */
+    retune_settle = RADIO_RETUNE_SETTLE;
+    Critical_Exit();
 
-    /* calculate the actual frequency */
+    /* calculate the actual frequency (mix2 nco has the resolution of 
+     * BB_SAMPLING_RATE / 2^32 Hz, so this is the true frequency) */
     actual_frequency = lo1_frequency + lo2_frequency;
     // /* show the frequency */
-    // dprintf("set_frequency = %d, act_frequency = %d, lo1 = %.5e, lo2 = %.5e\n", 
+    // dprintf("set_frequency = %.3f, act_frequency = %.3f, lo1 = %.5e, lo2 = %.5e\n", 
     //     set_frequency, actual_frequency, lo1_frequency, lo2_frequency);
-    // /* show the gain */
-    // dprintf("gain = %e\n", dac_gain);
+    // /* show the volume */
+    // dprintf("volume = %e\n", volume);
     
     /* update the display */
     if (Sem_Lock(&display_sem, CB_NONE) == EOK)
@@ -123,27 +277,28 @@ static int Radio_JoystickCallback(void *ptr)
 {
     /* cast event argument */
     joystick_evarg_t *ea = ptr;
-    /* change in gain per joystick event (1dB, voltage-wise) */
-    const float gain_change = 1.12202;
+    /* change in volume per joystick event (1dB, voltage-wise) */
+    const float volume_change = 1.12202;
     /* change in freqency per joystick event */
     const int frequency_change = 1000;
     /* final settings */
-    float new_gain = dac_gain; int new_frequency = set_frequency;
+    float new_volume = volume, new_frequency = set_frequency;
     
     /* adjust volume */
-    if (ea->status & JOYSTICK_STATUS_UP) new_gain *= gain_change;
-    if (ea->status & JOYSTICK_STATUS_DOWN) new_gain /= gain_change;
+    if (ea->status & JOYSTICK_STATUS_UP) new_volume *= volume_change;
+    if (ea->status & JOYSTICK_STATUS_DOWN) new_volume /= volume_change;
     /* adjust frequency */
     if (ea->status & JOYSTICK_STATUS_RIGHT) new_frequency += frequency_change;
     if (ea->status & JOYSTICK_STATUS_LEFT) new_frequency -= frequency_change;
 
-    /* sanity limits for the gain : +/- 40dB */
-    new_gain = min(1000, max(new_gain, 0.01));
+    /* sanity limits for the volume: -40dB up to the level at which the agc 
+     * target reaches the full scale */
+    new_volume = min(1.0f / AGC_TARGET, max(new_volume, 0.01f));
     /* sanity limits for the frequency: DC to Nyquist */
-    new_frequency = min(RF_SAMPLING_FREQ / 2, max(0, new_frequency));
+    new_frequency = min(RF_SAMPLING_FREQ / 2, max(0.0f, new_frequency));
 
     /* store */
-    dac_gain = new_gain; set_frequency = new_frequency;
+    volume = new_volume; set_frequency = new_frequency;
     /* invoke the update */
     Invoke_CallMeElsewhere(Radio_UpdateFrequencyCallback, 0);
 
@@ -194,6 +349,317 @@ static int Radio_DecimationCallback(void *ptr)
     return EOK;
 }
 
+/* apply the requested demodulation mode */
+static void Radio_ApplyMode(void)
+{
+    /* nothing has changed */
+    if (mode == set_mode)
+        return;
+
+    /* store the mode */
+    mode = set_mode;
+    /* set up the demodulator */
+    switch (mode) {
+    case RADIO_MODE_USB : DemodSSB_SetSideband(DEMODSSB_USB); break;
+    case RADIO_MODE_LSB : DemodSSB_SetSideband(DEMODSSB_LSB); break;
+    case RADIO_MODE_SAM : DemodSAM_Reset(); break;
+    case RADIO_MODE_CW : DemodCW_Reset(); break;
+    }
+
+    /* drop the carrier offset compensation */
+    if (lo2_offset != 0)
+        Mix2_SetLOFrequency(lo2_frequency), lo2_offset = 0;
+    /* no carrier tracking */
+    carrier_locked = 0, carrier_offset = 0;
+    /* agc settings of the mode need to be applied */
+    agc_update = 1;
+}
+
+/* new station has reached the audio path: dc offset of the previous one must 
+ * not show up as the transient, the gain and the levels need to be found 
+ * again */
+static void Radio_ApplyRetune(void)
+{
+    /* previous station is still within the pipeline */
+    if (!retune_settle || --retune_settle)
+        return;
+    /* reset the audio path */
+    DemodAM_Reset(); AGC_Reset(); Meter_Reset(); Notch_Reset();
+}
+
+/* apply the agc settings of the current mode */
+static void Radio_ApplyAGC(void)
+{
+    /* settings have changed? */
+    if (agc_update)
+        agc_update = 0, AGC_SetConfig(&agc_cfgs[mode]);
+}
+
+/* apply the requested bfo pitch */
+static void Radio_ApplyBFO(void)
+{
+    /* pitch has changed? */
+    if (bfo_pitch != set_bfo_pitch)
+        DemodCW_SetPitch(bfo_pitch = set_bfo_pitch);
+}
+
+/* apply the adaptive notch setting */
+static void Radio_ApplyNotch(void)
+{
+    /* notch starts without any knowledge about the tones */
+    if (notch != set_notch)
+        notch = set_notch, Notch_Reset();
+}
+
+/* feed the carrier offset found by the pll back to the 2nd local oscillator 
+ * so that the carrier stays at dc */
+static void Radio_TrackCarrier(void)
+{
+    /* residual carrier offset seen by the pll */
+    float f = DemodSAM_GetFrequency();
+
+    /* move it to the mixer, but only when locked and within the range */
+    if (DemodSAM_IsLocked() && fp_fabs(lo2_offset + f) < DEMODSAM_MAX_OFFSET) {
+        /* re-tune: the mixer shifts the spectrum down by the lo frequency */
+        float lo2 = Mix2_SetLOFrequency(lo2_frequency + lo2_offset + f);
+        /* offset that was actually moved (up to the nco resolution) */
+        f = lo2 - lo2_frequency - lo2_offset;
+        /* the pll does not need to track it anymore */
+        lo2_offset += f; DemodSAM_ShiftFrequency(-f);
+    }
+
+    /* publish the status */
+    carrier_locked = DemodSAM_IsLocked();
+    carrier_offset = lo2_offset + DemodSAM_GetFrequency();
+}
+
+/* scan needs the 1st local oscillator to be re-tuned */
+static int Radio_ScanCallback(void *ptr)
+{
+    /* cast callback argument */
+    scan_cbarg_t *arg = ptr;
+
+    /* scan is over: go back to the frequency that was set */
+    if (arg->done)
+        return Radio_UpdateFrequencyCallback(0);
+    /* go to the band that is about to be measured */
+    Mix1_SetLOFrequency(arg->frequency);
+
+    /* report status */
+    return EOK;
+}
+
+/* bring all the half-band decimators to the initial state */
+static void Radio_ResetHalfBands(void)
+{
+    /* both channels of all the decimators */
+    for (int k = 0; k < 2; k++) {
+        HBand_Init(&hb_bb[k], HBAND_TAPS);
+        HBand_Init(&hb_scan[k], HBAND_TAPS);
+        for (int s = 0; s < RADIO_IQ_HB_STAGES; s++)
+            HBand_Init(&hb_iq[s][k], HBAND_TAPS);
+    }
+}
+
+/* apply the requested iq stream rate to the frame that is about to be 
+ * decimated: decimators go down to the baseband rate at most, the narrower 
+ * iq streams are produced by the half-band stages */
+static void Radio_ApplyIQRate(void)
+{
+    /* iq stream rate of the frame and the rate of the decimators */
+    int dec = pp_iq_dec[pp] = set_iq_dec;
+    int rate = min(dec, DEC_DECIMATION_RATE);
+
+    /* nothing has changed */
+    if (rate == dec_rate)
+        return;
+    /* set up the decimators */
+#if DEC_SOFTWARE
+    assert(SDec_Init(rate) == EOK, "unsupported decimation rate", rate);
+#else
+    assert(Dec_SetDecimationRate(rate) == EOK, "unsupported decimation rate", 
+        rate);
+#endif
+    /* store the rate */
+    dec_rate = rate;
+}
+
+/* the frame that was produced for the new iq stream rate has reached the 
+ * processing: switch the stages that follow the decimators */
+static void Radio_SwitchIQRate(void)
+{
+    /* iq stream rate of the frame */
+    int dec = pp_iq_dec[!pp];
+
+    /* nothing has changed */
+    if (dec == iq_dec)
+        return;
+    /* store */
+    iq_dec = dec;
+
+    /* 2nd local oscillator works at the rate of the decimators */
+    Mix2_SetSamplingRate(RF_SAMPLING_FREQ / min(dec, DEC_DECIMATION_RATE));
+    Mix2_SetLOFrequency(lo2_frequency + lo2_offset);
+    /* half-band decimators start over */
+    Radio_ResetHalfBands();
+    /* decimators were set up from scratch: the audio path gets reset once 
+     * the transient leaves the pipeline */
+    retune_settle = RADIO_RETUNE_SETTLE;
+
+    /* prepare event argument */
+    radio_iq_evarg_t ea = { .rate = RF_SAMPLING_FREQ / dec };
+    /* usb streams the samples at the new rate */
+    USBAudioSrc_SetRate(ea.rate);
+    /* notify the consumers */
+    Ev_Notify(&radio_iq_ev, &ea);
+}
+
+/* half-band decimation of the iq data, returns the number of samples */
+static int Radio_HalfBand(hband_t *hb, const float *i, const float *q, 
+    int num, float *i_out, float *q_out)
+{
+    /* both channels produce the same number of samples */
+    HBand_Decimate(&hb[1], q, num, q_out);
+    return HBand_Decimate(&hb[0], i, num, i_out);
+}
+
+/* store the iq samples in the usb buffer (as the interleaved Q31 pairs) */
+static void Radio_PutIQ(const float *i, const float *q, int num)
+{
+    /* space within the usb buffer */
+    usb_audio_span_t span;
+    /* get the space, the buffer may wrap */
+    int usb_num = USBAudioSrc_AcquireSpace(num, &span);
+
+    /* convert to the fixed point (with saturation) and store */
+    for (int k = 0, n = 0; k < (int)elems(span.num); n += span.num[k++]) {
+        for (int m = 0; m < span.num[k]; m++) {
+            span.ptr[k][2 * m + 0] = Arch_VCVT_S32_F32(i[n + m], 31);
+            span.ptr[k][2 * m + 1] = Arch_VCVT_S32_F32(q[n + m], 31);
+        }
+    }
+    /* make the samples visible for the usb */
+    USBAudioSrc_CommitSamples(usb_num);
+}
+
+/* let the others know about the iq samples */
+static void Radio_NotifyIQ(const float *i, const float *q, int num)
+{
+    /* event argument */
+    radio_iqdata_evarg_t ea = { .i = i, .q = q, .num = num };
+    /* notify */
+    Ev_Notify(&radio_iqdata_ev, &ea);
+}
+
+/* usb host has selected the sampling rate of the iq stream */
+static int Radio_USBAudioCallback(void *ptr)
+{
+    /* cast event argument */
+    usb_audio_evarg_t *ea = ptr;
+    /* the rates offered to the host are built from the supported decimation 
+     * rates (see Radio_Init()) so the selected one cannot be rejected */
+    if (ea->rate != (uint32_t)(RF_SAMPLING_FREQ / set_iq_dec))
+        assert(Radio_SetIQRate(ea->rate) == EOK, "unsupported iq rate", 
+            ea->rate);
+
+    /* report status */
+    return EOK;
+}
+
+/* audio path: filtering, demodulation and gain. Takes the timestamp of the 
+ * stage that precedes it, returns the one of the last stage */
+static uint32_t Radio_ProcessAudio(float *i, float *q, int num, float *out, 
+    uint32_t ts)
+{
+    /* filtered data for the audio path */
+    float i_dec_flt[RADIO_BB_NUM], q_dec_flt[RADIO_BB_NUM];
+    /* demodulated audio samples */
+    float dem[RADIO_BB_NUM];
+
+    /* single sideband */
+    if (mode == RADIO_MODE_USB || mode == RADIO_MODE_LSB) {
+        /* sideband selection */
+        DemodSSB_Filter(i, q, num, i_dec_flt, q_dec_flt);
+        ts = Radio_ProfStage(RADIO_PROF_FILTER, ts);
+        /* demodulate the output data */
+        DemodSSB_Demodulate(i_dec_flt, q_dec_flt, num, dem);
+        ts = Radio_ProfStage(RADIO_PROF_DEMOD, ts);
+    /* synchronous amplitude modulation */
+    } else if (mode == RADIO_MODE_SAM) {
+        /* same selectivity as for the am */
+        DemodAM_Filter(i, q, num, i_dec_flt, q_dec_flt);
+        ts = Radio_ProfStage(RADIO_PROF_FILTER, ts);
+        /* demodulate the output data */
+        DemodSAM_Demodulate(i_dec_flt, q_dec_flt, num, dem);
+        /* keep the carrier at dc */
+        Radio_TrackCarrier();
+        ts = Radio_ProfStage(RADIO_PROF_DEMOD, ts);
+    /* continuous wave */
+    } else if (mode == RADIO_MODE_CW) {
+        /* narrow channel at the reduced sampling rate */
+        int cw_num = DemodCW_Filter(i, q, num, i_dec_flt, q_dec_flt);
+        ts = Radio_ProfStage(RADIO_PROF_FILTER, ts);
+        /* demodulate the output data, back at the baseband rate */
+        DemodCW_Demodulate(i_dec_flt, q_dec_flt, cw_num, dem);
+        ts = Radio_ProfStage(RADIO_PROF_DEMOD, ts);
+    /* amplitude modulation */
+    } else {
+        /* filter before demodulation */
+        DemodAM_Filter(i, q, num, i_dec_flt, q_dec_flt);
+        ts = Radio_ProfStage(RADIO_PROF_FILTER, ts);
+        /* demodulate the output data */
+        DemodAM_Demodulate(i_dec_flt, q_dec_flt, num, dem);
+        ts = Radio_ProfStage(RADIO_PROF_DEMOD, ts);
+    }
+
+    /* remove the steady tones, but not the one that the cw signal was 
+     * turned into */
+    if (notch && mode != RADIO_MODE_CW) {
+        Notch_Process(dem, num, dem);
+        ts = Radio_ProfStage(RADIO_PROF_NOTCH, ts);
+    }
+    /* automatic gain control and the volume */
+    AGC_Process(dem, num, volume, out);
+    return Radio_ProfStage(RADIO_PROF_AGC, ts);
+}
+
+/* audio output: bring the audio to the dac clock, convert it and store it in 
+ * the dac buffer. Takes the timestamp of the stage that precedes it */
+static void Radio_PutAudio(const float *audio, int num, uint32_t ts)
+{
+    /* resampled audio, the converter produces up to one sample more than 
+     * the input has */
+    float res[RADIO_BB_NUM + 2];
+    /* the same in the dac format */
+    int32_t out[elems(res)];
+
+    /* keep the dac buffer half full (the dma reads from it once the 
+     * streaming is started) */
+    if (dac_streaming) {
+        /* samples that wait for the dma */
+        int fill = (int)dac_head - SAI1A_GetPosition();
+        ASRC_Servo(&dac_asrc, fill < 0 ? fill + elems(dac) : fill, num);
+    }
+    /* match the sampling rates */
+    int res_num = ASRC_Process(&dac_asrc, audio, num, res);
+    ts = Radio_ProfStage(RADIO_PROF_ASRC, ts);
+    /* convert to the fixed point notation for the dac */
+    FloatFixp_FloatToFixp32(res, res_num, 23, out);
+    ts = Radio_ProfStage(RADIO_PROF_DAC_FIXP, ts);
+    /* do the saturation to avoid overflows on the agc attack overshoots and 
+     * with the volume turned up */
+    FixpSat_Saturate(out, res_num, 23, out);
+    ts = Radio_ProfStage(RADIO_PROF_SAT, ts);
+
+    /* store within the circular buffer, number of samples varies so it may 
+     * wrap */
+    int part = min(res_num, (int)(elems(dac) - dac_head));
+    memcpy(dac + dac_head, out, part * sizeof(dac[0]));
+    memcpy(dac, out + part, (res_num - part) * sizeof(dac[0]));
+    /* update dac head index */
+    dac_head = (dac_head + res_num) % elems(dac);
+}
+
 /* adc rf samples  have arrived callback */
 static int Radio_RFInCallback(void *ptr)
 {
@@ -203,51 +669,146 @@ static int Radio_RFInCallback(void *ptr)
     /* update the ping-pong counter */
     pp = !pp;
     /* head/tail adjusted pointers to the ping-pong buffer phase indicator */
-    float *i_dec_head = i_dec[ pp], *q_dec_head = q_dec[ pp];
-    float *i_dec_tail = i_dec[!pp], *q_dec_tail = q_dec[!pp];
-    /* number of decimated frames */
-    const int rf_num = elems(rf) / 2, dec_num = elems(i_dec[0]);
+    union dec_buf *i_dec_head = &i_dec[ pp], *q_dec_head = &q_dec[ pp];
+    float *i_dec_tail = i_dec[!pp].fl, *q_dec_tail = q_dec[!pp].fl;
 
-    /* filtered data for the audio path */
-    float i_dec_flt[elems(i_dec[0])], q_dec_flt[elems(q_dec[0])];
-    /* AM-demodulated audio samples */
-    float dem[elems(i_dec[0])];
-    /* conversion buffers to prepare the data for the usb */
-    int32_t i_dec_tail_i32[elems(i_dec[0])], q_dec_tail_i32[elems(q_dec[0])];
+    /* mode, bfo, notch and agc changes take place at the frame boundary */
+    Radio_ApplyMode();
+    Radio_ApplyBFO();
+    Radio_ApplyNotch();
+    Radio_ApplyAGC();
+    Radio_SwitchIQRate();
+    Radio_ApplyRetune();
+
+    /* number of rf samples, number of samples within the decimated frame, 
+     * number of the baseband samples and the iq stream samples */
+    const int rf_num = elems(rf) / 2;
+    const int tail_num = rf_num / min(iq_dec, DEC_DECIMATION_RATE);
+    const int dec_num = RADIO_BB_NUM, iq_num = rf_num / iq_dec;
+    /* space within the usb buffer */
+    usb_audio_span_t span;
+    /* audio samples */
+    float audio[RADIO_BB_NUM];
+    /* cycle budget of a single callback */
+    const uint32_t budget = CPUCLOCK_FREQ / RF_SAMPLING_FREQ * rf_num;
+    /* processing start timestamp and the timestamp of current stage */
+    uint32_t start = CycCnt_GetValue(), ts = start;
+    /* cycles spent on the half-band decimation */
+    uint32_t hb_cycles = 0;
 
+    /* raw rf capture goes first as it may send the samples from where they 
+     * are */
+    RFCap_PutSamples(ea->samples, ea->num);
+    ts = Radio_ProfStage(RADIO_PROF_RFCAP, ts);
     /* mix samples */
     Mix1_Mix(ea->samples, ea->num, i_mix1, q_mix1);
+    ts = Radio_ProfStage(RADIO_PROF_MIX1, ts);
+#if DEC_SOFTWARE
+    /* iq stream rate changes take place at the frame boundary */
+    Radio_ApplyIQRate();
+    /* decimate the mixed data in software */
+    SDec_Decimate(i_mix1, q_mix1, rf_num, i_dec_head->fl, q_dec_head->fl, 
+        CB_NONE);
+#else
     /* prepare the decimator */
     assert(Sem_Lock(&dec_sem, CB_NONE) == EOK, 
         "unable to lock the decimator", 0);
+    /* iq stream rate changes take place at the frame boundary (the decimator 
+     * is idle now) */
+    Radio_ApplyIQRate();
     /* start decimating mixed data data */
-    Dec_Decimate(i_mix1, q_mix1, rf_num, i_dec_head, q_dec_head, 
+    Dec_Decimate(i_mix1, q_mix1, rf_num, i_dec_head->i32, q_dec_head->i32, 
         Radio_DecimationCallback);
+    /* previous frame is complete (otherwise we would not be able to lock the 
+     * decimator), convert it from the fixed point notation. Decimators have 
+     * 8 times lower gain at the widest rate, the scaling makes up for it */
+    if (tail_num != dec_num) {
+        FloatFixp_Fixp32ToFloat(i_dec[!pp].i32, tail_num, 28, i_dec_tail);
+        FloatFixp_Fixp32ToFloat(q_dec[!pp].i32, tail_num, 28, q_dec_tail);
+    } else {
+        FloatFixp_Fixp32ToFloat(i_dec[!pp].i32, tail_num, 31, i_dec_tail);
+        FloatFixp_Fixp32ToFloat(q_dec[!pp].i32, tail_num, 31, q_dec_tail);
+    }
+#endif
+    ts = Radio_ProfStage(RADIO_PROF_DEC, ts);
 
-    /* 2nd stage mixing, done in-situ */
-    Mix2_Mix(i_dec_tail, q_dec_tail, dec_num, i_dec_tail, q_dec_tail);
-
-    /* convert to the fixed point notation for the usb */
-    FloatFixp_FloatToFixp32(i_dec_tail, dec_num, 31, i_dec_tail_i32);
-    FloatFixp_FloatToFixp32(q_dec_tail, dec_num, 31, q_dec_tail_i32);
-    /* put into usb buffers */
-    USBAudioSrc_PutSamples(i_dec_tail_i32, q_dec_tail_i32, dec_num);
+    /* the scanner works with the 1st stage mixer output at the baseband 
+     * rate */
+    if (tail_num != dec_num) {
+        /* wide frame needs to be brought down to it */
+        float i_scan[RADIO_BB_NUM], q_scan[RADIO_BB_NUM];
+        Radio_HalfBand(hb_scan, i_dec_tail, q_dec_tail, tail_num, i_scan, 
+            q_scan);
+        ts = Radio_ProfHBand(&hb_cycles, ts);
+        Scan_PutSamples(i_scan, q_scan, dec_num);
+    } else {
+        Scan_PutSamples(i_dec_tail, q_dec_tail, dec_num);
+    }
 
-    /* filter before demodulation */
-    DemodAM_Filter(i_dec_tail, q_dec_tail, dec_num, i_dec_flt, 
-        q_dec_flt);
-    /* demodulate the output data */
-    DemodAM_Demodulate(i_dec_flt, q_dec_flt, dec_num, dem);
+    /* iq stream at the rate of the decimators */
+    if (iq_num == tail_num) {
+        /* get the space for the iq data within the usb buffer */
+        int usb_num = USBAudioSrc_AcquireSpace(tail_num, &span);
+        /* 2nd stage mixing, done in-situ, fused with the conversion to the 
+         * fixed point notation and the storing in the usb buffer. Done in two 
+         * parts as the usb buffer may wrap */
+        for (int k = 0, n = 0; k < (int)elems(span.num); n += span.num[k++])
+            Mix2_MixFixp32(i_dec_tail + n, q_dec_tail + n, span.num[k], 
+                i_dec_tail + n, q_dec_tail + n, span.ptr[k]);
+        /* samples that did not fit into the usb buffer still need to be 
+         * mixed */
+        Mix2_Mix(i_dec_tail + usb_num, q_dec_tail + usb_num, 
+            tail_num - usb_num, i_dec_tail + usb_num, q_dec_tail + usb_num);
+        /* make the samples visible for the usb */
+        USBAudioSrc_CommitSamples(usb_num);
+        ts = Radio_ProfStage(RADIO_PROF_MIX2, ts);
+        /* notify the iq data listeners */
+        Radio_NotifyIQ(i_dec_tail, q_dec_tail, tail_num);
+        ts = Radio_ProfStage(RADIO_PROF_IQNTF, ts);
+    /* narrower iq stream */
+    } else {
+        /* 2nd stage mixing, done in-situ */
+        Mix2_Mix(i_dec_tail, q_dec_tail, tail_num, i_dec_tail, q_dec_tail);
+        ts = Radio_ProfStage(RADIO_PROF_MIX2, ts);
+        /* half-band stages bring the baseband down to the iq stream rate */
+        float i_iq[RADIO_BB_NUM / 2], q_iq[RADIO_BB_NUM / 2];
+        int n = Radio_HalfBand(hb_iq[0], i_dec_tail, q_dec_tail, tail_num, 
+            i_iq, q_iq);
+        for (int k = 1; n > iq_num; k++)
+            n = Radio_HalfBand(hb_iq[k], i_iq, q_iq, n, i_iq, q_iq);
+        /* store them for the usb */
+        Radio_PutIQ(i_iq, q_iq, n);
+        ts = Radio_ProfHBand(&hb_cycles, ts);
+        /* notify the iq data listeners */
+        Radio_NotifyIQ(i_iq, q_iq, n);
+        ts = Radio_ProfStage(RADIO_PROF_IQNTF, ts);
+    }
 
-    /* apply gain */
-    FloatScale_Scale(dem, dec_num, dac_gain, dem);
-    /* convert to the fixed point notation for the dac */
-    FloatFixp_FloatToFixp32(dem, dec_num, 23, dac + dac_head);
-    /* do the saturation to avoid overflows when the audio is getting loud */
-    FixpSat_Saturate(dac + dac_head, dec_num, 23, dac + dac_head);
+    /* wide frame: baseband is derived with the half-band filter */
+    if (tail_num != dec_num) {
+        Radio_HalfBand(hb_bb, i_dec_tail, q_dec_tail, tail_num, i_dec_tail, 
+            q_dec_tail);
+        ts = Radio_ProfHBand(&hb_cycles, ts);
+    }
+    /* half-band decimation is accounted once per frame */
+    if (hb_cycles)
+        Prof_Update(&prof[RADIO_PROF_HBAND], hb_cycles);
+    /* capture the frames for the spectrum engine */
+    Spectrum_PutSamples(i_dec_tail, q_dec_tail, dec_num);
 
-    /* update dac head index */
-    dac_head = (dac_head + dec_num) % elems(dac);
+    /* measure the channel, the audio path runs only when the squelch is 
+     * open */
+    int open = Meter_Process(i_dec_tail, q_dec_tail, dec_num);
+    ts = Radio_ProfStage(RADIO_PROF_METER, ts);
+    /* demodulate and apply the gain */
+    if (open) {
+        ts = Radio_ProcessAudio(i_dec_tail, q_dec_tail, dec_num, audio, ts);
+    /* channel is idle: the dac gets the silence */
+    } else {
+        memset(audio, 0, sizeof(audio));
+    }
+    /* convert for the dac */
+    Radio_PutAudio(audio, dec_num, ts);
 
     /* start streaming audio to the dac if not already started, but only if we 
      * have at least half of the dac buffer filled with data. this prevents the 
@@ -255,11 +816,18 @@ static int Radio_RFInCallback(void *ptr)
      * being sent to dac */
     if (dac_head >= elems(dac) / 2 && Sem_Lock(&sai1a_sem, CB_NONE) == EOK) {
         /* start streaming data */
-        SAI1A_StartStreaming(dac, elems(dac));
+        SAI1A_StartStreaming(dac, elems(dac)); dac_streaming = 1;
         /* start the dac enable procedure 100 ms after the stream was started 
          * to avoid audio glitches */
         Await_CallMeLater(100, Radio_DACEnableCallback, 0);
     }
+
+    /* time spent on the whole processing */
+    uint32_t total = CycCnt_GetValue() - start;
+    /* update the overall statistics */
+    Prof_Update(&prof[RADIO_PROF_TOTAL], total);
+    /* headroom is what is left from the budget, overruns are reported as 0 */
+    Prof_Update(&prof[RADIO_PROF_HEADROOM], total < budget ? budget - total : 0);
     
     /* report status */
     return EOK;
@@ -273,11 +841,60 @@ int Radio_Init(void)
         CPUCLOCK_FREQ, "cpu clock frequency is not a multiple of the sampling "
         "frequency!", 0);
 
+    /* baseband is one half-band stage away from the widest iq stream, 
+     * narrower streams are no more than RADIO_IQ_HB_STAGES stages away */
+    assert(DEC_DECIMATION_RATE == 2 * DEC_MIN_DECIMATION_RATE &&
+        IQ_MAX_DECIMATION_RATE <= DEC_DECIMATION_RATE << RADIO_IQ_HB_STAGES,
+        "unsupported iq stream decimation rates", IQ_MAX_DECIMATION_RATE);
+
+    /* reset the profilers */
+    Radio_ResetProfile();
+    /* enable the noise blanker */
+    assert(Mix1_SetBlanker(MIX1_NB_THRESHOLD) == EOK, 
+        "unsupported noise blanker threshold", MIX1_NB_THRESHOLD);
+    /* set up the signal meter */
+    assert(Meter_Init() == EOK, "unable to set up the meter", 0);
+    /* set up the automatic gain control */
+    assert(AGC_Init(&agc_cfgs[set_mode]) == EOK, "unable to set up the agc", 
+        0);
+    /* set up the sample rate converter for the dac: streaming starts with 
+     * the half of the buffer filled and the fill level is sampled before the 
+     * frame is stored, so it is a frame short of that */
+    assert(ASRC_Init(&dac_asrc, BB_SAMPLING_RATE / SAI1_ACTUAL_SAMPLING_RATE,
+        elems(dac) / 2 - RADIO_BB_NUM, 
+        ASRC_SERVO_TIME * BB_SAMPLING_RATE / 1000.0f) == EOK,
+        "unable to set up the sample rate converter", 0);
+    /* set up the spectrum engine */
+    assert(Spectrum_Init() == EOK, "unable to set up the spectrum engine", 0);
+    /* set up the wideband scanner */
+    assert(Scan_Init() == EOK, "unable to set up the scanner", 0);
+    /* set up the raw rf capture */
+    assert(RFCap_Init() == EOK, "unable to set up the rf capture", 0);
+
+#if DEC_SOFTWARE
+    /* set up the software decimator */
+    assert(SDec_Init(DEC_DECIMATION_RATE) == EOK, 
+        "unsupported decimation rate", DEC_DECIMATION_RATE);
+#endif
+    /* set up the half-band decimators */
+    Radio_ResetHalfBands();
+
+    /* iq stream rates offered to the usb host (in the ascending order) */
+    uint32_t iq_rates[USB_AUDIO_SRC_MAX_RATES]; int iq_rates_num = 0;
+    for (int d = IQ_MAX_DECIMATION_RATE; d >= DEC_MIN_DECIMATION_RATE; d /= 2)
+        iq_rates[iq_rates_num++] = RF_SAMPLING_FREQ / d;
+    /* the baseband rate is the one that we start with */
+    assert(USBAudioSrc_SetRates(iq_rates, iq_rates_num) == EOK &&
+        USBAudioSrc_SetRate(BB_SAMPLING_RATE) == EOK, 
+        "unable to set the usb sampling rates", iq_rates_num);
+
     /* subscribe to rf data ready notifications. the callback will be called 
      * every time a half of the buffer gets filled */
     Ev_RegisterCallback(&rfin_ev, Radio_RFInCallback);
     /* register callback for the joystick events */
     Ev_RegisterCallback(&joystick_ev, Radio_JoystickCallback);
+    /* usb host selects the iq stream rate */
+    Ev_RegisterCallback(&usb_audio_ev, Radio_USBAudioCallback);
 
     /* start usb action */
     USB_Connect(1);
@@ -314,4 +931,222 @@ int Radio_GetFrequency(float *f)
     *f = actual_frequency;
     /* report status */
     return EOK;
-}
\ No newline at end of file
+}
+
+/* set the demodulation mode */
+int Radio_SetMode(int mode)
+{
+    /* sanity check */
+    if (mode < 0 || mode >= RADIO_MODE_NUM)
+        return EFATAL;
+
+    /* the rf callback will pick it up */
+    set_mode = mode;
+    /* report status */
+    return EOK;
+}
+
+/* get the demodulation mode */
+int Radio_GetMode(int *mode)
+{
+    /* report the requested mode */
+    *mode = set_mode;
+    /* report status */
+    return EOK;
+}
+
+/* get the name of the mode */
+const char * Radio_GetModeName(int mode)
+{
+    /* sanity check */
+    if (mode < 0 || mode >= RADIO_MODE_NUM)
+        return 0;
+    /* return the name */
+    return mode_names[mode];
+}
+
+/* set the bfo pitch */
+int Radio_SetBFO(float hz)
+{
+    /* sanity check */
+    if (hz < DEMODCW_MIN_PITCH || hz > DEMODCW_MAX_PITCH)
+        return EFATAL;
+
+    /* the rf callback will pick it up */
+    set_bfo_pitch = hz;
+    /* report status */
+    return EOK;
+}
+
+/* get the bfo pitch */
+int Radio_GetBFO(float *hz)
+{
+    /* report the requested pitch */
+    *hz = set_bfo_pitch;
+    /* report status */
+    return EOK;
+}
+
+/* enable or disable the adaptive notch */
+int Radio_SetNotch(int enable)
+{
+    /* the rf callback will pick it up */
+    set_notch = !!enable;
+    /* report status */
+    return EOK;
+}
+
+/* get the adaptive notch setting */
+int Radio_GetNotch(int *enable)
+{
+    /* report the requested setting */
+    *enable = set_notch;
+    /* report status */
+    return EOK;
+}
+
+/* start or stop the wideband scan */
+int Radio_Scan(int dwell)
+{
+    /* start the scan, the scanner re-tunes the 1st local oscillator on its 
+     * own */
+    if (dwell)
+        return Scan_Start(dwell, Radio_ScanCallback);
+
+    /* stop it and go back to the frequency that was set */
+    Scan_Stop();
+    Invoke_CallMeElsewhere(Radio_UpdateFrequencyCallback, 0);
+    /* report status */
+    return EOK;
+}
+
+/* set the sampling rate of the iq stream */
+int Radio_SetIQRate(int rate)
+{
+    /* decimation rate that gives it */
+    int dec = rate > 0 ? RF_SAMPLING_FREQ / rate : 0, d;
+
+    /* rate has to come from the integer decimation */
+    if (!dec || dec * rate != RF_SAMPLING_FREQ)
+        return EFATAL;
+    /* which is the lowest one times the power of 2 */
+    for (d = DEC_MIN_DECIMATION_RATE; d < dec && d < IQ_MAX_DECIMATION_RATE; 
+        d *= 2);
+    if (d != dec)
+        return EFATAL;
+
+    /* the rf callback will pick it up */
+    set_iq_dec = dec;
+    /* report status */
+    return EOK;
+}
+
+/* get the sampling rate of the iq stream */
+int Radio_GetIQRate(int *rate)
+{
+    /* report the requested rate */
+    *rate = RF_SAMPLING_FREQ / set_iq_dec;
+    /* report status */
+    return EOK;
+}
+
+/* set the agc settings for given mode */
+int Radio_SetAGC(int _mode, const agc_cfg_t *cfg)
+{
+    /* sanity check */
+    if (_mode < 0 || _mode >= RADIO_MODE_NUM || AGC_CheckConfig(cfg) != EOK)
+        return EFATAL;
+
+    /* the rf callback reads the settings when applying them */
+    Critical_Enter();
+    agc_cfgs[_mode] = *cfg, agc_update = 1;
+    Critical_Exit();
+
+    /* report status */
+    return EOK;
+}
+
+/* get the agc settings for given mode */
+int Radio_GetAGC(int _mode, agc_cfg_t *cfg)
+{
+    /* sanity check */
+    if (_mode < 0 || _mode >= RADIO_MODE_NUM)
+        return EFATAL;
+
+    /* get the consistent copy */
+    Critical_Enter();
+    *cfg = agc_cfgs[_mode];
+    Critical_Exit();
+
+    /* report status */
+    return EOK;
+}
+
+/* get the agc gain and the signal level */
+int Radio_GetAGCStatus(float *gain, float *rssi)
+{
+    /* linear values */
+    float g, l;
+
+    /* get the agc state */
+    AGC_GetStatus(&g, &l);
+    /* convert to decibels (20 * log10(x) with the natural logarithm), avoid 
+     * the log of zero */
+    *gain = 20 / 2.302585093f * fp_log(g);
+    *rssi = 20 / 2.302585093f * fp_log(max(l, 1e-9f));
+
+    /* report status */
+    return EOK;
+}
+
+/* get the state of the sample rate converter that feeds the dac */
+int Radio_GetAudioSync(float *ppm, float *fill)
+{
+    /* report the converter state */
+    return ASRC_GetStatus(&dac_asrc, ppm, fill);
+}
+
+/* get the carrier tracking status */
+int Radio_GetCarrier(int *locked, float *offset)
+{
+    /* report the published values */
+    *locked = carrier_locked, *offset = carrier_offset;
+    /* report status */
+    return EOK;
+}
+
+/* get the profiling statistics */
+int Radio_GetProfile(int stage, const char **name, prof_stats_t *stats)
+{
+    /* sanity check */
+    if (stage < 0 || stage >= RADIO_PROF_NUM)
+        return EFATAL;
+
+    /* data is updated from within the interrupt */
+    Critical_Enter();
+    /* compute the statistics */
+    Prof_GetStats(&prof[stage], stats);
+    /* exit the critical section */
+    Critical_Exit();
+
+    /* store the name */
+    if (name)
+        *name = prof_names[stage];
+    /* report status */
+    return EOK;
+}
+
+/* reset the profiling statistics */
+int Radio_ResetProfile(void)
+{
+    /* data is updated from within the interrupt */
+    Critical_Enter();
+    /* reset all stages */
+    for (int i = 0; i < RADIO_PROF_NUM; i++)
+        Prof_Reset(&prof[i]);
+    /* exit the critical section */
+    Critical_Exit();
+
+    /* report status */
+    return EOK;
+}
@@ -0,0 +1,410 @@
+/**
+ * @file rfcap.c
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Raw rf capture. The 16-bit undecimated blocks are sent straight from 
+ * the rf buffer (zero-copy, only the header gets prepared): the transfer has 
+ * to be done before the adc comes back to the same half, which is when the 
+ * next block arrives, otherwise the block is counted as torn. All the other 
+ * formats are packed directly from the rf buffer into one of the two block 
+ * buffers: one is being sent while the other one waits, blocks that find 
+ * both of them taken are dropped. Decimation is done with the cascade of the 
+ * fixed point half-band filters, the 8-bit codes are the G.711 mu-law ones.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "compiler.h"
+#include "config.h"
+#include "err.h"
+#include "arch/arch.h"
+#include "dev/usb.h"
+#include "dev/usb_rfcap.h"
+#include "radio/rfcap.h"
+#include "sys/critical.h"
+#include "util/elems.h"
+#include "util/minmax.h"
+
+/* number of the half-band filter taps */
+#define RFCAP_HB_TAPS                       27
+/* mu-law codec: bias and the largest magnitude */
+#define RFCAP_MULAW_BIAS                    0x84
+#define RFCAP_MULAW_CLIP                    32635
+/* transfer slots: none, zero-copy one (block buffers have the indices 0 and 
+ * 1) */
+#define RFCAP_NONE                          -1
+#define RFCAP_ZERO_COPY                     2
+
+/* half-band filter (Q15): non-zero taps apart from the center one (0.5), 
+ * taps[j] is used for the samples that are 2 * j + 1 samples away from the 
+ * center. Equiripple design: flat within 0.05dB up to 0.2 of the input rate, 
+ * 45dB of rejection from 0.3 on */
+static const int16_t taps[(RFCAP_HB_TAPS + 1) / 4] = {
+    10289, -3196, 1645, -924, 510, -259, 127,
+};
+
+/* half-band decimator */
+typedef struct rfcap_hb {
+    /* input history, every sample is stored twice */
+    int16_t hist[2 * RFCAP_HB_TAPS];
+    /* position within the history, decimation phase */
+    int idx, phase;
+} rfcap_hb_t;
+
+/* block: header followed by the payload */
+typedef struct rfcap_block {
+    /* header */
+    rfcap_hdr_t hdr;
+    /* payload (the largest ones are the 16-bit samples decimated by 2 and 
+     * the undecimated 8-bit codes) */
+    union {
+        int16_t s16[RFCAP_BLOCK_SIZE / 2];
+        uint8_t u8[RFCAP_BLOCK_SIZE];
+    } data;
+} ALIGNED(4) rfcap_block_t;
+
+/* format requested, format in use */
+static volatile int set_format, set_dec = 1;
+static int format, dec = 1;
+/* decimator stages */
+static rfcap_hb_t hb[2];
+/* block buffers */
+static rfcap_block_t blocks[2];
+/* block being sent and the one that waits for it (RFCAP_NONE, block index 
+ * or RFCAP_ZERO_COPY) */
+static volatile int inflight = RFCAP_NONE, queued = RFCAP_NONE;
+/* header and the samples of the zero-copy block, the block was already 
+ * counted as torn */
+static rfcap_hdr_t zc_hdr;
+static const int16_t *zc_samples;
+static int zc_torn;
+/* statistics */
+static rfcap_stats_t stats;
+/* number of bytes sent, the value at the beginning of the throughput 
+ * measurement window */
+static volatile uint32_t bytes;
+static uint32_t rate_bytes;
+
+/* filter and decimate by 2, can be done in-situ */
+static int OPTIMIZE("O3") LOOP_UNROLL RFCap_HalfBand(rfcap_hb_t *hb, 
+    const int16_t *in, int num, int16_t *out)
+{
+    /* local copies of the state */
+    int idx = hb->idx, phase = hb->phase;
+    /* number of the output samples */
+    int out_num = 0;
+
+    /* process all input samples */
+    for (int n = 0; n < num; n++) {
+        /* store in the history (twice) */
+        hb->hist[idx] = hb->hist[idx + RFCAP_HB_TAPS] = in[n];
+        /* the window starts with the oldest sample */
+        if (++idx == RFCAP_HB_TAPS)
+            idx = 0;
+        /* only every second sample produces the output */
+        if ((phase = !phase))
+            continue;
+
+        /* center of the window */
+        const int16_t *c = hb->hist + idx + RFCAP_HB_TAPS / 2;
+        /* center tap */
+        int32_t acc = (int32_t)c[0] << 14;
+        /* symmetrical taps */
+        for (int j = 0; j < (int)elems(taps); j++)
+            acc += taps[j] * (c[-2 * j - 1] + c[2 * j + 1]);
+        /* round, saturate and store (the input sample was already consumed 
+         * so this works in-situ) */
+        out[out_num++] = Arch_SSAT((acc + (1 << 14)) >> 15, 16);
+    }
+
+    /* store the state */
+    hb->idx = idx, hb->phase = phase;
+    /* return the number of samples produced */
+    return out_num;
+}
+
+/* encode the sample with the mu-law */
+static inline ALWAYS_INLINE uint8_t RFCap_MuLawEncode(int32_t x)
+{
+    /* sign */
+    int sign = x < 0 ? 0x80 : 0;
+    /* biased magnitude of the scaled sample */
+    x = min(sign ? -x : x, RFCAP_MULAW_CLIP) + RFCAP_MULAW_BIAS;
+    /* segment: position of the leading one above the bit 7 */
+    int exp = 31 - __builtin_clz(x) - 7;
+    /* 4 bits that follow the leading one */
+    int mant = (x >> (exp + 3)) & 0xf;
+    /* codes are sent inverted */
+    return ~(sign | exp << 4 | mant);
+}
+
+/* pack the block into the payload, returns the number of samples */
+static int RFCap_Pack(const int16_t *samples, int num, rfcap_block_t *b)
+{
+    /* payload */
+    int16_t *s16 = b->data.s16; uint8_t *u8 = b->data.u8;
+
+    /* 8-bit codes of the undecimated samples */
+    if (dec == 1) {
+        for (int k = 0; k < num; k++)
+            u8[k] = RFCap_MuLawEncode(samples[k] << RFCAP_MULAW_SHIFT);
+        return num;
+    }
+
+    /* first half-band stage goes straight into the payload */
+    num = RFCap_HalfBand(&hb[0], samples, num, s16);
+    /* second one works in-situ */
+    if (dec == 4)
+        num = RFCap_HalfBand(&hb[1], s16, num, s16);
+    /* 8-bit codes (in-situ as well: code k never lands beyond the sample k) */
+    if (format == RFCAP_FMT_U8) {
+        for (int k = 0; k < num; k++)
+            u8[k] = RFCap_MuLawEncode(s16[k] << RFCAP_MULAW_SHIFT);
+    }
+
+    /* return the number of samples */
+    return num;
+}
+
+/* block was sent */
+static int RFCap_SentCallback(void *arg);
+
+/* start sending the block, to be called with the interrupts disabled */
+static void RFCap_Send(int b)
+{
+    /* status of the operation */
+    int rc;
+
+    /* mark as being sent */
+    inflight = b;
+    /* zero-copy one: the samples go from where they are */
+    if (b == RFCAP_ZERO_COPY) {
+        rc = USBRFCap_Send(&zc_hdr, sizeof(zc_hdr), zc_samples, 
+            RFCap_GetPayloadSize(&zc_hdr), RFCap_SentCallback);
+    /* header and the payload are continuous */
+    } else {
+        rc = USBRFCap_Send(&blocks[b].hdr, sizeof(blocks[b].hdr) + 
+            RFCap_GetPayloadSize(&blocks[b].hdr), 0, 0, RFCap_SentCallback);
+    }
+
+    /* endpoint was not there for us */
+    if (rc != EOK)
+        inflight = RFCAP_NONE, stats.dropped++;
+}
+
+/* block was sent */
+static int RFCap_SentCallback(void *arg)
+{
+    /* cast event argument */
+    usb_cbarg_t *ca = arg;
+
+    /* account the bytes and the block */
+    bytes += ca->size;
+    if (ca->error == EOK)
+        stats.sent++;
+    /* endpoint is free, send the block that waits */
+    inflight = RFCAP_NONE;
+    if (queued != RFCAP_NONE) {
+        int b = queued; queued = RFCAP_NONE; RFCap_Send(b);
+    }
+
+    /* report status */
+    return EOK;
+}
+
+/* apply the format change, called at the block boundary */
+static void RFCap_ApplyFormat(void)
+{
+    /* nothing has changed */
+    if (format == set_format && dec == set_dec)
+        return;
+
+    Critical_Enter();
+    /* capture gets enabled: counters start over */
+    if (format == RFCAP_FMT_OFF)
+        stats = (rfcap_stats_t) { 0 }, rate_bytes = bytes;
+    /* apply the settings */
+    format = set_format, dec = set_dec;
+    Critical_Exit();
+    /* decimators start with the empty history */
+    for (int i = 0; i < (int)elems(hb); i++)
+        hb[i] = (rfcap_hb_t) { .idx = 0 };
+}
+
+/* initialize the capture */
+int RFCap_Init(void)
+{
+    /* capture disabled */
+    set_format = format = RFCAP_FMT_OFF;
+    set_dec = dec = 1;
+
+    /* report status */
+    return EOK;
+}
+
+/* set the capture format */
+int RFCap_SetFormat(int format, int dec)
+{
+    /* sanity check */
+    if (format != RFCAP_FMT_OFF && format != RFCAP_FMT_S16 && 
+        format != RFCAP_FMT_U8)
+        return EFATAL;
+    if (dec != 1 && dec != 2 && dec != 4)
+        return EFATAL;
+
+    /* both values shall be applied together */
+    Critical_Enter();
+    set_format = format, set_dec = dec;
+    Critical_Exit();
+
+    /* report status */
+    return EOK;
+}
+
+/* get the capture format */
+int RFCap_GetFormat(int *format, int *dec)
+{
+    /* report the values */
+    Critical_Enter();
+    if (format)
+        *format = set_format;
+    if (dec)
+        *dec = set_dec;
+    Critical_Exit();
+
+    /* report status */
+    return EOK;
+}
+
+/* get the capture statistics */
+int RFCap_GetStats(rfcap_stats_t *s)
+{
+    /* counters are updated from within the interrupts */
+    Critical_Enter();
+    *s = stats;
+    Critical_Exit();
+
+    /* report status */
+    return EOK;
+}
+
+/* feed the block of the rf samples */
+void RFCap_PutSamples(const int16_t *samples, int num)
+{
+    /* zero-copy block is still being sent while the adc has come back to its 
+     * half of the buffer */
+    if (inflight == RFCAP_ZERO_COPY && !zc_torn)
+        stats.torn++, zc_torn = 1;
+
+    /* apply the format change */
+    RFCap_ApplyFormat();
+    /* capture is disabled */
+    if (format == RFCAP_FMT_OFF)
+        return;
+
+    /* block sequence number */
+    uint32_t seq = stats.blocks++;
+    /* update the throughput measurement */
+    if (stats.blocks % RFCAP_RATE_BLOCKS == 0) {
+        uint32_t b = bytes;
+        stats.rate = (uint64_t)(b - rate_bytes) * RF_SAMPLING_FREQ / 
+            ((uint64_t)num * RFCAP_RATE_BLOCKS);
+        rate_bytes = b;
+    }
+
+    /* zero-copy block: only the header gets prepared */
+    if (format == RFCAP_FMT_S16 && dec == 1) {
+        Critical_Enter();
+        /* previous transfer is still on */
+        if (inflight != RFCAP_NONE) {
+            stats.dropped++;
+        /* prepare the header and start sending */
+        } else {
+            zc_hdr = (rfcap_hdr_t) { .magic = RFCAP_MAGIC, .format = format, 
+                .dec = dec, .num = num, .torn = stats.torn, .seq = seq, 
+                .dropped = stats.dropped };
+            zc_samples = samples, zc_torn = 0;
+            RFCap_Send(RFCAP_ZERO_COPY);
+        }
+        Critical_Exit();
+        return;
+    }
+
+    /* both block buffers are taken */
+    if (queued != RFCAP_NONE) {
+        stats.dropped++; return;
+    }
+    /* use the buffer that is not being sent (no one else starts the 
+     * transfers of the buffers that are not queued) */
+    int b = inflight == 0 ? 1 : 0;
+    /* pack the samples */
+    num = RFCap_Pack(samples, num, &blocks[b]);
+    /* prepare the header */
+    blocks[b].hdr = (rfcap_hdr_t) { .magic = RFCAP_MAGIC, .format = format, 
+        .dec = dec, .num = num, .torn = stats.torn, .seq = seq, 
+        .dropped = stats.dropped };
+
+    /* send right away or wait for the current transfer to finish */
+    Critical_Enter();
+    if (inflight == RFCAP_NONE) {
+        RFCap_Send(b);
+    } else {
+        queued = b;
+    }
+    Critical_Exit();
+}
+
+/* decode the mu-law code */
+int16_t RFCap_MuLawDecode(uint8_t code)
+{
+    /* codes are sent inverted */
+    code = ~code;
+    /* segment and the 4 bits that follow the leading one */
+    int exp = (code >> 4) & 0x7, mant = code & 0xf;
+    /* magnitude */
+    int32_t x = (((mant << 3) + RFCAP_MULAW_BIAS) << exp) - RFCAP_MULAW_BIAS;
+    /* apply the sign and undo the scaling */
+    return (code & 0x80 ? -x : x) >> RFCAP_MULAW_SHIFT;
+}
+
+/* get the size of the block payload */
+int RFCap_GetPayloadSize(const rfcap_hdr_t *hdr)
+{
+    /* sanity check */
+    if (hdr->magic != RFCAP_MAGIC)
+        return EFATAL;
+    if (hdr->format != RFCAP_FMT_S16 && hdr->format != RFCAP_FMT_U8)
+        return EFATAL;
+    if (hdr->dec != 1 && hdr->dec != 2 && hdr->dec != 4)
+        return EFATAL;
+    if (hdr->num > RFCAP_BLOCK_SIZE / hdr->dec)
+        return EFATAL;
+
+    /* two bytes per 16-bit sample, one per mu-law code */
+    return hdr->num * (hdr->format == RFCAP_FMT_S16 ? 2 : 1);
+}
+
+/* unpack the block payload */
+int RFCap_Unpack(const rfcap_hdr_t *hdr, const void *payload, int16_t *out)
+{
+    /* validate the header */
+    int size = RFCap_GetPayloadSize(hdr);
+    if (size < 0)
+        return EFATAL;
+
+    /* 16-bit samples */
+    if (hdr->format == RFCAP_FMT_S16) {
+        memcpy(out, payload, size);
+    /* mu-law codes */
+    } else {
+        const uint8_t *u8 = payload;
+        for (int k = 0; k < hdr->num; k++)
+            out[k] = RFCap_MuLawDecode(u8[k]);
+    }
+
+    /* return the number of samples */
+    return hdr->num;
+}
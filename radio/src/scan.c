@@ -0,0 +1,262 @@
+/**
+ * @file scan.c
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Wideband scan. For every band of the 1st local oscillator the rf
+ * callback captures 'dwell' SCAN_SIZE long frames (after letting the
+ * decimator settle), the invoked callback windows them, transforms them and
+ * sums the power of the bins that make up each of the channels. Band b
+ * measures the channels centered at b * MIX1_BAND_SPACING + k *
+ * SCAN_CHANNEL_WIDTH for k = -SCAN_CHANNELS_PER_BAND / 2 ...
+ * SCAN_CHANNELS_PER_BAND / 2 - 1, so that the whole range gets covered with
+ * no gaps.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "compiler.h"
+#include "config.h"
+#include "err.h"
+#include "dev/invoke.h"
+#include "dsp/pspec.h"
+#include "radio/scan.h"
+#include "util/fp.h"
+#include "util/minmax.h"
+
+/* number of the fft bins per channel */
+#define SCAN_BINS_PER_CHANNEL                                               \
+    (SCAN_CHANNEL_WIDTH * SCAN_SIZE / BB_SAMPLING_RATE)
+/* number of the fft bins used per band */
+#define SCAN_BINS                                                           \
+    (SCAN_BINS_PER_CHANNEL * SCAN_CHANNELS_PER_BAND)
+/* first bin used (relative to the band center) */
+#define SCAN_FIRST_BIN                                                      \
+    (-SCAN_CHANNELS_PER_BAND / 2 * SCAN_BINS_PER_CHANNEL -                  \
+    SCAN_BINS_PER_CHANNEL / 2)
+/* noise floor histogram: lowest level and the number of 1dB bins */
+#define SCAN_HIST_MIN                       -160
+#define SCAN_HIST_BINS                      160
+
+/* scanner states */
+static volatile enum scan_states { IDLE, TUNING, MEASURING } state;
+/* re-tuning callback and its argument */
+static cb_t callback;
+static scan_cbarg_t callback_arg;
+/* number of frames per band, currently measured band and the number of the
+ * bands that are done */
+static int dwell, band;
+static volatile int bands_done;
+
+/* rf frames left to skip, number of captured samples */
+static int settle, fill;
+/* captured frame is being processed */
+static volatile int busy;
+/* captured frame */
+static float cap_i[SCAN_SIZE], cap_q[SCAN_SIZE];
+
+/* power spectrum of the frames */
+static pspec_t pspec;
+/* accumulated power of the bins in use, number of accumulated frames */
+static float acc[SCAN_BINS];
+static int acc_num;
+
+/* channel levels [dB] and the noise floor */
+static float levels[SCAN_CHANNELS], floor_level;
+
+/* re-tune to the current band and start the measurements */
+static void Scan_Tune(void)
+{
+    /* the rf callback ignores the data in the meantime */
+    state = TUNING;
+    /* let the radio do it's job */
+    callback_arg.frequency = band * MIX1_BAND_SPACING, callback_arg.done = 0;
+    callback(&callback_arg);
+    /* start over */
+    settle = SCAN_SETTLE, fill = 0, acc_num = 0;
+    /* measurements can now take place */
+    state = MEASURING;
+}
+
+/* tuning to the first band */
+static int Scan_TuneCallback(void *ptr)
+{
+    /* scan was stopped in the meantime */
+    if (state == TUNING)
+        Scan_Tune();
+    /* report status */
+    return EOK;
+}
+
+/* update the noise floor: median of all the measured channels */
+static void Scan_UpdateFloor(int channels)
+{
+    /* histogram of the levels */
+    uint16_t hist[SCAN_HIST_BINS] = { 0 };
+
+    /* build it */
+    for (int c = 0; c < channels; c++)
+        hist[min(SCAN_HIST_BINS - 1, max(0, (int)(levels[c] -
+            SCAN_HIST_MIN)))]++;
+    /* find the median */
+    int b = 0;
+    for (int cnt = hist[0]; cnt < (channels + 1) / 2; cnt += hist[++b]);
+    /* store it (center of the histogram bin) */
+    floor_level = SCAN_HIST_MIN + b + 0.5f;
+}
+
+/* process the captured frame */
+static int OPTIMIZE("O3") Scan_ProcessCallback(void *ptr)
+{
+    /* scan was stopped or re-started */
+    if (state != MEASURING) {
+        busy = 0; return EOK;
+    }
+
+    /* apply window and convert to Q31 */
+    PSpec_Load(&pspec, cap_i, cap_q);
+    /* frame can now be overwritten */
+    busy = 0;
+
+    /* do the transform, accumulate the power of the bins in use */
+    PSpec_Accumulate(&pspec, acc, SCAN_FIRST_BIN, SCAN_BINS, acc_num);
+    /* band is not complete yet */
+    if (++acc_num < dwell)
+        return EOK;
+
+    /* power of the full scale tone, the channel sums the power that the
+     * window has spread over the neighbouring bins */
+    const float ref = PSPEC_NOISE_BW * PSPEC_FULL_SCALE * acc_num;
+    /* channel levels */
+    for (int k = 0; k < SCAN_CHANNELS_PER_BAND; k++) {
+        /* channel number */
+        int c = band * SCAN_CHANNELS_PER_BAND + k -
+            SCAN_CHANNELS_PER_BAND / 2;
+        /* outside of the table (edges of the range) */
+        if (c < 0 || c >= SCAN_CHANNELS)
+            continue;
+        /* sum the power */
+        float p = 1;
+        for (int m = 0; m < SCAN_BINS_PER_CHANNEL; m++)
+            p += acc[k * SCAN_BINS_PER_CHANNEL + m];
+        /* express in dB (10 * log10(x) with the natural logarithm) */
+        levels[c] = 10 / 2.302585093f * fp_log(p / ref);
+    }
+    /* band is done */
+    bands_done = ++band;
+    /* noise floor of all the channels that were measured so far */
+    Scan_UpdateFloor(min(SCAN_CHANNELS, band * SCAN_CHANNELS_PER_BAND -
+        SCAN_CHANNELS_PER_BAND / 2));
+
+    /* go to the next band */
+    if (band < SCAN_BANDS) {
+        Scan_Tune();
+    /* all done */
+    } else {
+        state = IDLE;
+        callback_arg.done = 1; callback(&callback_arg);
+    }
+
+    /* report status */
+    return EOK;
+}
+
+/* initialize the scanner */
+int Scan_Init(void)
+{
+    /* channels must be made of whole bins and fill the bands */
+    if (SCAN_BINS_PER_CHANNEL * BB_SAMPLING_RATE !=
+        SCAN_CHANNEL_WIDTH * SCAN_SIZE ||
+        SCAN_CHANNELS_PER_BAND * SCAN_CHANNEL_WIDTH != MIX1_BAND_SPACING)
+        return EFATAL;
+    /* prepare the window, fft must be able to handle the frame */
+    if (PSpec_Init(&pspec, SCAN_SIZE) != EOK)
+        return EFATAL;
+    /* nothing is going on */
+    state = IDLE, busy = 0, bands_done = 0;
+
+    /* report status */
+    return EOK;
+}
+
+/* start the scan */
+int Scan_Start(int _dwell, cb_t cb)
+{
+    /* sanity check */
+    if (_dwell < 1 || _dwell > SCAN_MAX_DWELL || !cb)
+        return EFATAL;
+
+    /* the rf callback ignores the data from now on */
+    state = TUNING;
+    /* store the settings */
+    dwell = _dwell, callback = cb;
+    /* start from the first band */
+    band = 0, bands_done = 0;
+    /* re-tuning is done elsewhere */
+    Invoke_CallMeElsewhere(Scan_TuneCallback, 0);
+
+    /* report status */
+    return EOK;
+}
+
+/* stop the scan */
+int Scan_Stop(void)
+{
+    /* pending callbacks will see that */
+    state = IDLE;
+    /* report status */
+    return EOK;
+}
+
+/* feed the baseband samples */
+void Scan_PutSamples(const float *i, const float *q, int num)
+{
+    /* not measuring or the frame is still being processed */
+    if (state != MEASURING || busy)
+        return;
+    /* let the decimator settle after the re-tuning */
+    if (settle) {
+        settle--; return;
+    }
+
+    /* store the samples */
+    int n = min(num, SCAN_SIZE - fill);
+    memcpy(cap_i + fill, i, n * sizeof(*i));
+    memcpy(cap_q + fill, q, n * sizeof(*q));
+    fill += n;
+
+    /* frame is complete: process it elsewhere */
+    if (fill == SCAN_SIZE) {
+        busy = 1, fill = 0;
+        Invoke_CallMeElsewhere(Scan_ProcessCallback, 0);
+    }
+}
+
+/* get the scan progress */
+int Scan_GetProgress(int *running, int *bands)
+{
+    /* report the values */
+    *running = state != IDLE, *bands = bands_done;
+    /* report status */
+    return EOK;
+}
+
+/* get the channel from the occupancy table */
+int Scan_GetChannel(int ch, float *frequency, float *level, float *snr)
+{
+    /* sanity check */
+    if (ch < 0 || ch >= SCAN_CHANNELS)
+        return EFATAL;
+    /* band that measures the channel is not done yet */
+    if ((ch + SCAN_CHANNELS_PER_BAND / 2) / SCAN_CHANNELS_PER_BAND >=
+        bands_done)
+        return ENOINIT;
+
+    /* report the values */
+    *frequency = (float)ch * SCAN_CHANNEL_WIDTH;
+    *level = levels[ch], *snr = levels[ch] - floor_level;
+    /* report status */
+    return EOK;
+}
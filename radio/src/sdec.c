@@ -0,0 +1,171 @@
+/**
+ * @file sdec.c
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Software decimators for the I/Q channels
+ */
+
+#include <stdint.h>
+
+#include "assert.h"
+#include "compiler.h"
+#include "config.h"
+#include "dsp/hband.h"
+#include "err.h"
+#include "radio/sdec.h"
+#include "sys/cb.h"
+
+/* number of the cic output samples that are passed through the half-band
+ * stages at once */
+#define SDEC_BLOCK                          64
+
+/* single channel state */
+typedef struct sdec_chan {
+    /* integrators */
+    uint32_t int1, int2, int3;
+    /* comb delay elements */
+    uint32_t comb1, comb2, comb3;
+    /* input sample counter used for selecting the output samples */
+    int cnt;
+    /* droop compensation filter delay line */
+    float comp1, comp2;
+    /* half-band filters */
+    hband_t hb[SDEC_MAX_HB_STAGES];
+} sdec_chan_t;
+
+/* filters for both channels */
+static sdec_chan_t chan_i, chan_q;
+/* cic decimation rate and the number of half-band stages */
+static int cic_rate, hb_stages;
+/* cic output normalization factor */
+static float cic_scale;
+/* callback argument */
+static sdec_cbarg_t callback_arg;
+
+/* run the block of samples through the half-band stages (in-situ), returns
+ * the number of the output samples */
+static int SDec_HalfBands(sdec_chan_t *f, float *buf, int num, float *out)
+{
+    /* decimate by 2 in every stage */
+    for (int s = 0; s < hb_stages; s++)
+        num = HBand_Decimate(&f->hb[s], buf, num, buf);
+    /* store the result */
+    for (int k = 0; k < num; k++)
+        out[k] = buf[k];
+
+    /* return the number of samples produced */
+    return num;
+}
+
+/* process the data of a single channel, returns the number of output
+ * samples */
+static int OPTIMIZE("O3") SDec_Channel(sdec_chan_t *f, const int16_t *in,
+    int num, float *out)
+{
+    /* local copies of the state */
+    uint32_t i1 = f->int1, i2 = f->int2, i3 = f->int3;
+    uint32_t c1 = f->comb1, c2 = f->comb2, c3 = f->comb3, d1, d2, d3;
+    float comp1 = f->comp1, comp2 = f->comp2;
+    /* input counter and the rate */
+    int cnt = f->cnt, rate = cic_rate;
+    /* output pointer */
+    float *o = out;
+    /* block of the cic outputs for the half-band stages */
+    float buf[SDEC_BLOCK]; int buf_num = 0;
+
+    /* process all samples */
+    for (int k = 0; k < num; k++) {
+        /* integrator section, arithmetic is done modulo 2^32 as the combs
+         * remove any overflows that the integrators have produced */
+        i1 += (uint32_t)(int32_t)in[k]; i2 += i1; i3 += i2;
+        /* decimation */
+        if (++cnt < rate)
+            continue;
+        /* reset the counter */
+        cnt = 0;
+        /* comb section */
+        d1 = i3 - c1; c1 = i3;
+        d2 = d1 - c2; c2 = d1;
+        d3 = d2 - c3; c3 = d2;
+
+        /* normalize */
+        float x = (int32_t)d3 * cic_scale;
+        /* compensate for the sinc^3 droop: 1 + (pi * f)^2 / 2 approximated
+         * with the 3-tap filter */
+        float y = 1.25f * comp1 - 0.125f * (x + comp2);
+        comp2 = comp1, comp1 = x;
+
+        /* collect the samples for the half-band stages */
+        buf[buf_num++] = y;
+        if (buf_num == SDEC_BLOCK)
+            o += SDec_HalfBands(f, buf, buf_num, o), buf_num = 0;
+    }
+    /* flush the incomplete block */
+    o += SDec_HalfBands(f, buf, buf_num, o);
+
+    /* store the state */
+    f->int1 = i1, f->int2 = i2, f->int3 = i3;
+    f->comb1 = c1, f->comb2 = c2, f->comb3 = c3;
+    f->comp1 = comp1, f->comp2 = comp2;
+    f->cnt = cnt;
+
+    /* return the number of samples produced */
+    return o - out;
+}
+
+/* initialize decimator */
+int SDec_Init(int rate)
+{
+    /* number of the half-band stages */
+    int stages = 0;
+
+    /* use as many half-band stages as possible */
+    while (stages < SDEC_MAX_HB_STAGES && rate % (2 << stages) == 0 &&
+        rate / (2 << stages) >= SDEC_MIN_CIC_RATE)
+        stages++;
+    /* rate of the cic filter */
+    int rate_cic = rate >> stages;
+    /* the cic filter output must fit within 32 bits: the gain is rate^3 */
+    if (rate_cic < SDEC_MIN_CIC_RATE || (int64_t)rate_cic * rate_cic *
+        rate_cic << (DEC_MAX_INPUT_BITS - 1) > INT32_MAX)
+        return EFATAL;
+
+    /* store the configuration */
+    cic_rate = rate_cic, hb_stages = stages;
+    /* full scale input is to be represented as 1.0 at the output */
+    cic_scale = 1.0f / ((float)rate_cic * rate_cic * rate_cic *
+        (1 << (DEC_MAX_INPUT_BITS - 1)));
+    /* reset the filters */
+    chan_i = (sdec_chan_t) { 0 }, chan_q = (sdec_chan_t) { 0 };
+    for (int s = 0; s < stages; s++) {
+        HBand_Init(&chan_i.hb[s], SDEC_HB_TAPS);
+        HBand_Init(&chan_q.hb[s], SDEC_HB_TAPS);
+    }
+
+    /* report status */
+    return EOK;
+}
+
+/* perform filtration and decimation */
+sdec_cbarg_t * SDec_Decimate(const int16_t *i, const int16_t *q, int num,
+    float *i_out,  float *q_out, cb_t cb)
+{
+    /* sanity check for the number of samples */
+    assert(num % (cic_rate << hb_stages) == 0,
+        "number of samples is not divisible by the decimation factor", num);
+
+    /* run both channels */
+    callback_arg.num = SDec_Channel(&chan_i, i, num, i_out);
+    SDec_Channel(&chan_q, q, num, q_out);
+    /* set-up the callback argument */
+    callback_arg.i = i_out, callback_arg.q = q_out;
+
+    /* async call was made? */
+    if (cb != CB_SYNC && cb != CB_NONE)
+        cb(&callback_arg);
+
+    /* report the argument for sync calls */
+    return cb == CB_SYNC ? &callback_arg : 0;
+}
@@ -0,0 +1,185 @@
+/**
+ * @file spectrum.c
+ *
+ * @date 2026-10-17
+ * @author twatorowski
+ *
+ * @brief Spectrum (waterfall) engine. The rf callback only copies the
+ * SPECTRUM_SIZE samples long frames (one every BB_SAMPLING_RATE / (rate *
+ * average) samples), everything else (hann window, fft, averaging and the
+ * log-compression) is done in the invoked callback while the next frame is
+ * awaited.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "compiler.h"
+#include "config.h"
+#include "err.h"
+#include "dev/invoke.h"
+#include "dsp/pspec.h"
+#include "radio/spectrum.h"
+#include "sys/critical.h"
+#include "util/fp.h"
+#include "util/minmax.h"
+
+/* settings: lines per second, frames per line, samples between the frame
+ * starts */
+static volatile int rate, average, period;
+/* samples left till the next frame capture, number of captured samples */
+static int countdown, fill;
+/* captured frame is being processed */
+static volatile int busy;
+/* captured frame */
+static float cap_i[SPECTRUM_SIZE], cap_q[SPECTRUM_SIZE];
+
+/* power spectrum of the frames */
+static pspec_t pspec;
+/* accumulated power, number of accumulated frames and the number of frames
+ * that make up the line */
+static float acc[SPECTRUM_SIZE];
+static int acc_num, acc_average;
+
+/* latest line and its sequence number */
+static uint8_t line[SPECTRUM_SIZE];
+static uint32_t line_seq;
+
+/* process the captured frame */
+static int OPTIMIZE("O3") Spectrum_ProcessCallback(void *ptr)
+{
+    /* new line: frames per line are latched */
+    if (acc_num == 0)
+        acc_average = average;
+
+    /* apply window and convert to Q31 */
+    PSpec_Load(&pspec, cap_i, cap_q);
+    /* frame can now be overwritten */
+    busy = 0;
+
+    /* do the transform, accumulate the power */
+    PSpec_Accumulate(&pspec, acc, 0, SPECTRUM_SIZE, acc_num);
+
+    /* line is not complete yet */
+    if (++acc_num < acc_average)
+        return EOK;
+
+    /* power of the full scale tone */
+    const float ref = PSPEC_FULL_SCALE * acc_num;
+    /* 10 * log10(x) expressed with the natural logarithm and converted to
+     * the bin steps */
+    const float k_db = 10 / 2.302585093f / SPECTRUM_DB_STEP;
+
+    /* bins are stored with the negative frequencies first */
+    uint8_t bins[SPECTRUM_SIZE];
+    for (int m = 0; m < SPECTRUM_SIZE; m++) {
+        /* power relative to the full scale (avoid the log of zero) */
+        float p = (acc[(m + SPECTRUM_SIZE / 2) & (SPECTRUM_SIZE - 1)] + 1) /
+            ref;
+        /* log-compress */
+        float b = k_db * fp_log(p) - SPECTRUM_DB_MIN / SPECTRUM_DB_STEP;
+        bins[m] = (uint8_t)min(255.0f, max(0.0f, b + 0.5f));
+    }
+    /* start over */
+    acc_num = 0;
+
+    /* publish */
+    Critical_Enter();
+    memcpy(line, bins, sizeof(line)); line_seq++;
+    Critical_Exit();
+
+    /* report status */
+    return EOK;
+}
+
+/* initialize the spectrum engine */
+int Spectrum_Init(void)
+{
+    /* prepare the window, fft must be able to handle the frame */
+    if (PSpec_Init(&pspec, SPECTRUM_SIZE) != EOK)
+        return EFATAL;
+    /* drop the accumulated data */
+    acc_num = 0, fill = 0, countdown = 0, busy = 0;
+
+    /* apply the default settings */
+    return Spectrum_SetRate(SPECTRUM_RATE, SPECTRUM_AVERAGE);
+}
+
+/* set the rate at which the spectrum lines are produced */
+int Spectrum_SetRate(int _rate, int _average)
+{
+    /* sanity check */
+    if (_rate < 0 || _average < 1 || _average > SPECTRUM_MAX_AVERAGE ||
+        _rate * _average * SPECTRUM_SIZE > BB_SAMPLING_RATE)
+        return EFATAL;
+
+    /* the rf callback reads all three */
+    Critical_Enter();
+    rate = _rate, average = _average;
+    period = _rate ? BB_SAMPLING_RATE / (_rate * _average) : 0;
+    Critical_Exit();
+
+    /* report status */
+    return EOK;
+}
+
+/* get the rate settings */
+int Spectrum_GetRate(int *_rate, int *_average)
+{
+    /* report the values */
+    *_rate = rate, *_average = average;
+    /* report status */
+    return EOK;
+}
+
+/* feed the baseband samples */
+void Spectrum_PutSamples(const float *i, const float *q, int num)
+{
+    /* samples that precede the frame start, samples stored */
+    int start, n;
+
+    /* process all samples, more than one frame may start within the call */
+    for (; num && period; i += start + n, q += start + n, num -= start + n) {
+        /* no samples to skip while the frame is being captured */
+        start = 0;
+        /* waiting for the frame start */
+        if (fill == 0) {
+            /* consume the samples that precede the frame start */
+            start = min(num, countdown); countdown -= start;
+            /* frame is not due yet, starts with the next call or the
+             * previous one is still being processed */
+            if (countdown || start == num || busy)
+                return;
+            /* next frame starts one period after this one */
+            countdown = period;
+        }
+
+        /* store the samples */
+        n = min(num - start, SPECTRUM_SIZE - fill);
+        memcpy(cap_i + fill, i + start, n * sizeof(*i));
+        memcpy(cap_q + fill, q + start, n * sizeof(*q));
+        /* account them */
+        fill += n, countdown -= n;
+
+        /* frame is complete: process it elsewhere */
+        if (fill == SPECTRUM_SIZE) {
+            busy = 1, fill = 0;
+            Invoke_CallMeElsewhere(Spectrum_ProcessCallback, 0);
+        }
+    }
+}
+
+/* get the latest spectrum line */
+int Spectrum_GetLine(uint32_t *seq, uint8_t *bins)
+{
+    /* line is updated from the invoked callback */
+    Critical_Enter();
+    /* copy the data */
+    *seq = line_seq;
+    if (bins)
+        memcpy(bins, line, sizeof(line));
+    Critical_Exit();
+
+    /* report status */
+    return EOK;
+}
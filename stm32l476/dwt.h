@@ -0,0 +1,52 @@
+/**
+ * @file dwt.h
+ * 
+ * @date 2026-10-17
+ * @author twatorowski
+ * 
+ * @brief STM32 Headers: DWT (Data Watchpoint and Trace unit)
+ */
+
+#ifndef STM32L476_DWT_H_
+#define STM32L476_DWT_H_
+
+#include "stm32l476/stm32l476.h"
+
+/* register base */
+#define DWT_BASE							(0xE0001000)
+/* registers */
+#define DWT									((dwt_t *) DWT_BASE)
+
+/* data watchpoint and trace registers */
+typedef struct {
+	reg32_t CTRL;
+	reg32_t CYCCNT;
+	reg32_t CPICNT;
+	reg32_t EXCCNT;
+	reg32_t SLEEPCNT;
+	reg32_t LSUCNT;
+	reg32_t FOLDCNT;
+	reg32_t PCSR;
+} __attribute__((packed, aligned(4))) dwt_t;
+
+/* Control Register Definitions */
+#define DWT_CTRL_NUMCOMP					0xF0000000
+#define DWT_CTRL_NOTRCPKT					0x08000000
+#define DWT_CTRL_NOEXTTRIG					0x04000000
+#define DWT_CTRL_NOCYCCNT					0x02000000
+#define DWT_CTRL_NOPRFCNT					0x01000000
+#define DWT_CTRL_CYCEVTENA					0x00400000
+#define DWT_CTRL_FOLDEVTENA					0x00200000
+#define DWT_CTRL_LSUEVTENA					0x00100000
+#define DWT_CTRL_SLEEPEVTENA				0x00080000
+#define DWT_CTRL_EXCEVTENA					0x00040000
+#define DWT_CTRL_CPIEVTENA					0x00020000
+#define DWT_CTRL_EXCTRCENA					0x00010000
+#define DWT_CTRL_PCSAMPLENA					0x00001000
+#define DWT_CTRL_SYNCTAP					0x00000C00
+#define DWT_CTRL_CYCTAP						0x00000200
+#define DWT_CTRL_POSTINIT					0x000001E0
+#define DWT_CTRL_POSTPRESET					0x0000001E
+#define DWT_CTRL_CYCCNTENA					0x00000001
+
+#endif /* STM32L476_DWT_H_ */
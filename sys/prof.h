@@ -0,0 +1,70 @@
+/**
+ * @file prof.h
+ * 
+ * @date 2026-10-17
+ * @author twatorowski 
+ * 
+ * @brief Execution time profiler: gathers min/avg/max/p99 statistics of the 
+ * cycle counts reported for given code fragment. Percentiles are estimated 
+ * using the logarithmic histogram (8 bins per octave, so the p99 value is 
+ * reported with at most 12.5% of overestimation)
+ */
+
+#ifndef SYS_PROF_H_
+#define SYS_PROF_H_
+
+#include <stdint.h>
+
+/** @brief number of histogram bins per octave (must be a power of 2) */
+#define PROF_BINS_PER_OCTAVE                        8
+/** @brief histogram resolution: largest value in the histogram is 
+ * 2^PROF_MAX_OCTAVE, everything above that lands in the last bin */
+#define PROF_MAX_OCTAVE                             20
+/** @brief number of histogram bins */
+#define PROF_BINS_NUM                               (PROF_BINS_PER_OCTAVE * \
+    (PROF_MAX_OCTAVE - 2))
+
+/** @brief profiler data */
+typedef struct prof {
+    /* minimal and maximal value */
+    uint32_t min, max;
+    /* number of samples */
+    uint32_t cnt;
+    /* sum of all samples */
+    uint64_t sum;
+    /* histogram */
+    uint16_t hist[PROF_BINS_NUM];
+} prof_t;
+
+/** @brief profiler statistics */
+typedef struct prof_stats {
+    /* minimal, average, maximal value and the 99th percentile */
+    uint32_t min, avg, max, p99;
+    /* number of samples */
+    uint32_t cnt;
+} prof_stats_t;
+
+/**
+ * @brief Reset the profiler data
+ * 
+ * @param p profiler data
+ */
+void Prof_Reset(prof_t *p);
+
+/**
+ * @brief Update the profiler data with the new sample.
+ * 
+ * @param p profiler data
+ * @param cycles sample value (usually number of cpu cycles)
+ */
+void Prof_Update(prof_t *p, uint32_t cycles);
+
+/**
+ * @brief Compute the statistics from the profiler data
+ * 
+ * @param p profiler data
+ * @param s statistics placeholder
+ */
+void Prof_GetStats(const prof_t *p, prof_stats_t *s);
+
+#endif /* SYS_PROF_H_ */
@@ -0,0 +1,106 @@
+/**
+ * @file prof.c
+ * 
+ * @date 2026-10-17
+ * @author twatorowski 
+ * 
+ * @brief Execution time profiler
+ */
+
+#include <stdint.h>
+
+#include "compiler.h"
+#include "sys/prof.h"
+#include "util/elems.h"
+#include "util/minmax.h"
+
+/* number of bits that encode the position within the octave */
+#define PROF_OCTAVE_BITS            (__builtin_ctz(PROF_BINS_PER_OCTAVE))
+
+/* convert value to the histogram bin index. values below PROF_BINS_PER_OCTAVE
+ * have their own bins, all other are binned logarithmically */
+static int Prof_GetBin(uint32_t v)
+{
+    /* exact bins */
+    if (v < PROF_BINS_PER_OCTAVE)
+        return v;
+
+    /* octave (position of the leading one) */
+    int e = 31 - __builtin_clz(v);
+    /* past the histogram range */
+    if (e >= PROF_MAX_OCTAVE)
+        return PROF_BINS_NUM - 1;
+    /* bits that follow the leading one select the bin within the octave */
+    int m = (v >> (e - PROF_OCTAVE_BITS)) & (PROF_BINS_PER_OCTAVE - 1);
+    /* build up the index */
+    return (e - PROF_OCTAVE_BITS + 1) * PROF_BINS_PER_OCTAVE + m;
+}
+
+/* return the largest value that falls into given bin */
+static uint32_t Prof_GetBinUpperBound(int bin)
+{
+    /* exact bins */
+    if (bin < PROF_BINS_PER_OCTAVE)
+        return bin;
+
+    /* octave */
+    int e = bin / PROF_BINS_PER_OCTAVE + PROF_OCTAVE_BITS - 1;
+    /* position within the octave */
+    int m = bin % PROF_BINS_PER_OCTAVE;
+    /* the next bin starts right after this one */
+    return ((uint32_t)(PROF_BINS_PER_OCTAVE + m + 1) << 
+        (e - PROF_OCTAVE_BITS)) - 1;
+}
+
+/* reset the profiler data */
+void Prof_Reset(prof_t *p)
+{
+    /* clear everything */
+    *p = (prof_t) { .min = UINT32_MAX };
+}
+
+/* update the profiler data with new sample */
+void Prof_Update(prof_t *p, uint32_t cycles)
+{
+    /* update the extremes */
+    p->min = min(p->min, cycles), p->max = max(p->max, cycles);
+    /* update the accumulators */
+    p->cnt++, p->sum += cycles;
+
+    /* get the histogram bin */
+    uint16_t *h = &p->hist[Prof_GetBin(cycles)];
+    /* bin is about to saturate: scale down the whole histogram, this keeps 
+     * the proportions (and thus the percentiles) while favoring the recent 
+     * samples */
+    if (*h == UINT16_MAX)
+        for (int i = 0; i < (int)elems(p->hist); i++)
+            p->hist[i] >>= 1;
+    /* store the sample */
+    *h += 1;
+}
+
+/* compute the statistics */
+void Prof_GetStats(const prof_t *p, prof_stats_t *s)
+{
+    /* number of samples in the histogram */
+    uint32_t total = 0, acc = 0; int i;
+
+    /* no samples were gathered */
+    if (!p->cnt) {
+        *s = (prof_stats_t) { 0 }; return;
+    }
+
+    /* sum up the histogram */
+    for (i = 0; i < (int)elems(p->hist); i++)
+        total += p->hist[i];
+    /* look for the bin that contains the 99th percentile */
+    for (i = 0; i < (int)elems(p->hist) - 1; i++)
+        if ((acc += p->hist[i]) * 100 >= total * 99)
+            break;
+
+    /* store the results */
+    s->min = p->min, s->max = p->max, s->cnt = p->cnt;
+    s->avg = p->sum / p->cnt;
+    /* bin boundary may exceed the actual maximum */
+    s->p99 = min(Prof_GetBinUpperBound(i), p->max);
+}
@@ -14,6 +14,7 @@
 #include "dev/dec.h"
 #include "dev/led.h"
 #include "dev/timemeas.h"
+#include "dsp/float_fixp.h"
 #include "radio/mix1.h"
 #include "radio/mix2.h"
 #include "radio/demod_am.h"
@@ -160,9 +161,11 @@ int TestAMRadio_Init(void)
 {
     /* products of the 1st stage mixer */
     int16_t i_mix1[elems(rf)], q_mix1[elems(rf)];
+    /* decimated data */
+    int32_t i_dec32[elems(rf) / DEC_DECIMATION_RATE];
+    int32_t q_dec32[elems(rf) / DEC_DECIMATION_RATE];
     /* float data */
-    float i_dec[elems(rf) / DEC_DECIMATION_RATE];
-    float q_dec[elems(rf) / DEC_DECIMATION_RATE];
+    float i_dec[elems(i_dec32)], q_dec[elems(q_dec32)];
     /* demodulated output */
     float dem[elems(i_dec)];
 
@@ -176,7 +179,10 @@ int TestAMRadio_Init(void)
     /* do the mixing */
     Mix1_Mix(rf, elems(rf), i_mix1, q_mix1);
     /* decimate data */
-    Dec_Decimate(i_mix1, q_mix1, elems(rf), i_dec, q_dec, CB_SYNC);
+    Dec_Decimate(i_mix1, q_mix1, elems(rf), i_dec32, q_dec32, CB_SYNC);
+    /* convert to floating point */
+    FloatFixp_Fixp32ToFloat(i_dec32, elems(i_dec32), 31, i_dec);
+    FloatFixp_Fixp32ToFloat(q_dec32, elems(q_dec32), 31, q_dec);
     /* do the mixing */
     Mix2_Mix(i_dec, q_dec, elems(i_dec), i_dec, q_dec);
     /* demodulate the output data */
@@ -71,8 +71,8 @@ static const uint16_t ALIGNED(4) sine_lut[] = {
 };
 
 /* output results holding array */
-static float i_out[elems(sine_lut) / DEC_DECIMATION_RATE];
-static float q_out[elems(sine_lut) / DEC_DECIMATION_RATE];
+static int32_t i_out[elems(sine_lut) / DEC_DECIMATION_RATE];
+static int32_t q_out[elems(sine_lut) / DEC_DECIMATION_RATE];
 /* decimation counter */
 static int cnt = 0;
 
@@ -83,8 +83,9 @@ static int TestDec_DecimationDoneCallback(void *ptr)
     if (ptr && cnt < 10000) {
         /* compare two outputs */
         for (int i = 0; i < elems(i_out); i++) {
-            /* compare */
-            assert(i_out[i] == q_out[i], "decimated outputs differ", cnt);
+            /* compare (lowest byte holds the channel number) */
+            assert(i_out[i] >> 8 == q_out[i] >> 8, "decimated outputs differ", 
+                cnt);
             /* clear arrays */
             i_out[i] = q_out[i] = 0;
         }
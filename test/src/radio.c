@@ -38,8 +38,10 @@ static int16_t rf[RF_SAMPLING_FREQ * 2 / 1000];
 /* complex data after 1st stage mixing */
 static int16_t i_mix1[elems(rf) / 2], q_mix1[elems(rf) / 2];
 /* decimation result holding array, set up as ping-pong buffer */
-static float i_dec[2][elems(i_mix1) / DEC_DECIMATION_RATE],
-             q_dec[2][elems(q_mix1) / DEC_DECIMATION_RATE];
+static int32_t i_dec[2][elems(i_mix1) / DEC_DECIMATION_RATE],
+               q_dec[2][elems(q_mix1) / DEC_DECIMATION_RATE];
+/* decimated data converted to the floating point notation */
+static float i_bb[elems(i_dec[0])], q_bb[elems(q_dec[0])];
 /* ping pong indicator */
 static volatile int pp;
 
@@ -246,8 +248,8 @@ static int TestRadio_AnalogCallback(void *ptr)
     /* update the ping-pong counter */
     pp = !pp;
     /* head/tail adjusted pointers to the ping-pong buffer phase indicator */
-    float *i_dec_head = i_dec[ pp], *q_dec_head = q_dec[ pp];
-    float *i_dec_tail = i_dec[!pp], *q_dec_tail = q_dec[!pp];
+    int32_t *i_dec_head = i_dec[ pp], *q_dec_head = q_dec[ pp];
+    int32_t *i_dec_tail = i_dec[!pp], *q_dec_tail = q_dec[!pp];
 
     /* do the mixing */
     Mix1_Mix(ea->samples, ea->num, i_mix1, q_mix1);
@@ -259,13 +261,16 @@ static int TestRadio_AnalogCallback(void *ptr)
     Dec_Decimate(i_mix1, q_mix1, ea->num, i_dec_head, q_dec_head, 
         TestRadio_DecimationCallback);
     
+    /* convert the previous frame to the floating point notation */
+    FloatFixp_Fixp32ToFloat(i_dec_tail, dec_num, 31, i_bb);
+    FloatFixp_Fixp32ToFloat(q_dec_tail, dec_num, 31, q_bb);
     /* 2nd stage mixing, done in-situ */
-    Mix2_Mix(i_dec_tail, q_dec_tail, dec_num, i_dec_tail, q_dec_tail);
+    Mix2_Mix(i_bb, q_bb, dec_num, i_bb, q_bb);
 
     /* filter before demodulation */
-    DemodAM_Filter(i_dec_tail, q_dec_tail, dec_num, i_dec_tail, q_dec_tail);
+    DemodAM_Filter(i_bb, q_bb, dec_num, i_bb, q_bb);
     /* demodulate the output data */
-    DemodAM_Demodulate(i_dec_tail, q_dec_tail, dec_num, dem);
+    DemodAM_Demodulate(i_bb, q_bb, dec_num, dem);
 
     /* apply gain */
     FloatScale_Scale(dem, dec_num, 10.0, dem);
@@ -26,8 +26,8 @@ static alignas(4)int16_t rf[DEC_DECIMATION_RATE * 2 * 20];
 /* mixed samples buffer */
 static ALIGNED(4) int16_t i_mix[elems(rf) / 2], q_mix[elems(rf) / 2];
 /* output results holding array */
-static float i_out[2][elems(i_mix) / DEC_DECIMATION_RATE];
-static float q_out[2][elems(q_mix) / DEC_DECIMATION_RATE];
+static int32_t i_out[2][elems(i_mix) / DEC_DECIMATION_RATE];
+static int32_t q_out[2][elems(q_mix) / DEC_DECIMATION_RATE];
 /* ping pong buffer indicator */
 static int pp;
 
@@ -17,7 +17,6 @@
 #include "dev/rfin.h"
 #include "dev/usb.h"
 #include "dev/usb_audiosrc.h"
-#include "dsp/float_fixp.h"
 #include "radio/mix1.h"
 #include "util/elems.h"
 #include "util/minmax.h"
@@ -30,8 +29,8 @@ static ALIGNED(4)int16_t rf[RF_SAMPLING_FREQ * 2 / 1000];
 /* mixed samples buffer */
 static ALIGNED(4) int16_t i_mix[elems(rf) / 2], q_mix[elems(rf) / 2];
 /* decimation result holding array */
-static float i_dec[2][elems(i_mix) / DEC_DECIMATION_RATE],
-             q_dec[2][elems(q_mix) / DEC_DECIMATION_RATE];
+static int32_t i_dec[2][elems(i_mix) / DEC_DECIMATION_RATE],
+               q_dec[2][elems(q_mix) / DEC_DECIMATION_RATE];
 /* ping pong buffer indicator */
 static volatile int pp;
 
@@ -49,8 +48,6 @@ static int TestRFDecUSB_RFSamplesReady(void *ptr)
 {
     /* cast event argument */
     rfin_evarg_t *ea = ptr;
-    /* conversion buffers to prepare the data for the usb */
-    int32_t i_dec_i32[elems(i_dec[0])], q_dec_i32[elems(q_dec[0])];
 
     /* update the ping-pong counter */
     pp = !pp;
@@ -67,12 +64,9 @@ static int TestRFDecUSB_RFSamplesReady(void *ptr)
     Dec_Decimate(i_mix, q_mix, rf_num, i_dec[pp], q_dec[pp], 
         TestRFDecUSB_DecimationDoneCallback);
     
-    /* convert to the fixed point notation for the usb */
-    FloatFixp_FloatToFixp32(i_dec[!pp], dec_num, 31, i_dec_i32);
-    FloatFixp_FloatToFixp32(q_dec[!pp], dec_num, 31, q_dec_i32);
-
-    /* store within the usb buffer */
-    USBAudioSrc_PutSamples(i_dec_i32, q_dec_i32, elems(i_dec_i32));
+    /* decimator delivers the data in the fixed point notation, the usb can 
+     * take it as it is */
+    USBAudioSrc_PutSamples(i_dec[!pp], q_dec[!pp], dec_num);
     
     /* report status */
     return EOK;
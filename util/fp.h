@@ -52,6 +52,8 @@
 #define fp_cos(x)							cosf(x)
 /** @brief natural logarithm */
 #define fp_log(x)                           logf(x)
+/** @brief exponential function */
+#define fp_exp(x)                           expf(x)
 /** @brief break into integral and fractional part */
 #define fp_modf(x, int_part)                modff(x, int_part)
 
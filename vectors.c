@@ -59,6 +59,7 @@ SECTION(".flash_vectors") vector_entry_t flash_vectors[] = {
 
     /* decimators */
     SET_INT_VEC(STM32_INT_DMA1C4, Dec_DMA1C4Isr),
+    SET_INT_VEC(STM32_INT_DMA1C5, Dec_DMA1C5Isr),
 
     /* i2c1 */
     SET_INT_VEC(STM32_INT_I2C1_EV, I2C1_I2C1EvIsr),